@@ -9,6 +9,14 @@
 //   • Gamepad, touch, and mechanical input handling
 //   • Editable values with autosave support
 //   • SD JSON persistence helpers
+//   • FADE page transitions (blend.h) and each page's background
+//     restore, split over both cores (split.h)
+//   • Layout follows the display rotation (display.h)
+//   • UTF-8 labels (text.h), vector icons (icons.h)
+//   • Wallpaper (wallpaper.h): only damaged rects are restored
+//   • Debug overlay line, drawn into the page (setMenuOverlay)
+//   • No per-frame heap strings: value text from the frame
+//     arena (arena.h), fixed menu stack, fade buffer kept
 //
 //  Notes:
 //   - Uses TFT_eSPI sprites for smooth redraws. 
@@ -19,24 +27,102 @@
 #include "MenuUI.h"
 #include "controls.h"
 #include "config.h"
+#include "blend.h"
+#include "display.h"
+#include "text.h"
+#include "icons.h"
+#include "wallpaper.h"
+#include "split.h"
+#include "arena.h"
+#include "sdcard.h"
 #include <ArduinoJson.h>
-#include <vector>
 
 // =========================================================
 //  GLOBAL STATE
 // =========================================================
 static TFT_eSprite* spriteA = nullptr;
-static TFT_eSprite* spriteB = nullptr; // reserved for future transitions
-static std::vector<EditMenu*> menuStack;
+static TFT_eSprite* spriteB = nullptr; // outgoing page during a fade
+static uint16_t* fadeOut = nullptr;    // blended frame, kept between fades
+static size_t fadeOutPx = 0;
+static bool fadeNext = false;
+static EditMenu* menuStack[MENU_STACK_DEPTH];
+static uint8_t stackDepth = 0;
+static bool inputLocked = false;       // cleared by lockTimer
+static TimerId lockTimer = 0;
 static unsigned long inputLockUntil = 0;
+static bool blinkOn = false;           // edit-value blink, toggled by blinkTimer
+static TimerId blinkTimer = 0;
 static EditMenu* rootMenu = nullptr;
+static char overlayLine[48] = "";      // setMenuOverlay()
+
+// What spriteA holds besides the background: every rect drawn
+// into it last frame. The next frame restores only these.
+struct DamageRect { int16_t x, y, w, h; };
+static DamageRect       damage[MENU_DAMAGE_RECTS];
+static uint8_t          damageCount = 0;
+static bool             damageFull = true;   // repaint the whole background
+static const MenuBase*  paintedBy = nullptr;
+static uint16_t         paintedBg = 0;
+static uint32_t         paintedWall = 0;
+
+
+// =========================================================
+//  INPUT TIMING (timer wheel)
+// =========================================================
+static void unlockInput(void*) { inputLocked = false; }
+
+// Ignore input for `ms` (debounces page changes)
+static void lockInput(uint32_t ms) {
+  timerCancel(lockTimer);
+  inputLockUntil = millis() + ms;
+  lockTimer = timerAfter(ms, unlockInput, nullptr);
+  inputLocked = lockTimer != 0;
+}
+
+static void repeatDue(void* ctx) { ((KeyRepeat*)ctx)->due = true; }
+
+// Direction to act on this frame: once on press, then each time
+// the repeat timer comes due while it's held (initial delay,
+// then hold rate, then fast rate after fastRepeatAfter)
+static int8_t repeatStep(KeyRepeat& k, int8_t d, const MenuSettings& s) {
+  if (d != k.dir) {
+    timerCancel(k.timer);
+    k.dir = d;
+    k.due = false;
+    if (!d) return 0;
+    k.start = millis();
+    k.timer = timerAfter(s.initialRepeatDelay, repeatDue, &k);
+    return d;
+  }
+  if (!d || !k.due) return 0;
+  k.due = false;
+  uint32_t held = millis() - k.start;
+  k.timer = timerAfter(held >= s.fastRepeatAfter ? s.fastRepeatDelay : s.holdRepeatDelay, repeatDue, &k);
+  return d;
+}
+
+static void toggleBlink(void* ctx) {
+  blinkOn = !blinkOn;
+  ((EditMenu*)ctx)->markDirtyPublic();
+}
+
+static void autosaveDue(void* ctx) {
+  EditMenu* m = (EditMenu*)ctx;
+  saveMenuSettings(*m, m->autosavePath());
+}
 
 
 // =========================================================
 //  ACCESSORS
 // =========================================================
 unsigned long getMenuInputLockUntil() { return inputLockUntil; }
-void setMenuInputLockUntil(unsigned long val) { inputLockUntil = val; }
+void setMenuInputLockUntil(unsigned long val) {
+  long ms = (long)(val - millis());
+  if (ms > 0) { lockInput(ms); return; }
+  timerCancel(lockTimer);
+  inputLocked = false;
+  inputLockUntil = val;
+}
 
 
 // =========================================================
@@ -44,25 +130,47 @@ void setMenuInputLockUntil(unsigned long val) { inputLockUntil = val; }
 // =========================================================
 void setRootMenu(EditMenu* m) {
   rootMenu = m;
-  menuStack.clear();
-  if (m) menuStack.push_back(m);
+  stackDepth = 0;
+  if (m) menuStack[stackDepth++] = m;
 }
 
 EditMenu* currentMenu() {
-  if (menuStack.empty()) return nullptr;
-  return menuStack.back();
+  if (!stackDepth) return nullptr;
+  return menuStack[stackDepth - 1];
+}
+
+// Keeps the page on screen so the next one can fade in over it
+static void captureOutgoing() {
+  EditMenu* m = currentMenu();
+  if (!m || !spriteA || !spriteA->created()) return;
+  const MenuTheme& th = m->theme();
+  if (!th.animations || (th.pageTransition != TransitionStyle::FADE &&
+                         th.pageTransition != TransitionStyle::SLIDE_FADE)) return;
+
+  int16_t w = spriteA->width(), h = spriteA->height();
+  if (!spriteB) spriteB = new TFT_eSprite(&m->tft());
+  if (spriteB->created() && (spriteB->width() != w || spriteB->height() != h)) spriteB->deleteSprite();
+  if (!spriteB->created() && !spriteB->createSprite(w, h)) return;
+  memcpy(spriteB->getPointer(), spriteA->getPointer(), (size_t)w * h * sizeof(uint16_t));
+  fadeNext = true;
 }
 
 void pushMenu(EditMenu* m) {
   if (!m) return;
-  menuStack.push_back(m);
+  if (stackDepth >= MENU_STACK_DEPTH) {
+    DBG_IF(MENU, "[Menu] Stack full (MENU_STACK_DEPTH %u)\n", MENU_STACK_DEPTH);
+    return;
+  }
+  captureOutgoing();
+  menuStack[stackDepth++] = m;
   m->forceRedraw();
 }
 
 EditMenu* popMenu() {
-  if (menuStack.size() <= 1) return nullptr;
-  menuStack.pop_back();
-  EditMenu* prev = menuStack.back();
+  if (stackDepth <= 1) return nullptr;
+  captureOutgoing();
+  stackDepth--;
+  EditMenu* prev = menuStack[stackDepth - 1];
   prev->forceRedraw();
   return prev;
 }
@@ -71,23 +179,25 @@ EditMenu* popMenu() {
 // =========================================================
 //  MENU ITEM BUILDERS
 // =========================================================
-// Helper shortcuts for creating label/range/array menu items
-MenuItem makeLabel(const String& text, IconType it, const String& iconPath, int iw, int ih) {
-  MenuItem m; m.text = text; m.iconType = it; m.iconPath = iconPath; m.iconW = iw; m.iconH = ih;
+// Helper shortcuts for creating label/range/array menu items.
+// Strings are taken by value and moved in: one copy at most.
+MenuItem makeLabel(String text, IconType it, String iconPath, int iw, int ih) {
+  MenuItem m; m.text = std::move(text); m.iconType = it; m.iconPath = std::move(iconPath);
+  m.iconW = iw; m.iconH = ih;
   return m;
 }
 
-MenuItem makeRange(const String& text, long v, long minV, long maxV, long step,
-                   IconType it, const String& iconPath, int iw, int ih) {
-  MenuItem m = makeLabel(text, it, iconPath, iw, ih);
+MenuItem makeRange(String text, long v, long minV, long maxV, long step,
+                   IconType it, String iconPath, int iw, int ih) {
+  MenuItem m = makeLabel(std::move(text), it, std::move(iconPath), iw, ih);
   m.edit = EditKind::RANGE;
   m.r.value = v; m.r.minV = minV; m.r.maxV = maxV; m.r.step = step;
   return m;
 }
 
-MenuItem makeArray(const String& text, const char** choices, uint16_t n, uint16_t idx,
-                   IconType it, const String& iconPath, int iw, int ih) {
-  MenuItem m = makeLabel(text, it, iconPath, iw, ih);
+MenuItem makeArray(String text, const char** choices, uint16_t n, uint16_t idx,
+                   IconType it, String iconPath, int iw, int ih) {
+  MenuItem m = makeLabel(std::move(text), it, std::move(iconPath), iw, ih);
   m.edit = EditKind::ARRAY;
   m.a.choices = choices; m.a.count = n; m.a.index = idx;
   return m;
@@ -98,7 +208,7 @@ MenuItem makeArray(const String& text, const char** choices, uint16_t n, uint16_
 //  MENUBASE IMPLEMENTATION
 // =========================================================
 MenuBase::MenuBase(TFT_eSPI& tft, int16_t w, int16_t h)
-  : _tft(tft), _W(w), _H(h) {}
+  : _tft(tft), _W(w), _H(h), _fixedSize(w > 0 && h > 0) {}
 
 void MenuBase::setTheme(const MenuTheme& th) { _th = th; _dirty = true; }
 void MenuBase::setInputMode(InputMode m) { _mode = m; }
@@ -111,6 +221,21 @@ bool MenuBase::addItem(const MenuItem& it) {
   return true;
 }
 
+bool MenuBase::addItem(MenuItem&& it) {
+  if (_count >= MAX_OPT) return false;
+  _items[_count++] = std::move(it);
+  _dirty = true;
+  return true;
+}
+
+void MenuBase::clearItems() {
+  for (int i = 0; i < _count; ++i) _items[i] = MenuItem();
+  _count = 0;
+  _sel = 0;
+  _firstVisible = 0;
+  _dirty = true;
+}
+
 void MenuBase::setItemEnabled(uint16_t idx, bool en) { if (idx < _count) _items[idx].enabled = en; }
 void MenuBase::setItemText(uint16_t idx, const String& s) { if (idx < _count) _items[idx].text = s; }
 long MenuBase::getItemValue(uint16_t idx) const { return (idx < _count) ? _items[idx].value() : 0; }
@@ -123,12 +248,84 @@ uint16_t MenuBase::selected() const { return _sel; }
 //  DRAW HELPERS
 // =========================================================
 
+// --- Damage tracking ---
+static void damageAdd(int32_t x, int32_t y, int32_t w, int32_t h) {
+  if (w <= 0 || h <= 0) return;
+  if (damageCount >= MENU_DAMAGE_RECTS) { damageFull = true; return; }
+  damage[damageCount++] = { (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h };
+}
+
+// The background restore is split over both cores (split.h)
+// in bands of PAGE_BAND rows; each band restores its own rows
+// of the page or of every damage rect. The labels and icons
+// drawn over it stay on the UI core: the glyph and icon caches
+// and the sprite's text state are not shared-safe.
+static constexpr int16_t PAGE_BAND = 16;
+
+struct RestoreJob {
+  uint16_t*       fb;
+  const uint16_t* src;      // wallpaperFor(), resolved up front
+  int16_t         w, h;
+  uint16_t        bg;
+  bool            full;
+};
+
+static void restoreBand(void* ctx, uint16_t band) {
+  const RestoreJob& j = *(const RestoreJob*)ctx;
+  const int32_t y0 = band * PAGE_BAND, y1 = min<int32_t>(y0 + PAGE_BAND, j.h);
+  if (j.full) { wallpaperRestoreRaw(j.fb, j.w, j.h, j.src, 0, y0, j.w, y1 - y0, j.bg); return; }
+  for (uint8_t i = 0; i < damageCount; ++i) {
+    const DamageRect& d = damage[i];
+    const int32_t top = max<int32_t>(d.y, y0), bottom = min<int32_t>(d.y + d.h, y1);
+    if (bottom > top) wallpaperRestoreRaw(j.fb, j.w, j.h, j.src, d.x, top, d.w, bottom - top, j.bg);
+  }
+}
+
+// Restores the background under whatever the last frame drew
+// (all of it after a size, menu, colour or wallpaper change)
+void MenuBase::_clearFrame(TFT_eSprite& spr) {
+  static SplitStats stats;
+  RestoreJob j;
+  j.fb   = (uint16_t*)spr.getPointer();
+  j.w    = spr.width();
+  j.h    = spr.height();
+  j.src  = wallpaperFor(j.w, j.h);   // may decode: not on the worker
+  j.bg   = _th.bg;
+  j.full = damageFull || paintedBy != this || paintedBg != _th.bg || paintedWall != wallpaperGeneration();
+  if (j.fb && (j.full || damageCount))
+    splitRun((j.h + PAGE_BAND - 1) / PAGE_BAND, restoreBand, nullptr, &j, &stats);
+  if (stats.frames >= 60) splitLog("menu page", stats);
+  damageCount = 0;
+  damageFull = false;
+  paintedBy = this;
+  paintedBg = _th.bg;
+  paintedWall = wallpaperGeneration();
+}
+
+// Text over the wallpaper is drawn without a background box
+// (TFT_eSPI: background == foreground)
+uint16_t MenuBase::_textBg(uint16_t fg, bool sel) const {
+  if (sel) return _th.selFill;
+  return wallpaperActive() ? fg : _th.bg;
+}
+
+// textDraw() plus its box for the damage list, from the datum
+void MenuBase::_label(TFT_eSprite& spr, const char* s, int32_t x, int32_t y, uint16_t col) {
+  textDraw(spr, s, x, y, col);
+  const int32_t w = textWidth(spr, s), h = spr.fontHeight();
+  const uint8_t d = spr.getTextDatum();
+  const int32_t x0 = x - ((d % 3) == 1 ? w / 2 : (d % 3) == 2 ? w : 0);
+  const int32_t y0 = y - (d >= 3 && d <= 5 ? h / 2 : d >= 6 ? h : 0);
+  damageAdd(x0 - 1, y0 - 1, w + 2, h + 2);
+}
+
 // --- Vertical List Mode ---
 void MenuBase::drawListToBuffer(TFT_eSprite& spr) {
-  spr.fillSprite(_th.bg);
+  _clearFrame(spr);
   int16_t y = _th.marginT;
+  const int last = min((int)_count, _firstVisible + _rowsFit());
 
-  for (int i = 0; i < _count; ++i) {
+  for (int i = _firstVisible; i < last; ++i) {
     const MenuItem& it = _items[i];
     bool sel = (i == _sel);
 
@@ -138,26 +335,36 @@ void MenuBase::drawListToBuffer(TFT_eSprite& spr) {
                         _th.selectorRadius, _th.selFill);
       spr.drawRoundRect(_th.marginL, y, _W - _th.marginL - _th.marginR, _th.rowH - 4,
                         _th.selectorRadius, _th.selBorder);
+      damageAdd(_th.marginL, y, _W - _th.marginL - _th.marginR, _th.rowH - 4);
     }
 
     // Text
     spr.setTextFont(_th.textFont);
     spr.setTextDatum(ML_DATUM);
-    spr.setTextColor(_th.fg, sel ? _th.selFill : _th.bg);
-    spr.drawString(it.text, _th.marginL + _th.textPad, y + _th.rowH / 2);
+    spr.setTextColor(_th.fg, _textBg(_th.fg, sel));
+    _label(spr, it.text.c_str(), _th.marginL + _th.textPad, y + _th.rowH / 2, _th.fg);
 
     y += _th.rowH;
   }
 }
 
 
+// --- Carousel icon, centered above the selection box ---
+void MenuBase::drawItemIcon(TFT_eSprite& spr, const MenuItem& it, int x, bool sel) {
+  if (it.iconType == IconType::NONE || !it.iconVec) return;
+  const int16_t s = _th.iconSize;
+  iconDraw(spr, it.iconVec, x - s / 2, _H / 2 - 28 - _th.iconPad - s, s,
+           sel ? _th.fg : _th.monoTint);
+  damageAdd(x - s / 2, _H / 2 - 28 - _th.iconPad - s, s, s);
+}
+
 // --- Horizontal Carousel Mode (Nintendo-style) ---
 void MenuBase::drawCarouselToBuffer(TFT_eSprite& spr) {
-  spr.fillSprite(_th.bg);
+  _clearFrame(spr);
 
   int widest = 0;
   for (int i = 0; i < _count; ++i) {
-    int w = spr.textWidth(_items[i].text.c_str());
+    int w = textWidth(spr, _items[i].text);
     if (w > widest) widest = w;
   }
 
@@ -178,46 +385,54 @@ void MenuBase::drawCarouselToBuffer(TFT_eSprite& spr) {
       int boxW = widest + 60;
       spr.fillRoundRect(x - boxW / 2, _H / 2 - 28, boxW, 56, _th.selectorRadius, _th.selFill);
       spr.drawRoundRect(x - boxW / 2, _H / 2 - 28, boxW, 56, _th.selectorRadius, _th.selBorder);
-      spr.setTextColor(_th.fg, _th.selFill);
-    } else {
-      spr.setTextColor(_th.fg, _th.bg);
+      damageAdd(x - boxW / 2, _H / 2 - 28, boxW, 56);
     }
+    spr.setTextColor(_th.fg, _textBg(_th.fg, sel));
 
-    spr.drawString(it.text, x, _H / 2);
+    _label(spr, it.text.c_str(), x, _H / 2, _th.fg);
+    drawItemIcon(spr, it, x, sel);
   }
 }
 
 
 // --- Scroll Arrows ---
 void MenuBase::drawArrowsIfNeededToBuffer(TFT_eSprite& tft) {
-  const int rowsFit = max(1, (_H - _th.marginT - _th.marginB) / _th.rowH);
+  const int rowsFit = _rowsFit();
   bool up = (_firstVisible > 0);
   bool dn = (_firstVisible + rowsFit < _count);
 
   // Clear arrow zones to prevent artifacts
-  tft.fillRect(0, 0, _W, _th.marginT, _th.bg);
-  tft.fillRect(0, _H - _th.marginB, _W, _th.marginB, _th.bg);
+  wallpaperRestore(tft, 0, 0, _W, _th.marginT, _th.bg);
+  wallpaperRestore(tft, 0, _H - _th.marginB, _W, _th.marginB, _th.bg);
 
   if (_th.orientation == MenuOrientation::VERTICAL) {
-    if (up)
+    if (up) {
       tft.fillTriangle(
         _W / 2 - 6, _th.marginT - 2,
         _W / 2 + 6, _th.marginT - 2,
         _W / 2, _th.marginT - 14,
         _th.arrow);
-    if (dn)
+      damageAdd(_W / 2 - 6, _th.marginT - 14, 13, 13);
+    }
+    if (dn) {
       tft.fillTriangle(
         _W / 2 - 6, _H - _th.marginB + 2,
         _W / 2 + 6, _H - _th.marginB + 2,
         _W / 2, _H - _th.marginB + 14,
         _th.arrow);
+      damageAdd(_W / 2 - 6, _H - _th.marginB + 2, 13, 13);
+    }
   } else {
     bool left = (_sel > 0);
     bool right = (_sel < _count - 1);
-    if (left)
+    if (left) {
       tft.fillTriangle(8, _H / 2 - 8, 8, _H / 2 + 8, 0, _H / 2, _th.arrow);
-    if (right)
+      damageAdd(0, _H / 2 - 8, 9, 17);
+    }
+    if (right) {
       tft.fillTriangle(_W - 8, _H / 2 - 8, _W - 8, _H / 2 + 8, _W, _H / 2, _th.arrow);
+      damageAdd(_W - 8, _H / 2 - 8, 9, 17);
+    }
   }
 }
 
@@ -225,16 +440,21 @@ void MenuBase::drawArrowsIfNeededToBuffer(TFT_eSprite& tft) {
 // =========================================================
 //  SELECTION & INPUT HANDLING
 // =========================================================
+int MenuBase::_rowsFit() const {
+  return max(1, (_H - _th.marginT - _th.marginB) / _th.rowH);
+}
+
 void MenuBase::_ensureVisible() {
   if (_th.orientation == MenuOrientation::VERTICAL) {
+    const int rows = _rowsFit();
     if (_sel < _firstVisible) _firstVisible = _sel;
-    if (_sel >= _firstVisible + 6) _firstVisible = _sel - 5;
+    if (_sel >= _firstVisible + rows) _firstVisible = _sel - rows + 1;
   }
 }
 
 void MenuBase::_moveSel(int delta) {
   int newSel = constrain((int)_sel + delta, 0, (int)_count - 1);
-  if (newSel != _sel) { _sel = newSel; _dirty = true; }
+  if (newSel != _sel) { _sel = newSel; _ensureVisible(); _dirty = true; }
 }
 
 static inline int8_t dirFromOrientation(const MenuTheme& th, bool left, bool right, bool up, bool down) {
@@ -264,75 +484,39 @@ void MenuBase::_handleInput() {
 
 // --- Gamepad Navigation ---
 void MenuBase::_handleGamepad() {
-  if (millis() < inputLockUntil) return;
+  if (inputLocked) return;
 
   int8_t d = dirFromOrientation(_th, controls.left(), controls.right(), controls.up(), controls.down());
-  bool any = (d != 0);
-  unsigned long now = millis();
-
-  if (!any) { _navActive = false; _navDir = 0; }
-  else {
-    if (!_navActive || d != _navDir) {
-      _moveSel(d);
-      _navActive = true;
-      _navDir = d;
-      _navStart = now;
-      _navNext = now + settings.initialRepeatDelay;  // first delay
-    } else if (now >= _navNext) {
-      _moveSel(d);
-      unsigned long elapsed = now - _navStart;
-      _navNext = now + (elapsed >= settings.fastRepeatAfter
-                        ? settings.fastRepeatDelay
-                        : settings.holdRepeatDelay);
-    }
-  }
+  if (int8_t step = repeatStep(_nav, d, settings)) _moveSel(step);
 
   if (controls.confirmPressed()) _activatedIndex = _sel;
   if (controls.backPressed()) {
-    if (menuStack.size() > 1) popMenu();
+    if (stackDepth > 1) popMenu();
     controls.consumeBack();
-    inputLockUntil = millis() + 200;
+    lockInput(200);
   }
 }
 
 
 // --- Mechanical (buttons / encoder) ---
 void MenuBase::_handleMechanical() {
-  if (millis() < inputLockUntil) return;
+  if (inputLocked) return;
 
   int8_t d = dirFromOrientation(_th, controls.left(), controls.right(), controls.up(), controls.down());
-  bool any = (d != 0);
-  unsigned long now = millis();
-
-  if (!any) { _navActive = false; _navDir = 0; }
-  else {
-    if (!_navActive || d != _navDir) {
-      _moveSel(d);
-      _navActive = true;
-      _navDir = d;
-      _navStart = now;
-      _navNext = now + settings.initialRepeatDelay;
-    } else if (now >= _navNext) {
-      _moveSel(d);
-      unsigned long elapsed = now - _navStart;
-      _navNext = now + (elapsed >= settings.fastRepeatAfter
-                        ? settings.fastRepeatDelay
-                        : settings.holdRepeatDelay);
-    }
-  }
+  if (int8_t step = repeatStep(_nav, d, settings)) _moveSel(step);
 
   if (controls.confirmPressed()) { _activatedIndex = _sel; controls.consumeConfirm(); }
   if (controls.backPressed()) {
-    if (menuStack.size() > 1) popMenu();
+    if (stackDepth > 1) popMenu();
     controls.consumeBack();
-    inputLockUntil = millis() + 200;
+    lockInput(200);
   }
 }
 
 
 // --- Touch ---
 void MenuBase::_handleTouch() {
-  if (millis() < inputLockUntil) return;
+  if (inputLocked) return;
   int x, y; bool tap = false;
   if (menuGetTouch(x, y, tap)) {
     if (tap) _activatedIndex = _sel;
@@ -343,21 +527,130 @@ void MenuBase::_handleTouch() {
 // =========================================================
 //  DRAW + UPDATE LOOP
 // =========================================================
-void MenuBase::draw() {
-  if (!_dirty) return;
+// Blends the outgoing page (spriteB) into the new one
+// (spriteA), eased over animPageMs. Each step is split across
+// both cores in bands (split.h): the top half goes to the
+// panel while core 0 is still blending the bottom half.
+// SLIDE_FADE fades too until slides exist.
+static constexpr int16_t FADE_BAND = 16;
+
+struct FadeStep {
+  uint16_t*       out;
+  const uint16_t* to;
+  const uint16_t* from;
+  int16_t         w, h;
+  uint8_t         alpha;
+};
+
+static void fadeBand(void* ctx, uint16_t band) {
+  const FadeStep& f = *(const FadeStep*)ctx;
+  int16_t y = band * FADE_BAND, lines = min<int16_t>(FADE_BAND, f.h - y);
+  size_t at = (size_t)y * f.w;
+  blendBuffers(f.out + at, f.to + at, f.from + at, (uint32_t)lines * f.w, f.alpha, true);
+}
+
+static void fadePush(void* ctx, uint16_t first, uint16_t count) {
+  const FadeStep& f = *(const FadeStep*)ctx;
+  int16_t y = first * FADE_BAND, lines = min<int16_t>(count * FADE_BAND, f.h - y);
+  displayPushRows(f.out + (size_t)y * f.w, y, lines);
+}
+
+static void fadePages(const MenuTheme& th) {
+  static SplitStats stats;
+  FadeStep f;
+  f.w = spriteA->width();
+  f.h = spriteA->height();
+  f.to   = (const uint16_t*)spriteA->getPointer();
+  f.from = (const uint16_t*)spriteB->getPointer();
+  const size_t px = (size_t)f.w * f.h;
+  if (fadeOutPx != px) {
+    free(fadeOut);
+    fadeOut = (uint16_t*)ps_malloc(px * sizeof(uint16_t));
+    fadeOutPx = fadeOut ? px : 0;
+  }
+  f.out = fadeOut;
+  if (!f.out) return;
+  const uint16_t bands = (f.h + FADE_BAND - 1) / FADE_BAND;
+
+  uint32_t t0 = millis();
+  for (uint32_t t; (t = millis() - t0) < th.animPageMs; ) {
+    float p = 1.0f - (float)t / th.animPageMs;
+    float e = p;
+    for (uint8_t i = 1; i < th.animEase; ++i) e *= p;  // ease out
+    f.alpha = (uint8_t)(255 * (1.0f - e));
+    splitRun(bands, fadeBand, fadePush, &f, &stats);
+  }
+  if (stats.frames >= 60) splitLog("menu fade", stats);
+}
+
+// The debug line, into the page like any other label (so it
+// follows the rotation and goes out with the page's own push)
+static void drawOverlayToBuffer(TFT_eSprite& spr) {
+  if (!overlayLine[0]) return;
+  spr.setTextFont(1);
+  const int32_t w = spr.textWidth(overlayLine) + 4, h = spr.fontHeight() + 6;
+  spr.fillRect(0, 0, w, h, 0x0000);
+  spr.setTextColor(0xFFFF, 0x0000);
+  spr.setTextDatum(TL_DATUM);
+  spr.drawString(overlayLine, 2, 3);
+  damageAdd(0, 0, w, h);
+}
+
+void setMenuOverlay(const char* line) {
+  if (!line) line = "";
+  if (!strncmp(line, overlayLine, sizeof(overlayLine) - 1)) return;
+  strlcpy(overlayLine, line, sizeof(overlayLine));
+  if (EditMenu* m = currentMenu()) m->markDirtyPublic();
+}
+
+static void presentPage(const MenuTheme& th) {
+  drawOverlayToBuffer(*spriteA);
+  if (fadeNext && spriteB && spriteB->created() &&
+      spriteB->width() == spriteA->width() && spriteB->height() == spriteA->height())
+    fadePages(th);
+  fadeNext = false;
+
+  displayPushSprite(*spriteA);
+
+  // The frame's temporaries are done with
+  static size_t loggedPeak = 0;
+  if (frameArena.peak() > loggedPeak) {
+    loggedPeak = frameArena.peak();
+    DBG_IF(MENU, "[Menu] Frame arena peak %u of %u bytes (%lu overflows)\n", (unsigned)loggedPeak,
+           (unsigned)frameArena.capacity(), (unsigned long)frameArena.overflows());
+  }
+  frameArena.reset();
+}
+
+// Re-derives the layout from the display (it may have been
+// rotated since the last draw) and readies spriteA at that size.
+// The old page is freed before the new one is allocated, so a
+// rotation never holds two frames.
+void MenuBase::_beginFrame() {
+  if (!_fixedSize && (_W != displayWidth() || _H != displayHeight())) {
+    _W = displayWidth();
+    _H = displayHeight();
+    _ensureVisible();
+  }
   if (!spriteA) spriteA = new TFT_eSprite(&_tft);
-
+  if (spriteA->created() && (spriteA->width() != _W || spriteA->height() != _H)) {
+    spriteA->deleteSprite();
+    if (spriteB) spriteB->deleteSprite();  // a fade across sizes can't happen
+  }
+  if (!spriteA->created()) damageFull = true;
   spriteA->createSprite(_W, _H);
+}
+
+void MenuBase::draw() {
+  if (!_dirty) return;
+  _beginFrame();
   if (_th.orientation == MenuOrientation::VERTICAL)
     drawListToBuffer(*spriteA);
   else
     drawCarouselToBuffer(*spriteA);
 
   drawArrowsIfNeededToBuffer(*spriteA);
-
-  _tft.startWrite();
-  spriteA->pushSprite(0, 0);
-  _tft.endWrite();
+  presentPage(_th);
 
   _dirty = false;
 }
@@ -390,14 +683,12 @@ void EditMenu::_editAdjust(int dir) {
   long newVal = it.value();
   if (it.onChange && newVal != oldVal) it.onChange(newVal);
 
-  // Autosave (throttled)
+  // Autosave once the value settles, so the last change is
+  // always written and a held key doesn't hammer the SD card
   if (_autosave && _savePath) {
-    static unsigned long lastSave = 0;
-    unsigned long now = millis();
-    if (now - lastSave > 300) {
-      saveMenuSettings(*this, _savePath);
-      lastSave = now;
-    }
+    timerCancel(_saveTimer);
+    _saveTimer = timerAfter(MENU_AUTOSAVE_MS, autosaveDue, this);
+    if (!_saveTimer) saveMenuSettings(*this, _savePath);
   }
 }
 
@@ -415,29 +706,9 @@ void EditMenu::_handleInputEdit() {
 }
 
 void EditMenu::_editGamepad() { // I undastand it now >:)
-  if (millis() < inputLockUntil) return;
-  bool left = controls.left();
-  bool right = controls.right();
-  int8_t d = left ? -1 : right ? 1 : 0;
-  bool any = (d != 0);
-  unsigned long now = millis();
-
-  if (!any) { _editActive = false; _editDir = 0; }
-  else {
-    if (!_editActive || d != _editDir) {
-      _editAdjust(d);
-      _editActive = true;
-      _editDir = d;
-      _editStart = now;
-      _editNext = now + settings.initialRepeatDelay;
-    } else if (now >= _editNext) {
-      _editAdjust(d);
-      unsigned long elapsed = now - _editStart;
-      _editNext = now + (elapsed >= settings.fastRepeatAfter
-                        ? settings.fastRepeatDelay
-                        : settings.holdRepeatDelay);
-    }
-  }
+  if (inputLocked) return;
+  int8_t d = controls.left() ? -1 : controls.right() ? 1 : 0;
+  if (int8_t step = repeatStep(_edit, d, settings)) _editAdjust(step);
 
   if (controls.confirmPressed()) {
     _editing = false;
@@ -452,35 +723,15 @@ void EditMenu::_editGamepad() { // I undastand it now >:)
 }
 
 void EditMenu::_editMechanical() { // No fucking clue if this works yet
-  if (millis() < inputLockUntil) return;
-  bool left = controls.left();
-  bool right = controls.right();
-  int8_t d = left ? -1 : right ? 1 : 0;
-  bool any = (d != 0);
-  unsigned long now = millis();
-
-  if (!any) { _editActive = false; _editDir = 0; }
-  else {
-    if (!_editActive || d != _editDir) {
-      _editAdjust(d);
-      _editActive = true;
-      _editDir = d;
-      _editStart = now;
-      _editNext = now + settings.initialRepeatDelay;
-    } else if (now >= _editNext) {
-      _editAdjust(d);
-      unsigned long elapsed = now - _editStart;
-      _editNext = now + (elapsed >= settings.fastRepeatAfter
-                        ? settings.fastRepeatDelay
-                        : settings.holdRepeatDelay);
-    }
-  }
+  if (inputLocked) return;
+  int8_t d = controls.left() ? -1 : controls.right() ? 1 : 0;
+  if (int8_t step = repeatStep(_edit, d, settings)) _editAdjust(step);
   if (controls.confirmPressed()) { _editing = false; controls.consumeConfirm(); }
   if (controls.backPressed()) { _editing = false; controls.consumeBack(); }
 }
 
 void EditMenu::_editTouch() { // No fucking clue if this works yet
-  if (millis() < inputLockUntil) return;
+  if (inputLocked) return;
   int x, y; bool tap = false;
   if (menuGetTouch(x, y, tap)) {
     if (tap) _editing = false;
@@ -492,10 +743,11 @@ void EditMenu::_editTouch() { // No fucking clue if this works yet
 //  EDITMODE DRAW HELPERS (values)
 // =========================================================
 void EditMenu::drawListWithValues() {
-  spriteA->fillSprite(_th.bg);
+  _clearFrame(*spriteA);
   int16_t y = _th.marginT;
+  const int last = min((int)_count, _firstVisible + _rowsFit());
 
-  for (int i = 0; i < _count; ++i) {
+  for (int i = _firstVisible; i < last; ++i) {
     const MenuItem& it = _items[i];
     bool sel = (i == _sel);
 
@@ -504,12 +756,13 @@ void EditMenu::drawListWithValues() {
                               _th.selectorRadius, _th.selFill);
       spriteA->drawRoundRect(_th.marginL, y, _W - _th.marginL - _th.marginR, _th.rowH - 4,
                               _th.selectorRadius, _th.selBorder);
+      damageAdd(_th.marginL, y, _W - _th.marginL - _th.marginR, _th.rowH - 4);
     }
 
     spriteA->setTextFont(_th.textFont);
     spriteA->setTextDatum(ML_DATUM);
-    spriteA->setTextColor(_th.fg, sel ? _th.selFill : _th.bg);
-    spriteA->drawString(it.text, _th.marginL + _th.textPad, y + _th.rowH / 2);
+    spriteA->setTextColor(_th.fg, _textBg(_th.fg, sel));
+    _label(*spriteA, it.text.c_str(), _th.marginL + _th.textPad, y + _th.rowH / 2, _th.fg);
 
     if (it.edit != EditKind::NONE) {
       spriteA->setTextFont(_th.valueFont);
@@ -517,19 +770,18 @@ void EditMenu::drawListWithValues() {
 
       // Default muted color
       uint16_t textCol = _th.muted;
-      uint16_t bgCol   = sel ? _th.selFill : _th.bg;
 
       // Sexy man blink while edit :D
-      if (_editing && sel && (millis() / 300 % 2))
+      if (_editing && sel && blinkOn)
         textCol = _th.selBorder;
 
-      spriteA->setTextColor(textCol, bgCol);
+      spriteA->setTextColor(textCol, _textBg(textCol, sel));
 
-      String valStr = (it.edit == EditKind::RANGE)
-                        ? String(it.r.value)
-                        : String(it.a.choices[it.a.index]);
+      const char* valStr = (it.edit == EditKind::RANGE)
+                             ? frameArena.format("%ld", it.r.value)
+                             : it.a.choices[it.a.index];
 
-      spriteA->drawString(valStr, _W - _th.marginR - 4, y + _th.rowH / 2);
+      _label(*spriteA, valStr, _W - _th.marginR - 4, y + _th.rowH / 2, textCol);
     }
 
     y += _th.rowH;
@@ -537,11 +789,11 @@ void EditMenu::drawListWithValues() {
 }
 
 void EditMenu::drawCarouselWithValues() {
-  spriteA->fillSprite(_th.bg);
+  _clearFrame(*spriteA);
 
   int widest = 0;
   for (int i = 0; i < _count; ++i) {
-    int w = spriteA->textWidth(_items[i].text.c_str());
+    int w = textWidth(*spriteA, _items[i].text);
     if (w > widest) widest = w;
   }
 
@@ -560,13 +812,13 @@ void EditMenu::drawCarouselWithValues() {
       int boxW = widest + 60;
       spriteA->fillRoundRect(x - boxW / 2, _H / 2 - 28, boxW, 56, _th.selectorRadius, _th.selFill);
       spriteA->drawRoundRect(x - boxW / 2, _H / 2 - 28, boxW, 56, _th.selectorRadius, _th.selBorder);
-      spriteA->setTextColor(_th.fg, _th.selFill);
-    } else {
-      spriteA->setTextColor(_th.fg, _th.bg);
+      damageAdd(x - boxW / 2, _H / 2 - 28, boxW, 56);
     }
+    spriteA->setTextColor(_th.fg, _textBg(_th.fg, sel));
 
     spriteA->setTextFont(_th.textFont);
-    spriteA->drawString(it.text, x, _H / 2 - 10);
+    _label(*spriteA, it.text.c_str(), x, _H / 2 - 10, _th.fg);
+    drawItemIcon(*spriteA, it, x, sel);
 
     if (it.edit != EditKind::NONE) {
       spriteA->setTextFont(_th.valueFont);
@@ -574,19 +826,18 @@ void EditMenu::drawCarouselWithValues() {
 
       // Default muted color
       uint16_t textCol = _th.muted;
-      uint16_t bgCol   = sel ? _th.selFill : _th.bg;
 
       // Blink while editing (same logic as vertical)
-      if (_editing && sel && (millis() / 300 % 2))
+      if (_editing && sel && blinkOn)
         textCol = _th.selBorder;
 
-      spriteA->setTextColor(textCol, bgCol);
+      spriteA->setTextColor(textCol, _textBg(textCol, sel));
 
-      String valStr = (it.edit == EditKind::RANGE)
-                        ? String(it.r.value)
-                        : String(it.a.choices[it.a.index]);
+      const char* valStr = (it.edit == EditKind::RANGE)
+                             ? frameArena.format("%ld", it.r.value)
+                             : it.a.choices[it.a.index];
 
-      spriteA->drawString(valStr, x, _H / 2 + 14);
+      _label(*spriteA, valStr, x, _H / 2 + 14, textCol);
     }
   }
 }
@@ -597,42 +848,30 @@ void EditMenu::drawCarouselWithValues() {
 // =========================================================
 void EditMenu::draw() {
   if (!_dirty) return;
-  if (!spriteA) spriteA = new TFT_eSprite(&_tft);
-
-  spriteA->createSprite(_W, _H);
+  _beginFrame();
   if (_th.orientation == MenuOrientation::VERTICAL)
     drawListWithValues();
   else
     drawCarouselWithValues();
 
   drawArrowsIfNeededToBuffer(*spriteA);
-
-  _tft.startWrite();
-  spriteA->pushSprite(0, 0);
-  _tft.endWrite();
+  presentPage(_th);
 
   _dirty = false;
 }
 
 int EditMenu::update() {
   _activatedIndex = -1;
-  static unsigned long lastBlink = 0;
-  static bool blinkState = false;
 
   if (_editing) {
     _handleInputEdit();
-
-    unsigned long now = millis();
-    bool newState = (now / 300) % 2;
-    if (newState != blinkState) {
-      blinkState = newState;
-      _dirty = true;
-    }
+    if (!timerPending(blinkTimer)) blinkTimer = timerEvery(MENU_BLINK_MS, toggleBlink, this);
   } else {
     _handleInput();
     // Reset blink when editing ends
-    if (blinkState) {
-      blinkState = false;
+    timerCancel(blinkTimer);
+    if (blinkOn) {
+      blinkOn = false;
       _dirty = true;
     }
   }
@@ -644,7 +883,7 @@ int EditMenu::update() {
     MenuItem& it = _items[_activatedIndex];
     if (it.submenu) {
       pushMenu(it.submenu);
-      inputLockUntil = millis() + 150;
+      lockInput(150);
     } else if (it.edit != EditKind::NONE) {
       _editing = true;
     } else {
@@ -654,18 +893,18 @@ int EditMenu::update() {
   return ret;
 }
 
+// Saving only: the values are read once, by whoever owns the
+// boot (loadMenuSettings(), off the loop task)
 void EditMenu::enableAutoSave(const char* path) {
   _autosave = true;
   _savePath = path;
+}
 
-  // if this dont work im blowing my brains out
-  if (loadMenuSettings(*this, _savePath)) {
-    _dirty = true;
-    DBG_IF(MENU, "[Menu] Loaded settings from %s\n", _savePath);
-  } else {
-    DBG_IF(MENU, "[Menu] No existing settings file, will create new.\n");
-  }
-  // it worked
+bool EditMenu::flushAutoSave() {
+  if (!timerPending(_saveTimer)) return false;
+  timerCancel(_saveTimer);
+  saveMenuSettings(*this, _savePath);
+  return true;
 }
 
 
@@ -673,35 +912,41 @@ void EditMenu::enableAutoSave(const char* path) {
 //  SAVE / LOAD HELPERS (SD / FS)
 // =========================================================
 bool saveMenuSettings(MenuBase& menu, const char* path) {
-  pinMode(TFT_CS, OUTPUT); digitalWrite(TFT_CS, HIGH);
+  SdBus bus;
   File f = SD.open(path, FILE_WRITE);
-  if (!f) { digitalWrite(TFT_CS, LOW); return false; }
+  if (!f) return false;
 
+  // Keys stay on the stack until serialized (no String temporaries)
   StaticJsonDocument<512> doc;
-  for (int i = 0; i < menu.size(); i++) // please work
-    doc[String(i)] = menu.getItemValue(i);
+  char keys[MAX_OPT][4];
+  for (int i = 0; i < menu.size(); i++) { // please work
+    snprintf(keys[i], sizeof(keys[i]), "%d", i);
+    doc[(const char*)keys[i]] = menu.getItemValue(i);
+  }
 
   serializeJsonPretty(doc, f);
   f.close();
-  digitalWrite(TFT_CS, LOW);
   return true;
 }
 
 bool loadMenuSettings(MenuBase& menu, const char* path) {
-  pinMode(TFT_CS, OUTPUT); digitalWrite(TFT_CS, HIGH);
-  File f = SD.open(path, FILE_READ);
-  if (!f) { digitalWrite(TFT_CS, LOW); return false; }
-
   StaticJsonDocument<512> doc;
-  DeserializationError err = deserializeJson(doc, f);
-  f.close();
-  digitalWrite(TFT_CS, LOW);
+  DeserializationError err;
+  {
+    SdBus bus;
+    File f = SD.open(path, FILE_READ);
+    if (!f) return false;
+    err = deserializeJson(doc, f);
+    f.close();
+  }
 
   if (err) return false;
 
+  char key[4];
   for (int i = 0; i < menu.size(); i++) { // please work
-    if (doc.containsKey(String(i)))
-      menu.setItemValue(i, doc[String(i)].as<long>());
+    snprintf(key, sizeof(key), "%d", i);
+    if (doc.containsKey(key))
+      menu.setItemValue(i, doc[key].as<long>());
   }
   return true;
 }
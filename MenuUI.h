@@ -6,6 +6,7 @@
 #include <functional>
 
 #include "config.h"  // Central config (orientation, colors, fonts, animations)
+#include "timerwheel.h"
 
 // ============================================================
 //  RowBoy Firmware Prototype v1.0 (ESP32-S3)
@@ -55,6 +56,15 @@ struct MenuSettings {
   uint16_t  fastRepeatAfter    = REPEAT_AFTER_MS;    // Time until fast mode
 };
 
+// Held-direction auto-repeat: a timer marks the next step due,
+// the input handler takes it while the direction is still held.
+struct KeyRepeat {
+  int8_t   dir   = 0;
+  bool     due   = false;
+  uint32_t start = 0;
+  TimerId  timer = 0;
+};
+
 
 // ============================================================
 //  WEAK EXTERNAL HOOKS
@@ -105,6 +115,7 @@ struct MenuItem {
   IconType iconType = IconType::NONE;
   String   iconPath;
   int16_t  iconW = 0, iconH = 0;
+  const uint8_t* iconVec = nullptr;  // Vector icon path (icons.h)
   bool     enabled = true;
 
   EditKind edit = EditKind::NONE;
@@ -138,17 +149,17 @@ struct MenuItem {
 //  QUICK ITEM BUILDERS
 // ============================================================
 // Simple helpers to construct menu items inline.
-MenuItem makeLabel(const String& text,
+MenuItem makeLabel(String text,
                    IconType it = IconType::NONE,
-                   const String& iconPath = "", int iw = 0, int ih = 0);
+                   String iconPath = String(), int iw = 0, int ih = 0);
 
-MenuItem makeRange(const String& text, long v, long minV, long maxV, long step,
+MenuItem makeRange(String text, long v, long minV, long maxV, long step,
                    IconType it = IconType::NONE,
-                   const String& iconPath = "", int iw = 0, int ih = 0);
+                   String iconPath = String(), int iw = 0, int ih = 0);
 
-MenuItem makeArray(const String& text, const char** choices, uint16_t n, uint16_t idx,
+MenuItem makeArray(String text, const char** choices, uint16_t n, uint16_t idx,
                    IconType it = IconType::NONE,
-                   const String& iconPath = "", int iw = 0, int ih = 0);
+                   String iconPath = String(), int iw = 0, int ih = 0);
 
 
 // ============================================================
@@ -163,6 +174,7 @@ struct MenuTheme {
   int16_t marginB = MENU_MARGIN_B;
   int16_t rowH    = MENU_ROW_H;
   int16_t iconPad = MENU_ICON_PAD;
+  int16_t iconSize = MENU_ICON_SIZE;
   int16_t textPad = MENU_TEXT_PAD;
   int16_t selectorRadius = MENU_SELECTOR_RADIUS;
   int16_t selectorBorder = MENU_SELECTOR_BORDER;
@@ -206,7 +218,8 @@ class MenuBase {
 public:
   MenuSettings settings;
 
-  MenuBase(TFT_eSPI& tft, int16_t w, int16_t h);
+  // w/h of 0 follow the display (and its rotation)
+  MenuBase(TFT_eSPI& tft, int16_t w = 0, int16_t h = 0);
 
   // --- Dirty flag control ---
   void markDirty()  { _dirty = true; }
@@ -226,6 +239,8 @@ public:
 
   // --- Item management ---
   bool addItem(const MenuItem& it);
+  bool addItem(MenuItem&& it);     // makeLabel(...) results move in
+  void clearItems();
   void setItemEnabled(uint16_t idx, bool en);
   void setItemText(uint16_t idx, const String& s);
   long getItemValue(uint16_t idx) const;
@@ -266,8 +281,10 @@ protected:
   bool      _dirty = true;
   int       _activatedIndex = -1;
   int16_t   _W, _H;
+  bool      _fixedSize;
 
   // --- Navigation helpers ---
+  int  _rowsFit() const;
   void _ensureVisible();
   void _moveSel(int delta);
 
@@ -278,16 +295,18 @@ protected:
   void _handleTouch();
 
   // --- Drawing helpers ---
+  void _beginFrame();
   void drawListToBuffer(TFT_eSprite& tft);
   void drawCarouselToBuffer(TFT_eSprite& tft);
   void drawArrowsIfNeededToBuffer(TFT_eSprite& tft);
+  void drawItemIcon(TFT_eSprite& spr, const MenuItem& it, int x, bool sel);
+  void _clearFrame(TFT_eSprite& spr);   // background back under last frame's items
+  void _label(TFT_eSprite& spr, const char* s, int32_t x, int32_t y, uint16_t col);
+  uint16_t _textBg(uint16_t fg, bool sel) const;
   static String wrapTextByWidth(TFT_eSPI& tft, const String& s, int maxW, int font);
 
   // --- Navigation timing ---
-  int8_t        _navDir = 0;
-  bool          _navActive = false;
-  unsigned long _navNext = 0;
-  unsigned long _navStart = 0;
+  KeyRepeat _nav;
 };
 
 
@@ -303,8 +322,12 @@ public:
   bool inEditing() const { return _editing; }
 
   // --- Auto-Save ---
+  // Doesn't load: call loadMenuSettings() (once) for that
   void enableAutoSave(const char* path = "/settings.json");
   void disableAutoSave() { _autosave = false; }
+  // Writes a pending trailing save now; do this before another
+  // task takes the SD card. False if nothing was pending.
+  bool flushAutoSave();
   bool autosaveEnabled() const { return _autosave; }
   const char* autosavePath() const { return _savePath; }
 
@@ -329,10 +352,8 @@ protected:
   void _editTouch();
 
   // --- Edit timing ---
-  int8_t        _editDir = 0;
-  bool          _editActive = false;
-  unsigned long _editNext = 0;
-  unsigned long _editStart = 0;
+  KeyRepeat _edit;
+  TimerId   _saveTimer = 0;   // trailing autosave
 };
 
 
@@ -346,6 +367,15 @@ EditMenu* currentMenu();
 void      setRootMenu(EditMenu* m);
 
 
+// ============================================================
+//  DEBUG OVERLAY
+// ============================================================
+// One line over the top-left corner of every page, drawn into
+// the page before it is presented; "" removes it. Only a
+// changed line redraws the current menu.
+void setMenuOverlay(const char* line);
+
+
 // ============================================================
 //  INPUT LOCK (prevent early repeat between menus)
 // ============================================================
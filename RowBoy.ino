@@ -8,6 +8,9 @@
 //  - Unified input system: Gamepad + Mechanical + Touch
 //  - Optional icons, smooth(ish) transitions, configurable fonts/colors
 //  - Drop-in Settings menu with autosave over SD
+//  - Game Library: NES ROMs from SD, emulated in-core
+//  - Homebrew: carts on a built-in fantasy-console runtime
+//  - Gallery: MJPEG videos and animated GIFs from SD
 //
 //  ---------------------------------------------------------
 //  HOW TO USE
@@ -37,8 +40,9 @@
 //
 //  SAVING SETTINGS
 //  ----------------
-//  - Call menu.enableAutoSave("/path.json") on a settings menu.
-//  - TFT_CS is safely toggled around SD access to avoid screen artifacts.
+//  - Call menu.enableAutoSave("/path.json") on a settings menu,
+//    and loadMenuSettings() once to read it back (bootFlow).
+//  - SD access holds an SdBus (sdcard.h): the TFT stays off the shared bus.
 //
 //  DEBUGGING
 //  ----------
@@ -56,6 +60,22 @@
 #include "controls.h"
 #include "gamepad.h"
 #include "sdcard.h"
+#include "library.h"
+#include "gallery.h"
+#include "video.h"
+#include "gif.h"
+#include "emulator.h"
+#include "homebrew.h"
+#include "fcon.h"
+#include "audio.h"
+#include "romstore.h"
+#include "resume.h"
+#include "display.h"
+#include "icons.h"
+#include "wallpaper.h"
+#include "timerwheel.h"
+#include "coro.h"
+#include "sysmon.h"
 #include "esp_wifi.h"
 
 // =========================================================
@@ -66,15 +86,20 @@
 TFT_eSPI tft;
 
 // --- Menus ---
-static EditMenu rootMenu(tft, 480, 320);     // Root “Home” menu
-static EditMenu settingsMenu(tft, 480, 320); // Settings submenu
-static EditMenu powerMenu(tft, 480, 320);    // Power submenu
+// Sized from the display at draw time (follows Settings → Rotation)
+static EditMenu rootMenu(tft);     // Root “Home” menu
+static EditMenu settingsMenu(tft); // Settings submenu
+static EditMenu powerMenu(tft);    // Power submenu
 
 // --- Forward declarations ---
 static void buildThemes();
 static void buildRootHorizontal();
 static void buildSettingsMenu();
 static void buildPowerMenu();
+static CoTask bootFlow();
+CoTask enterLightSleep();
+CoTask exitLightSleep();
+void enterDeepSleep();
 
 int brightnessValue = 200;  // Default brightness (0–255)
 
@@ -90,19 +115,13 @@ void setBrightness(int val) {
 // =========================================================
 //  DEBUG OVERLAY
 // =========================================================
-//  Tiny corner overlay for live debug messages or FPS counters.
+//  Tiny corner overlay for live debug messages or FPS counters,
+//  drawn by MenuUI into the next page it presents.
 //  Enabled via Debug::ONSCREEN.
 
 static void drawOverlay(const char* msg) {
   if (!Debug::ONSCREEN) return;
-
-  tft.startWrite();
-  tft.fillRect(0, 0, 200, 18, rgb(0, 0, 0));
-  tft.setTextFont(1);
-  tft.setTextColor(rgb(255, 255, 255), rgb(0, 0, 0));
-  tft.setTextDatum(TL_DATUM);
-  tft.drawString(msg, 2, 4);
-  tft.endWrite();
+  setMenuOverlay(msg);
 }
 
 // =========================================================
@@ -122,7 +141,7 @@ void setup() {
 
   // --- Display Init ---
   tft.init();
-  tft.setRotation(SCREEN_ROTATION);
+  displayBegin(tft);  // SCREEN_ROTATION; Settings may change it later
   tft.fillScreen(COL_BG);
 
   // --- Backlight PWM ---
@@ -132,7 +151,11 @@ void setup() {
 
   // --- Storage & Peripherals ---
   setupSD();        // Mount SD card
+  romstoreBegin();  // Flash ROM store index (if partitioned)
+  resumeBegin();    // Splash + last game restoring on core 0
   setupGamepad();   // Init Bluepad32 or local controls
+  audioBegin(AUDIO_SAMPLE_RATE);  // I2S DAC + feeder task
+  sysmonBegin();    // Task CPU% + stack watch (low priority)
 
   // --- Menu System ---
   buildThemes();
@@ -149,44 +172,12 @@ void setup() {
   // Register root menu
   setRootMenu(&rootMenu);
 
-  // --- Load persisted settings (if any) ---
-  if (loadMenuSettings(settingsMenu, "/settings.json")) {
-    int bright = settingsMenu.getItemValue(0);
-    setBrightness(map(bright, 0, 100, 5, 255));
-
-    int volume = settingsMenu.getItemValue(1);
-    (void)volume; // Placeholder – TODO: route to audio system
-
-    int ori = settingsMenu.getItemValue(2);
-    rootMenu.setOrientation(ori == 0
-      ? MenuOrientation::HORIZONTAL
-      : MenuOrientation::VERTICAL);
-    settingsMenu.setOrientation(rootMenu.orientation());
-    powerMenu.setOrientation(rootMenu.orientation());
-
-    int tr = settingsMenu.getItemValue(3);
-    rootMenu.setPageTransition((TransitionStyle)tr);
-    settingsMenu.setPageTransition((TransitionStyle)tr);
+  // SD + panel are ours again once the restore is done
+  resumeWait();
 
-    bool icons = (settingsMenu.getItemValue(4) == 1);
-    for (int i = 0; i < rootMenu.size(); i++)
-      rootMenu.getItemRef(i).iconType = icons
-        ? IconType::COLOR
-        : IconType::NONE;
-
-    DBG_IF(MENU, "[Menu] Settings applied at boot.\n");
-  } else {
-    DBG_IF(MENU, "[Menu] No settings file found; using defaults.\n");
-  }
-
-  // Overlay “Ready” indicator
-  drawOverlay("Ready");
-
-  DBG_IF(
-    MENU,
-    "[Menu] UI ready (orientation=%s)\n",
-    (int)MENU_ORIENTATION_DEFAULT == (int)MenuOrientation::HORIZONTAL ? "H" : "V"
-  );
+  // Settings load, "Ready" and quick-resume continue as a
+  // flow driven from loop() (see FLOWS)
+  coSpawn(bootFlow());
 }
 
 // =========================================================
@@ -195,12 +186,12 @@ void setup() {
 
 static void handleRootActivation(EditMenu& menu, int idx) {
   switch (idx) {
-    case 0: DBG_IF(MENU, "[Action] Game Library\n"); break;
-    case 1: DBG_IF(MENU, "[Action] Gallery\n"); break;
+    case 0: DBG_IF(MENU, "[Action] Game Library\n"); openGameLibrary(); break;
+    case 1: DBG_IF(MENU, "[Action] Gallery\n"); openGallery(); break;
     case 2: DBG_IF(MENU, "[Action] Music Player\n"); break;
     case 3: /* Settings submenu */ break;
     case 4: DBG_IF(MENU, "[Action] File Manager\n"); break;
-    case 5: DBG_IF(MENU, "[Action] Homebrew\n"); break;
+    case 5: DBG_IF(MENU, "[Action] Homebrew\n"); openHomebrew(); break;
     case 6: /* Power submenu */ break;
   }
 }
@@ -210,13 +201,106 @@ static void handleSettingsActivation(EditMenu& menu, int idx) {
   DBG_IF(MENU, "[Settings] Activated index=%d\n", idx);
 }
 
-static bool sleeping = false;
+static CoTask powerFlow(int idx);
 
 static void handlePowerActivation(EditMenu& menu, int idx) {
+  coSpawn(powerFlow(idx));
+}
+
+// =========================================================
+//  FLOWS (coro.h)
+// =========================================================
+// While a flow owns the panel (boot, sleep) loop() doesn't
+// drive the menus: its SD jobs share their SPI bus.
+static bool uiPaused = false;
+
+static bool loadSettingsJob(void*) { return loadMenuSettings(settingsMenu, "/settings.json"); }
+static bool saveResumeJob(void*)   { resumeSave(); return true; }
+static bool wakePressed()          { return gpA() || gpStart(); }
+
+// A flow's SD jobs go through here. A trailing autosave is a
+// timer, and timers still fire while the UI is paused: written
+// now, it can't overlap the I/O task's turn on the SPI bus.
+static CoIo sdJob(bool (*fn)(void*)) {
+  settingsMenu.flushAutoSave();
+  return coIo(fn);
+}
+
+static void applySettings() {
+  int bright = settingsMenu.getItemValue(0);
+  setBrightness(map(bright, 0, 100, 5, 255));
+
+  audioSetVolume(settingsMenu.getItemValue(1));
+
+  int ori = settingsMenu.getItemValue(2);
+  rootMenu.setOrientation(ori == 0
+    ? MenuOrientation::HORIZONTAL
+    : MenuOrientation::VERTICAL);
+  settingsMenu.setOrientation(rootMenu.orientation());
+  powerMenu.setOrientation(rootMenu.orientation());
+
+  int tr = settingsMenu.getItemValue(3);
+  rootMenu.setPageTransition((TransitionStyle)tr);
+  settingsMenu.setPageTransition((TransitionStyle)tr);
+
+  bool icons = (settingsMenu.getItemValue(4) == 1);
+  for (int i = 0; i < rootMenu.size(); i++)
+    rootMenu.getItemRef(i).iconType = icons
+      ? IconType::COLOR
+      : IconType::NONE;
+
+  displaySetRotation((SCREEN_ROTATION + settingsMenu.getItemValue(5)) & 3);
+
+  if (settingsMenu.getItemValue(6) && !wallpaperSet(WALLPAPER_PATH))
+    settingsMenu.setItemValue(6, 0);
+}
+
+// Boot, once setup() returns: settings are read on the I/O
+// task while loop() keeps Bluetooth and the timers running
+static CoTask bootFlow() {
+  uiPaused = true;
+
+  // --- Load persisted settings (if any) ---
+  if (co_await sdJob(loadSettingsJob)) {
+    applySettings();
+    DBG_IF(MENU, "[Menu] Settings applied at boot.\n");
+  } else {
+    DBG_IF(MENU, "[Menu] No settings file found; using defaults.\n");
+  }
+
+  // Overlay “Ready” indicator
+  drawOverlay("Ready");
+
+  DBG_IF(
+    MENU,
+    "[Menu] UI ready (orientation=%s)\n",
+    (int)MENU_ORIENTATION_DEFAULT == (int)MenuOrientation::HORIZONTAL ? "H" : "V"
+  );
+
+  // Jump back into the last app, or fall through to the menus.
+  // What's left of the splash: B goes home, A plays now
+  if (resumeReady()) {
+    int8_t choice = -1;
+    while (choice < 0 && resumeSplashLeft()) {
+      co_await coSleep(min<uint32_t>(MENU_IDLE_POLL_MS, resumeSplashLeft()));
+      choice = resumeChoice();
+    }
+    resumeFinish(choice != 0);
+  }
+  uiPaused = false;
+}
+
+// Sleep is fade out, wait for A / START, fade back in
+static CoTask powerFlow(int idx) {
+  uiPaused = true;
+  co_await sdJob(saveResumeJob);  // last app, for quick-resume at next boot
+
   if (idx == 0) {
     DBG_IF(MENU, "[Power] Sleep\n");
-    sleeping = true;
-    enterLightSleep();
+    co_await enterLightSleep();
+    co_await coInput(wakePressed);
+    co_await exitLightSleep();
+    if (EditMenu* m = currentMenu()) m->update();  // swallows the wake press
   } else if (idx == 1) {
     DBG_IF(MENU, "[Power] Reboot\n");
     ESP.restart();
@@ -224,36 +308,78 @@ static void handlePowerActivation(EditMenu& menu, int idx) {
     DBG_IF(MENU, "[Power] Shutdown\n");
     enterDeepSleep();
   }
+  uiPaused = false;
 }
 
 // =========================================================
 //  MAIN LOOP
 // =========================================================
 
+// Frame governor: sleep until the next timer is due, but no
+// longer than maxMs (buttons and the pad are polled)
+static void idleUntilNextTimer(uint32_t maxMs) {
+  uint32_t ms = timerNextDue();
+  delay(ms < maxMs ? ms : maxMs);
+}
+
 void loop() {
+  timerPoll();
   updateGamepad();
+  coRun();
+
+  // A running game owns the screen + input until it exits
+  // Record the app for quick-resume once its session ends
+  if (emuRunning()) {
+    emuUpdate();
+    if (!emuRunning()) resumeSave();
+    return;
+  }
+  if (fconRunning()) {
+    fconUpdate();
+    if (!fconRunning()) resumeSave();
+    return;
+  }
+  if (videoRunning()) {
+    videoUpdate();
+    return;
+  }
+  if (gifRunning()) {
+    gifUpdate();
+    return;
+  }
 
   EditMenu* m = currentMenu();
   if (!m) return;
 
-  // Handle wake from light sleep
-  if (sleeping) {
-    if (gpA() || gpStart()) {
-      sleeping = false;
-      exitLightSleep();
-      m->update();
-    }
-    delay(100);
+  // A flow has the panel (booting, asleep)
+  if (uiPaused) {
+    idleUntilNextTimer(MENU_IDLE_POLL_MS);
     return;
   }
 
   // Drive the active menu
   int activated = m->update();
   if (activated >= 0) {
-    if      (m == &rootMenu)      handleRootActivation(*m, activated);
-    else if (m == &settingsMenu)  handleSettingsActivation(*m, activated);
-    else if (m == &powerMenu)     handlePowerActivation(*m, activated);
+    if      (m == &rootMenu)         handleRootActivation(*m, activated);
+    else if (m == &settingsMenu)     handleSettingsActivation(*m, activated);
+    else if (m == &powerMenu)        handlePowerActivation(*m, activated);
+    else if (m == gameLibraryMenu()) handleLibraryActivation(*m, activated);
+    else if (m == homebrewMenu())    handleHomebrewActivation(*m, activated);
+    else if (m == galleryMenu())     handleGalleryActivation(*m, activated);
   }
+
+  // Task monitor in the corner overlay: a fresh sample redraws
+  // the page (once per SYSMON_PERIOD_MS at most); the page
+  // draws the line itself otherwise
+  const SysmonSnapshot* mon;
+  if (Debug::ONSCREEN && sysmonLatest(mon)) {
+    char line[40];
+    sysmonLine(*mon, line, sizeof(line));
+    drawOverlay(line);
+  }
+
+  // Nothing animates between inputs: sleep, don't spin
+  idleUntilNextTimer(MENU_IDLE_POLL_MS);
 }
 
 // =========================================================
@@ -269,6 +395,7 @@ static void buildThemes() {
   th.marginB        = MENU_MARGIN_B;
   th.rowH           = MENU_ROW_H;
   th.iconPad        = MENU_ICON_PAD;
+  th.iconSize       = MENU_ICON_SIZE;
   th.textPad        = MENU_TEXT_PAD;
   th.selectorRadius = MENU_SELECTOR_RADIUS;
   th.selectorBorder = MENU_SELECTOR_BORDER;
@@ -327,6 +454,13 @@ static void buildRootHorizontal() {
   rootMenu.addItem(makeLabel("File Manager", MENU_SHOW_ICONS_DEFAULT ? IconType::COLOR : IconType::NONE));
   rootMenu.addItem(makeLabel("Homebrew",     MENU_SHOW_ICONS_DEFAULT ? IconType::COLOR : IconType::NONE));
   rootMenu.addItem(makeLabel("Power",        MENU_SHOW_ICONS_DEFAULT ? IconType::COLOR : IconType::NONE));
+
+  static const uint8_t* const ICONS[] = {
+    ICON_GAMEPAD, ICON_GALLERY, ICON_MUSIC, ICON_SETTINGS,
+    ICON_FOLDER, ICON_HOMEBREW, ICON_POWER,
+  };
+  for (int i = 0; i < rootMenu.size(); i++)
+    rootMenu.getItemRef(i).iconVec = ICONS[i];
 }
 
 // ---------------------------------------------------------
@@ -336,6 +470,8 @@ static void buildSettingsMenu() {
   static const char* orientations[] = { "Horizontal", "Vertical" };
   static const char* anims[]        = { "None", "Slide", "Fade", "Slide+Fade" };
   static const char* iconChoices[]  = { "Off", "On" };
+  // Quarter turns from SCREEN_ROTATION (a landscape one)
+  static const char* rotations[]    = { "Landscape", "Portrait", "Landscape 180", "Portrait 180" };
 
   auto& m = settingsMenu;
 
@@ -350,12 +486,19 @@ static void buildSettingsMenu() {
          PAGE_TRANSITION == TransitionStyle::SLIDE_FADE ? 3 : 0)
       : 0)));
   m.addItem(makeArray("Icons", iconChoices, 2, MENU_SHOW_ICONS_DEFAULT ? 1 : 0));
+  m.addItem(makeArray("Rotation", rotations, 4, 0));
+  m.addItem(makeArray("Wallpaper", iconChoices, 2, 0));
 
   // --- Brightness live update ---
   m.getItemRef(0).onChange = [](long v) {
     setBrightness(map(v, 0, 100, 5, 255));
   };
 
+  // --- Volume live update ---
+  m.getItemRef(1).onChange = [](long v) {
+    audioSetVolume((uint8_t)v);
+  };
+
   // --- Orientation live update ---
   m.getItemRef(2).onChange = [](long v) {
     MenuOrientation o = (v == 0)
@@ -388,7 +531,23 @@ static void buildSettingsMenu() {
     settingsMenu.forceRedraw();
   };
 
-  // Auto-save to SD
+  // --- Rotation live update ---
+  // Menus re-derive their layout on the next draw; the page
+  // covers the whole panel, so nothing else needs clearing.
+  m.getItemRef(5).onChange = [](long v) {
+    displaySetRotation((SCREEN_ROTATION + v) & 3);
+    DBG_IF(MENU, "[Settings] Rotation -> %s\n", rotations[v & 3]);
+    settingsMenu.forceRedraw();
+  };
+
+  // --- Wallpaper (WALLPAPER_PATH) ---
+  // Falls back to Off if the file can't be used
+  m.getItemRef(6).onChange = [](long v) {
+    if (!wallpaperSet(v ? WALLPAPER_PATH : nullptr)) settingsMenu.setItemValue(6, 0);
+    settingsMenu.forceRedraw();
+  };
+
+  // Auto-save to SD (bootFlow reads it back)
   m.enableAutoSave("/settings.json");
 }
 
@@ -405,11 +564,11 @@ static void buildPowerMenu() {
 //  POWER MANAGEMENT
 // =========================================================
 
-void enterLightSleep() {
+CoTask enterLightSleep() {
   // Smooth fade-out to avoid flicker
   for (int b = brightnessValue; b > 0; b -= 10) {
     ledcWrite(BL_CHANNEL, b);
-    delay(5);
+    co_await coSleep(5);
   }
 
   // Enter low-power display sleep
@@ -420,9 +579,9 @@ void enterLightSleep() {
   DBG_IF(MENU, "[Power] Entering light sleep mode...\n");
 }
 
-void exitLightSleep() {
+CoTask exitLightSleep() {
   tft.writecommand(0x11); // Wake display
-  delay(150);
+  co_await coSleep(150);
   setBrightness(brightnessValue);
   DBG_IF(MENU, "[Power] Woke from light sleep.\n");
 }
@@ -0,0 +1,136 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  arena.cpp — Frame Arena + Host Allocation Tracker
+//
+//  frameArena lives in internal SRAM (MENU_FRAME_ARENA bytes)
+//  and is reset by MenuUI after each present, so a frame's
+//  value text and scratch cost a pointer bump each.
+//
+//  Host allocation tracker:
+//    g++ -O2 -DARENA_BENCH_MAIN -x c++ arena.cpp -o arena_bench
+//  replaces malloc / free with counting wrappers and runs a
+//  model of a settings-page frame (value text, settings keys,
+//  an input event) through the arena and a Pool. It must report
+//  zero heap allocations; the same frames with a heap string
+//  per value (what String did) are counted alongside.
+//  It checks the arena and pools, not MenuUI. Not verified by
+//  anything here:
+//   - EditMenu::update() / draw() themselves (they need
+//     TFT_eSPI and aren't built on a PC);
+//   - MenuItem text and icon paths, which are Arduino Strings
+//     built by the make* helpers and setItemText() — meant to
+//     happen when a page is built, not per frame;
+//   - the glyph and icon caches: their nodes are Pools and
+//     their bitmaps preallocated, so a miss doesn't allocate,
+//     but only by construction, not by measurement.
+// =========================================================
+
+#include "arena.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+  #include "config.h"
+#else
+  static constexpr size_t MENU_FRAME_ARENA = 1024;
+#endif
+
+// =========================================================
+//  FRAME ARENA
+// =========================================================
+static uint8_t frameMem[MENU_FRAME_ARENA] __attribute__((aligned(8)));
+FrameArena frameArena(frameMem, sizeof(frameMem));
+
+const char* FrameArena::format(const char* fmt, ...) {
+  size_t at = _top;
+  if (at >= _cap) { _overflows++; return ""; }
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf((char*)_base + at, _cap - at, fmt, ap);
+  va_end(ap);
+  if (n < 0 || (size_t)n >= _cap - at) { _overflows++; return ""; }
+  _top = at + n + 1;
+  if (_top > _peak) _peak = _top;
+  return (const char*)_base + at;
+}
+
+
+// =========================================================
+//  HOST ALLOCATION TRACKER
+// =========================================================
+#ifdef ARENA_BENCH_MAIN
+#include <stdlib.h>
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void  __libc_free(void*);
+
+static size_t heapCalls = 0;   // malloc / calloc / realloc
+
+extern "C" void* malloc(size_t n)            { heapCalls++; return __libc_malloc(n); }
+extern "C" void* calloc(size_t n, size_t s)  { heapCalls++; return __libc_calloc(n, s); }
+extern "C" void* realloc(void* p, size_t n)  { heapCalls++; return __libc_realloc(p, n); }
+extern "C" void  free(void* p)               { __libc_free(p); }
+
+// A model settings page: the kinds of item MenuUI draws values
+// for (not MenuUI's own code)
+struct BenchItem { bool range; long value; const char* const* choices; uint16_t index; };
+struct BenchEvent { uint8_t button; uint32_t at; };
+
+static const char* const THEMES[] = { "Dark", "Light", "Ocean" };
+static BenchItem items[15];
+static Pool<BenchEvent, 8> events;
+static volatile size_t benchSink;  // keeps the output live
+
+// One model frame: an event in, value text for every row,
+// settings keys for an autosave, then the present's reset
+static size_t frame(uint32_t n, bool heapStrings) {
+  size_t sink = 0;
+  BenchEvent* e = events.make(BenchEvent{ (uint8_t)(n & 3), n });
+  for (auto& it : items) {
+    if (it.range) it.value = (it.value + 5) % 105;
+    const char* text = it.range ? frameArena.format("%ld", it.value) : it.choices[it.index];
+    if (heapStrings) {
+      char* s = strdup(text);
+      sink += strlen(s);
+      free(s);
+    } else {
+      sink += strlen(text);
+    }
+  }
+  char keys[15][4];
+  for (int i = 0; i < 15; ++i) snprintf(keys[i], sizeof(keys[i]), "%d", i);
+  sink += keys[n % 15][0];
+  events.destroy(e);
+  frameArena.reset();
+  return sink;
+}
+
+int main() {
+  static constexpr uint32_t FRAMES = 100000;
+  for (int i = 0; i < 15; ++i)
+    items[i] = { (i % 3) != 2, i * 7L, THEMES, (uint16_t)(i % 3) };
+
+  size_t sink = frame(0, false);   // warm-up
+  size_t before = heapCalls;
+  for (uint32_t n = 1; n <= FRAMES; ++n) sink += frame(n, false);
+  size_t arenaCalls = heapCalls - before;
+
+  before = heapCalls;
+  for (uint32_t n = 1; n <= FRAMES; ++n) sink += frame(n, true);
+  size_t stringCalls = heapCalls - before;
+
+  printf("[Arena] %s: %zu heap allocations in %u model frames (heap strings: %.1f per frame); "
+         "arena peak %zu of %zu B, %u overflows; event pool peak %u, %u misses\n",
+         arenaCalls ? "FAIL" : "ok", arenaCalls, (unsigned)FRAMES, (double)stringCalls / FRAMES,
+         frameArena.peak(), frameArena.capacity(), (unsigned)frameArena.overflows(),
+         (unsigned)events.peak(), (unsigned)events.misses());
+  benchSink = sink;
+  return arenaCalls ? 1 : 0;
+}
+#endif
+
+// ======================= End of File =======================
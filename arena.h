@@ -0,0 +1,111 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  arena.h — Frame Arena + Fixed-Size Pools
+//
+//  Provides:
+//   • FrameArena   — Bump allocator for one frame's temporaries
+//                    (value text, scratch); reset() frees it all
+//   • frameArena   — The UI's, reset after every page present
+//   • Pool<T, N>   — Typed fixed-size pool: make() / destroy()
+//                    from a free list, never the heap; used for
+//                    coroutine frames and the glyph / icon caches
+//
+//  Notes:
+//   - Neither is thread-safe: one owner task each. Hand data
+//     to another task through channel.h instead.
+//   - A full arena or pool returns nullptr (format(): "") and
+//     counts it; nothing falls back to malloc.
+//   - Host allocation tracker + bench: arena.cpp.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include <utility>
+
+// =========================================================
+//  FRAME ARENA
+// =========================================================
+class FrameArena {
+public:
+  FrameArena(void* mem, size_t bytes) : _base((uint8_t*)mem), _cap(bytes) {}
+
+  void* alloc(size_t n, size_t align = 4) {
+    size_t at = (_top + align - 1) & ~(align - 1);
+    if (at + n > _cap) { _overflows++; return nullptr; }
+    _top = at + n;
+    if (_top > _peak) _peak = _top;
+    return _base + at;
+  }
+
+  // snprintf into the arena; "" if it doesn't fit
+  const char* format(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+  void reset() { _top = 0; }
+
+  size_t   used() const      { return _top; }
+  size_t   peak() const      { return _peak; }
+  size_t   capacity() const  { return _cap; }
+  uint32_t overflows() const { return _overflows; }
+
+private:
+  uint8_t* _base;
+  size_t   _cap;
+  size_t   _top = 0;
+  size_t   _peak = 0;
+  uint32_t _overflows = 0;
+};
+
+extern FrameArena frameArena;
+
+
+// =========================================================
+//  POOL
+// =========================================================
+template <typename T, uint16_t N>
+class Pool {
+  static constexpr uint16_t NIL = 0xFFFF;
+  static_assert(N > 0 && N < NIL, "Pool size out of range");
+
+public:
+  Pool() {
+    for (uint16_t i = 0; i < N; ++i) _next[i] = (uint16_t)(i + 1 < N ? i + 1 : NIL);
+  }
+
+  template <typename... Args>
+  T* make(Args&&... args) {
+    if (_free == NIL) { _misses++; return nullptr; }
+    uint16_t i = _free;
+    _free = _next[i];
+    if (++_live > _peak) _peak = _live;
+    return new (_mem[i]) T(std::forward<Args>(args)...);
+  }
+
+  void destroy(T* p) {
+    if (!p) return;
+    p->~T();
+    uint16_t i = indexOf(p);
+    _next[i] = _free;
+    _free = i;
+    _live--;
+  }
+
+  // 0..N-1, for side tables kept elsewhere (e.g. in PSRAM)
+  uint16_t indexOf(const T* p) const { return (uint16_t)(((const uint8_t*)p - _mem[0]) / sizeof(T)); }
+
+  uint16_t inUse() const  { return _live; }
+  uint16_t peak() const   { return _peak; }
+  uint32_t misses() const { return _misses; }
+
+private:
+  alignas(T) uint8_t _mem[N][sizeof(T)];
+  uint16_t _next[N];
+  uint16_t _free = 0;
+  uint16_t _live = 0;
+  uint16_t _peak = 0;
+  uint32_t _misses = 0;
+};
+
+// ======================= End of File =======================
@@ -0,0 +1,172 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  audio.cpp — Audio Output (I2S → PCM5102)
+//
+//  Provides:
+//   • Mono sample queue (SpscRing: app loop → feeder task)
+//   • Feeder task: queue → volume → stereo → i2s_write()
+//   • Linear resampler used by the emulator's rate control
+//
+//  Notes:
+//   - The feeder blocks inside i2s_write(), so the DAC clock
+//     paces it; the queue level is therefore the true measure
+//     of whether the producer is running fast or slow.
+//   - The queue is a channel.h SpscRing: the resampler writes
+//     straight into its slots and commits once per block.
+// =========================================================
+
+#include "audio.h"
+#include "config.h"
+#include "channel.h"
+#include "driver/i2s.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// =========================================================
+//  STATE
+// =========================================================
+static SpscRing<int16_t, AUDIO_RING_SAMPLES> ring;
+static volatile uint16_t volume = 154;    // 0–256 (60%)
+static volatile bool     producing = false;
+static volatile uint32_t underruns = 0;
+
+static uint32_t rate = 0;
+static bool     started = false;
+
+// Resampler carry-over
+static uint32_t rsPos = 0;                // 16.16, relative to rsPrev
+static int16_t  rsPrev = 0;
+
+
+// =========================================================
+//  FEEDER TASK
+// =========================================================
+static void feederTask(void*) {
+  static int16_t out[AUDIO_CHUNK * 2];
+
+  for (;;) {
+    uint32_t avail = ring.available();
+    uint32_t n = avail < AUDIO_CHUNK ? avail : AUDIO_CHUNK;
+    int32_t  vol = volume;
+
+    for (uint32_t i = 0; i < n; ++i) {
+      int16_t s = (int16_t)((ring.peek(i) * vol) >> 8);
+      out[2 * i] = out[2 * i + 1] = s;
+    }
+    ring.consume(n);
+
+    if (n < AUDIO_CHUNK) {
+      memset(out + 2 * n, 0, (AUDIO_CHUNK - n) * 2 * sizeof(int16_t));
+      if (producing) underruns = underruns + 1;
+    }
+
+    size_t written = 0;
+    i2s_write(I2S_NUM_0, out, sizeof(out), &written, portMAX_DELAY);
+  }
+}
+
+
+// =========================================================
+//  SETUP
+// =========================================================
+bool audioBegin(uint32_t sampleRate) {
+  if (started) return true;
+  rate = sampleRate;
+
+  i2s_config_t cfg = {};
+  cfg.mode                 = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX);
+  cfg.sample_rate          = sampleRate;
+  cfg.bits_per_sample      = I2S_BITS_PER_SAMPLE_16BIT;
+  cfg.channel_format       = I2S_CHANNEL_FMT_RIGHT_LEFT;
+  cfg.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+  cfg.intr_alloc_flags     = ESP_INTR_FLAG_LEVEL1;
+  cfg.dma_buf_count        = 4;
+  cfg.dma_buf_len          = AUDIO_CHUNK;
+  cfg.use_apll             = true;
+  cfg.tx_desc_auto_clear   = true;
+
+  i2s_pin_config_t pins = {};
+  pins.mck_io_num   = AUDIO_MCK_PIN;
+  pins.bck_io_num   = AUDIO_BCK_PIN;
+  pins.ws_io_num    = AUDIO_WS_PIN;
+  pins.data_out_num = AUDIO_DOUT_PIN;
+  pins.data_in_num  = I2S_PIN_NO_CHANGE;
+
+  if (i2s_driver_install(I2S_NUM_0, &cfg, 0, nullptr) != ESP_OK ||
+      i2s_set_pin(I2S_NUM_0, &pins) != ESP_OK) {
+    DBG_IF(AUDIO, "[Audio] I2S init failed\n");
+    return false;
+  }
+  i2s_zero_dma_buffer(I2S_NUM_0);
+
+  xTaskCreatePinnedToCore(feederTask, "audio", 3072, nullptr, 5, nullptr, 0);
+  started = true;
+  DBG_IF(AUDIO, "[Audio] I2S up at %lu Hz\n", (unsigned long)sampleRate);
+  return true;
+}
+
+uint32_t audioSampleRate() { return rate; }
+
+void audioSetVolume(uint8_t pct) {
+  if (pct > 100) pct = 100;
+  volume = (uint16_t)(pct * 256 / 100);
+}
+
+
+// =========================================================
+//  PRODUCER SIDE
+// =========================================================
+size_t audioWrite(const int16_t* pcm, size_t n) {
+  if (!started) return 0;
+  producing = true;
+  return ring.write(pcm, n);
+}
+
+size_t audioWriteResampled(const int16_t* pcm, size_t n, float ratio) {
+  if (!started || n == 0) return 0;
+  producing = true;
+
+  // Virtual input: v[0] = rsPrev, v[k] = pcm[k - 1]
+  uint32_t step = (uint32_t)(65536.0f / ratio);
+  uint32_t room = ring.space();
+  size_t   out = 0;
+
+  while ((rsPos >> 16) < n) {
+    uint32_t i = rsPos >> 16;
+    int32_t  a = i ? pcm[i - 1] : rsPrev;
+    int32_t  b = pcm[i];
+    int32_t  f = rsPos & 0xFFFF;
+    if (out < room)
+      ring.slot(out++) = (int16_t)(a + (((b - a) * f) >> 16));
+    rsPos += step;
+  }
+  rsPos -= (uint32_t)n << 16;
+  rsPrev = pcm[n - 1];
+
+  ring.commit(out);
+  return out;
+}
+
+void audioPrime(float fill) {
+  if (!started) return;
+  uint32_t want = (uint32_t)(fill * AUDIO_RING_SAMPLES);
+  uint32_t have = ring.size();
+  uint32_t n = want > have ? min(want - have, ring.space()) : 0;
+  for (uint32_t i = 0; i < n; ++i) ring.slot(i) = 0;
+  ring.commit(n);
+  rsPos = 0;
+  rsPrev = 0;
+  underruns = 0;
+  producing = true;
+}
+
+void audioIdle() { producing = false; }
+
+float audioFill() {
+  return (float)ring.size() / AUDIO_RING_SAMPLES;
+}
+
+uint32_t audioUnderruns() { return underruns; }
+
+// ======================= End of File =======================
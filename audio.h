@@ -0,0 +1,45 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  audio.h — Audio Output (Header)
+//
+//  Provides:
+//   • audioBegin()    — I2S (PCM5102) + feeder task on core 0
+//   • audioWrite()    — Queue mono PCM as-is
+//   • audioWriteResampled() — Queue with a small rate nudge
+//   • audioFill()     — Queue level (0–1) for rate control
+//   • audioSetVolume() — 0–100, applied in the feeder
+//
+//  Notes:
+//   - One producer (the app loop), one consumer (the feeder).
+//   - The feeder plays silence when the queue runs dry and
+//     counts it as an underrun while a producer is active.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool     audioBegin(uint32_t sampleRate);
+uint32_t audioSampleRate();
+void     audioSetVolume(uint8_t pct);
+
+// Returns the number of samples accepted (the rest is dropped).
+size_t audioWrite(const int16_t* pcm, size_t n);
+
+// Linear resampler: emits ~n * ratio samples. Phase carries
+// over between calls, so blocks join without clicks.
+size_t audioWriteResampled(const int16_t* pcm, size_t n, float ratio);
+
+// Stream start: tops the queue up with silence to `fill` (0–1)
+// so rate control begins at its set point.
+void audioPrime(float fill);
+// Stream end: the queue drains and dry-outs stop counting.
+void audioIdle();
+
+float    audioFill();
+uint32_t audioUnderruns();
+
+// ======================= End of File =======================
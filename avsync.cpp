@@ -0,0 +1,73 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  avsync.cpp — Audio-Driven Rate Control + Frameskip
+//
+//  Provides:
+//   • Proportional ratio control around SYNC_FILL_TARGET
+//   • Hysteresis frameskip (SYNC_SKIP_BELOW → SYNC_SKIP_RESUME)
+//   • 60-frame skip history for the overlay / logs
+//
+//  Notes:
+//   - The raw queue level jitters by one I2S chunk per read,
+//     so it is smoothed before the controller sees it.
+// =========================================================
+
+#include "avsync.h"
+#include "config.h"
+
+// =========================================================
+//  CONTROL
+// =========================================================
+void AvSync::reset() {
+  _ratio = 1.0f;
+  _fill = SYNC_FILL_TARGET;
+  _skip = false;
+  _run = 0;
+  _mode = Mode::LOCKED;
+  _history = 0;
+}
+
+void AvSync::update(float fill) {
+  _history = (_history << 1) | (_skip ? 1 : 0);
+  _fill += (fill - _fill) * 0.125f;
+
+  // --- Rate: more samples when low, fewer when high ---
+  float err = (SYNC_FILL_TARGET - _fill) / SYNC_FILL_TARGET;
+  if (err > 1.0f)  err = 1.0f;
+  if (err < -1.0f) err = -1.0f;
+  _ratio = 1.0f + SYNC_RATE_MAX * err;
+
+  // --- Frameskip: only when the queue is really draining ---
+  // Uses the raw level so it reacts within a frame.
+  if (_skip) _skip = fill < SYNC_SKIP_RESUME;
+  else       _skip = fill < SYNC_SKIP_BELOW;
+
+  // Never starve the screen completely
+  if (_skip && _run >= SYNC_MAX_SKIP) _skip = false;
+  _run = _skip ? _run + 1 : 0;
+
+  if (_skip)                 _mode = Mode::SKIP;
+  else if (err >  0.2f)      _mode = Mode::STRETCH;
+  else if (err < -0.2f)      _mode = Mode::SQUEEZE;
+  else                       _mode = Mode::LOCKED;
+}
+
+
+// =========================================================
+//  REPORTING
+// =========================================================
+uint8_t AvSync::skipRate() const {
+  return (uint8_t)__builtin_popcountll(_history & ((1ULL << 60) - 1));
+}
+
+const char* AvSync::modeName() const {
+  switch (_mode) {
+    case Mode::STRETCH: return "stretch";
+    case Mode::SQUEEZE: return "squeeze";
+    case Mode::SKIP:    return "skip";
+    default:            return "locked";
+  }
+}
+
+// ======================= End of File =======================
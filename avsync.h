@@ -0,0 +1,49 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  avsync.h — Audio-Driven Rate Control + Frameskip (Header)
+//
+//  Provides:
+//   • AvSync — per-frame controller fed with the audio queue
+//     level; outputs a resample ratio and a skip decision
+//
+//  Notes:
+//   - Small drift (core clock vs DAC clock, 60.10 vs 60 Hz
+//     pacing) is absorbed by nudging the resample ratio by at
+//     most ±SYNC_RATE_MAX around 1.0: no pitch you can hear.
+//   - Real overload (queue draining fast) turns on frameskip:
+//     the core still runs CPU + APU, only video is dropped.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  AVSYNC CLASS
+// =========================================================
+class AvSync {
+public:
+  enum class Mode : uint8_t { LOCKED, STRETCH, SQUEEZE, SKIP };
+
+  void reset();
+
+  // Call once per frame, after that frame's audio was queued.
+  void update(float fill);
+
+  float   ratio() const     { return _ratio; }
+  bool    skipNext() const  { return _skip; }
+  Mode    mode() const      { return _mode; }
+  float   fill() const      { return _fill; }
+  uint8_t skipRate() const;                  // skipped frames in the last 60
+  const char* modeName() const;
+
+private:
+  float    _ratio = 1.0f;
+  float    _fill = 0.0f;                     // smoothed queue level
+  bool     _skip = false;
+  uint8_t  _run = 0;                         // consecutive skips
+  Mode     _mode = Mode::LOCKED;
+  uint64_t _history = 0;                     // 1 bit per frame, newest in bit 0
+};
+
+// ======================= End of File =======================
@@ -0,0 +1,571 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  blend.cpp — RGB565 Alpha Blending
+//
+//  Every kernel computes, per channel,
+//      (x * a + y * (32 - a) + 16) >> 5      a = 0..32
+//  which is exact at both ends and never overflows a field.
+//
+//  Two pixels per word (SWAR):
+//   - A 32-bit word holds two pixels; each channel of both is
+//     masked into its own 16-bit lane (0x001F001F, 0x003F003F),
+//     where 63 * 32 + 16 still fits. One multiply then scales
+//     both pixels, so a pair costs what one pixel did.
+//   - blendSolid() folds the colour's share into a constant,
+//     leaving three multiplies per pair.
+//   - blendMask4() varies alpha per pixel, so it spreads one
+//     pixel over a word instead (0x07E0F81F) and skips / fills
+//     whole bytes of mask that are fully clear / opaque.
+//   - Buffers are read in words when dst and the sources share
+//     alignment (sprites and heap buffers do); otherwise the
+//     same math runs a pixel at a time.
+//   - Byte-swapped buffers are swapped in-register, two pixels
+//     at a time, on the way in and out.
+//
+//  Pixel loops (BLEND_SWAR 0):
+//   - The same math one pixel at a time in 16-bit fields, plain
+//     loops with no alignment cases: slower scalar code than
+//     SWAR, but what a vectorizer (SSE, NEON) widens to 8+
+//     pixels per op. GCC has none for the S3's PIE unit, so
+//     SWAR stays the default there and this one elsewhere;
+//     blendBenchmark() times both on whatever runs it.
+//
+//  PIE (ESP32-S3, BLEND_PIE 1):
+//   - blendBuffers() / blendSolid() run eight pixels per op on
+//     the S3's 128-bit vector unit (hand-written ee.* asm; GCC
+//     never emits them). One channel at a time: shift + mask it
+//     into 16-bit lanes, ee.vmul.u16 by a and 32 - a, saturating
+//     add (nothing gets near 32767), round, then back in place.
+//   - ee.vld / ee.vst ignore the low four address bits, so this
+//     needs dst, a and b to share 16-byte alignment; up to seven
+//     pixels of head, the tail and any other case go to SWAR.
+//   - Byte-swapped buffers are swapped in 64-pixel chunks on the
+//     stack (ee.vmul by 256 shifts either way within a lane).
+//   - blendMask4() stays per pixel: its skip / fill of whole
+//     mask bytes is what makes it fast.
+//   - verify() checks it against blendPixel() like the others.
+//
+//  Host benchmark (-O3: GCC only vectorizes these at -O3):
+//    g++ -O3 -DBLEND_BENCH_MAIN -x c++ blend.cpp -o blend_bench
+// =========================================================
+
+#include "blend.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+  #include "config.h"
+  #include "sdkconfig.h"
+  #define BENCH_LOG(...) DBG_IF(MENU, __VA_ARGS__)
+  #define BENCH_UNIT "cycles"
+  static uint32_t benchTicks() { return ESP.getCycleCount(); }
+#else
+  #include <stdio.h>
+  #include <chrono>
+  #define BENCH_LOG(...) printf(__VA_ARGS__)
+  #define BENCH_UNIT "ns"
+  static uint32_t benchTicks() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+// SWAR where there's no vectorizer to beat it
+#ifndef BLEND_SWAR
+  #ifdef __XTENSA__
+    #define BLEND_SWAR 1
+  #else
+    #define BLEND_SWAR 0
+  #endif
+#endif
+
+// PIE where there is one (the S3, not the plain ESP32)
+#ifndef BLEND_PIE
+  #if defined(__XTENSA__) && defined(CONFIG_IDF_TARGET_ESP32S3)
+    #define BLEND_PIE 1
+  #else
+    #define BLEND_PIE 0
+  #endif
+#endif
+
+enum class BlendPath : uint8_t { LOOP, SWAR, PIE };
+static constexpr BlendPath BLEND_PATH = BLEND_PIE ? BlendPath::PIE : BLEND_SWAR ? BlendPath::SWAR : BlendPath::LOOP;
+
+// =========================================================
+//  HELPERS
+// =========================================================
+static constexpr uint32_t LANE5 = 0x001F001F;
+static constexpr uint32_t LANE6 = 0x003F003F;
+static constexpr uint32_t ROUND = 0x00100010;     // +16 in both lanes
+static constexpr uint32_t SPREAD = 0x07E0F81F;    // G:21-26 R:11-15 B:0-4
+static constexpr uint32_t SPREAD_ROUND = 0x02008010;
+
+static inline uint32_t alpha32(uint8_t alpha) { return (alpha + 4) >> 3; }
+
+static inline uint16_t swap16(uint16_t c) { return (uint16_t)((c >> 8) | (c << 8)); }
+static inline uint32_t swap2(uint32_t w) { return ((w >> 8) & 0x00FF00FF) | ((w & 0x00FF00FF) << 8); }
+
+// One pixel, spread so every field has five bits of headroom
+static inline uint16_t lerp1(uint16_t x, uint16_t y, uint32_t a) {
+  uint32_t sx = (x | ((uint32_t)x << 16)) & SPREAD;
+  uint32_t sy = (y | ((uint32_t)y << 16)) & SPREAD;
+  uint32_t r  = ((sx * a + sy * (32 - a) + SPREAD_ROUND) >> 5) & SPREAD;
+  return (uint16_t)(r | (r >> 16));
+}
+
+// Two pixels, one channel per lane
+static inline uint32_t lerp2(uint32_t x, uint32_t y, uint32_t a, uint32_t ia) {
+  uint32_t b = (((x & LANE5) * a + (y & LANE5) * ia + ROUND) >> 5) & LANE5;
+  uint32_t g = ((((x >> 5) & LANE6) * a + ((y >> 5) & LANE6) * ia + ROUND) >> 5) & LANE6;
+  uint32_t r = ((((x >> 11) & LANE5) * a + ((y >> 11) & LANE5) * ia + ROUND) >> 5) & LANE5;
+  return b | (g << 5) | (r << 11);
+}
+
+// One pixel, channel by channel in 16-bit math (63 * 32 + 16
+// fits): a loop of these is what a vectorizer widens
+static inline uint16_t lerp16(uint16_t x, uint16_t y, uint16_t a, uint16_t ia) {
+  uint16_t b = (uint16_t)((x & 31) * a + (y & 31) * ia + 16) >> 5;
+  uint16_t g = (uint16_t)(((x >> 5) & 63) * a + ((y >> 5) & 63) * ia + 16) >> 5;
+  uint16_t r = (uint16_t)((x >> 11) * a + (y >> 11) * ia + 16) >> 5;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static inline bool aligned4(const void* p) { return ((uintptr_t)p & 3) == 0; }
+static inline bool aligned16(const void* p) { return ((uintptr_t)p & 15) == 0; }
+
+
+// =========================================================
+//  PIE (ESP32-S3)
+// =========================================================
+#if BLEND_PIE
+static constexpr uint32_t PIE_CHUNK = 64;   // pixels per swap / colour buffer
+
+// Lane constants, loaded into q3..q7 (16-byte aligned for ee.vld)
+struct alignas(16) PieConsts { uint16_t v[5][8]; };
+
+// `vecs` x 8 pixels, all three pointers 16-byte aligned; dst may
+// be a or b (each group is read before it is stored)
+static void pieLerp(uint16_t* d, const uint16_t* a, const uint16_t* b, uint32_t vecs, uint32_t k) {
+  PieConsts c;
+  for (int i = 0; i < 8; ++i) {
+    c.v[0][i] = 31;                 // q3: 5-bit mask
+    c.v[1][i] = 63;                 // q4: 6-bit mask
+    c.v[2][i] = (uint16_t)k;        // q5: a
+    c.v[3][i] = (uint16_t)(32 - k); // q6: 32 - a
+    c.v[4][i] = 16;                 // q7: rounding
+  }
+  const PieConsts* kp = &c;
+  asm volatile(
+    "ee.vld.128.ip   q3, %[k], 16\n"
+    "ee.vld.128.ip   q4, %[k], 16\n"
+    "ee.vld.128.ip   q5, %[k], 16\n"
+    "ee.vld.128.ip   q6, %[k], 16\n"
+    "ee.vld.128.ip   q7, %[k], 16\n"
+    "1:\n"
+    // Blue, bits 0-4: t = x * a + y * (32 - a) + 16, out = t >> 5
+    "ee.vld.128.ip   q0, %[a], 0\n"
+    "ee.vld.128.ip   q1, %[b], 0\n"
+    "ee.andq         q0, q0, q3\n"
+    "ee.andq         q1, q1, q3\n"
+    "ssai            0\n"
+    "ee.vmul.u16     q0, q0, q5\n"
+    "ee.vmul.u16     q1, q1, q6\n"
+    "ee.vadds.s16    q0, q0, q1\n"
+    "ee.vadds.s16    q0, q0, q7\n"
+    "ssai            5\n"
+    "ee.vsr.32       q0, q0\n"
+    "ee.andq         q2, q0, q3\n"        // bits from the lane above masked off
+    // Green, bits 5-10: (t >> 5) << 5 is t minus its low 5 bits
+    "ee.vld.128.ip   q0, %[a], 0\n"
+    "ee.vld.128.ip   q1, %[b], 0\n"
+    "ee.vsr.32       q0, q0\n"
+    "ee.vsr.32       q1, q1\n"
+    "ee.andq         q0, q0, q4\n"
+    "ee.andq         q1, q1, q4\n"
+    "ssai            0\n"
+    "ee.vmul.u16     q0, q0, q5\n"
+    "ee.vmul.u16     q1, q1, q6\n"
+    "ee.vadds.s16    q0, q0, q1\n"
+    "ee.vadds.s16    q0, q0, q7\n"
+    "ee.andq         q1, q0, q3\n"
+    "ee.vsubs.s16    q0, q0, q1\n"
+    "ee.orq          q2, q2, q0\n"
+    // Red, bits 11-15: the same, then x 1024 >> 4 puts it in place
+    "ee.vld.128.ip   q0, %[a], 16\n"
+    "ee.vld.128.ip   q1, %[b], 16\n"
+    "ssai            11\n"
+    "ee.vsr.32       q0, q0\n"
+    "ee.vsr.32       q1, q1\n"
+    "ee.andq         q0, q0, q3\n"
+    "ee.andq         q1, q1, q3\n"
+    "ssai            0\n"
+    "ee.vmul.u16     q0, q0, q5\n"
+    "ee.vmul.u16     q1, q1, q6\n"
+    "ee.vadds.s16    q0, q0, q1\n"
+    "ee.vadds.s16    q0, q0, q7\n"
+    "ee.andq         q1, q0, q3\n"
+    "ee.vsubs.s16    q0, q0, q1\n"
+    "ee.vadds.s16    q1, q5, q6\n"        // 32
+    "ee.vmul.u16     q1, q1, q1\n"        // 1024
+    "ssai            4\n"
+    "ee.vmul.u16     q0, q0, q1\n"
+    "ee.orq          q2, q2, q0\n"
+    "ee.vst.128.ip   q2, %[d], 16\n"
+    "addi            %[n], %[n], -1\n"
+    "bnez            %[n], 1b\n"
+    : [d] "+r"(d), [a] "+r"(a), [b] "+r"(b), [n] "+r"(vecs), [k] "+r"(kp)
+    :
+    : "memory");
+}
+
+// Byte-swaps `vecs` x 8 pixels: x * 256 keeps x << 8 in the low
+// half of each product and x >> 8 in the high half (SAR 16)
+static void pieSwap(uint16_t* d, const uint16_t* s, uint32_t vecs) {
+  PieConsts c;
+  for (int i = 0; i < 8; ++i) c.v[0][i] = 256;
+  const PieConsts* kp = &c;
+  asm volatile(
+    "ee.vld.128.ip   q7, %[k], 16\n"
+    "1:\n"
+    "ee.vld.128.ip   q0, %[s], 16\n"
+    "ssai            16\n"
+    "ee.vmul.u16     q1, q0, q7\n"
+    "ssai            0\n"
+    "ee.vmul.u16     q0, q0, q7\n"
+    "ee.orq          q0, q0, q1\n"
+    "ee.vst.128.ip   q0, %[d], 16\n"
+    "addi            %[n], %[n], -1\n"
+    "bnez            %[n], 1b\n"
+    : [d] "+r"(d), [s] "+r"(s), [n] "+r"(vecs), [k] "+r"(kp)
+    :
+    : "memory");
+}
+
+// Pixels before dst reaches 16-byte alignment
+static inline uint32_t pieHead(const uint16_t* dst, uint32_t n) {
+  uint32_t head = ((16 - ((uintptr_t)dst & 15)) & 15) / 2;
+  return head < n ? head : n;
+}
+#endif
+
+
+// =========================================================
+//  KERNELS
+// =========================================================
+uint16_t blendPixel(uint16_t a, uint16_t b, uint8_t alpha) {
+  return lerp1(a, b, alpha32(alpha));
+}
+
+template <bool SWAP>
+static void buffersSwar(uint16_t* dst, const uint16_t* a, const uint16_t* b, uint32_t n, uint32_t k) {
+  if (n && !aligned4(dst)) {
+    *dst++ = SWAP ? swap16(lerp1(swap16(*a++), swap16(*b++), k)) : lerp1(*a++, *b++, k);
+    n--;
+  }
+  if (aligned4(a) && aligned4(b)) {
+    uint32_t* d = (uint32_t*)dst;
+    const uint32_t* pa = (const uint32_t*)a;
+    const uint32_t* pb = (const uint32_t*)b;
+    uint32_t ik = 32 - k;
+    for (uint32_t i = 0; i < n / 2; ++i) {
+      uint32_t x = pa[i], y = pb[i];
+      d[i] = SWAP ? swap2(lerp2(swap2(x), swap2(y), k, ik)) : lerp2(x, y, k, ik);
+    }
+    dst += n & ~1u;
+    a += n & ~1u;
+    b += n & ~1u;
+    n &= 1;
+  }
+  for (uint32_t i = 0; i < n; ++i)
+    dst[i] = SWAP ? swap16(lerp1(swap16(a[i]), swap16(b[i]), k)) : lerp1(a[i], b[i], k);
+}
+
+template <bool SWAP>
+static void buffersLoop(uint16_t* dst, const uint16_t* a, const uint16_t* b, uint32_t n, uint32_t k) {
+  uint16_t ik = (uint16_t)(32 - k);
+  for (uint32_t i = 0; i < n; ++i)
+    dst[i] = SWAP ? swap16(lerp16(swap16(a[i]), swap16(b[i]), k, ik)) : lerp16(a[i], b[i], k, ik);
+}
+
+#if BLEND_PIE
+template <bool SWAP>
+static void buffersPie(uint16_t* dst, const uint16_t* a, const uint16_t* b, uint32_t n, uint32_t k) {
+  uint32_t head = pieHead(dst, n);
+  buffersSwar<SWAP>(dst, a, b, head, k);
+  dst += head; a += head; b += head; n -= head;
+  if (!aligned16(a) || !aligned16(b)) { buffersSwar<SWAP>(dst, a, b, n, k); return; }
+
+  uint32_t vecs = n / 8;
+  if (vecs && !SWAP) pieLerp(dst, a, b, vecs, k);
+  for (uint32_t at = 0; SWAP && at < vecs * 8; at += PIE_CHUNK) {
+    alignas(16) uint16_t ta[PIE_CHUNK], tb[PIE_CHUNK];
+    uint32_t v = (vecs * 8 - at < PIE_CHUNK ? vecs * 8 - at : PIE_CHUNK) / 8;
+    pieSwap(ta, a + at, v);
+    pieSwap(tb, b + at, v);
+    pieLerp(ta, ta, tb, v, k);
+    pieSwap(dst + at, ta, v);
+  }
+  buffersSwar<SWAP>(dst + vecs * 8, a + vecs * 8, b + vecs * 8, n & 7, k);
+}
+#endif
+
+static void buffersWith(BlendPath path, uint16_t* dst, const uint16_t* a, const uint16_t* b,
+                        uint32_t n, uint32_t k, bool swapped) {
+  switch (path) {
+#if BLEND_PIE
+    case BlendPath::PIE:
+      swapped ? buffersPie<true>(dst, a, b, n, k) : buffersPie<false>(dst, a, b, n, k);
+      break;
+#endif
+    case BlendPath::SWAR:
+      swapped ? buffersSwar<true>(dst, a, b, n, k) : buffersSwar<false>(dst, a, b, n, k);
+      break;
+    default:
+      swapped ? buffersLoop<true>(dst, a, b, n, k) : buffersLoop<false>(dst, a, b, n, k);
+      break;
+  }
+}
+
+void blendBuffers(uint16_t* dst, const uint16_t* a, const uint16_t* b, uint32_t n,
+                  uint8_t alpha, bool swapped) {
+  buffersWith(BLEND_PATH, dst, a, b, n, alpha32(alpha), swapped);
+}
+
+template <bool SWAP>
+static void solidSwar(uint16_t* dst, uint32_t n, uint16_t color, uint32_t k) {
+  if (n && !aligned4(dst)) {
+    *dst = SWAP ? swap16(lerp1(color, swap16(*dst), k)) : lerp1(color, *dst, k);
+    dst++;
+    n--;
+  }
+
+  // The colour's share of every lane, rounding included
+  uint32_t c  = color | ((uint32_t)color << 16);
+  uint32_t cb = (c & LANE5) * k + ROUND;
+  uint32_t cg = ((c >> 5) & LANE6) * k + ROUND;
+  uint32_t cr = ((c >> 11) & LANE5) * k + ROUND;
+  uint32_t ik = 32 - k;
+
+  uint32_t* d = (uint32_t*)dst;
+  for (uint32_t i = 0; i < n / 2; ++i) {
+    uint32_t y = SWAP ? swap2(d[i]) : d[i];
+    uint32_t b = (((y & LANE5) * ik + cb) >> 5) & LANE5;
+    uint32_t g = ((((y >> 5) & LANE6) * ik + cg) >> 5) & LANE6;
+    uint32_t r = ((((y >> 11) & LANE5) * ik + cr) >> 5) & LANE5;
+    uint32_t o = b | (g << 5) | (r << 11);
+    d[i] = SWAP ? swap2(o) : o;
+  }
+  if (n & 1) {
+    uint16_t& last = dst[n - 1];
+    last = SWAP ? swap16(lerp1(color, swap16(last), k)) : lerp1(color, last, k);
+  }
+}
+
+template <bool SWAP>
+static void solidLoop(uint16_t* dst, uint32_t n, uint16_t color, uint32_t k) {
+  uint16_t ik = (uint16_t)(32 - k);
+  for (uint32_t i = 0; i < n; ++i)
+    dst[i] = SWAP ? swap16(lerp16(color, swap16(dst[i]), k, ik)) : lerp16(color, dst[i], k, ik);
+}
+
+#if BLEND_PIE
+// The colour is a 64-pixel buffer on the stack, read as `a`
+template <bool SWAP>
+static void solidPie(uint16_t* dst, uint32_t n, uint16_t color, uint32_t k) {
+  uint32_t head = pieHead(dst, n);
+  solidSwar<SWAP>(dst, head, color, k);
+  dst += head; n -= head;
+
+  uint32_t vecs = n / 8;
+  if (vecs) {
+    alignas(16) uint16_t c[PIE_CHUNK], t[PIE_CHUNK];
+    for (uint32_t i = 0; i < PIE_CHUNK; ++i) c[i] = color;
+    for (uint32_t at = 0; at < vecs * 8; at += PIE_CHUNK) {
+      uint32_t v = (vecs * 8 - at < PIE_CHUNK ? vecs * 8 - at : PIE_CHUNK) / 8;
+      if (SWAP) {
+        pieSwap(t, dst + at, v);
+        pieLerp(t, c, t, v, k);
+        pieSwap(dst + at, t, v);
+      } else {
+        pieLerp(dst + at, c, dst + at, v, k);
+      }
+    }
+  }
+  solidSwar<SWAP>(dst + vecs * 8, n & 7, color, k);
+}
+#endif
+
+static void solidWith(BlendPath path, uint16_t* dst, uint32_t n, uint16_t color, uint32_t k, bool swapped) {
+  switch (path) {
+#if BLEND_PIE
+    case BlendPath::PIE:
+      swapped ? solidPie<true>(dst, n, color, k) : solidPie<false>(dst, n, color, k);
+      break;
+#endif
+    case BlendPath::SWAR:
+      swapped ? solidSwar<true>(dst, n, color, k) : solidSwar<false>(dst, n, color, k);
+      break;
+    default:
+      swapped ? solidLoop<true>(dst, n, color, k) : solidLoop<false>(dst, n, color, k);
+      break;
+  }
+}
+
+void blendSolid(uint16_t* dst, uint32_t n, uint16_t color, uint8_t alpha, bool swapped) {
+  solidWith(BLEND_PATH, dst, n, color, alpha32(alpha), swapped);
+}
+
+template <bool SWAP>
+static void mask4Impl(uint16_t* dst, const uint8_t* mask, uint32_t n, uint16_t color) {
+  uint16_t fill = SWAP ? swap16(color) : color;
+  for (uint32_t i = 0; i < n; i += 2, ++mask) {
+    uint8_t m = *mask;
+    bool pair = i + 1 < n;
+    if (m == 0x00 && pair) continue;
+    if (m == 0xFF && pair) { dst[i] = dst[i + 1] = fill; continue; }
+
+    // Nibble 0..15 → 0..32
+    uint32_t k = ((m >> 4) * 17 + 4) >> 3;
+    dst[i] = SWAP ? swap16(lerp1(color, swap16(dst[i]), k)) : lerp1(color, dst[i], k);
+    if (pair) {
+      k = ((m & 15) * 17 + 4) >> 3;
+      dst[i + 1] = SWAP ? swap16(lerp1(color, swap16(dst[i + 1]), k)) : lerp1(color, dst[i + 1], k);
+    }
+  }
+}
+
+void blendMask4(uint16_t* dst, const uint8_t* mask, uint32_t n, uint16_t color, bool swapped) {
+  if (swapped) mask4Impl<true>(dst, mask, n, color);
+  else         mask4Impl<false>(dst, mask, n, color);
+}
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+// Random pixels through every kernel (pixel loops, SWAR and,
+// on the S3, PIE), both byte orders, every offset modulo 16
+// bytes, odd lengths, sources out of step with each other;
+// compared with blendPixel(). Then each one timed over a
+// 4096-pixel buffer.
+static constexpr uint32_t BENCH_PX = 4096, BENCH_REPS = 64;
+
+static const BlendPath PATHS[] = { BlendPath::LOOP, BlendPath::SWAR,
+#if BLEND_PIE
+                                   BlendPath::PIE,
+#endif
+};
+static constexpr int NPATHS = sizeof(PATHS) / sizeof(PATHS[0]);
+static const char* const PATH_NAMES[] = { "pixel loops", "SWAR", "PIE" };
+
+static uint32_t rng = 0x12345678;
+static uint16_t rand16() {
+  rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+  return (uint16_t)rng;
+}
+
+// The obvious way: unpack, blend each channel, repack
+static uint16_t naivePixel(uint16_t a, uint16_t b, uint8_t alpha) {
+  int r = ((a >> 11) * alpha + (b >> 11) * (255 - alpha)) / 255;
+  int g = (((a >> 5) & 63) * alpha + ((b >> 5) & 63) * (255 - alpha)) / 255;
+  int bl = ((a & 31) * alpha + (b & 31) * (255 - alpha)) / 255;
+  return (uint16_t)((r << 11) | (g << 5) | bl);
+}
+
+static void naiveBuffers(uint16_t* d, const uint16_t* a, const uint16_t* b, uint32_t n, uint8_t alpha) {
+  for (uint32_t i = 0; i < n; ++i) d[i] = naivePixel(a[i], b[i], alpha);
+}
+
+// a, b, d 16-byte aligned
+static uint32_t verify(uint16_t* a, uint16_t* b, uint16_t* d, uint8_t* mask) {
+  uint32_t bad = 0;
+  for (int round = 0; round < 64 * NPATHS; ++round) {
+    uint32_t off = rand16() & 7, n = (rand16() % 257) + 1;
+    uint32_t boff = off + ((round & 8) ? 1 : 0);     // b out of step: no PIE
+    uint8_t alpha = (uint8_t)rand16();
+    uint16_t color = rand16();
+    bool sw = round & 1;
+    BlendPath path = PATHS[(round >> 1) % NPATHS];
+    for (uint32_t i = 0; i < n + boff; ++i) { a[i] = rand16(); b[i] = rand16(); }
+    for (uint32_t i = 0; i < (n + 1) / 2; ++i) {
+      uint16_t r = rand16();
+      mask[i] = (r & 0x300) == 0 ? 0x00 : (r & 0x300) == 0x100 ? 0xFF : (uint8_t)r;
+    }
+    auto in  = [&](uint16_t c) { return sw ? swap16(c) : c; };
+
+    buffersWith(path, d + off, a + off, b + boff, n, alpha32(alpha), sw);
+    for (uint32_t i = 0; i < n; ++i)
+      bad += in(d[off + i]) != blendPixel(in(a[off + i]), in(b[boff + i]), alpha);
+
+    memcpy(d, b, (n + off) * sizeof(uint16_t));
+    solidWith(path, d + off, n, color, alpha32(alpha), sw);
+    for (uint32_t i = 0; i < n; ++i)
+      bad += in(d[off + i]) != blendPixel(color, in(b[off + i]), alpha);
+
+    memcpy(d, b, (n + off) * sizeof(uint16_t));
+    blendMask4(d + off, mask, n, color, sw);
+    for (uint32_t i = 0; i < n; ++i) {
+      uint8_t nib = (i & 1) ? (mask[i / 2] & 15) : (mask[i / 2] >> 4);
+      bad += in(d[off + i]) != lerp1(color, in(b[off + i]), (nib * 17 + 4) >> 3);
+    }
+  }
+  return bad;
+}
+
+static uint16_t* align16(void* p) { return (uint16_t*)(((uintptr_t)p + 15) & ~(uintptr_t)15); }
+
+bool blendBenchmark() {
+  static constexpr size_t BYTES = BENCH_PX * sizeof(uint16_t) + 16;   // room to align
+  void* ma = malloc(BYTES);
+  void* mb = malloc(BYTES);
+  void* md = malloc(BYTES);
+  uint8_t* m = (uint8_t*)malloc(BENCH_PX / 2);
+  if (!ma || !mb || !md || !m) {
+    BENCH_LOG("[Blend] Out of memory for the benchmark\n");
+    free(ma); free(mb); free(md); free(m);
+    return false;
+  }
+  uint16_t* a = align16(ma);
+  uint16_t* b = align16(mb);
+  uint16_t* d = align16(md);
+
+  uint32_t bad = verify(a, b, d, m);
+  for (uint32_t i = 0; i < BENCH_PX; ++i) { a[i] = rand16(); b[i] = d[i] = rand16(); }
+  for (uint32_t i = 0; i < BENCH_PX / 2; ++i) m[i] = (uint8_t)rand16();  // worst case: all partial
+
+  // Per path: buffers, swapped buffers, solid. The length comes
+  // from `count` so no kernel is vectorized just for a constant
+  // trip count.
+  volatile uint32_t count = BENCH_PX;
+  auto timed = [&](auto&& run) {
+    uint32_t n = count;
+    uint32_t t0 = benchTicks();
+    for (uint32_t r = 0; r < BENCH_REPS; ++r) run(n, r, (uint8_t)(r * 4));
+    return (benchTicks() - t0) / (float)(BENCH_PX * BENCH_REPS);
+  };
+  float naive = timed([&](uint32_t n, uint32_t, uint8_t al) { naiveBuffers(d, a, b, n, al); });
+  float mask4 = timed([&](uint32_t n, uint32_t r, uint8_t) { blendMask4(d, m, n, a[r]); });
+
+  BENCH_LOG("[Blend] %s; " BENCH_UNIT "/px: naive per-channel %.2f, mask4 %.2f\n",
+            bad ? "MISMATCH vs reference" : "all kernels match the reference", naive, mask4);
+  for (int p = 0; p < NPATHS; ++p) {
+    BlendPath path = PATHS[p];
+    float buf = timed([&](uint32_t n, uint32_t, uint8_t al) { buffersWith(path, d, a, b, n, alpha32(al), false); });
+    float swp = timed([&](uint32_t n, uint32_t, uint8_t al) { buffersWith(path, d, a, b, n, alpha32(al), true); });
+    float sol = timed([&](uint32_t n, uint32_t r, uint8_t al) { solidWith(path, d, n, a[r], alpha32(al), false); });
+    BENCH_LOG("[Blend]   %-11s buffers %.2f (swapped %.2f), solid %.2f%s\n", PATH_NAMES[(int)path],
+              buf, swp, sol, path == BLEND_PATH ? "  <- in use" : "");
+  }
+  if (bad) BENCH_LOG("[Blend] %u mismatched pixels\n", (unsigned)bad);
+  free(ma); free(mb); free(md); free(m);
+  return !bad;
+}
+
+#ifdef BLEND_BENCH_MAIN
+int main() {
+  return blendBenchmark() ? 0 : 1;
+}
+#endif
+
+// ======================= End of File =======================
@@ -0,0 +1,46 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  blend.h — RGB565 Alpha Blending (Header)
+//
+//  Provides:
+//   • blendPixel()    — One pixel; the reference for the rest
+//   • blendBuffers()  — Two buffers at a constant alpha (fades)
+//   • blendSolid()    — A solid colour over a buffer (dimming,
+//                       overlays, toasts)
+//   • blendMask4()    — A solid colour through a 4-bpp coverage
+//                       mask (anti-aliased text, icons)
+//   • blendBenchmark()— Checks every kernel against blendPixel()
+//                       and prints cycles (ns on a PC) per pixel;
+//                       false on any mismatch
+//
+//  Conventions:
+//   - alpha is 0..255 (255 = all `a` / all `color`); kernels use
+//     it in 1/32 steps, the precision of the 5-bit channels.
+//   - `swapped` buffers hold byte-swapped pixels, as sprites
+//     and DMA blocks do; colours are always passed native.
+//   - dst may be the same buffer as a or b.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+
+// =========================================================
+//  KERNELS
+// =========================================================
+uint16_t blendPixel(uint16_t a, uint16_t b, uint8_t alpha);
+
+void blendBuffers(uint16_t* dst, const uint16_t* a, const uint16_t* b, uint32_t n,
+                  uint8_t alpha, bool swapped = false);
+void blendSolid(uint16_t* dst, uint32_t n, uint16_t color, uint8_t alpha, bool swapped = false);
+
+// Two pixels per byte, left pixel in the high nibble; the
+// first pixel is the high nibble of mask[0]
+void blendMask4(uint16_t* dst, const uint8_t* mask, uint32_t n, uint16_t color, bool swapped = false);
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+bool blendBenchmark();
+
+// ======================= End of File =======================
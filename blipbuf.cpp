@@ -0,0 +1,282 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  blipbuf.cpp — Band-Limited Step Buffer
+//
+//  Provides:
+//   • Windowed-sinc step kernel (Blackman), built once
+//   • Delta placement at 1/PHASES sample resolution
+//   • Block integrate + DC leak + clamp to int16
+//
+//  Notes:
+//   - Each kernel phase sums to exactly 1 << KERNEL_BITS, so a
+//     step always settles on its true level; only the edge is
+//     smoothed.
+//   - Cells hold delta × kernel in 32 bits: there is headroom
+//     for ~16 full-scale steps landing on the same sample.
+//
+//  Host check + benchmark (NES pulse/triangle tones against
+//  point sampling, alias energy from an FFT):
+//    g++ -O2 -DBLIP_BENCH_MAIN -x c++ blipbuf.cpp -o blip_bench
+// =========================================================
+
+#include "blipbuf.h"
+#include <math.h>
+#include <string.h>
+
+// =========================================================
+//  KERNEL
+// =========================================================
+static int16_t kernel[BlipBuf::PHASES][BlipBuf::WIDTH];
+static bool    kernelReady = false;
+
+static void buildKernel() {
+  const int   W      = BlipBuf::WIDTH;
+  const int   center = W / 2 - 1;   // tap holding a step at phase 0
+  const float cutoff = 0.92f;       // passband, fraction of Nyquist
+  const int   unity  = 1 << 12;
+
+  for (int p = 0; p < BlipBuf::PHASES; ++p) {
+    float frac = (float)p / BlipBuf::PHASES;
+    float h[W], sum = 0;
+    for (int i = 0; i < W; ++i) {
+      float x  = i - center - frac;           // samples from the step
+      float sx = (float)M_PI * cutoff * x;
+      float s  = fabsf(sx) < 1e-6f ? 1.0f : sinf(sx) / sx;
+      float w  = (x + W / 2) / W;             // 0..1 across the taps
+      float win = 0.42f - 0.5f * cosf(2 * (float)M_PI * w) + 0.08f * cosf(4 * (float)M_PI * w);
+      h[i] = s * win;
+      sum += h[i];
+    }
+    int total = 0;
+    for (int i = 0; i < W; ++i) {
+      kernel[p][i] = (int16_t)lroundf(h[i] * unity / sum);
+      total += kernel[p][i];
+    }
+    kernel[p][center + (frac >= 0.5f)] += unity - total;  // exact DC gain
+  }
+  kernelReady = true;
+}
+
+
+// =========================================================
+//  SETUP
+// =========================================================
+void BlipBuf::setRates(uint32_t clockHz, uint32_t sampleHz) {
+  static_assert(KERNEL_BITS == 12, "buildKernel() scales to 1 << 12");
+  if (!kernelReady) buildKernel();
+  _factor = (uint32_t)(((uint64_t)sampleHz << FRAC_BITS) / clockHz);
+  clear();
+}
+
+void BlipBuf::clear() {
+  _offset = 0;
+  _integrator = 0;
+  memset(_buf, 0, sizeof(_buf));
+}
+
+
+// =========================================================
+//  SYNTHESIS
+// =========================================================
+// Cell of the first tap for a step at `clock`, nullptr past the
+// end of the buffer (frame longer than MAX_SAMPLES).
+inline int32_t* BlipBuf::_cell(uint32_t clock, uint32_t& frac) {
+  uint32_t pos = _offset + clock * _factor;
+  uint32_t idx = pos >> FRAC_BITS;
+  if (idx >= (uint32_t)MAX_SAMPLES) return nullptr;
+  frac = pos & ((1u << FRAC_BITS) - 1);
+  return _buf + idx;
+}
+
+void BlipBuf::addDelta(uint32_t clock, int delta) {
+  uint32_t frac;
+  int32_t* c = _cell(clock, frac);
+  if (!c) return;
+  const int16_t* k = kernel[frac >> (FRAC_BITS - PHASE_BITS)];
+  for (int i = 0; i < WIDTH; ++i) c[i] += delta * k[i];
+}
+
+// Linear interpolation between the two centre taps: no band
+// limiting, but exact timing. Fine for noise.
+void BlipBuf::addDeltaFast(uint32_t clock, int delta) {
+  uint32_t frac;
+  int32_t* c = _cell(clock, frac);
+  if (!c) return;
+  int w = (int)(frac >> (FRAC_BITS - KERNEL_BITS));
+  c[WIDTH / 2 - 1] += delta * ((1 << KERNEL_BITS) - w);
+  c[WIDTH / 2]     += delta * w;
+}
+
+
+// =========================================================
+//  OUTPUT
+// =========================================================
+void BlipBuf::endFrame(uint32_t clocks) {
+  _offset += clocks * _factor;
+  if (samplesAvail() > MAX_SAMPLES) _offset = (uint32_t)MAX_SAMPLES << FRAC_BITS;
+}
+
+int BlipBuf::readSamples(int16_t* out, int max) {
+  int n = samplesAvail();
+  if (n > max) n = max;
+
+  int32_t sum = _integrator;
+  for (int i = 0; i < n; ++i) {
+    sum += _buf[i];
+    int32_t s = sum >> KERNEL_BITS;
+    if (s > 32767) s = 32767; else if (s < -32768) s = -32768;
+    out[i] = (int16_t)s;
+    sum -= sum >> BASS_SHIFT;
+  }
+  _integrator = sum;
+
+  // Slide the unread samples + kernel tails to the front
+  int keep = samplesAvail() - n + WIDTH;
+  memmove(_buf, _buf + n, keep * sizeof(int32_t));
+  memset(_buf + keep, 0, n * sizeof(int32_t));
+  _offset -= (uint32_t)n << FRAC_BITS;
+  return n;
+}
+
+
+// =========================================================
+//  HOST CHECK + BENCHMARK
+// =========================================================
+#ifdef BLIP_BENCH_MAIN
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+static constexpr uint32_t CLOCK = 1789773;   // NES CPU
+static constexpr uint32_t RATE  = 44100;
+static constexpr uint32_t FRAME = 29780;     // CPU clocks per frame
+static constexpr int      N     = 16384;     // FFT length
+static constexpr int      SKIP  = 4096;      // let the DC leak settle
+
+static uint64_t benchNs() {
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// NES tone: level at step `s` and steps per period
+struct Tone { const char* name; uint32_t clocksPerStep; int steps; int (*level)(int); };
+static int pulseLevel(int s) { return s < 4 ? 15 : 0; }                 // 50% duty
+static int triLevel(int s)   { return s < 16 ? 15 - s : s - 16; }
+
+static void fft(double* re, double* im, int n) {
+  for (int i = 1, j = 0; i < n; ++i) {
+    int bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) { double t = re[i]; re[i] = re[j]; re[j] = t; t = im[i]; im[i] = im[j]; im[j] = t; }
+  }
+  for (int len = 2; len <= n; len <<= 1) {
+    double a = -2 * M_PI / len;
+    for (int i = 0; i < n; i += len)
+      for (int k = 0; k < len / 2; ++k) {
+        double wr = cos(a * k), wi = sin(a * k);
+        double* ur = re + i + k; double* ui = im + i + k;
+        double vr = ur[len / 2] * wr - ui[len / 2] * wi, vi = ur[len / 2] * wi + ui[len / 2] * wr;
+        ur[len / 2] = *ur - vr; ui[len / 2] = *ui - vi;
+        *ur += vr; *ui += vi;
+      }
+  }
+}
+
+// Energy away from the tone's harmonics (and DC), in dB of the
+// total: what aliasing folded back into the audible band
+static double aliasDb(const int16_t* x, double f0) {
+  static double re[N], im[N];
+  for (int i = 0; i < N; ++i) {
+    double w = 0.35875 - 0.48829 * cos(2 * M_PI * i / N) + 0.14128 * cos(4 * M_PI * i / N)
+             - 0.01168 * cos(6 * M_PI * i / N);              // Blackman-Harris
+    re[i] = x[i] * w;
+    im[i] = 0;
+  }
+  fft(re, im, N);
+  double total = 0, alias = 0;
+  for (int b = 8; b < N / 2; ++b) {
+    double e = re[b] * re[b] + im[b] * im[b];
+    double h = b * (double)RATE / N / f0;                    // in harmonics
+    bool near = fabs(h - floor(h + 0.5)) * f0 * N / RATE <= 6;
+    total += e;
+    if (!near) alias += e;
+  }
+  return 10 * log10(alias / total + 1e-30);
+}
+
+// Renders `t` both ways: band-limited deltas and the old point
+// sampling of the channel level
+static void render(const Tone& t, int16_t* blip, int16_t* point) {
+  static BlipBuf b;
+  b.setRates(CLOCK, RATE);
+  const int AMP = 600;
+  uint64_t clock = 0, nextStep = 0;
+  int step = 0, last = 0, got = 0;
+  while (got < SKIP + N) {
+    uint64_t end = clock + FRAME;
+    for (; nextStep < end; nextStep += t.clocksPerStep) {
+      int lv = t.level(step) * AMP;
+      if (lv != last) b.addDelta((uint32_t)(nextStep - clock), lv - last);
+      last = lv;
+      step = (step + 1) % t.steps;
+    }
+    b.endFrame(FRAME);
+    clock = end;
+    int16_t tmp[BlipBuf::MAX_SAMPLES];
+    int n = b.readSamples(tmp, BlipBuf::MAX_SAMPLES);
+    for (int i = 0; i < n && got < SKIP + N; ++i, ++got)
+      if (got >= SKIP) blip[got - SKIP] = tmp[i];
+  }
+  for (int i = 0; i < N; ++i) {
+    uint64_t c = (uint64_t)(SKIP + i) * CLOCK / RATE;
+    point[i] = (int16_t)(t.level((int)(c / t.clocksPerStep % t.steps)) * AMP - 15 * AMP / 2);
+  }
+}
+
+int main() {
+  static const Tone tones[] = {
+    { "pulse    435 Hz", 16 * 257 / 8, 8, pulseLevel },
+    { "pulse   1.7 kHz", 16 *  66 / 8, 8, pulseLevel },
+    { "pulse   3.5 kHz", 16 *  32 / 8, 8, pulseLevel },
+    { "pulse   6.6 kHz", 16 *  17 / 8, 8, pulseLevel },
+    { "triangle 434 Hz", 129, 32, triLevel },
+    { "triangle 1.7 kHz", 33, 32, triLevel },
+  };
+  static int16_t blip[N], point[N];
+  bool ok = true;
+  for (const Tone& t : tones) {
+    render(t, blip, point);
+    double f0 = (double)CLOCK / (t.clocksPerStep * t.steps);
+    double db = aliasDb(blip, f0), pdb = aliasDb(point, f0);
+    bool pass = db < -35 && db < pdb - 10;
+    ok &= pass;
+    printf("[Blip] %-16s off-harmonic energy: band-limited %6.1f dB, point-sampled %6.1f dB  %s\n",
+           t.name, db, pdb, pass ? "ok" : "FAIL");
+  }
+
+  // Cost per step and per output sample
+  static BlipBuf b;
+  b.setRates(CLOCK, RATE);
+  const int FRAMES = 2000, STEPS = 400;
+  int16_t out[BlipBuf::MAX_SAMPLES];
+  uint64_t slowNs = 0, fastNs = 0, readNs = 0, samples = 0;
+  for (int f = 0; f < FRAMES; ++f) {
+    uint64_t t0 = benchNs();
+    for (int i = 0; i < STEPS; ++i) b.addDelta(i * (FRAME / STEPS), (i & 1) ? -500 : 500);
+    uint64_t t1 = benchNs();
+    for (int i = 0; i < STEPS; ++i) b.addDeltaFast(i * (FRAME / STEPS) + 7, (i & 1) ? -500 : 500);
+    b.endFrame(FRAME);
+    uint64_t t2 = benchNs();
+    samples += b.readSamples(out, BlipBuf::MAX_SAMPLES);
+    uint64_t t3 = benchNs();
+    slowNs += t1 - t0; fastNs += t2 - t1; readNs += t3 - t2;
+  }
+  printf("[Blip] addDelta %.1f ns, addDeltaFast %.1f ns, integrate %.2f ns/sample\n",
+         (double)slowNs / (FRAMES * STEPS), (double)fastNs / (FRAMES * STEPS), (double)readNs / samples);
+  return ok ? 0 : 1;
+}
+#endif
+
+// ======================= End of File =======================
@@ -0,0 +1,70 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  blipbuf.h — Band-Limited Step Buffer (Header)
+//
+//  Provides:
+//   • BlipBuf — sound-chip synthesis at the output rate
+//   • addDelta()     — amplitude step at a chip-clock timestamp
+//   • addDeltaFast() — cheaper 2-tap step for busy channels
+//   • endFrame() / readSamples() — integrate + filter a block
+//
+//  Design:
+//   - A chip channel only reports when its output changes.
+//     Each change is spread over WIDTH samples with a windowed
+//     sinc step (PHASES sub-sample positions), so square waves
+//     come out without the aliasing of point sampling.
+//   - The buffer holds differences; readSamples() integrates
+//     them with a leaky integrator, which doubles as the DC
+//     blocker (corner ~14 Hz at 44.1 kHz).
+//
+//  Notes:
+//   - No Arduino dependency; shared by the emulator cores.
+//   - Timestamps are chip clocks since the last endFrame().
+//     One frame may hold up to MAX_SAMPLES output samples;
+//     read them all before the next frame.
+//   - Output is delayed by WIDTH / 2 samples.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+
+// =========================================================
+//  BLIPBUF CLASS
+// =========================================================
+class BlipBuf {
+public:
+  static constexpr int MAX_SAMPLES = 1024;  // per frame
+  static constexpr int WIDTH       = 16;    // taps per step
+  static constexpr int PHASE_BITS  = 5;
+  static constexpr int PHASES      = 1 << PHASE_BITS;  // sub-sample positions
+
+  // --- Setup ---
+  void setRates(uint32_t clockHz, uint32_t sampleHz);
+  void clear();
+
+  // --- Synthesis ---
+  void addDelta(uint32_t clock, int delta);
+  void addDeltaFast(uint32_t clock, int delta);
+
+  // --- Output ---
+  // Closes the frame after `clocks` chip clocks; its samples
+  // become readable. readSamples() returns how many it wrote.
+  void endFrame(uint32_t clocks);
+  int  samplesAvail() const { return (int)(_offset >> FRAC_BITS); }
+  int  readSamples(int16_t* out, int max);
+
+private:
+  static constexpr int FRAC_BITS   = 20;    // sample position, 12.20
+  static constexpr int KERNEL_BITS = 12;    // each phase sums to 1 << 12
+  static constexpr int BASS_SHIFT  = 9;     // integrator leak
+
+  uint32_t _factor = 0;                     // samples per clock, .20
+  uint32_t _offset = 0;                     // frame start, .20
+  int32_t  _integrator = 0;
+  int32_t  _buf[MAX_SAMPLES + WIDTH] = {};
+
+  int32_t* _cell(uint32_t clock, uint32_t& frac);
+};
+
+// ======================= End of File =======================
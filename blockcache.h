@@ -0,0 +1,155 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  blockcache.h — Translated Block Cache for Guest CPUs
+//
+//  Shared by the CPU cores: each core decodes a guest basic
+//  block once into a run of its own `Op` records (handler
+//  pointer + pre-extracted operands) and executes from here
+//  on later visits, skipping fetch + decode entirely.
+//
+//  Provides:
+//   • BlockCache<Op, MAX_OPS, PAGES> — bump arena + hash lookup
+//   • find() / alloc() / commit()    — translate on miss
+//   • invalidatePage()               — self-modifying code
+//   • flush()                        — bank/state changes
+//
+//  Notes:
+//   - Blocks are keyed by the HOST address of their first
+//     byte, so a bank switch can never alias two blocks. The
+//     guest address is kept as a tag: mirrored views of the
+//     same bytes get separate blocks (their PCs differ).
+//   - Writable guest memory is split into pages chosen by the
+//     core. A block must not cross one (the core stops
+//     decoding at the edge) and is linked into its page, so a
+//     write there drops exactly the affected blocks. ROM
+//     blocks use page -1 and are never invalidated.
+//   - A page invalidated more than HOT_PAGE times between
+//     flushes is left to the plain interpreter: code that
+//     patches itself every pass would only re-translate.
+//   - When the arena fills up, everything is flushed and
+//     re-translated on demand; no per-block freeing.
+//   - No allocation of its own: the caller hands in memory.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// =========================================================
+//  BLOCKCACHE TEMPLATE
+// =========================================================
+template <typename Op, uint16_t MAX_OPS, uint16_t PAGES>
+class BlockCache {
+public:
+  struct Block {
+    const void* key;         // host address of the first opcode; nullptr = dead
+    uint32_t    tag;         // guest address of the first opcode
+    Block*      hashNext;
+    Block*      pageNext;
+    uint16_t    count;
+    int16_t     page;
+    Op          ops[1];      // `count` entries follow in the arena
+  };
+
+  static constexpr uint16_t BUCKETS  = 256;
+  static constexpr uint8_t  HOT_PAGE = 32;
+
+  // --- Setup ---
+  void attach(void* mem, size_t bytes) {
+    _mem = (uint8_t*)mem;
+    _size = mem ? bytes : 0;
+    flush();
+  }
+  bool enabled() const { return _mem != nullptr; }
+
+  void flush() {
+    _used = 0;
+    memset(_buckets, 0, sizeof(_buckets));
+    memset(_pages, 0, sizeof(_pages));
+    memset(_pageHasCode, 0, sizeof(_pageHasCode));
+    memset(_pageInvals, 0, sizeof(_pageInvals));
+    _flushes++;
+  }
+
+  // --- Lookup ---
+  Block* find(const void* key, uint32_t tag) const {
+    for (Block* b = _buckets[_hash(key)]; b; b = b->hashNext)
+      if (b->key == key && b->tag == tag) return b;
+    return nullptr;
+  }
+
+  // --- Translate (miss path) ---
+  // Returns room for MAX_OPS ops; fill them, then commit() the
+  // real count. Flushes first if the arena cannot fit a block.
+  Block* alloc() {
+    if (!_mem) return nullptr;
+    if (_used + _blockBytes(MAX_OPS) > _size) flush();
+    return (Block*)(_mem + _used);
+  }
+
+  void commit(Block* b, const void* key, uint32_t tag, uint16_t count, int16_t page) {
+    b->key   = key;
+    b->tag   = tag;
+    b->count = count;
+    b->page  = page;
+
+    Block*& head = _buckets[_hash(key)];
+    b->hashNext = head;
+    head = b;
+
+    b->pageNext = nullptr;
+    if (page >= 0 && page < PAGES) {
+      b->pageNext = _pages[page];
+      _pages[page] = b;
+      _pageHasCode[page] = 1;
+    }
+    _used += (_blockBytes(count) + 3) & ~(size_t)3;
+    _translated++;
+  }
+
+  // --- Self-modifying code ---
+  // Cheap test for the write fast path.
+  bool pageHasCode(int page) const { return _pageHasCode[page]; }
+  bool pageIsHot(int page) const   { return page >= 0 && _pageInvals[page] > HOT_PAGE; }
+
+  void invalidatePage(int page) {
+    for (Block* b = _pages[page]; b; b = b->pageNext) b->key = nullptr;
+    _pages[page] = nullptr;
+    _pageHasCode[page] = 0;
+    if (_pageInvals[page] <= HOT_PAGE) _pageInvals[page]++;
+    _generation++;
+    _invalidations++;
+  }
+
+  // Bumped on every invalidation; a running block checks it to
+  // stop right after a write into its own code.
+  uint32_t generation() const { return _generation; }
+
+  // --- Stats ---
+  uint32_t translated() const    { return _translated; }
+  uint32_t flushes() const       { return _flushes; }
+  uint32_t invalidations() const { return _invalidations; }
+  size_t   used() const          { return _used; }
+
+private:
+  uint8_t* _mem = nullptr;
+  size_t   _size = 0, _used = 0;
+  Block*   _buckets[BUCKETS] = {};
+  Block*   _pages[PAGES] = {};
+  uint8_t  _pageHasCode[PAGES] = {};
+  uint8_t  _pageInvals[PAGES] = {};
+  uint32_t _generation = 0;
+  uint32_t _translated = 0, _flushes = 0, _invalidations = 0;
+
+  static size_t _blockBytes(uint16_t n) {
+    return offsetof(Block, ops) + (size_t)n * sizeof(Op);
+  }
+  static uint16_t _hash(const void* key) {
+    uintptr_t k = (uintptr_t)key;
+    return (uint16_t)((k ^ (k >> 8) ^ (k >> 16)) & (BUCKETS - 1));
+  }
+};
+
+// ======================= End of File =======================
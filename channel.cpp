@@ -0,0 +1,334 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  channel.cpp — Channel Stress Test + Throughput Benchmark
+//
+//  channel.h is header-only; this file only exercises it.
+//  Each channel is driven from two sides at once (two cores on
+//  the device, threads on the host) and every item is checked:
+//   • SpscRing    — a counting sequence in random-size bursts
+//                   must come out whole and in order
+//   • MpscQueue   — per-producer sequences must each stay in
+//                   order, none lost or duplicated
+//   • Seqlock     — a snapshot whose fields are derived from
+//                   one counter must never be seen torn
+//   • TripleBuffer — same, and the counter never goes back
+//
+//  Host stress test (ThreadSanitizer):
+//    g++ -O1 -g -fsanitize=thread -pthread -DCHANNEL_BENCH_MAIN -x c++ channel.cpp -o channel_tsan
+//  Host benchmark:
+//    g++ -O2 -pthread -DCHANNEL_BENCH_MAIN -x c++ channel.cpp -o channel_bench
+// =========================================================
+
+#include "channel.h"
+#include <stdlib.h>
+
+#ifdef ARDUINO
+  #include "config.h"
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+  #include "freertos/semphr.h"
+  #define BENCH_LOG(...) DBG_IF(CHANNEL, __VA_ARGS__)
+  static uint32_t benchUs() { return micros(); }
+  static void benchYield() { taskYIELD(); }
+#else
+  #include <stdio.h>
+  #include <chrono>
+  #include <thread>
+  #include <vector>
+  #define BENCH_LOG(...) printf(__VA_ARGS__)
+  static uint32_t benchUs() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+  static void benchYield() { std::this_thread::yield(); }
+#endif
+
+// =========================================================
+//  THREADS
+// =========================================================
+// Device: FreeRTOS tasks on core 0, the caller on core 1.
+// Host: std::thread.
+#ifdef ARDUINO
+static SemaphoreHandle_t benchDone = nullptr;
+static int               benchLive = 0;
+
+struct BenchStart { void (*fn)(void*); void* arg; };
+static BenchStart benchStarts[4];
+
+static void benchTask(void* p) {
+  const BenchStart& s = *(const BenchStart*)p;
+  s.fn(s.arg);
+  xSemaphoreGive(benchDone);
+  vTaskDelete(nullptr);
+}
+
+static bool benchSpawn(void (*fn)(void*), void* arg) {
+  if (!benchDone) benchDone = xSemaphoreCreateCounting(4, 0);
+  if (!benchDone || benchLive >= 4) return false;
+  benchStarts[benchLive] = { fn, arg };
+  if (xTaskCreatePinnedToCore(benchTask, "chan", 3072, &benchStarts[benchLive], 1, nullptr, 0) != pdPASS)
+    return false;
+  benchLive++;
+  return true;
+}
+
+static void benchJoin() {
+  for (; benchLive > 0; --benchLive) xSemaphoreTake(benchDone, portMAX_DELAY);
+}
+#else
+static std::vector<std::thread> benchThreads;
+
+static bool benchSpawn(void (*fn)(void*), void* arg) {
+  benchThreads.emplace_back(fn, arg);
+  return true;
+}
+
+static void benchJoin() {
+  for (auto& t : benchThreads) t.join();
+  benchThreads.clear();
+}
+#endif
+
+
+// =========================================================
+//  SPSC
+// =========================================================
+#ifdef ARDUINO
+static constexpr uint32_t SPSC_ITEMS = 200000;
+#else
+static constexpr uint32_t SPSC_ITEMS = 4000000;
+#endif
+
+static SpscRing<uint32_t, 1024> spsc;
+
+static void spscProducer(void*) {
+  uint32_t next = 0, rng = 1;
+  uint32_t burst[64];
+  while (next < SPSC_ITEMS) {
+    rng = rng * 1664525u + 1013904223u;
+    uint32_t n = 1 + (rng >> 26);                       // 1..64
+    if (n > SPSC_ITEMS - next) n = SPSC_ITEMS - next;
+    for (uint32_t i = 0; i < n; ++i) burst[i] = next + i;
+    uint32_t sent = 0;
+    while (sent < n) {
+      uint32_t k = spsc.write(burst + sent, n - sent);
+      if (!k) benchYield();
+      sent += k;
+    }
+    next += n;
+  }
+}
+
+static uint32_t spscConsume() {
+  uint32_t expect = 0, bad = 0;
+  while (expect < SPSC_ITEMS) {
+    uint32_t n = spsc.available();
+    if (!n) { benchYield(); continue; }
+    for (uint32_t i = 0; i < n; ++i)
+      if (spsc.peek(i) != expect + i) bad++;
+    spsc.consume(n);
+    expect += n;
+  }
+  return bad;
+}
+
+
+// =========================================================
+//  MPSC
+// =========================================================
+static constexpr int MPSC_PRODUCERS = 3;
+#ifdef ARDUINO
+static constexpr uint32_t MPSC_ITEMS = 50000;           // per producer
+#else
+static constexpr uint32_t MPSC_ITEMS = 1000000;
+#endif
+
+static MpscQueue<uint32_t, 256> mpsc;
+static uint32_t mpscIds[MPSC_PRODUCERS];
+
+static void mpscProducer(void* arg) {
+  uint32_t id = *(const uint32_t*)arg;
+  for (uint32_t i = 0; i < MPSC_ITEMS; ++i)
+    while (!mpsc.push(id << 24 | i)) benchYield();
+}
+
+static uint32_t mpscConsume(int producers) {
+  uint32_t next[MPSC_PRODUCERS] = {};
+  uint32_t got = 0, bad = 0, v;
+  while (got < MPSC_ITEMS * producers) {
+    if (!mpsc.pop(v)) { benchYield(); continue; }
+    uint32_t id = v >> 24;
+    if (id >= MPSC_PRODUCERS || (v & 0xFFFFFF) != next[id]) bad++;
+    else next[id]++;
+    got++;
+  }
+  return bad;
+}
+
+
+// =========================================================
+//  SEQLOCK / TRIPLE BUFFER
+// =========================================================
+struct BenchSnap {
+  uint32_t n, twice, inv, sq;
+  uint16_t lo, hi;
+};
+
+static BenchSnap snapOf(uint32_t n) {
+  return { n, n * 2, ~n, n * n, (uint16_t)n, (uint16_t)(n >> 16) };
+}
+
+static bool snapTorn(const BenchSnap& s) {
+  BenchSnap r = snapOf(s.n);
+  return memcmp(&r, &s, sizeof(s)) != 0;
+}
+
+#ifdef ARDUINO
+static constexpr uint32_t SNAP_WRITES = 100000;
+#else
+static constexpr uint32_t SNAP_WRITES = 2000000;
+#endif
+
+// A run proves little unless reads overlap writes: each writer
+// waits for its reader, then keeps going (up to 20x) until the
+// reader has checked SNAP_MIN_READS snapshots
+static constexpr uint32_t SNAP_MIN_READS = 5000;
+
+static Seqlock<BenchSnap>      seqlock;
+static TripleBuffer<BenchSnap> triple;
+static std::atomic<bool>       writing{false}, reading{false};
+static std::atomic<uint32_t>   readsSoFar{0};
+static uint32_t                snapWrites = 0;
+
+static void waitForReader() {
+  while (!reading.load(std::memory_order_acquire)) benchYield();
+}
+
+static bool keepWriting(uint32_t i) {
+  if (i > SNAP_WRITES * 20) return false;
+  return i <= SNAP_WRITES || readsSoFar.load(std::memory_order_relaxed) < SNAP_MIN_READS;
+}
+
+static void seqlockWriter(void*) {
+  waitForReader();
+  uint32_t i = 1;
+  for (; keepWriting(i); ++i) seqlock.write(snapOf(i));
+  snapWrites = i - 1;
+  writing.store(false, std::memory_order_release);
+}
+
+// Yields now and then, so a reader sharing its core still runs
+static void tripleWriter(void*) {
+  waitForReader();
+  uint32_t i = 1;
+  for (; keepWriting(i); ++i) {
+    triple.back() = snapOf(i);
+    triple.publish();
+    if (!(i & 255)) benchYield();
+  }
+  snapWrites = i - 1;
+  writing.store(false, std::memory_order_release);
+}
+
+// Returns torn / backwards reads; `reads` gets the total
+static uint32_t seqlockRead(uint32_t& reads) {
+  uint32_t bad = 0, last = 0;
+  reads = 0;
+  reading.store(true, std::memory_order_release);
+  while (writing.load(std::memory_order_acquire)) {
+    BenchSnap s = seqlock.read();
+    if (snapTorn(s) || s.n < last) bad++;
+    last = s.n;
+    readsSoFar.store(++reads, std::memory_order_relaxed);
+  }
+  return bad;
+}
+
+static uint32_t tripleRead(uint32_t& reads) {
+  uint32_t bad = 0, last = 0;
+  reads = 0;
+  reading.store(true, std::memory_order_release);
+  while (writing.load(std::memory_order_acquire)) {
+    if (!triple.update()) { benchYield(); continue; }
+    const BenchSnap& s = triple.front();
+    if (snapTorn(s) || s.n < last) bad++;
+    last = s.n;
+    readsSoFar.store(++reads, std::memory_order_relaxed);
+  }
+  return bad;
+}
+
+// Both ends down to the starting line
+static void snapReset() {
+  writing.store(true);
+  reading.store(false);
+  readsSoFar.store(0);
+}
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+bool channelBenchmark() {
+  // --- SPSC ---
+  uint32_t t0 = benchUs();
+  if (!benchSpawn(spscProducer, nullptr)) { BENCH_LOG("[Channel] Can't start a producer\n"); return false; }
+  uint32_t spscBad = spscConsume();
+  benchJoin();
+  float spscUs = (float)(benchUs() - t0);
+
+  // --- MPSC ---
+  t0 = benchUs();
+  int producers = 0;
+  for (int p = 0; p < MPSC_PRODUCERS; ++p) {
+    mpscIds[p] = p;
+    producers += benchSpawn(mpscProducer, &mpscIds[p]);
+  }
+  uint32_t mpscBad = mpscConsume(producers);
+  benchJoin();
+  float mpscUs = (float)(benchUs() - t0);
+
+  // --- Seqlock ---
+  uint32_t seqReads = 0, triReads = 0;
+  seqlock.write(snapOf(0));
+  snapReset();
+  t0 = benchUs();
+  benchSpawn(seqlockWriter, nullptr);
+  uint32_t seqBad = seqlockRead(seqReads);
+  benchJoin();
+  float seqUs = (float)(benchUs() - t0);
+  uint32_t seqWrites = snapWrites;
+
+  // --- Triple buffer ---
+  snapReset();
+  t0 = benchUs();
+  benchSpawn(tripleWriter, nullptr);
+  uint32_t triBad = tripleRead(triReads);
+  benchJoin();
+  float triUs = (float)(benchUs() - t0);
+  uint32_t triWrites = snapWrites;
+
+  uint32_t bad = spscBad + mpscBad + seqBad + triBad;
+  bool few = seqReads < SNAP_MIN_READS || triReads < SNAP_MIN_READS;
+  BENCH_LOG("[Channel] %s; M items/s: spsc %.2f, mpsc x%d %.2f; M writes/s (reads): seqlock %.2f (%lu), "
+            "triple %.2f (%lu)\n",
+            bad ? "ERRORS" : few ? "TOO FEW READS" : "no lost, reordered or torn items",
+            SPSC_ITEMS / spscUs, producers, MPSC_ITEMS * producers / mpscUs,
+            seqWrites / seqUs, (unsigned long)seqReads, triWrites / triUs, (unsigned long)triReads);
+  if (bad)
+    BENCH_LOG("[Channel] spsc %lu, mpsc %lu, seqlock %lu, triple %lu bad\n", (unsigned long)spscBad,
+              (unsigned long)mpscBad, (unsigned long)seqBad, (unsigned long)triBad);
+  if (few)
+    BENCH_LOG("[Channel] Readers overlapped too little (need %lu reads each): proves nothing\n",
+              (unsigned long)SNAP_MIN_READS);
+  return !bad && !few;
+}
+
+#ifdef CHANNEL_BENCH_MAIN
+int main() {
+  return channelBenchmark() ? 0 : 1;
+}
+#endif
+
+// ======================= End of File =======================
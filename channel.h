@@ -0,0 +1,285 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  channel.h — Lock-Free Channels Between Tasks
+//
+//  The standard way for two tasks (or a task and an ISR) to
+//  hand data across: no mutex, no critical section, no heap.
+//
+//  Provides:
+//   • SpscRing<T, N>    — One producer, one consumer; wait-free.
+//                         Bulk slot()/commit() and peek()/consume()
+//                         for block data (audio), push()/pop()
+//                         for events
+//   • MpscQueue<T, N>   — Any number of producers, one consumer;
+//                         bounded, never blocks (push fails when full)
+//   • Seqlock<T>        — One writer publishes a snapshot; readers
+//                         retry instead of locking (stats, state)
+//   • TripleBuffer<T>   — One writer, one reader, always the latest
+//                         whole value; neither side ever waits
+//
+//  Notes:
+//   - Indices are free-running uint32_t; N is a power of two.
+//   - Only 32-bit atomics are used: they are lock-free on the
+//     LX7 (S32C1I compare-and-swap) as on the host.
+//   - T must be trivially copyable. Seqlock copies it as
+//     atomic 32-bit words (no fences, so ThreadSanitizer can
+//     follow it): a torn read is caught by the sequence check
+//     rather than being a data race.
+//   - A Seqlock reader spins while a write is in progress: keep
+//     the writer on the other core, or at a higher priority.
+//   - Host stress test + throughput bench: channel.cpp.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// Producer and consumer indices on separate cache lines on
+// the host; the S3's internal SRAM has no per-core cache, so
+// padding there would only cost RAM.
+#ifdef ARDUINO
+  #define CHANNEL_ALIGN alignas(4)
+#else
+  #define CHANNEL_ALIGN alignas(64)
+#endif
+
+// =========================================================
+//  SPSC RING
+// =========================================================
+template <typename T, uint32_t N>
+class SpscRing {
+  static_assert(N && !(N & (N - 1)), "SpscRing size must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value, "SpscRing needs a trivially copyable T");
+
+public:
+  static constexpr uint32_t CAPACITY = N;
+
+  // --- Producer side ---
+  uint32_t space() const {
+    return N - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+  }
+  // i-th free slot past the head (i < space()); visible to the
+  // consumer only after commit()
+  T& slot(uint32_t i) { return buf[(head.load(std::memory_order_relaxed) + i) & (N - 1)]; }
+  void commit(uint32_t n) {
+    head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+  }
+
+  bool push(const T& v) {
+    if (!space()) return false;
+    slot(0) = v;
+    commit(1);
+    return true;
+  }
+
+  // Returns how many were taken (the rest didn't fit)
+  uint32_t write(const T* src, uint32_t n) {
+    uint32_t room = space();
+    if (n > room) n = room;
+    for (uint32_t i = 0; i < n; ++i) slot(i) = src[i];
+    commit(n);
+    return n;
+  }
+
+  // --- Consumer side ---
+  uint32_t available() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+  }
+  // i-th queued item (i < available())
+  const T& peek(uint32_t i) const { return buf[(tail.load(std::memory_order_relaxed) + i) & (N - 1)]; }
+  void consume(uint32_t n) {
+    tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+  }
+
+  bool pop(T& out) {
+    if (!available()) return false;
+    out = peek(0);
+    consume(1);
+    return true;
+  }
+
+  uint32_t read(T* dst, uint32_t n) {
+    uint32_t have = available();
+    if (n > have) n = have;
+    for (uint32_t i = 0; i < n; ++i) dst[i] = peek(i);
+    consume(n);
+    return n;
+  }
+
+  // --- Either side ---
+  // A snapshot: exact on the producer's side, a lower bound on
+  // the consumer's
+  uint32_t size() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+private:
+  CHANNEL_ALIGN std::atomic<uint32_t> head{0};   // written by the producer
+  CHANNEL_ALIGN std::atomic<uint32_t> tail{0};   // written by the consumer
+  T buf[N];
+};
+
+
+// =========================================================
+//  MPSC QUEUE
+// =========================================================
+// Bounded array queue with a sequence number per cell
+// (Vyukov): producers claim a cell with one CAS on the head,
+// fill it, then publish it by bumping its sequence. The
+// consumer owns the tail outright.
+template <typename T, uint32_t N>
+class MpscQueue {
+  static_assert(N >= 2 && !(N & (N - 1)), "MpscQueue size must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value, "MpscQueue needs a trivially copyable T");
+
+public:
+  static constexpr uint32_t CAPACITY = N;
+
+  MpscQueue() {
+    for (uint32_t i = 0; i < N; ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  // --- Producers (any task or ISR) ---
+  bool push(const T& v) {
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    Cell* c;
+    for (;;) {
+      c = &cells[pos & (N - 1)];
+      int32_t dif = (int32_t)(c->seq.load(std::memory_order_acquire) - pos);
+      if (dif == 0) {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0) {
+        return false;                                   // full
+      } else {
+        pos = head.load(std::memory_order_relaxed);     // another producer won
+      }
+    }
+    c->value = v;
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // --- Consumer ---
+  bool pop(T& out) {
+    Cell& c = cells[tail & (N - 1)];
+    if ((int32_t)(c.seq.load(std::memory_order_acquire) - (tail + 1)) < 0) return false;
+    out = c.value;
+    c.seq.store(tail + N, std::memory_order_release);
+    tail++;
+    return true;
+  }
+
+  // Claimed by producers but not yet popped (approximate)
+  uint32_t size() const { return head.load(std::memory_order_relaxed) - tail; }
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    T value;
+  };
+  CHANNEL_ALIGN std::atomic<uint32_t> head{0};
+  CHANNEL_ALIGN uint32_t tail = 0;                      // consumer only
+  Cell cells[N];
+};
+
+
+// =========================================================
+//  SEQLOCK
+// =========================================================
+// Odd sequence = write in progress. A reader copies the words
+// out and keeps the copy only if the sequence was even and
+// unchanged across it.
+template <typename T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "Seqlock needs a trivially copyable T");
+  static constexpr uint32_t WORDS = (sizeof(T) + 3) / 4;
+
+public:
+  Seqlock() { write(T()); }
+
+  // --- Writer (one) ---
+  void write(const T& v) {
+    uint32_t tmp[WORDS] = {};
+    memcpy(tmp, &v, sizeof(T));
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    // Release per word: a reader that sees any of them also
+    // sees the odd sequence before it
+    for (uint32_t i = 0; i < WORDS; ++i) words[i].store(tmp[i], std::memory_order_release);
+    seq.store(s + 2, std::memory_order_release);
+  }
+
+  // --- Readers (any number) ---
+  // One attempt; false if a write overlapped it
+  bool tryRead(T& out) const {
+    uint32_t tmp[WORDS];
+    uint32_t s0 = seq.load(std::memory_order_acquire);
+    if (s0 & 1) return false;
+    for (uint32_t i = 0; i < WORDS; ++i) tmp[i] = words[i].load(std::memory_order_acquire);
+    if (seq.load(std::memory_order_relaxed) != s0) return false;
+    memcpy(&out, tmp, sizeof(T));
+    return true;
+  }
+
+  T read() const {
+    T out;
+    while (!tryRead(out)) {}
+    return out;
+  }
+
+  // Bumps by 2 per write: readers can tell a fresh snapshot
+  uint32_t version() const { return seq.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<uint32_t> seq{0};
+  std::atomic<uint32_t> words[WORDS];
+};
+
+
+// =========================================================
+//  TRIPLE BUFFER
+// =========================================================
+// Three copies: the writer's back, the reader's front, and a
+// middle one swapped with either side in a single exchange.
+// The middle's index and a "fresh" bit share one atomic word.
+template <typename T>
+class TripleBuffer {
+  static constexpr uint32_t FRESH = 0x4;
+
+public:
+  // --- Writer ---
+  T& back() { return buf[backIdx]; }
+  void publish() {
+    backIdx = mid.exchange(backIdx | FRESH, std::memory_order_acq_rel) & 3;
+  }
+
+  // --- Reader ---
+  // Picks up the newest published value, if any; front() stays
+  // valid until the next update()
+  bool update() {
+    if (!(mid.load(std::memory_order_relaxed) & FRESH)) return false;
+    frontIdx = mid.exchange(frontIdx, std::memory_order_acq_rel) & 3;
+    return true;
+  }
+  const T& front() const { return buf[frontIdx]; }
+
+private:
+  T buf[3] = {};
+  CHANNEL_ALIGN uint32_t backIdx = 0;                   // writer only
+  CHANNEL_ALIGN std::atomic<uint32_t> mid{1};
+  CHANNEL_ALIGN uint32_t frontIdx = 2;                  // reader only
+};
+
+// =========================================================
+//  BENCHMARK (channel.cpp)
+// =========================================================
+// Cross-core stress + throughput of all four; any lost,
+// duplicated, reordered or torn item is reported. False on
+// errors, or if a reader overlapped its writer too little.
+bool channelBenchmark();
+
+// ======================= End of File =======================
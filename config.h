@@ -17,6 +17,12 @@
    • Debug:        Toggle Serial + on-screen output per feature-group
    • IO Pins:      TFT, SD, LED, Buttons, Encoders
    • Input:        Deadzones and repeat timing live here too
+   • Emulation:    ROM folder, benchmark length, scanout, rewind
+   • Audio:        I2S pins, sample rate, rate-control tuning
+   • Homebrew:     Fantasy-console screen, layers, SFX voices, Lua carts
+   • Resume:       Quick-resume record file and boot splash timeout
+   • Gallery:      Media folder, video read-ahead and A/V sync, GIF cache
+   • Text:         UTF-8 font file on SD, glyph page + glyph caches
 
    Notes:
    - If using FreeFonts / smooth fonts, load them in your sketch and
@@ -38,7 +44,9 @@
 #define LED_PIN    4
 #define BTN_PIN    5
 
-// TFT rotation (0–3). HORIZONTAL layout looks best with 3 or 1.
+// TFT rotation (0–3) at boot; Settings → Rotation turns the menus
+// at runtime (display.h). Keep it landscape (3 or 1): apps draw
+// landscape regardless.
 #define SCREEN_ROTATION 3
 
 
@@ -60,6 +68,7 @@ namespace Debug {
   // --- Master Switches ---
   static constexpr bool SERIAL_EN = true;   // Enable Serial output
   static constexpr bool ONSCREEN  = false;  // Tiny corner overlay (FPS/logs)
+  static constexpr bool BENCHMARKS = false; // Gallery SELECT+confirm runs the benchmarks
 
   // --- Feature Group Flags ---
   // Enable/disable verbose logs for subsystems
@@ -67,6 +76,18 @@ namespace Debug {
   static constexpr bool INPUT_LOGS   = false;  // Button / axis states
   static constexpr bool GAMEPAD_LOGS = true;   // Controller connect/pair
   static constexpr bool SD_LOGS      = true;   // SD mount/listing
+  static constexpr bool EMU_LOGS     = true;   // ROM load / FPS / benchmark
+  static constexpr bool AUDIO_LOGS   = true;   // I2S init
+  static constexpr bool FCON_LOGS    = true;   // Homebrew runtime / benchmark
+  static constexpr bool LUA_LOGS     = true;   // Lua carts: load / GC pauses / errors
+  static constexpr bool RESUME_LOGS  = true;   // Quick-resume record / boot timing
+  static constexpr bool VIDEO_LOGS   = true;   // Gallery video: FPS / drops
+  static constexpr bool GIF_LOGS     = true;   // Gallery GIFs: changed area / CPU
+  static constexpr bool TEXT_LOGS    = true;   // UTF-8 glyph pages loaded from SD
+  static constexpr bool SPLIT_LOGS   = true;   // Dual-core frames: utilization / speedup
+  static constexpr bool CHANNEL_LOGS = true;   // Lock-free channel stress / benchmark
+  static constexpr bool CORO_LOGS    = true;   // Coroutine frame pool exhaustion
+  static constexpr bool SYSMON_LOGS  = true;   // Task CPU% / stack table + warnings
 }
 
 // Debug macro — clean conditional wrapper for group logs
@@ -86,7 +107,26 @@ enum class MenuOrientation : uint8_t { HORIZONTAL, VERTICAL };
 static constexpr MenuOrientation MENU_ORIENTATION_DEFAULT = MenuOrientation::HORIZONTAL;
 
 // --- Icons ---
-static constexpr bool MENU_SHOW_ICONS_DEFAULT = false;
+// Vector icons (icons.h) are rasterized once per size into a
+// PSRAM cache; tint comes from the theme at draw time.
+static constexpr bool     MENU_SHOW_ICONS_DEFAULT = false;
+static constexpr uint16_t ICON_MAX_PX             = 96;   // Largest icon size served
+static constexpr uint8_t  ICON_CACHE_SLOTS        = 24;   // Masks kept (LRU)
+
+// --- Wallpaper ---
+// Optional JPEG behind every menu (Settings → Wallpaper),
+// decoded once into PSRAM. Each frame only the rectangles
+// drawn last frame are restored from it (MENU_DAMAGE_RECTS;
+// past that the page is repainted whole).
+#define WALLPAPER_PATH "/wallpaper.jpg"
+static constexpr uint32_t WALLPAPER_MAX_KB  = 512;  // Largest JPEG accepted
+static constexpr uint8_t  MENU_DAMAGE_RECTS = 64;
+
+// --- Frame memory ---
+// Per-frame temporaries (value text) come from a bump arena
+// reset after each present; menus nest at most this deep.
+static constexpr size_t  MENU_FRAME_ARENA = 1024;   // Bytes, internal SRAM
+static constexpr uint8_t MENU_STACK_DEPTH = 8;
 
 // --- Fonts ---
 // TFT_eSPI built-in IDs; replace with custom IDs if loading FreeFonts.
@@ -100,6 +140,7 @@ static constexpr int16_t MENU_MARGIN_T        = 10;
 static constexpr int16_t MENU_MARGIN_B        = 10;
 static constexpr int16_t MENU_ROW_H           = 36;
 static constexpr int16_t MENU_ICON_PAD        = 8;
+static constexpr int16_t MENU_ICON_SIZE       = 48;   // Vector icons, carousel
 static constexpr int16_t MENU_TEXT_PAD        = 10;
 static constexpr int16_t MENU_SELECTOR_RADIUS = 8;
 static constexpr int16_t MENU_SELECTOR_BORDER = 2;
@@ -147,6 +188,24 @@ static constexpr uint16_t  REPEAT_HOLD_MS     = 220;  // Slow hold rate
 static constexpr uint16_t  REPEAT_FAST_MS     = 120;  // Fast hold rate
 static constexpr uint16_t  REPEAT_AFTER_MS    = 800;  // Threshold for fast repeat
 
+// --- Timers ---
+// Every UI timeout (repeat, input lock, blink, autosave, pairing)
+// is a timerwheel.h timer; between them the menu loop sleeps,
+// waking at least every MENU_IDLE_POLL_MS to read input.
+static constexpr uint16_t  TIMER_SLOTS        = 32;   // Timers pending at once
+static constexpr uint16_t  MENU_BLINK_MS      = 300;  // Edited value blink
+static constexpr uint16_t  MENU_AUTOSAVE_MS   = 300;  // Save once a value settles
+static constexpr uint16_t  MENU_IDLE_POLL_MS  = 10;   // Longest menu-loop sleep
+
+// --- Flows ---
+// UI flows (boot settings load, power menu) are coro.h
+// coroutines; frames come from a fixed pool, coIo() jobs run
+// on a core-0 task.
+static constexpr uint8_t   CORO_FRAMES        = 6;     // Flows + awaited steps alive at once
+static constexpr uint16_t  CORO_FRAME_BYTES   = 384;   // Largest frame accepted
+static constexpr uint32_t  CORO_IO_QUEUE      = 4;     // Pending coIo() jobs (power of 2)
+static constexpr uint32_t  CORO_IO_STACK      = 6144;  // I/O task (SD + JSON)
+
 
 // ============================================================
 //  GAMEPAD (Bluepad32) PAIRING + LED FEEDBACK
@@ -157,6 +216,171 @@ static constexpr uint16_t  REPEAT_AFTER_MS    = 800;  // Threshold for fast repe
 #define DEBOUNCE_MS      50
 
 
+// ============================================================
+//  EMULATION (Game Library)
+// ============================================================
+// ROMs are listed from this folder (*.nes). Battery saves are
+// written next to the ROM as <name>.sav.
+#define ROM_DIR "/roms"
+
+static constexpr uint16_t EMU_BENCH_FRAMES = 600;   // Headless benchmark length
+
+// Flash ROM store: ROMs are copied once into this partition and
+// mapped in place afterwards (needs partitions/rowboy_16MB.csv).
+static constexpr bool    EMU_FLASH_ROMS   = true;
+#define ROMSTORE_LABEL   "roms"
+#define ROMSTORE_SUBTYPE 0x40
+static constexpr uint32_t EMU_FRAME_US     = 16639; // NTSC 60.0988 Hz
+
+// Scanout: lines go straight to the panel over DMA, no framebuffer.
+// Scale-to-fit stretches 256x240 → 341x320; off = 1:1 centered.
+static constexpr bool    EMU_SCALE_TO_FIT    = true;
+static constexpr uint8_t SCANOUT_BLOCK_LINES = 16;  // Lines per DMA block
+static constexpr uint8_t SCANOUT_RING_BLOCKS = 2;   // Blocks in flight / filling
+
+// Rewind (hold Y): a snapshot every REWIND_INTERVAL frames, kept
+// as compressed XOR deltas in a PSRAM ring.
+static constexpr bool     EMU_REWIND       = true;
+static constexpr uint8_t  REWIND_INTERVAL  = 4;     // Frames per snapshot
+static constexpr uint32_t REWIND_RING_KB   = 2048;  // PSRAM for history
+static constexpr uint16_t REWIND_MAX_SNAPS = 4096;  // Index entries
+
+// Cached interpreter: 6502 blocks are translated once into this
+// much internal RAM (0 = plain interpreter).
+static constexpr uint32_t EMU_CODE_CACHE_KB = 48;
+
+// Quick-resume: a save state is left next to the ROM on exit
+// (<name>.rsm) and restored when resuming at boot.
+static constexpr bool     EMU_RESUME_STATE  = true;
+
+
+// ============================================================
+//  SPLIT-FRAME RENDERING (split.h)
+// ============================================================
+// CPU-bound frames (menu fades, GIF composition) draw half their
+// bands on a core-0 worker; the first half is pushed while the
+// second is drawn.
+static constexpr uint32_t SPLIT_TASK_STACK = 3072;
+static constexpr uint8_t  SPLIT_TASK_PRIO  = 3;     // Above the MJPEG decoder, below audio
+
+
+// ============================================================
+//  AUDIO (PCM5102 over I2S)
+// ============================================================
+#define AUDIO_MCK_PIN    16   // PCM5102 SCK; -1 if tied to GND
+#define AUDIO_BCK_PIN    15
+#define AUDIO_WS_PIN     6
+#define AUDIO_DOUT_PIN   7
+
+static constexpr uint32_t AUDIO_SAMPLE_RATE  = 44100;
+static constexpr uint16_t AUDIO_RING_SAMPLES = 4096;  // Power of two (~93 ms)
+static constexpr uint16_t AUDIO_CHUNK        = 256;   // Samples per I2S write
+
+// Rate control: emulation follows the audio queue level.
+static constexpr float   SYNC_FILL_TARGET = 0.50f;   // Queue level to hold
+static constexpr float   SYNC_RATE_MAX    = 0.005f;  // ±0.5% resample nudge
+static constexpr float   SYNC_SKIP_BELOW  = 0.25f;   // Start frameskip
+static constexpr float   SYNC_SKIP_RESUME = 0.40f;   // Stop frameskip
+static constexpr uint8_t SYNC_MAX_SKIP    = 3;       // Max consecutive skips
+
+
+// ============================================================
+//  HOMEBREW (Fantasy Console)
+// ============================================================
+// Fixed 240x160 indexed screen (2x on the 480x320 panel): a
+// scrolling tilemap, a draw layer and 8x8 sprites, composed per
+// scanline straight into the scanout DMA path.
+static constexpr int16_t  FCON_W        = 240;
+static constexpr int16_t  FCON_H        = 160;
+static constexpr uint8_t  FCON_MAP_W    = 32;     // Tiles, power of two
+static constexpr uint8_t  FCON_MAP_H    = 32;     // Tiles, power of two
+static constexpr uint8_t  FCON_SPRITES  = 64;
+static constexpr uint32_t FCON_FRAME_US = 16667;  // Fixed 60 Hz update
+static constexpr uint16_t FCON_BENCH_FRAMES = 300;
+
+// 3D (r3d.h): triangles are binned to bands of R3D_BAND rows,
+// each filled in an internal-SRAM strip (+ 16-bit depth).
+static constexpr uint16_t R3D_MAX_TRIS  = 2048;   // Display list per frame (PSRAM, ~48 B each)
+static constexpr uint16_t R3D_MAX_VERTS = 1024;   // Largest r3dMesh()
+static constexpr uint8_t  R3D_BAND      = 16;     // Rows per strip
+static constexpr int16_t  R3D_MAX_W     = FCON_W; // Widest target
+
+// SFX mixer: band-limited voices shared by homebrew carts.
+static constexpr uint8_t  SFX_VOICES    = 4;
+
+// Lua carts: *.lua in HOMEBREW_DIR. Compiled chunks are cached
+// as LUA_CACHE_DIR/<source hash>.luac.
+#define HOMEBREW_DIR  "/homebrew"
+#define LUA_CACHE_DIR "/homebrew/.luac"
+static constexpr uint32_t LUA_ARENA_KB      = 512;   // PSRAM per running script
+static constexpr uint32_t LUA_GC_BUDGET_US  = 1000;  // Max collector time per frame
+static constexpr uint8_t  LUA_GC_STEP_KB    = 1;     // Work per step between clock checks
+static constexpr uint16_t LUA_GC_PAUSE      = 200;   // Heap growth (%) before a new cycle
+static constexpr uint32_t LUA_CALL_LIMIT_MS = 250;   // Longest single script callback
+static constexpr uint16_t LUA_HOOK_COUNT    = 1000;  // VM instructions per watchdog check
+static constexpr uint8_t  LUA_BENCH_LOADS   = 20;    // Loads per benchmark pass
+
+
+// ============================================================
+//  QUICK RESUME
+// ============================================================
+// The last app launched is kept in RESUME_FILE. At boot a splash
+// offers it; the restore runs on core 0 while setup() carries on.
+#define RESUME_FILE "/resume.json"
+static constexpr bool     RESUME_ENABLED    = true;
+static constexpr uint32_t RESUME_SPLASH_MS  = 2500;  // Auto-resume after; B = home
+static constexpr uint32_t RESUME_TASK_STACK = 8192;  // Restore task (SD + ROM mapping)
+
+
+// ============================================================
+//  GALLERY (Video + GIF)
+// ============================================================
+// Media is listed from this folder. Videos are AVI files with
+// MJPEG frames and optional PCM audio; frames are pushed with
+// the scanout block size (SCANOUT_BLOCK_LINES).
+#define GALLERY_DIR "/gallery"
+static constexpr uint8_t  VIDEO_SLOTS       = 4;      // Compressed frames read ahead
+static constexpr uint32_t VIDEO_SLOT_KB     = 96;     // Largest JPEG frame accepted
+static constexpr uint32_t VIDEO_AUDIO_STAGE = 65536;  // Staged PCM samples (power of two)
+static constexpr uint32_t VIDEO_AUDIO_CHUNK = 4096;   // Bytes per audio read
+static constexpr uint32_t VIDEO_AV_SLACK_MS = 80;     // A/V drift before audio resyncs
+static constexpr uint32_t VIDEO_JPEG_POOL   = 4096;   // TJpgDec work area (≥ 3100)
+static constexpr uint8_t  VIDEO_DITHER      = 1;      // 0 = truncate, 1 = ordered, 2 = Floyd–Steinberg
+
+// GIFs are read into PSRAM whole. If every frame of the first
+// loop fits GIF_CACHE_KB, later loops replay the pushed
+// rectangles without decoding (0 = always decode).
+static constexpr uint32_t GIF_MAX_KB        = 4096;   // Largest GIF file accepted
+static constexpr uint32_t GIF_CACHE_KB      = 1024;   // Decoded-frame cache (PSRAM)
+static constexpr uint32_t GIF_CANVAS_KB     = 2048;   // Largest logical screen (RGB565, PSRAM)
+
+
+// ============================================================
+//  TEXT (UTF-8 labels)
+// ============================================================
+// Non-ASCII labels (file names, titles) are drawn from a GNU
+// Unifont .hex file on SD, paged in on first use. ASCII keeps
+// the built-in fonts. Both caches live in PSRAM.
+#define TEXT_FONT_PATH "/fonts/unifont.hex"
+static constexpr uint8_t  TEXT_PAGE_SLOTS   = 12;     // 256-code-point pages (~8.5 KB each)
+static constexpr uint16_t TEXT_GLYPH_SLOTS  = 384;    // Scaled glyphs kept (LRU)
+static constexpr uint8_t  TEXT_GLYPH_MAX_PX = 32;     // Tallest font height served
+
+
+// ============================================================
+//  SYSTEM MONITOR (sysmon.h)
+// ============================================================
+// Per-task CPU% and stack high-water marks, sampled on a
+// low-priority task; shown in the corner overlay
+// (Debug::ONSCREEN) and as a Serial table (SYSMON_LOGS).
+static constexpr uint32_t SYSMON_PERIOD_MS     = 2000;   // Sample span
+static constexpr uint32_t SYSMON_REPORT_MS     = 10000;  // Serial task table
+static constexpr uint32_t SYSMON_STACK_WARN    = 512;    // Bytes left: warn
+static constexpr uint8_t  SYSMON_IDLE_WARN_PCT = 5;      // Core idle below: warn (TWDT risk)
+static constexpr uint32_t SYSMON_TASK_STACK    = 3072;
+static constexpr uint8_t  SYSMON_TASK_PRIO     = 1;      // Just above idle
+
+
 // ============================================================
 //  OPTIONAL MECHANICAL INPUTS
 // ============================================================
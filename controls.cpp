@@ -38,6 +38,7 @@ void InputMapper::update(InputMode mode) {
   _s = ControlState{};
   _s.confirmLast = prevConfirm;
   _s.backLast    = prevBack;
+  _mode = mode;
 
   switch (mode) {
     case InputMode::GAMEPAD: _readGamepad(); break;
@@ -79,6 +80,11 @@ void InputMapper::_readGamepad() {
   _s.alt     = btnState(_map.alt);
   _s.start   = gpStart();
   _s.select  = gpSelect();
+
+  _s.a = gpA();
+  _s.b = gpB();
+  _s.x = gpX();
+  _s.y = gpY();
 }
 
 
@@ -90,8 +96,8 @@ void InputMapper::_readGamepad() {
 void InputMapper::_readMechanical() {
   if (MENU_BTN_UP_PIN     >= 0) _s.up      = (digitalRead(MENU_BTN_UP_PIN)     == LOW);
   if (MENU_BTN_DOWN_PIN   >= 0) _s.down    = (digitalRead(MENU_BTN_DOWN_PIN)   == LOW);
-  if (MENU_BTN_OK_PIN     >= 0) _s.confirm = (digitalRead(MENU_BTN_OK_PIN)     == LOW);
-  if (MENU_BTN_BACK_PIN   >= 0) _s.back    = (digitalRead(MENU_BTN_BACK_PIN)   == LOW);
+  if (MENU_BTN_OK_PIN     >= 0) _s.confirm = _s.a = (digitalRead(MENU_BTN_OK_PIN)   == LOW);
+  if (MENU_BTN_BACK_PIN   >= 0) _s.back    = _s.b = (digitalRead(MENU_BTN_BACK_PIN) == LOW);
   if (MENU_BTN_START_PIN  >= 0) _s.start   = (digitalRead(MENU_BTN_START_PIN)  == LOW);
   if (MENU_BTN_SELECT_PIN >= 0) _s.select  = (digitalRead(MENU_BTN_SELECT_PIN) == LOW);
 
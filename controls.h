@@ -34,6 +34,7 @@ public:
     bool up = false, down = false, left = false, right = false;
     bool confirm = false, back = false, menu = false, alt = false;
     bool start = false, select = false;
+    bool a = false, b = false, x = false, y = false;  // raw face buttons (games)
 
     // Edge tracking & consumption flags
     bool confirmLast = false, backLast = false;
@@ -55,6 +56,10 @@ public:
   // ---------------------------------------------------------
   void update(InputMode mode);
 
+  // Mode of the last update(); apps launched from a menu keep
+  // reading the source that menu was set to
+  InputMode mode() const { return _mode; }
+
   // ---------------------------------------------------------
   // State Accessors
   // ---------------------------------------------------------
@@ -65,6 +70,12 @@ public:
   bool start() const  { return _s.start; }
   bool select() const { return _s.select; }
 
+  // Raw face buttons, unaffected by rebinding (used by emulators)
+  bool a() const      { return _s.a; }
+  bool b() const      { return _s.b; }
+  bool x() const      { return _s.x; }
+  bool y() const      { return _s.y; }
+
   // ---------------------------------------------------------
   // Edge-detect helpers (trigger once on press)
   // ---------------------------------------------------------
@@ -89,6 +100,7 @@ public:
 
 private:
   mutable ControlState _s;
+  InputMode _mode = InputMode::GAMEPAD;
   struct Mapping {
     ButtonID confirm;
     ButtonID back;
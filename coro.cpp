@@ -0,0 +1,256 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  coro.cpp — Coroutine Scheduler, Frame Pool, I/O Task
+//
+//  Scheduling:
+//   - Anything that becomes ready (timer fired, input edge,
+//     I/O done, frame tick) goes on one ready ring; coRun()
+//     resumes the ring in order. Nothing resumes a coroutine
+//     from inside a timer callback or another task.
+//   - coIo() jobs queue to a core-0 task through an SpscRing;
+//     results come back through another, read by coRun().
+//
+//  Host heap-free check:
+//    g++ -std=c++20 -O2 -DCORO_BENCH_MAIN -x c++ coro.cpp timerwheel.cpp -o coro_bench
+//  replaces malloc with a counting wrapper and runs flows that
+//  spawn, nest, await frames, input edges and I/O jobs; it
+//  fails unless none of it touched the heap.
+// =========================================================
+
+#include "coro.h"
+#include "arena.h"
+#include "channel.h"
+
+#ifdef ARDUINO
+  #include "config.h"
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+#else
+  #include <stdio.h>
+  static constexpr uint8_t  CORO_FRAMES      = 6;
+  static constexpr uint16_t CORO_FRAME_BYTES = 384;
+  static constexpr uint32_t CORO_IO_QUEUE    = 4;
+  #define DBG_IF(grp, ...) printf(__VA_ARGS__)
+#endif
+
+// =========================================================
+//  FRAME POOL
+// =========================================================
+struct alignas(8) FrameBlock { uint8_t bytes[CORO_FRAME_BYTES]; };
+
+static Pool<FrameBlock, CORO_FRAMES> frames;
+static CoStats stats = {};
+
+void* coFrameAlloc(size_t bytes) {
+  if (bytes > stats.largest) stats.largest = (uint16_t)bytes;
+  FrameBlock* f = bytes <= sizeof(FrameBlock) ? frames.make() : nullptr;
+  if (!f) {
+    stats.failed++;
+    DBG_IF(CORO, "[Coro] No frame for %u B (%u of %u in use, %u B each)\n", (unsigned)bytes,
+           (unsigned)frames.inUse(), (unsigned)CORO_FRAMES, (unsigned)sizeof(FrameBlock));
+    return nullptr;
+  }
+  stats.live = frames.inUse();
+  if (stats.live > stats.peak) stats.peak = stats.live;
+  return f;
+}
+
+void coFrameFree(void* p) {
+  frames.destroy((FrameBlock*)p);
+  stats.live = frames.inUse();
+}
+
+
+// =========================================================
+//  READY RING + WAIT LISTS
+// =========================================================
+// A coroutine waits on one thing at a time, so one entry per
+// frame is enough
+static std::coroutine_handle<> ready[CORO_FRAMES];
+static uint8_t  readyHead = 0, readyCount = 0;
+static CoWait*  frameWaiters = nullptr;
+static CoWait*  inputWaiters = nullptr;
+
+static void makeReady(std::coroutine_handle<> h) {
+  ready[(readyHead + readyCount) % CORO_FRAMES] = h;
+  readyCount++;
+}
+
+static void wakeTimer(void* ctx) { makeReady(((CoWait*)ctx)->h); }
+
+void CoFrame::await_suspend(std::coroutine_handle<> c) noexcept {
+  h = c;
+  next = frameWaiters;
+  frameWaiters = this;
+}
+
+bool CoSleep::await_suspend(std::coroutine_handle<> c) noexcept {
+  h = c;
+  timer = timerAfter(ms, wakeTimer, this);
+  return timer != 0;
+}
+
+// Edge, not level: a button still held from the menu press
+// that started the flow doesn't count
+void CoInput::await_suspend(std::coroutine_handle<> c) noexcept {
+  h = c;
+  was = pred();
+  next = inputWaiters;
+  inputWaiters = this;
+}
+
+
+// =========================================================
+//  I/O TASK
+// =========================================================
+static SpscRing<CoIo*, CORO_IO_QUEUE> ioRequests;   // loop task → I/O task
+static SpscRing<CoIo*, CORO_IO_QUEUE> ioDone;       // I/O task → loop task
+
+#ifdef ARDUINO
+static TaskHandle_t ioTask = nullptr;
+
+static void ioTaskMain(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    CoIo* r;
+    while (ioRequests.pop(r)) {
+      r->result = r->fn(r->ctx);
+      while (!ioDone.push(r)) vTaskDelay(1);   // at most one per waiting flow
+    }
+  }
+}
+#endif
+
+bool CoIo::await_suspend(std::coroutine_handle<> c) noexcept {
+  h = c;
+  stats.ioJobs++;
+#ifdef ARDUINO
+  if (!ioTask &&
+      xTaskCreatePinnedToCore(ioTaskMain, "coio", CORO_IO_STACK, nullptr, 1, &ioTask, 0) != pdPASS)
+    ioTask = nullptr;
+  if (ioTask && ioRequests.push(this)) {
+    xTaskNotifyGive(ioTask);
+    return true;
+  }
+  result = fn(ctx);   // no task / queue full: run it here
+  return false;
+#else
+  // Host: no I/O task, but completion still goes the device's way
+  result = fn(ctx);
+  ioDone.push(this);
+  return true;
+#endif
+}
+
+
+// =========================================================
+//  SPAWN / RUN
+// =========================================================
+bool coSpawn(CoTask&& t) {
+  if (!t._h) return false;   // coFrameAlloc() logged it
+  auto h = t._h;
+  t._h = nullptr;
+  h.promise().detached = true;
+  stats.spawned++;
+  h.resume();
+  return true;
+}
+
+void coRun() {
+  CoIo* io;
+  while (ioDone.pop(io)) makeReady(io->h);
+
+  for (CoWait** pp = &inputWaiters; *pp; ) {
+    CoInput* w = (CoInput*)*pp;
+    bool now = w->pred();
+    if (now && !w->was) { *pp = w->next; makeReady(w->h); }
+    else                { w->was = now; pp = &w->next; }
+  }
+
+  // Frame tick: whoever waited before this pass
+  for (CoWait* w = frameWaiters, *n; w; w = n) {
+    n = w->next;
+    makeReady(w->h);
+  }
+  frameWaiters = nullptr;
+
+  while (readyCount) {
+    std::coroutine_handle<> h = ready[readyHead];
+    readyHead = (readyHead + 1) % CORO_FRAMES;
+    readyCount--;
+    h.resume();
+  }
+}
+
+CoStats coStats() { return stats; }
+
+
+// =========================================================
+//  HOST HEAP-FREE CHECK
+// =========================================================
+#ifdef CORO_BENCH_MAIN
+#include <stdlib.h>
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void  __libc_free(void*);
+
+static size_t heapCalls = 0;
+
+extern "C" void* malloc(size_t n)            { heapCalls++; return __libc_malloc(n); }
+extern "C" void* calloc(size_t n, size_t s)  { heapCalls++; return __libc_calloc(n, s); }
+extern "C" void* realloc(void* p, size_t n)  { heapCalls++; return __libc_realloc(p, n); }
+extern "C" void  free(void* p)               { __libc_free(p); }
+
+static uint32_t pass = 0;
+static uint32_t steps = 0, ioSeen = 0, bad = 0;
+
+static bool buttonDown() { return (pass & 7) == 5; }   // pressed one pass in 8
+static bool ioJob(void* ctx) { return *(uint32_t*)ctx & 1; }
+
+// A child step: a couple of frames
+static CoTask settle(uint32_t n) {
+  for (uint32_t i = 0; i < n; ++i) co_await coFrame();
+  steps++;
+}
+
+// What a UI flow does: wait for a press, do I/O, wait frames
+static CoTask flow(uint32_t id, uint32_t rounds) {
+  for (uint32_t r = 0; r < rounds; ++r) {
+    co_await coInput(buttonDown);
+    if (!buttonDown()) bad++;
+    uint32_t v = id + r;
+    bool odd = co_await coIo(ioJob, &v);
+    if (odd != (bool)(v & 1)) bad++;
+    ioSeen++;
+    co_await settle(2);
+  }
+}
+
+int main() {
+  static constexpr uint32_t ROUNDS = 20000, FLOWS = 3;
+
+  // Warm-up: one full flow, so lazy runtime setup isn't counted
+  coSpawn(flow(99, 1));
+  while (coStats().live) { pass++; coRun(); }
+
+  size_t before = heapCalls;
+  for (uint32_t f = 0; f < FLOWS; ++f) coSpawn(flow(f, ROUNDS));
+  uint32_t passes = 0;
+  while (coStats().live) { pass++; passes++; coRun(); }
+  size_t calls = heapCalls - before;
+
+  CoStats s = coStats();
+  bool ok = !calls && !bad && steps == FLOWS * ROUNDS + 1 && !s.failed;
+  printf("[Coro] %s: %zu heap allocations over %u flows x %u rounds (%u passes, %u I/O jobs); "
+         "frames peak %u of %u, largest %u of %u B\n",
+         ok ? "ok" : "FAIL", calls, (unsigned)FLOWS, (unsigned)ROUNDS, (unsigned)passes,
+         (unsigned)ioSeen, (unsigned)s.peak, (unsigned)CORO_FRAMES, (unsigned)s.largest,
+         (unsigned)sizeof(FrameBlock));
+  return ok ? 0 : 1;
+}
+#endif
+
+// ======================= End of File =======================
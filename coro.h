@@ -0,0 +1,174 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  coro.h — Coroutine Flows on the UI Task (Header)
+//
+//  A UI flow that waits on the user or on I/O reads top to
+//  bottom as one C++20 coroutine instead of a state machine
+//  spread over loop().
+//
+//  Provides:
+//   • CoTask         — Coroutine type; co_await one to run it
+//                      as a step of the caller
+//   • coSpawn()      — Start a flow; it runs until its first
+//                      await, then coRun() resumes it
+//   • coRun()        — Resume whatever is ready (loop task,
+//                      once per loop, after timerPoll())
+//   • Awaitables:
+//       co_await coFrame()         — Next loop pass
+//       co_await coSleep(ms)       — Timer wheel (timerwheel.h)
+//       co_await coInput(pred)     — pred() goes false → true
+//       co_await coIo(fn, ctx)     — bool fn(ctx) on the I/O
+//                                    task (core 0); returns it
+//
+//  Notes:
+//   - Frames come from a fixed pool (CORO_FRAMES of
+//     CORO_FRAME_BYTES), never the heap; awaiting allocates
+//     nothing. No free frame: coSpawn() fails and logs.
+//   - Waits are cooperative: every resume happens in coRun()
+//     on the loop task, so a flow can touch menus and the panel.
+//   - coIo() jobs run while the flow is suspended: one touching
+//     SD must not overlap panel drawing (shared SPI bus), so
+//     the flow keeps the menus paused until it completes.
+//   - Flows run to completion; there is no cancel.
+//   - Host heap-free check: coro.cpp.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <coroutine>
+#include "timerwheel.h"
+
+// =========================================================
+//  FRAME POOL
+// =========================================================
+void* coFrameAlloc(size_t bytes);   // nullptr if too big / none free
+void  coFrameFree(void* p);
+
+
+// =========================================================
+//  TASK
+// =========================================================
+class CoTask {
+public:
+  struct promise_type {
+    std::coroutine_handle<> cont;   // awaiting parent
+    bool detached = false;          // spawned: frees itself at the end
+
+    static void* operator new(size_t n) noexcept { return coFrameAlloc(n); }
+    static void  operator delete(void* p) noexcept { coFrameFree(p); }
+    static CoTask get_return_object_on_allocation_failure() { return CoTask(); }
+
+    CoTask get_return_object() {
+      return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct Final {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+        promise_type& p = h.promise();
+        if (p.cont) return p.cont;
+        if (p.detached) h.destroy();
+        return std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+    Final final_suspend() noexcept { return {}; }
+
+    void return_void() {}
+    void unhandled_exception() {}
+  };
+
+  CoTask() = default;
+  CoTask(CoTask&& o) noexcept : _h(o._h) { o._h = nullptr; }
+  CoTask(const CoTask&) = delete;
+  CoTask& operator=(const CoTask&) = delete;
+  ~CoTask() { if (_h) _h.destroy(); }
+
+  explicit operator bool() const { return (bool)_h; }
+
+  // co_await child: runs it to the end as part of the caller
+  // (a child without a frame is skipped)
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> h;
+      bool await_ready() const noexcept { return !h; }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept {
+        h.promise().cont = parent;
+        return h;
+      }
+      void await_resume() noexcept {}
+    };
+    return Awaiter{ _h };
+  }
+
+private:
+  explicit CoTask(std::coroutine_handle<promise_type> h) : _h(h) {}
+  std::coroutine_handle<promise_type> _h;
+
+  friend bool coSpawn(CoTask&& t);
+};
+
+bool coSpawn(CoTask&& t);   // false: no frame, the flow never ran
+void coRun();
+
+
+// =========================================================
+//  AWAITABLES
+// =========================================================
+// Each lives in the suspended coroutine's frame while it waits
+// and links itself into the scheduler's lists: no allocation.
+struct CoWait {
+  std::coroutine_handle<> h;
+  CoWait* next = nullptr;
+  bool await_ready() const noexcept { return false; }
+  void await_resume() const noexcept {}
+};
+
+struct CoFrame : CoWait {
+  void await_suspend(std::coroutine_handle<> c) noexcept;
+};
+
+struct CoSleep : CoWait {
+  uint32_t ms;
+  TimerId  timer = 0;
+  explicit CoSleep(uint32_t ms) : ms(ms) {}
+  bool await_ready() const noexcept { return ms == 0; }
+  bool await_suspend(std::coroutine_handle<> c) noexcept;   // false: no timer free
+};
+
+struct CoInput : CoWait {
+  bool (*pred)();
+  bool was = false;
+  explicit CoInput(bool (*pred)()) : pred(pred) {}
+  void await_suspend(std::coroutine_handle<> c) noexcept;
+};
+
+struct CoIo : CoWait {
+  bool (*fn)(void*);
+  void* ctx;
+  bool  result = false;
+  CoIo(bool (*fn)(void*), void* ctx) : fn(fn), ctx(ctx) {}
+  bool await_suspend(std::coroutine_handle<> c) noexcept;   // false: ran inline
+  bool await_resume() const noexcept { return result; }
+};
+
+inline CoFrame coFrame()                                { return CoFrame(); }
+inline CoSleep coSleep(uint32_t ms)                     { return CoSleep(ms); }
+inline CoInput coInput(bool (*pred)())                  { return CoInput(pred); }
+inline CoIo    coIo(bool (*fn)(void*), void* ctx = nullptr) { return CoIo(fn, ctx); }
+
+
+// =========================================================
+//  STATS
+// =========================================================
+struct CoStats {
+  uint32_t spawned, failed, ioJobs;
+  uint16_t live, peak;      // frames in use
+  uint16_t largest;         // biggest frame asked for (bytes)
+};
+CoStats coStats();
+
+// ======================= End of File =======================
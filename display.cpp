@@ -0,0 +1,141 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  display.cpp — Panel Rotation + UI Blits
+//
+//  Same axis as SCREEN_ROTATION:
+//   - tft.setRotation(r); the controller mirrors its own scan
+//     and UI pixels go out untouched.
+//
+//  Other axis (portrait on a landscape build):
+//   - The controller stays one step before r, on the boot
+//     axis, and the UI (e.g. 320x480) is turned the last 90°
+//     here. UI pixel (x, y) lands on panel pixel
+//     (H - 1 - y, x), H being the UI height, so a band of UI
+//     rows becomes a band of panel columns.
+//   - Bands of 16 rows are transposed in 16x16 tiles (a tile's
+//     reads and writes both stay within a few cache lines) into
+//     one of two DMA blocks; the next band is transposed while
+//     the previous one is on the wire.
+// =========================================================
+
+#include "display.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+
+// =========================================================
+//  MODULE STATE
+// =========================================================
+static constexpr int16_t BAND = 16;  // UI rows per block (= tile size)
+
+static TFT_eSPI* panel = nullptr;
+static uint8_t   rotation = SCREEN_ROTATION;
+static bool      transposed = false;
+static uint16_t* block[2] = {};      // DMA blocks, internal SRAM
+
+
+// =========================================================
+//  HELPERS
+// =========================================================
+static void freeBlocks() {
+  for (auto& b : block) { heap_caps_free(b); b = nullptr; }
+}
+
+static bool allocBlocks() {
+  if (block[0] && block[1]) return true;
+  size_t bytes = (size_t)BAND * max(panel->width(), panel->height()) * sizeof(uint16_t);
+  for (auto& b : block) {
+    if (!b) b = (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!b) { freeBlocks(); return false; }
+  }
+  return true;
+}
+
+// `lines` (<= BAND) UI rows of width w → w panel rows of `lines`
+// pixels: dst[x * lines + j] = src[(lines - 1 - j) * w + x]
+static void transposeBand(uint16_t* dst, const uint16_t* src, int16_t w, int16_t lines) {
+  for (int16_t x0 = 0; x0 < w; x0 += BAND) {
+    int16_t x1 = min<int16_t>(x0 + BAND, w);
+    for (int16_t j = 0; j < lines; ++j) {
+      const uint16_t* s = src + (size_t)(lines - 1 - j) * w;
+      uint16_t* d = dst + j;
+      for (int16_t x = x0; x < x1; ++x) d[(size_t)x * lines] = s[x];
+    }
+  }
+}
+
+
+// =========================================================
+//  ROTATION
+// =========================================================
+void displayBegin(TFT_eSPI& tft) {
+  panel = &tft;
+  displaySetRotation(SCREEN_ROTATION);
+}
+
+void displaySetRotation(uint8_t r) {
+  if (!panel) return;
+  r &= 3;
+  bool wantT = ((r ^ SCREEN_ROTATION) & 1) != 0;
+  if (wantT && !allocBlocks()) {
+    DBG_IF(MENU, "[Display] No SRAM for rotation %u; staying on %u\n", r, rotation);
+    return;
+  }
+
+  panel->dmaWait();
+  panel->setRotation(wantT ? (uint8_t)((r + 3) & 3) : r);
+  rotation   = r;
+  transposed = wantT;
+  if (!transposed) freeBlocks();
+  DBG_IF(MENU, "[Display] Rotation %u (%dx%d%s)\n", r, displayWidth(), displayHeight(),
+         transposed ? ", transposed" : "");
+}
+
+uint8_t displayRotation()  { return rotation; }
+bool    displayTransposed() { return transposed; }
+
+int16_t displayWidth()  { return panel ? (transposed ? panel->height() : panel->width())  : 0; }
+int16_t displayHeight() { return panel ? (transposed ? panel->width()  : panel->height()) : 0; }
+
+
+// =========================================================
+//  BLITS
+// =========================================================
+void displayPushRows(const uint16_t* px, int16_t y, int16_t lines) {
+  if (!panel || lines <= 0) return;
+  const int16_t w = displayWidth(), h = displayHeight();
+  bool swapWas = panel->getSwapBytes();
+  panel->setSwapBytes(false);  // sprite pixels are stored swapped
+
+  panel->startWrite();
+  if (!transposed) {
+    panel->setAddrWindow(0, y, w, lines);
+    panel->pushPixels(px, (uint32_t)w * lines);
+  } else {
+    panel->initDMA();
+    int b = 0;
+    for (int16_t done = 0; done < lines; done += BAND, b ^= 1) {
+      int16_t n = min<int16_t>(BAND, lines - done);
+      transposeBand(block[b], px + (size_t)done * w, w, n);  // overlaps the previous push
+      panel->dmaWait();
+      panel->setAddrWindow(h - (y + done) - n, 0, n, w);
+      panel->pushPixelsDMA(block[b], (uint32_t)w * n);
+    }
+    panel->dmaWait();
+  }
+  panel->endWrite();
+  panel->setSwapBytes(swapWas);
+}
+
+void displayPushSprite(TFT_eSprite& spr) {
+  if (!panel || !spr.created()) return;
+  if (!transposed) {
+    panel->startWrite();
+    spr.pushSprite(0, 0);
+    panel->endWrite();
+    return;
+  }
+  displayPushRows((const uint16_t*)spr.getPointer(), 0, min<int16_t>(spr.height(), displayHeight()));
+}
+
+// ======================= End of File =======================
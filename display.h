@@ -0,0 +1,44 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  display.h — Panel Rotation + UI Blits (Header)
+//
+//  Provides:
+//   • displayBegin()        — Boot rotation (SCREEN_ROTATION)
+//   • displaySetRotation()  — Switch at runtime, 0..3 as in
+//                             TFT_eSPI::setRotation()
+//   • displayWidth/Height() — Logical UI size for the rotation
+//   • displayPushRows()     — Push a band of UI lines
+//   • displayPushSprite()   — Push a full-screen UI sprite
+//
+//  Notes:
+//   - Rotations on the boot axis are a plain controller flip.
+//     The other two keep the ST7796 scanning on its native
+//     axis (DMA-friendly, tear-free) and transpose the UI in
+//     16x16 tiles at blit time, through two band-sized DMA
+//     blocks — never a second frame.
+//   - Only the menu UI follows the rotation; games, video and
+//     GIFs keep drawing landscape on tft directly.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+void    displayBegin(TFT_eSPI& tft);
+void    displaySetRotation(uint8_t r);
+uint8_t displayRotation();
+bool    displayTransposed();  // UI axis differs from the panel's
+
+int16_t displayWidth();
+int16_t displayHeight();
+
+// `px` holds `lines` rows of displayWidth() byte-swapped pixels
+// (sprite order) for UI lines y .. y + lines - 1.
+void displayPushRows(const uint16_t* px, int16_t y, int16_t lines);
+void displayPushSprite(TFT_eSprite& spr);
+
+// ======================= End of File =======================
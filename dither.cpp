@@ -0,0 +1,203 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  dither.cpp — RGB888 → RGB565 Conversion
+//
+//  Truncating 8 bits to 5/6 leaves visible bands on smooth
+//  gradients (skies, skin, fades in video).
+//
+//  Ordered (Bayer 4x4):
+//   - Scales each channel to 5/6 bits with a threshold from
+//     the pixel's position: (v * 31 + t) >> 8, t in 8..248.
+//     That can't overflow, so the inner loop is straight-line
+//     integer math (multiply-add, shift, a rotate for the byte
+//     swap): no branches, no state between pixels, and host
+//     compilers vectorize it.
+//
+//  Floyd–Steinberg:
+//   - Error goes 7/16 right, 3/16 + 5/16 + 1/16 to the row
+//     below, so rows must arrive in order; two rows of error
+//     are kept (int16, 16x scaled) and swapped per row.
+//   - Quantization error is measured against the value the
+//     panel shows (565 expanded back to 888), not against the
+//     truncated bits, so mid-greys don't drift.
+//
+//  Host benchmark:
+//    g++ -O2 -DDITHER_BENCH_MAIN -x c++ dither.cpp -o dither_bench
+// =========================================================
+
+#include "dither.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+  #include "config.h"
+  #define BENCH_LOG(...) DBG_IF(VIDEO, __VA_ARGS__)
+  static uint32_t benchUs() { return micros(); }
+#else
+  #include <stdio.h>
+  #include <chrono>
+  #define BENCH_LOG(...) printf(__VA_ARGS__)
+  static uint32_t benchUs() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+// =========================================================
+//  HELPERS
+// =========================================================
+static const uint8_t BAYER4[4][4] = {
+  {  0,  8,  2, 10 },
+  { 12,  4, 14,  6 },
+  {  3, 11,  1,  9 },
+  { 15,  7, 13,  5 },
+};
+
+static inline int clamp255(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+// sh = 8 swaps the bytes, sh = 0 leaves them (c | c)
+static inline uint16_t pack(uint32_t r5, uint32_t g6, uint32_t b5, int sh) {
+  uint16_t c = (uint16_t)((r5 << 11) | (g6 << 5) | b5);
+  return (uint16_t)((c << sh) | (c >> sh));
+}
+
+
+// =========================================================
+//  ROW KERNELS
+// =========================================================
+void ditherTruncRow(const uint8_t* rgb, uint16_t* dst, int n, bool swap) {
+  int sh = swap ? 8 : 0;
+  for (int i = 0; i < n; ++i, rgb += 3)
+    dst[i] = pack(rgb[0] >> 3, rgb[1] >> 2, rgb[2] >> 3, sh);
+}
+
+void ditherOrderedRow(const uint8_t* rgb, uint16_t* dst, int n, int x, int y, bool swap) {
+  // Thresholds centered in each of the 16 steps of 1/256
+  const uint8_t* row = BAYER4[y & 3];
+  uint16_t t[4];
+  for (int i = 0; i < 4; ++i) t[i] = row[(x + i) & 3] * 16 + 8;
+
+  int sh = swap ? 8 : 0;
+  for (int i = 0; i < n; ++i, rgb += 3) {
+    uint32_t r = (rgb[0] * 31 + t[i & 3]) >> 8;
+    uint32_t g = (rgb[1] * 63 + t[i & 3]) >> 8;
+    uint32_t b = (rgb[2] * 31 + t[i & 3]) >> 8;
+    dst[i] = pack(r, g, b, sh);
+  }
+}
+
+
+// =========================================================
+//  ERROR DIFFUSION
+// =========================================================
+// One pixel of padding each side so x - 1 / x + 1 never branch
+static size_t rowStride(uint16_t width) { return ((size_t)width + 2) * 3; }
+
+bool ditherFsBegin(DitherFs& fs, uint16_t width) {
+  ditherFsEnd(fs);
+  fs.err = (int16_t*)malloc(rowStride(width) * 2 * sizeof(int16_t));
+  if (!fs.err) return false;
+  fs.width = width;
+  ditherFsReset(fs);
+  return true;
+}
+
+void ditherFsReset(DitherFs& fs) {
+  if (fs.err) memset(fs.err, 0, rowStride(fs.width) * 2 * sizeof(int16_t));
+  fs.row = 0;
+}
+
+void ditherFsRow(DitherFs& fs, const uint8_t* rgb, uint16_t* dst, int n, bool swap) {
+  size_t stride = rowStride(fs.width);
+  int16_t* cur = fs.err + (fs.row & 1) * stride + 3;
+  int16_t* nxt = fs.err + ((fs.row + 1) & 1) * stride + 3;
+  memset(nxt - 3, 0, stride * sizeof(int16_t));
+  if (n > fs.width) n = fs.width;
+
+  int sh = swap ? 8 : 0;
+  int er = 0, eg = 0, eb = 0;  // 7/16 carried right
+  for (int i = 0; i < n; ++i, rgb += 3, cur += 3, nxt += 3) {
+    int r = clamp255(rgb[0] + ((cur[0] + er + 8) >> 4));
+    int g = clamp255(rgb[1] + ((cur[1] + eg + 8) >> 4));
+    int b = clamp255(rgb[2] + ((cur[2] + eb + 8) >> 4));
+    int r5 = r >> 3, g6 = g >> 2, b5 = b >> 3;
+
+    // Error against what the panel shows
+    int dr = r - ((r5 << 3) | (r5 >> 2));
+    int dg = g - ((g6 << 2) | (g6 >> 4));
+    int db = b - ((b5 << 3) | (b5 >> 2));
+    er = dr * 7; nxt[-3] += dr * 3; nxt[0] += dr * 5; nxt[3] += dr;
+    eg = dg * 7; nxt[-2] += dg * 3; nxt[1] += dg * 5; nxt[4] += dg;
+    eb = db * 7; nxt[-1] += db * 3; nxt[2] += db * 5; nxt[5] += db;
+
+    dst[i] = pack(r5, g6, b5, sh);
+  }
+  fs.row++;
+}
+
+void ditherFsEnd(DitherFs& fs) {
+  free(fs.err);
+  fs.err = nullptr;
+  fs.width = 0;
+}
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+static volatile uint16_t benchSink;  // keeps the output live
+
+// A 480x320 frame of gradients, converted in 16-line strips
+// like the JPEG decoder delivers them
+void ditherBenchmark() {
+  static constexpr int W = 480, H = 320, STRIP = 16, FRAMES = 10;
+  uint8_t*  src = (uint8_t*)malloc((size_t)W * STRIP * 3);
+  uint16_t* dst = (uint16_t*)malloc((size_t)W * sizeof(uint16_t));
+  DitherFs fs;
+  if (!src || !dst || !ditherFsBegin(fs, W)) {
+    BENCH_LOG("[Dither] Out of memory for the benchmark\n");
+    free(src);
+    free(dst);
+    return;
+  }
+  for (int y = 0; y < STRIP; ++y)
+    for (int x = 0; x < W; ++x) {
+      uint8_t* p = src + ((size_t)y * W + x) * 3;
+      p[0] = (uint8_t)(x * 255 / (W - 1));
+      p[1] = (uint8_t)(64 + y * 4 + x / 8);
+      p[2] = (uint8_t)(255 - x * 255 / (W - 1));
+    }
+
+  float mpx[3] = {};
+  for (int mode = 0; mode < 3; ++mode) {
+    uint32_t t0 = benchUs();
+    for (int f = 0; f < FRAMES; ++f) {
+      ditherFsReset(fs);
+      for (int y = 0; y < H; ++y) {
+        const uint8_t* row = src + (size_t)(y % STRIP) * W * 3;
+        if (mode == 0)      ditherTruncRow(row, dst, W, true);
+        else if (mode == 1) ditherOrderedRow(row, dst, W, 0, y, true);
+        else                ditherFsRow(fs, row, dst, W, true);
+        benchSink = dst[y % W];
+      }
+    }
+    uint32_t us = benchUs() - t0;
+    mpx[mode] = us ? (float)W * H * FRAMES / us : 0.0f;
+  }
+
+  BENCH_LOG("[Dither] %dx%d x %d frames: truncate %.1f, ordered %.1f, floyd-steinberg %.1f Mpx/s\n",
+            W, H, FRAMES, mpx[0], mpx[1], mpx[2]);
+  ditherFsEnd(fs);
+  free(src);
+  free(dst);
+}
+
+#ifdef DITHER_BENCH_MAIN
+int main() {
+  ditherBenchmark();
+  return 0;
+}
+#endif
+
+// ======================= End of File =======================
@@ -0,0 +1,52 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  dither.h — RGB888 → RGB565 Conversion (Header)
+//
+//  Provides:
+//   • ditherTruncRow()   — Plain truncation (what rgb() does)
+//   • ditherOrderedRow() — 4x4 Bayer ordered dither; position-
+//                          based, so tiles can arrive in any order
+//   • DitherFs           — Floyd–Steinberg, fed rows top to bottom
+//   • ditherBenchmark()  — Mpx/s of each mode (Serial / stdout)
+//
+//  Notes:
+//   - `swap` writes byte-swapped pixels, ready for DMA pushes
+//     with setSwapBytes(false).
+//   - Plain C++: builds for the host too (see dither.cpp).
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+
+enum class DitherMode : uint8_t { NONE, ORDERED, DIFFUSION };
+
+// =========================================================
+//  ROW KERNELS
+// =========================================================
+// `rgb` holds n packed RGB888 pixels; (x, y) is the position
+// of the first one on the image.
+void ditherTruncRow(const uint8_t* rgb, uint16_t* dst, int n, bool swap);
+void ditherOrderedRow(const uint8_t* rgb, uint16_t* dst, int n, int x, int y, bool swap);
+
+// =========================================================
+//  ERROR DIFFUSION
+// =========================================================
+// Error carried to the current and the next row, 16x scaled
+struct DitherFs {
+  int16_t* err   = nullptr;
+  uint16_t width = 0;
+  uint32_t row   = 0;
+};
+
+bool ditherFsBegin(DitherFs& fs, uint16_t width);
+void ditherFsReset(DitherFs& fs);  // new image
+void ditherFsRow(DitherFs& fs, const uint8_t* rgb, uint16_t* dst, int n, bool swap);
+void ditherFsEnd(DitherFs& fs);
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+void ditherBenchmark();
+
+// ======================= End of File =======================
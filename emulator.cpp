@@ -0,0 +1,569 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  emulator.cpp — Emulator Frontend (NES)
+//
+//  Provides:
+//   • ROM loading: flash-mapped (romstore) or SD → PSRAM
+//   • InputMapper → NES controller mapping
+//   • Scanline sink → scanout (DMA straight to the TFT)
+//   • 60 Hz frame pacing + FPS logging
+//   • APU audio → resampler, rate control + frameskip (AvSync)
+//   • Profiler overlay in the side margin (Debug::ONSCREEN)
+//   • Rewind: hold Y (snapshots every REWIND_INTERVAL frames)
+//   • Battery-backed PRG-RAM saves (<rom>.sav)
+//   • Resume state on exit (<rom>.rsm) for quick-resume
+//   • Code cache for the cached 6502 interpreter
+//   • Headless benchmark mode (plain vs cached interpreter,
+//     test-ROM result readout)
+//
+//  Notes:
+//   - The NES object (~14 KB) lives in internal RAM; the ROM is
+//     mapped from flash when the store is available (PSRAM copy
+//     otherwise), decoded CHR goes to the heap.
+//   - No frame sprite: each PPU line is scaled, converted and
+//     queued for DMA while the core runs on, so "present" is
+//     just the tail of the last block.
+// =========================================================
+
+#include "emulator.h"
+#include "config.h"
+#include "controls.h"
+#include "MenuUI.h"
+#include "nes.h"
+#include "scanout.h"
+#include "audio.h"
+#include "avsync.h"
+#include "rewind.h"
+#include "romstore.h"
+#include "esp_heap_caps.h"
+#include <TFT_eSPI.h>
+#include "sdcard.h"
+#include <SD.h>
+
+extern TFT_eSPI tft;
+
+// =========================================================
+//  SESSION STATE
+// =========================================================
+static NES          nes;
+static uint8_t*     romImage = nullptr;  // PSRAM copy (SD fallback)
+static bool         romMapped = false;   // image lives in the flash store
+static uint32_t     launchMs = 0;
+static const char*  launchSource = "";
+static bool         running = false;
+static String       savePath;
+static String       resumePath;
+static uint8_t*     resumeState = nullptr; // prepared, applied by emuStart()
+static bool         prepared = false;
+static int16_t      videoW = 0;       // picture width on the panel
+static AvSync       sync;
+static void*        codeCache = nullptr; // translated 6502 blocks
+
+// Rewind
+static uint8_t*     stateBuf = nullptr;
+static size_t       stateLen = 0;
+static uint8_t      sinceSnap = 0;
+static bool         rewinding = false;
+static uint32_t     statSaveUs = 0, statSaves = 0;
+
+// Pacing + stats
+static unsigned long nextFrameUs = 0;
+static uint32_t statFrames = 0, statCoreUs = 0, statPresentUs = 0;
+static unsigned long statStart = 0;
+static float    statFps = 0;
+
+
+// =========================================================
+//  SD HELPERS
+// =========================================================
+static uint8_t* readFile(const char* path, size_t& len) {
+  SdBus bus;
+  File f = SD.open(path, FILE_READ);
+  if (!f) return nullptr;
+
+  len = f.size();
+  uint8_t* buf = (uint8_t*)ps_malloc(len);
+  if (!buf) buf = (uint8_t*)malloc(len);
+  if (buf && f.read(buf, len) != len) { free(buf); buf = nullptr; }
+
+  f.close();
+  return buf;
+}
+
+static void loadBattery() {
+  if (!nes.hasBattery()) return;
+  SdBus bus;
+  File f = SD.open(savePath.c_str(), FILE_READ);
+  if (f) {
+    f.read(nes.prgRam(), nes.prgRamSize());
+    f.close();
+    DBG_IF(EMU, "[Emu] Loaded save %s\n", savePath.c_str());
+  }
+}
+
+static void storeBattery() {
+  if (!nes.hasBattery()) return;
+  SdBus bus;
+  File f = SD.open(savePath.c_str(), FILE_WRITE);
+  if (f) {
+    f.write(nes.prgRam(), nes.prgRamSize());
+    f.close();
+    DBG_IF(EMU, "[Emu] Wrote save %s\n", savePath.c_str());
+  }
+}
+
+// The state a session left on exit, loaded into PSRAM. Ignored
+// unless it matches this core's state size.
+static void loadResumeState() {
+  size_t len = 0;
+  resumeState = readFile(resumePath.c_str(), len);
+  if (resumeState && len != nes.stateSize()) {
+    free(resumeState);
+    resumeState = nullptr;
+  }
+  DBG_IF(EMU, "[Emu] Resume state %s: %s\n", resumePath.c_str(), resumeState ? "loaded" : "none");
+}
+
+static void storeResumeState() {
+  if (!EMU_RESUME_STATE) return;
+  size_t len = nes.stateSize();
+  uint8_t* buf = stateBuf ? stateBuf : (uint8_t*)ps_malloc(len);
+  if (!buf) return;
+  nes.saveState(buf);
+
+  {
+    SdBus bus;
+    File f = SD.open(resumePath.c_str(), FILE_WRITE);
+    if (f) {
+      f.write(buf, len);
+      f.close();
+      DBG_IF(EMU, "[Emu] Wrote resume state %s\n", resumePath.c_str());
+    }
+  }
+  if (buf != stateBuf) free(buf);
+}
+
+static void unloadRom() {
+  nes.unload();
+  if (romMapped) romstoreUnmap();
+  free(romImage);
+  romImage = nullptr;
+  romMapped = false;
+}
+
+// Maps the ROM from the flash store (storing it on first use),
+// else reads it into PSRAM, and hands it to the core.
+static bool loadRom(const char* path) {
+  uint32_t t0 = millis();
+  size_t len = 0;
+  const uint8_t* image = nullptr;
+
+  if (EMU_FLASH_ROMS && romstoreReady()) {
+    bool stored = false;
+    image = romstoreMap(path, len, stored);
+    romMapped = (image != nullptr);
+    launchSource = stored ? "copied to flash" : "flash-mapped";
+  }
+  if (!image) {
+    romImage = readFile(path, len);
+    image = romImage;
+    launchSource = "SD -> PSRAM";
+  }
+  if (!image) {
+    DBG_IF(EMU, "[Emu] Cannot read %s\n", path);
+    return false;
+  }
+  if (!nes.load(image, len)) {
+    DBG_IF(EMU, "[Emu] Unsupported ROM %s\n", path);
+    unloadRom();
+    return false;
+  }
+  launchMs = millis() - t0;
+  DBG_IF(EMU, "[Emu] Loaded %s (%u KB, mapper %d, %s)\n",
+         path, (unsigned)(len / 1024), nes.mapperId(), launchSource);
+  return true;
+}
+
+
+// =========================================================
+//  VIDEO
+// =========================================================
+static bool beginVideo() {
+  int16_t w = NES::SCREEN_W, h = NES::SCREEN_H;
+  if (EMU_SCALE_TO_FIT) {
+    h = tft.height();
+    w = (int16_t)((int32_t)NES::SCREEN_W * h / NES::SCREEN_H);
+  }
+  if (!scanoutBegin(tft, NES::SCREEN_W, NES::SCREEN_H, w, h)) return false;
+  videoW = w;
+
+  uint16_t pal[64];
+  for (int i = 0; i < 64; ++i) {
+    uint32_t c = NES::PALETTE_RGB[i];
+    pal[i] = rgb((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+  }
+  scanoutSetPalette(pal, 64);
+  return true;
+}
+
+static void lineToPanel(void*, int line, const uint8_t* px) {
+  scanoutLine(line, px);
+}
+
+// Rate-control + timing readout in the left margin. Drawn between
+// frames, so it never races the scanout DMA.
+static void drawProfiler() {
+  if (!Debug::ONSCREEN) return;
+  int16_t margin = (tft.width() - videoW) / 2;
+  if (margin < 66) return;
+
+  char buf[6][16];
+  snprintf(buf[0], 16, "FPS  %.1f", statFps);
+  snprintf(buf[1], 16, "CPU  %.1fms", statCoreUs / 1000.0f / (statFrames ? statFrames : 1));
+  snprintf(buf[2], 16, "SKIP %u/60", sync.skipRate());
+  snprintf(buf[3], 16, "RATE %+.2f%%", (sync.ratio() - 1.0f) * 100.0f);
+  snprintf(buf[4], 16, "BUF  %d%%", (int)(sync.fill() * 100));
+  snprintf(buf[5], 16, "%s", sync.modeName());
+
+  tft.startWrite();
+  tft.setTextFont(1);
+  tft.setTextColor(COL_MUTED, COL_BG);
+  tft.setTextDatum(TL_DATUM);
+  for (int i = 0; i < 6; ++i) {
+    tft.fillRect(0, 4 + i * 10, margin, 10, COL_BG);
+    tft.drawString(buf[i], 2, 5 + i * 10);
+  }
+  tft.endWrite();
+}
+
+
+// =========================================================
+//  CODE CACHE
+// =========================================================
+// Internal RAM first: ops are read on every instruction.
+static void beginCodeCache() {
+  if (!EMU_CODE_CACHE_KB || codeCache) return;
+  size_t bytes = EMU_CODE_CACHE_KB * 1024;
+  codeCache = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (!codeCache) codeCache = ps_malloc(bytes);
+  if (!codeCache) {
+    DBG_IF(EMU, "[Emu] No memory for the code cache; plain interpreter\n");
+    return;
+  }
+  nes.setCodeCache(codeCache, bytes);
+}
+
+static void endCodeCache() {
+  nes.setCodeCache(nullptr, 0);
+  free(codeCache);
+  codeCache = nullptr;
+}
+
+static void logCodeCache() {
+  const NesBlockCache& c = nes.codeCache();
+  if (!c.enabled()) return;
+  DBG_IF(EMU, "[Emu] Code cache: %lu blocks translated, %lu flushes, %lu SMC drops, %u/%lu KB\n",
+         (unsigned long)c.translated(), (unsigned long)c.flushes(),
+         (unsigned long)c.invalidations(),
+         (unsigned)(c.used() / 1024), (unsigned long)EMU_CODE_CACHE_KB);
+}
+
+
+// =========================================================
+//  REWIND
+// =========================================================
+static void beginRewind() {
+  if (!EMU_REWIND) return;
+  stateLen = nes.stateSize();
+  stateBuf = (uint8_t*)ps_malloc(stateLen);
+  if (!stateBuf || !rewindBegin(stateLen, REWIND_RING_KB * 1024)) {
+    free(stateBuf);
+    stateBuf = nullptr;
+    DBG_IF(EMU, "[Emu] Rewind off (no PSRAM)\n");
+    return;
+  }
+  sinceSnap = 0;
+  rewinding = false;
+  statSaveUs = statSaves = 0;
+  DBG_IF(EMU, "[Emu] Rewind: %u B state, %lu KB ring\n", (unsigned)stateLen, (unsigned long)REWIND_RING_KB);
+}
+
+static void endRewind() {
+  rewindEnd();
+  free(stateBuf);
+  stateBuf = nullptr;
+}
+
+// Runs before each frame: either steps back one snapshot (Y held)
+// or records one every REWIND_INTERVAL frames.
+static void stepRewind() {
+  if (!stateBuf) return;
+
+  if (controls.y()) {
+    if (const uint8_t* s = rewindPop()) nes.loadState(s, stateLen);
+    rewinding = true;
+    return;
+  }
+  if (rewinding) {
+    rewinding = false;
+    sinceSnap = 0;  // the restored snapshot is the new reference
+  }
+  if (++sinceSnap < REWIND_INTERVAL) return;
+  sinceSnap = 0;
+
+  uint32_t t0 = micros();
+  nes.saveState(stateBuf);
+  statSaveUs += micros() - t0;
+  statSaves++;
+  rewindPush(stateBuf);
+}
+
+static void logRewind() {
+  if (!stateBuf) return;
+  RewindStats r = rewindStats();
+  float saveMs = statSaves ? statSaveUs / 1000.0f / statSaves : 0;
+  DBG_IF(EMU, "[Emu] Rewind: %u snaps = %.1f s, %.1f KB per s of history, "
+              "save %.2f + push %.2f ms/snap (%.3f ms/frame), pop %.2f ms\n",
+         rewindDepth(),
+         rewindDepth() * REWIND_INTERVAL / 60.0f,
+         r.bytesPerSnap * 60.0f / REWIND_INTERVAL / 1024.0f,
+         saveMs, r.pushMs, (saveMs + r.pushMs) / REWIND_INTERVAL, r.popMs);
+}
+
+
+// =========================================================
+//  INPUT
+// =========================================================
+static uint8_t readPad() {
+  uint8_t b = 0;
+  if (controls.a())      b |= NES::BTN_A;
+  if (controls.b())      b |= NES::BTN_B;
+  if (controls.select()) b |= NES::BTN_SELECT;
+  if (controls.start())  b |= NES::BTN_START;
+  if (controls.up())     b |= NES::BTN_UP;
+  if (controls.down())   b |= NES::BTN_DOWN;
+  if (controls.left())   b |= NES::BTN_LEFT;
+  if (controls.right())  b |= NES::BTN_RIGHT;
+  return b;
+}
+
+
+// =========================================================
+//  SESSION LIFECYCLE
+// =========================================================
+bool emuPrepare(const char* path, bool withResumeState) {
+  if (running) emuStop();
+  emuCancel();
+
+  String p(path);
+  int dot = p.lastIndexOf('.');
+  String base = dot > 0 ? p.substring(0, dot) : p;
+  savePath   = base + ".sav";
+  resumePath = base + ".rsm";
+
+  if (!loadRom(path)) return false;
+  loadBattery();
+  if (withResumeState) loadResumeState();
+  prepared = true;
+  return true;
+}
+
+void emuCancel() {
+  if (!prepared) return;
+  prepared = false;
+  free(resumeState);
+  resumeState = nullptr;
+  unloadRom();
+}
+
+bool emuStart() {
+  if (!prepared) return false;
+  prepared = false;
+
+  tft.fillScreen(COL_BG);
+  if (!beginVideo()) {
+    DBG_IF(EMU, "[Emu] No DMA memory for scanout\n");
+    free(resumeState);
+    resumeState = nullptr;
+    unloadRom();
+    return false;
+  }
+
+  nes.setLineSink(lineToPanel, nullptr);
+  nes.setVideoSkip(false);
+  nes.setSampleRate(audioSampleRate() ? audioSampleRate() : AUDIO_SAMPLE_RATE);
+  beginCodeCache();
+  if (resumeState) {
+    nes.loadState(resumeState, nes.stateSize());
+    free(resumeState);
+    resumeState = nullptr;
+  }
+
+  sync.reset();
+  audioPrime(SYNC_FILL_TARGET);
+  beginRewind();
+
+  running = true;
+  nextFrameUs = micros();
+  statStart = millis();
+  statFrames = statCoreUs = statPresentUs = 0;
+  statFps = 0;
+  return true;
+}
+
+bool emuLaunch(const char* path) {
+  uint32_t t0 = millis();
+  if (!emuPrepare(path, false) || !emuStart()) return false;
+  launchMs = millis() - t0;  // ROM + video + saves, up to the first frame
+  return true;
+}
+
+bool emuRunning() { return running; }
+
+uint32_t    emuLaunchMs()     { return launchMs; }
+const char* emuLaunchSource() { return launchSource; }
+
+void emuStop() {
+  if (!running) return;
+  running = false;
+
+  audioIdle();
+  storeBattery();
+  storeResumeState();
+  scanoutStop();
+  endRewind();
+  logCodeCache();
+  endCodeCache();
+  unloadRom();
+
+  // Hand the screen back to the menus
+  tft.fillScreen(COL_BG);
+  setMenuInputLockUntil(millis() + 300);
+  if (EditMenu* m = currentMenu()) m->forceRedraw();
+  DBG_IF(EMU, "[Emu] Session ended\n");
+}
+
+void emuUpdate() {
+  if (!running) return;
+
+  controls.update(controls.mode());
+  if (controls.start() && controls.select()) { emuStop(); return; }
+  nes.setButtons(readPad());
+  stepRewind();
+
+  // Scanout overlaps the core, so "present" is only the final
+  // block flush + DMA drain after the last visible line.
+  // Skipped frames still run CPU + APU, just no video.
+  bool skip = sync.skipNext();
+  nes.setVideoSkip(skip);
+
+  uint32_t t0 = micros();
+  if (!skip) scanoutFrameBegin();
+  nes.runFrame();
+  uint32_t t1 = micros();
+  if (!skip) scanoutFrameEnd();
+  uint32_t t2 = micros();
+
+  audioWriteResampled(nes.audioSamples(), nes.audioSampleCount(), sync.ratio());
+  sync.update(audioFill());
+
+  statCoreUs    += t1 - t0;
+  statPresentUs += t2 - t1;
+  if (++statFrames == 300) {
+    float secs = (millis() - statStart) / 1000.0f;
+    statFps = statFrames / secs;
+    drawProfiler();
+    DBG_IF(EMU, "[Emu] %.1f FPS (core %.2f ms, present %.2f ms) skip %u/60, rate %+.2f%%, buf %d%% [%s], underruns %lu\n",
+           statFps,
+           statCoreUs / 1000.0f / statFrames,
+           statPresentUs / 1000.0f / statFrames,
+           sync.skipRate(), (sync.ratio() - 1.0f) * 100.0f,
+           (int)(sync.fill() * 100), sync.modeName(),
+           (unsigned long)audioUnderruns());
+    logRewind();
+    statFrames = statCoreUs = statPresentUs = 0;
+    statStart = millis();
+  } else if (statFrames % 30 == 0) {
+    statFps = statFrames / ((millis() - statStart) / 1000.0f);
+    drawProfiler();
+  }
+
+  // --- Pacing: sleep off what's left of the frame ---
+  nextFrameUs += EMU_FRAME_US;
+  long wait = (long)(nextFrameUs - micros());
+  if (wait > 0) {
+    if (wait > 2000) delay(wait / 1000);
+    while ((long)(nextFrameUs - micros()) > 0) {}
+  } else if (wait < -(long)EMU_FRAME_US) {
+    nextFrameUs = micros();  // fell behind; don't try to catch up
+  }
+}
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+// Headless: the PPU still renders every line (sprite 0 needs
+// it), only the RGB565 conversion and SPI push are skipped.
+// Runs the ROM twice from reset, plain then cached interpreter,
+// then once per APU channel to price its synthesis.
+static uint32_t benchPass(uint16_t frames) {
+  nes.reset();
+  uint32_t t0 = micros();
+  for (uint16_t i = 0; i < frames; ++i) nes.runFrame();
+  return micros() - t0;
+}
+
+// CPU test ROMs (blargg's) report through PRG-RAM: status at
+// $6000 (0x80 = still running, 0 = passed), DE B0 61 at $6001,
+// then a text message.
+static void logTestRom() {
+  const uint8_t* r = nes.prgRam();
+  if (r[1] != 0xDE || r[2] != 0xB0 || r[3] != 0x61) return;
+  char msg[96];
+  size_t n = 0;
+  while (n < sizeof(msg) - 1 && r[4 + n]) { msg[n] = r[4 + n]; n++; }
+  msg[n] = 0;
+  DBG_IF(EMU, "[Emu] Test ROM: %s (status %02X)\n%s\n",
+         r[0] == 0 ? "passed" : r[0] == 0x80 ? "still running" : "FAILED", r[0], msg);
+}
+
+void emuBenchmark(const char* path, uint16_t frames) {
+  if (running) emuStop();
+  if (!loadRom(path)) return;
+
+  nes.setLineSink(nullptr, nullptr);
+  nes.setVideoSkip(false);
+
+  uint32_t plainUs = benchPass(frames);
+  logTestRom();
+  beginCodeCache();
+  uint32_t cachedUs = benchPass(frames);
+  logTestRom();
+
+  DBG_IF(EMU, "[Emu] Bench %s: %u frames, plain %.1f FPS (%.2f ms/frame), "
+              "cached %.1f FPS (%.2f ms/frame), %.2fx\n",
+         path, frames,
+         frames * 1e6f / plainUs, plainUs / 1000.0f / frames,
+         frames * 1e6f / cachedUs, cachedUs / 1000.0f / frames,
+         (float)plainUs / cachedUs);
+  logCodeCache();
+
+  // Audio: all channels muted is the baseline; each channel
+  // alone adds its timer + band-limited step cost
+  static const char* const CH_NAMES[5] = { "pulse1", "pulse2", "triangle", "noise", "DMC" };
+  nes.setChannelMask(0);
+  uint32_t mutedUs = benchPass(frames);
+  for (int ch = 0; ch < 5; ++ch) {
+    nes.setChannelMask(1 << ch);
+    int32_t us = (int32_t)benchPass(frames) - (int32_t)mutedUs;
+    DBG_IF(EMU, "[Emu] Bench APU %-8s %+.1f us/frame\n", CH_NAMES[ch], (float)us / frames);
+  }
+  nes.setChannelMask(NES::CH_ALL);
+
+  endCodeCache();
+  unloadRom();
+}
+
+// ======================= End of File =======================
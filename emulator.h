@@ -0,0 +1,49 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  emulator.h — Emulator Frontend (Header)
+//
+//  Provides:
+//   • emuLaunch()    — Load a ROM from SD and start a session
+//   • emuUpdate()    — Run + present one frame (call from loop)
+//   • emuStop()      — End the session, flush battery saves
+//                      and the resume state
+//   • emuPrepare() / emuStart() — launch in two halves
+//   • emuBenchmark() — Headless FPS measurement over serial
+//
+//  Notes:
+//   - Input comes from InputMapper; START + SELECT exits.
+//   - While a session runs, loop() should skip the menus.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool emuLaunch(const char* path);
+
+// emuLaunch() split for quick-resume. emuPrepare() does only
+// the storage side — ROM mapping, battery save and optionally
+// the state left by the last emuStop() — and touches neither
+// the panel nor audio, so it may run on another task while
+// the rest of boot carries on. emuStart() brings up video and
+// starts the session; emuCancel() drops a prepared ROM.
+bool emuPrepare(const char* path, bool withResumeState);
+bool emuStart();
+void emuCancel();
+
+bool emuRunning();
+void emuUpdate();
+void emuStop();
+
+// Time from emuLaunch() to the first frame, and where the ROM
+// came from ("flash-mapped", "copied to flash", "SD -> PSRAM").
+uint32_t    emuLaunchMs();
+const char* emuLaunchSource();
+
+// Runs `frames` frames with no video output and logs FPS.
+void emuBenchmark(const char* path, uint16_t frames);
+
+// ======================= End of File =======================
@@ -0,0 +1,474 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  fcon.cpp — Fantasy Console Runtime
+//
+//  Provides:
+//   • Session lifecycle + fixed 60 Hz tick (cart → render → SFX)
+//   • Scanline compositor: tilemap, draw layer, sprites
+//   • Draw-layer primitives + 3x5 font
+//   • Renderer benchmark
+//
+//  Notes:
+//   - Nothing is composed into a full-screen buffer: each line
+//     is built in a 248-byte buffer and handed to scanout,
+//     which scales, palette-converts and DMAs it while the
+//     next line is built.
+//   - Tilemap lines are whole 8-byte tile rows (two word
+//     copies per tile); fine X scroll is just a pointer offset
+//     into the line buffer.
+//   - Draw-layer rows that were never drawn on are skipped
+//     entirely; drawn rows are merged a word at a time.
+//   - Tiles + draw layer live in internal RAM when possible.
+// =========================================================
+
+#include "fcon.h"
+#include "config.h"
+#include "controls.h"
+#include "MenuUI.h"
+#include "scanout.h"
+#include "audio.h"
+#include "avsync.h"
+#include "esp_heap_caps.h"
+#include <TFT_eSPI.h>
+
+extern TFT_eSPI tft;
+
+// =========================================================
+//  MACHINE STATE
+// =========================================================
+struct Sprite {
+  int16_t x, y;
+  uint8_t tile, flags;
+};
+
+static uint8_t*  fb = nullptr;             // draw layer, FCON_W x FCON_H
+static uint8_t   fbRows[FCON_H];           // row has been drawn on
+static uint8_t*  tiles = nullptr;          // 256 tiles x 64 px
+static uint8_t   tileMap[FCON_MAP_H][FCON_MAP_W];
+static Sprite    sprites[FCON_SPRITES];
+static uint16_t  palette[256];
+static bool      palDirty = true;
+static int16_t   scrollX = 0, scrollY = 0;
+static bool      mapOn = true;
+static uint16_t  btnNow = 0, btnLast = 0;
+
+alignas(4) static uint8_t lineBuf[FCON_W + 8];
+
+// Session
+static const FconCart* cart = nullptr;
+static bool            running = false;
+static uint32_t        frame = 0;
+static AvSync          sync;
+static int16_t         pcm[1024];
+
+// Pacing + stats
+static unsigned long nextFrameUs = 0;
+static uint32_t statFrames = 0, statCartUs = 0, statRenderUs = 0;
+static unsigned long statStart = 0;
+
+// PICO-8 style defaults for indices 0–15
+static const uint32_t DEFAULT_PAL[16] = {
+  0x000000, 0x1D2B53, 0x7E2553, 0x008751, 0xAB5236, 0x5F574F, 0xC2C3C7, 0xFFF1E8,
+  0xFF004D, 0xFFA300, 0xFFEC27, 0x00E436, 0x29ADFF, 0x83769C, 0xFF77A8, 0xFFCCAA,
+};
+
+// 3x5 glyphs for ' '..'_', one octal digit per row (4 = left)
+static const uint16_t FONT[64] = {
+  000000, 022202, 055000, 057575, 036236, 051245, 025253, 022000,
+  012221, 042224, 005250, 002720, 000024, 000700, 000002, 011244,
+  075557, 026227, 071747, 071317, 055711, 074717, 074757, 071111,
+  075757, 075717, 002020, 002024, 012421, 007070, 042124, 071302,
+  075547, 025755, 065656, 034443, 065556, 074647, 074644, 034553,
+  055755, 072227, 011152, 055655, 044447, 057755, 065555, 025552,
+  065644, 025563, 065655, 034216, 072222, 055557, 055552, 055775,
+  055255, 055222, 071247, 032223, 044211, 062226, 025000, 000007,
+};
+
+
+// =========================================================
+//  MEMORY
+// =========================================================
+static void* fastAlloc(size_t n) {
+  void* p = heap_caps_malloc(n, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  return p ? p : ps_malloc(n);
+}
+
+static bool allocMachine() {
+  fb    = (uint8_t*)fastAlloc((size_t)FCON_W * FCON_H);
+  tiles = (uint8_t*)fastAlloc(256 * 64);
+  if (fb && tiles) return true;
+  free(fb);    fb = nullptr;
+  free(tiles); tiles = nullptr;
+  return false;
+}
+
+static void freeMachine() {
+  free(fb);    fb = nullptr;
+  free(tiles); tiles = nullptr;
+}
+
+// Power-on state: blank layers, default palette, all sprites off
+static void resetMachine() {
+  memset(fb, 0, (size_t)FCON_W * FCON_H);
+  memset(fbRows, 0, sizeof(fbRows));
+  memset(tiles, 0, 256 * 64);
+  memset(tileMap, 0, sizeof(tileMap));
+  for (Sprite& s : sprites) s = { 0, 0, 0, FCON_HIDDEN };
+  memset(palette, 0, sizeof(palette));
+  for (int i = 0; i < 16; ++i) {
+    uint32_t c = DEFAULT_PAL[i];
+    palette[i] = rgb((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+  }
+  palDirty = true;
+  scrollX = scrollY = 0;
+  mapOn = true;
+  btnNow = btnLast = 0;
+  frame = 0;
+}
+
+
+// =========================================================
+//  RENDERER
+// =========================================================
+static uint8_t visible[FCON_SPRITES];  // slots on screen this frame
+static uint8_t visibleCount = 0;
+
+static void collectSprites() {
+  visibleCount = 0;
+  for (int i = 0; i < FCON_SPRITES; ++i) {
+    const Sprite& s = sprites[i];
+    if (s.flags & FCON_HIDDEN) continue;
+    if (s.x <= -8 || s.x >= FCON_W || s.y <= -8 || s.y >= FCON_H) continue;
+    visible[visibleCount++] = i;
+  }
+}
+
+static const uint8_t* renderLine(int y) {
+  uint8_t* out = lineBuf;
+
+  // --- Tilemap ---
+  if (mapOn) {
+    int my = (y + scrollY) & (FCON_MAP_H * 8 - 1);
+    int mx = scrollX & (FCON_MAP_W * 8 - 1);
+    const uint8_t* row = tileMap[my >> 3];
+    const uint8_t* src = tiles + (my & 7) * 8;
+    int col = mx >> 3;
+    uint32_t* d = (uint32_t*)lineBuf;
+    for (int i = 0; i <= FCON_W / 8; ++i) {
+      const uint32_t* t = (const uint32_t*)(src + row[(col + i) & (FCON_MAP_W - 1)] * 64);
+      d[0] = t[0];
+      d[1] = t[1];
+      d += 2;
+    }
+    out = lineBuf + (mx & 7);
+  } else {
+    memset(lineBuf, 0, FCON_W);
+  }
+
+  // --- Draw layer ---
+  if (fbRows[y]) {
+    const uint8_t* s = fb + y * FCON_W;
+    for (int x = 0; x < FCON_W; x += 4) {
+      if (!*(const uint32_t*)(s + x)) continue;
+      if (s[x])     out[x]     = s[x];
+      if (s[x + 1]) out[x + 1] = s[x + 1];
+      if (s[x + 2]) out[x + 2] = s[x + 2];
+      if (s[x + 3]) out[x + 3] = s[x + 3];
+    }
+  }
+
+  // --- Sprites (slot order: higher slots on top) ---
+  for (int i = 0; i < visibleCount; ++i) {
+    const Sprite& sp = sprites[visible[i]];
+    int r = y - sp.y;
+    if ((unsigned)r >= 8) continue;
+    if (sp.flags & FCON_FLIP_Y) r = 7 - r;
+    const uint8_t* p = tiles + sp.tile * 64 + r * 8;
+    const int step = (sp.flags & FCON_FLIP_X) ? -1 : 1;
+    if (step < 0) p += 7;
+
+    int x0 = sp.x, k0 = 0, k1 = 8;
+    if (x0 < 0)          k0 = -x0;
+    if (x0 + 8 > FCON_W) k1 = FCON_W - x0;
+    for (int k = k0; k < k1; ++k) {
+      uint8_t c = p[k * step];
+      if (c) out[x0 + k] = c;
+    }
+  }
+  return out;
+}
+
+static void renderFrame(bool toPanel) {
+  collectSprites();
+  if (!toPanel) {
+    for (int y = 0; y < FCON_H; ++y) renderLine(y);
+    return;
+  }
+  if (palDirty) { scanoutSetPalette(palette, 256); palDirty = false; }
+  scanoutFrameBegin();
+  for (int y = 0; y < FCON_H; ++y) scanoutLine(y, renderLine(y));
+  scanoutFrameEnd();
+}
+
+
+// =========================================================
+//  INPUT
+// =========================================================
+static uint16_t readButtons() {
+  uint16_t b = 0;
+  if (controls.up())     b |= FCON_UP;
+  if (controls.down())   b |= FCON_DOWN;
+  if (controls.left())   b |= FCON_LEFT;
+  if (controls.right())  b |= FCON_RIGHT;
+  if (controls.a())      b |= FCON_A;
+  if (controls.b())      b |= FCON_B;
+  if (controls.x())      b |= FCON_X;
+  if (controls.y())      b |= FCON_Y;
+  if (controls.start())  b |= FCON_START;
+  if (controls.select()) b |= FCON_SELECT;
+  return b;
+}
+
+bool fconBtn(uint16_t b)  { return btnNow & b; }
+bool fconBtnp(uint16_t b) { return (btnNow & ~btnLast) & b; }
+
+
+// =========================================================
+//  SESSION LIFECYCLE
+// =========================================================
+bool fconLaunch(const FconCart& c) {
+  if (running) fconStop();
+  if (!allocMachine()) {
+    DBG_IF(FCON, "[Fcon] Out of memory\n");
+    return false;
+  }
+  resetMachine();
+
+  // Largest whole scale that fits the panel (2x on 480x320)
+  int scale = min(tft.width() / FCON_W, tft.height() / FCON_H);
+  if (scale < 1) scale = 1;
+  tft.fillScreen(COL_BG);
+  if (!scanoutBegin(tft, FCON_W, FCON_H, FCON_W * scale, FCON_H * scale)) {
+    DBG_IF(FCON, "[Fcon] No DMA memory for scanout\n");
+    freeMachine();
+    return false;
+  }
+
+  sfxBegin(audioSampleRate() ? audioSampleRate() : AUDIO_SAMPLE_RATE);
+  sync.reset();
+  audioPrime(SYNC_FILL_TARGET);
+
+  cart = &c;
+  if (cart->init) cart->init();
+
+  running = true;
+  nextFrameUs = micros();
+  statStart = millis();
+  statFrames = statCartUs = statRenderUs = 0;
+  DBG_IF(FCON, "[Fcon] Running %s (%dx%d at %dx)\n", cart->name, FCON_W, FCON_H, scale);
+  return true;
+}
+
+bool fconRunning() { return running; }
+
+void fconStop() {
+  if (!running) return;
+  running = false;
+
+  if (cart->quit) cart->quit();
+  sfxStop();
+  audioIdle();
+  scanoutStop();
+  freeMachine();
+  cart = nullptr;
+
+  // Hand the screen back to the menus
+  tft.fillScreen(COL_BG);
+  setMenuInputLockUntil(millis() + 300);
+  if (EditMenu* m = currentMenu()) m->forceRedraw();
+  DBG_IF(FCON, "[Fcon] Session ended\n");
+}
+
+void fconUpdate() {
+  if (!running) return;
+
+  controls.update(controls.mode());
+  if (controls.start() && controls.select()) { fconStop(); return; }
+  btnLast = btnNow;
+  btnNow = readButtons();
+
+  uint32_t t0 = micros();
+  if (cart->update) cart->update();
+  if (cart->draw)   cart->draw();
+  uint32_t t1 = micros();
+  renderFrame(true);
+  uint32_t t2 = micros();
+
+  int n = sfxRender(pcm, sizeof(pcm) / sizeof(pcm[0]));
+  audioWriteResampled(pcm, n, sync.ratio());
+  sync.update(audioFill());
+  frame++;
+
+  statCartUs   += t1 - t0;
+  statRenderUs += t2 - t1;
+  if (++statFrames == 300) {
+    float secs = (millis() - statStart) / 1000.0f;
+    DBG_IF(FCON, "[Fcon] %.1f FPS (cart %.2f ms, render + present %.2f ms), underruns %lu\n",
+           statFrames / secs,
+           statCartUs / 1000.0f / statFrames,
+           statRenderUs / 1000.0f / statFrames,
+           (unsigned long)audioUnderruns());
+    statFrames = statCartUs = statRenderUs = 0;
+    statStart = millis();
+  }
+
+  // --- Pacing: fixed 60 Hz, no catch-up after a stall ---
+  nextFrameUs += FCON_FRAME_US;
+  long wait = (long)(nextFrameUs - micros());
+  if (wait > 0) {
+    if (wait > 2000) delay(wait / 1000);
+    while ((long)(nextFrameUs - micros()) > 0) {}
+  } else if (wait < -(long)FCON_FRAME_US) {
+    nextFrameUs = micros();
+  }
+}
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+// Worst-case screen: every tile row textured, a scrolling map,
+// text on every other draw-layer row and all sprites visible.
+void fconBenchmark(uint16_t frames) {
+  if (running) fconStop();
+  if (!allocMachine()) return;
+  resetMachine();
+
+  for (int i = 0; i < 256 * 64; ++i) tiles[i] = (uint8_t)((i * 7 + (i >> 6)) & 15) | 1;
+  for (int ty = 0; ty < FCON_MAP_H; ++ty)
+    for (int tx = 0; tx < FCON_MAP_W; ++tx) tileMap[ty][tx] = (uint8_t)(tx * 13 + ty * 7);
+  for (int y = 0; y < FCON_H; y += 12) fconPrint("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG", 2, y, 7);
+
+  uint32_t worst = 0, total = 0;
+  for (uint16_t f = 0; f < frames; ++f) {
+    scrollX = f; scrollY = f / 2;
+    for (int i = 0; i < FCON_SPRITES; ++i)
+      fconSpr(i, (i * 37 + f) % (FCON_W + 8) - 8, (i * 23 + f) % (FCON_H + 8) - 8, i, i & 3);
+    uint32_t t0 = micros();
+    renderFrame(false);
+    uint32_t us = micros() - t0;
+    total += us;
+    if (us > worst) worst = us;
+  }
+
+  DBG_IF(FCON, "[Fcon] Bench: %u frames, tilemap + draw layer + %d sprites: %.2f ms/frame (worst %.2f ms)\n",
+         frames, FCON_SPRITES, total / 1000.0f / frames, worst / 1000.0f);
+  freeMachine();
+}
+
+
+// =========================================================
+//  CART API — PALETTE / DRAW LAYER
+// =========================================================
+void fconPal(uint8_t idx, uint16_t c) {
+  palette[idx] = c;
+  palDirty = true;
+}
+
+void fconCls(uint8_t c) {
+  memset(fb, c, (size_t)FCON_W * FCON_H);
+  memset(fbRows, c ? 1 : 0, sizeof(fbRows));
+}
+
+void fconPset(int x, int y, uint8_t c) {
+  if ((unsigned)x >= (unsigned)FCON_W || (unsigned)y >= (unsigned)FCON_H) return;
+  fb[y * FCON_W + x] = c;
+  fbRows[y] = 1;
+}
+
+uint8_t* fconDrawRow(int y) {
+  if (!fb || (unsigned)y >= (unsigned)FCON_H) return nullptr;
+  fbRows[y] = 1;
+  return fb + y * FCON_W;
+}
+
+uint8_t fconPget(int x, int y) {
+  if ((unsigned)x >= (unsigned)FCON_W || (unsigned)y >= (unsigned)FCON_H) return 0;
+  return fb[y * FCON_W + x];
+}
+
+void fconRect(int x, int y, int w, int h, uint8_t c, bool fill) {
+  if (!fill) {
+    fconLine(x, y, x + w - 1, y, c);
+    fconLine(x, y + h - 1, x + w - 1, y + h - 1, c);
+    fconLine(x, y, x, y + h - 1, c);
+    fconLine(x + w - 1, y, x + w - 1, y + h - 1, c);
+    return;
+  }
+  int x0 = max(x, 0), x1 = min(x + w, (int)FCON_W);
+  int y0 = max(y, 0), y1 = min(y + h, (int)FCON_H);
+  if (x0 >= x1) return;
+  for (int yy = y0; yy < y1; ++yy) {
+    memset(fb + yy * FCON_W + x0, c, x1 - x0);
+    fbRows[yy] = 1;
+  }
+}
+
+void fconLine(int x0, int y0, int x1, int y1, uint8_t c) {
+  int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+  for (;;) {
+    fconPset(x0, y0, c);
+    if (x0 == x1 && y0 == y1) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+void fconPrint(const char* s, int x, int y, uint8_t c) {
+  for (; *s; ++s, x += 4) {
+    char ch = *s;
+    if (ch >= 'a' && ch <= 'z') ch -= 32;
+    if (ch < ' ' || ch > '_') continue;
+    uint16_t g = FONT[ch - ' '];
+    for (int row = 0; row < 5; ++row) {
+      uint8_t bits = (g >> (12 - row * 3)) & 7;
+      if (bits & 4) fconPset(x,     y + row, c);
+      if (bits & 2) fconPset(x + 1, y + row, c);
+      if (bits & 1) fconPset(x + 2, y + row, c);
+    }
+  }
+}
+
+
+// =========================================================
+//  CART API — TILES / MAP / SPRITES / SOUND
+// =========================================================
+void     fconSetTile(uint8_t idx, const uint8_t* px) { memcpy(tiles + idx * 64, px, 64); }
+uint8_t* fconTile(uint8_t idx)                        { return tiles + idx * 64; }
+
+void fconMapSet(int tx, int ty, uint8_t tile) {
+  tileMap[ty & (FCON_MAP_H - 1)][tx & (FCON_MAP_W - 1)] = tile;
+}
+uint8_t fconMapGet(int tx, int ty) {
+  return tileMap[ty & (FCON_MAP_H - 1)][tx & (FCON_MAP_W - 1)];
+}
+void fconMapShow(bool on)     { mapOn = on; }
+void fconScroll(int x, int y) { scrollX = x; scrollY = y; }
+
+void fconSpr(uint8_t slot, int x, int y, uint8_t tile, uint8_t flags) {
+  if (slot >= FCON_SPRITES) return;
+  sprites[slot] = { (int16_t)x, (int16_t)y, tile, flags };
+}
+void fconSprHide(uint8_t slot) {
+  if (slot < FCON_SPRITES) sprites[slot].flags |= FCON_HIDDEN;
+}
+
+void fconSfx(uint8_t voice, const SfxNote& note) { sfxPlay(voice, note); }
+
+uint32_t fconFrame() { return frame; }
+
+// ======================= End of File =======================
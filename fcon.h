@@ -0,0 +1,122 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  fcon.h — Fantasy Console Runtime (Header)
+//
+//  A fixed little 2D machine for homebrew games: carts draw
+//  into indexed layers and never touch TFT_eSPI.
+//
+//  Provides:
+//   • FconCart         — init / update / draw / quit callbacks
+//   • fconLaunch() / fconUpdate() / fconStop() — session
+//   • Draw layer: fconCls / fconPset / fconRect / fconLine / fconPrint
+//     (3D: r3d.h renders into it through fconDrawRow)
+//   • Tiles + map: fconSetTile / fconMapSet / fconScroll
+//   • Sprites: fconSpr (FCON_SPRITES 8x8, tiles from the same bank)
+//   • Input: fconBtn / fconBtnp
+//   • Sound: fconSfx → SFX mixer (sfx.h)
+//   • fconBenchmark() — renderer timing over Serial
+//
+//  Screen:
+//   - FCON_W x FCON_H pixels, 8-bit colour indices into a
+//     256-entry RGB565 palette (the first 16 preset).
+//   - Layers, back to front: tilemap → draw layer (index 0 is
+//     transparent) → sprites (index 0 transparent, higher
+//     slots on top).
+//
+//  Notes:
+//   - update() + draw() run exactly once per 60 Hz tick.
+//   - START + SELECT exits back to the Homebrew menu.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include "sfx.h"
+
+// =========================================================
+//  TYPES
+// =========================================================
+struct FconCart {
+  const char* name;
+  void (*init)();
+  void (*update)();
+  void (*draw)();
+  void (*quit)();   // optional: session ended (exit or relaunch)
+};
+
+enum : uint16_t {
+  FCON_UP     = 0x001,
+  FCON_DOWN   = 0x002,
+  FCON_LEFT   = 0x004,
+  FCON_RIGHT  = 0x008,
+  FCON_A      = 0x010,
+  FCON_B      = 0x020,
+  FCON_X      = 0x040,
+  FCON_Y      = 0x080,
+  FCON_START  = 0x100,
+  FCON_SELECT = 0x200,
+};
+
+enum : uint8_t {
+  FCON_FLIP_X = 0x01,
+  FCON_FLIP_Y = 0x02,
+  FCON_HIDDEN = 0x80,
+};
+
+// =========================================================
+//  SESSION
+// =========================================================
+bool fconLaunch(const FconCart& cart);
+bool fconRunning();
+void fconUpdate();   // one tick; call from loop()
+void fconStop();
+
+// Renders `frames` frames of a full tilemap + all sprites with
+// no panel output and logs the time per frame.
+void fconBenchmark(uint16_t frames);
+
+// =========================================================
+//  CART API
+// =========================================================
+// --- Palette ---
+void fconPal(uint8_t idx, uint16_t rgb565);
+
+// --- Draw layer ---
+void    fconCls(uint8_t c = 0);
+void    fconPset(int x, int y, uint8_t c);
+uint8_t fconPget(int x, int y);
+void    fconRect(int x, int y, int w, int h, uint8_t c, bool fill = true);
+void    fconLine(int x0, int y0, int x1, int y1, uint8_t c);
+void    fconPrint(const char* s, int x, int y, uint8_t c);  // 3x5 glyphs, 4 px apart
+uint8_t* fconDrawRow(int y);   // FCON_W indices, marked drawn (nullptr off-screen)
+
+// --- Tiles + map ---
+// A tile is 64 colour indices, row by row.
+void    fconSetTile(uint8_t idx, const uint8_t* px);
+uint8_t* fconTile(uint8_t idx);
+void    fconMapSet(int tx, int ty, uint8_t tile);
+uint8_t fconMapGet(int tx, int ty);
+void    fconMapShow(bool on);
+void    fconScroll(int x, int y);
+
+// --- Sprites ---
+void fconSpr(uint8_t slot, int x, int y, uint8_t tile, uint8_t flags = 0);
+void fconSprHide(uint8_t slot);
+
+// --- Input ---
+bool fconBtn(uint16_t b);   // held
+bool fconBtnp(uint16_t b);  // pressed this tick
+
+// --- Sound ---
+void fconSfx(uint8_t voice, const SfxNote& note);
+
+// --- Time ---
+uint32_t fconFrame();
+
+// =========================================================
+//  BUILT-IN CARTS
+// =========================================================
+extern const FconCart FCON_DEMO;     // fcon_demo.cpp
+extern const FconCart FCON_DEMO3D;   // fcon_demo3d.cpp
+
+// ======================= End of File =======================
@@ -0,0 +1,165 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  fcon_demo.cpp — Built-in Homebrew Demo Cart
+//
+//  A small cart that exercises the whole runtime: a scrolling
+//  starfield tilemap, a ship on the D-pad, bouncing sprites in
+//  every remaining slot, a HUD on the draw layer and SFX.
+//
+//  Controls:
+//   • D-pad  — move          • A — fire (pulse sweep)
+//   • B      — toggle the map • X — scatter the balls (noise)
+// =========================================================
+
+#include "fcon.h"
+#include "config.h"
+
+// =========================================================
+//  ART
+// =========================================================
+enum : uint8_t { T_SPACE = 0, T_STAR = 1, T_BIG_STAR = 2, T_SHIP = 16, T_BALL = 17, T_SHOT = 18 };
+
+static void makeTiles() {
+  uint8_t px[64];
+
+  memset(px, 1, 64);                        // deep blue
+  fconSetTile(T_SPACE, px);
+  px[3 * 8 + 4] = 6;
+  fconSetTile(T_STAR, px);
+  px[2 * 8 + 4] = px[4 * 8 + 4] = px[3 * 8 + 3] = px[3 * 8 + 5] = 13;
+  px[3 * 8 + 4] = 7;
+  fconSetTile(T_BIG_STAR, px);
+
+  // Ship: arrow pointing right
+  static const char* SHIP[8] = {
+    "cc......", ".ccc....", ".c7cc...", ".c77ccc.",
+    ".c77ccc.", ".c7cc...", ".ccc....", "cc......",
+  };
+  // Ball: filled circle with a highlight
+  static const char* BALL[8] = {
+    "..8888..", ".877888.", "88778888", "88888888",
+    "88888888", "88888882", ".888882.", "..2222..",
+  };
+  auto load = [&](uint8_t idx, const char* const* rows) {
+    for (int y = 0; y < 8; ++y)
+      for (int x = 0; x < 8; ++x) {
+        char c = rows[y][x];
+        px[y * 8 + x] = c == '.' ? 0 : (c <= '9' ? c - '0' : c - 'a' + 10);
+      }
+    fconSetTile(idx, px);
+  };
+  load(T_SHIP, SHIP);
+  load(T_BALL, BALL);
+
+  memset(px, 0, 64);
+  for (int x = 1; x < 7; ++x) px[3 * 8 + x] = px[4 * 8 + x] = 10;
+  fconSetTile(T_SHOT, px);
+}
+
+
+// =========================================================
+//  GAME STATE
+// =========================================================
+static constexpr int BALLS = FCON_SPRITES - 2;   // slot 0 = ship, 1 = shot
+
+struct Ball { int16_t x, y; int8_t dx, dy; };
+
+static Ball    balls[BALLS];
+static int16_t shipX, shipY;
+static int16_t shotX = -1, shotY;
+static bool    showMap = true;
+static uint16_t hits = 0;
+
+static void scatter() {
+  for (int i = 0; i < BALLS; ++i) {
+    balls[i].x  = (i * 53) % (FCON_W - 8);
+    balls[i].y  = (i * 29) % (FCON_H - 8);
+    balls[i].dx = (i & 1) ? 1 : -1;
+    balls[i].dy = (i & 2) ? 1 : -1;
+  }
+}
+
+static void demoInit() {
+  makeTiles();
+  for (int ty = 0; ty < FCON_MAP_H; ++ty)
+    for (int tx = 0; tx < FCON_MAP_W; ++tx) {
+      uint32_t h = (tx * 73856093u) ^ (ty * 19349663u);
+      fconMapSet(tx, ty, (h % 11 == 0) ? T_STAR : (h % 37 == 0) ? T_BIG_STAR : T_SPACE);
+    }
+  shipX = 16;
+  shipY = FCON_H / 2;
+  shotX = -1;
+  showMap = true;
+  hits = 0;
+  scatter();
+}
+
+
+// =========================================================
+//  UPDATE / DRAW
+// =========================================================
+static void demoUpdate() {
+  if (fconBtn(FCON_LEFT)  && shipX > 0)           shipX--;
+  if (fconBtn(FCON_RIGHT) && shipX < FCON_W - 8)  shipX++;
+  if (fconBtn(FCON_UP)    && shipY > 8)           shipY--;
+  if (fconBtn(FCON_DOWN)  && shipY < FCON_H - 8)  shipY++;
+
+  if (fconBtnp(FCON_A) && shotX < 0) {
+    shotX = shipX + 8;
+    shotY = shipY;
+    SfxNote n;
+    n.wave = SfxWave::PULSE; n.hz = 1400; n.slide = -90; n.frames = 12; n.fade = true; n.duty = 8;
+    fconSfx(0, n);
+  }
+  if (fconBtnp(FCON_B)) showMap = !showMap;
+  if (fconBtnp(FCON_X)) {
+    scatter();
+    SfxNote n;
+    n.wave = SfxWave::NOISE; n.hz = 300; n.frames = 20; n.fade = true;
+    fconSfx(3, n);
+  }
+
+  if (shotX >= 0) {
+    shotX += 4;
+    if (shotX >= FCON_W) shotX = -1;
+  }
+
+  for (int i = 0; i < BALLS; ++i) {
+    Ball& b = balls[i];
+    b.x += b.dx; b.y += b.dy;
+    if (b.x <= 0 || b.x >= FCON_W - 8) b.dx = -b.dx;
+    if (b.y <= 8 || b.y >= FCON_H - 8) b.dy = -b.dy;
+
+    if (shotX >= 0 && abs(shotX - b.x) < 6 && abs(shotY - b.y) < 6) {
+      shotX = -1;
+      b.y = 8;
+      hits++;
+      SfxNote n;
+      n.wave = SfxWave::TRIANGLE; n.hz = 220 + (hits % 8) * 55; n.frames = 8; n.vol = 15;
+      fconSfx(1, n);
+    }
+  }
+}
+
+static void demoDraw() {
+  fconMapShow(showMap);
+  fconScroll(fconFrame() / 2, 0);
+
+  fconCls(0);
+  fconRect(0, 0, FCON_W, 7, 0x01);
+  char hud[40];
+  snprintf(hud, sizeof(hud), "HITS %u  SPRITES %d", hits, FCON_SPRITES);
+  fconPrint(hud, 2, 1, 7);
+  fconPrint("A FIRE  B MAP  X SCATTER", FCON_W - 24 * 4 - 2, 1, 6);
+
+  fconSpr(0, shipX, shipY, T_SHIP);
+  if (shotX >= 0) fconSpr(1, shotX, shotY, T_SHOT);
+  else            fconSprHide(1);
+  for (int i = 0; i < BALLS; ++i)
+    fconSpr(2 + i, balls[i].x, balls[i].y, T_BALL, (i & 1) ? FCON_FLIP_X : 0);
+}
+
+const FconCart FCON_DEMO = { "Sprite Demo", demoInit, demoUpdate, demoDraw };
+
+// ======================= End of File =======================
@@ -0,0 +1,136 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  fcon_demo3d.cpp — Built-in 3D Demo Cart
+//
+//  A flat-shaded cube with an octahedron orbiting through it,
+//  drawn with r3d.h into the draw layer over the tilemap, so
+//  the intersection shows the depth buffer at work.
+//
+//  Controls:
+//   • D-pad  — turn the cube   • A — wireframe on / off
+//   • B      — z-buffer / painter's sort
+// =========================================================
+
+#include "fcon.h"
+#include "config.h"
+#include "r3d.h"
+
+// =========================================================
+//  PALETTE + MESHES
+// =========================================================
+// Six ramps of SHADES entries from RAMP_BASE, dark → bright
+static constexpr uint8_t RAMP_BASE = 32;
+static constexpr uint8_t SHADES    = 4;
+
+static const uint32_t RAMPS[6] = { 0xE04040, 0x40C060, 0x4070E0, 0xE0C040, 0xC050D0, 0x40C8D0 };
+
+static uint8_t ramp(int i) { return RAMP_BASE + i * SHADES; }
+
+static constexpr r3dfx O = R3D_ONE;
+static const R3dVec CUBE_V[8] = {
+  { -O, -O, -O }, {  O, -O, -O }, {  O,  O, -O }, { -O,  O, -O },
+  { -O, -O,  O }, {  O, -O,  O }, {  O,  O,  O }, { -O,  O,  O },
+};
+// Counter-clockwise seen from outside
+static const uint16_t CUBE_T[36] = {
+  0, 2, 3,  0, 1, 2,   4, 6, 5,  4, 7, 6,   0, 5, 1,  0, 4, 5,
+  3, 6, 7,  3, 2, 6,   0, 7, 4,  0, 3, 7,   1, 6, 2,  1, 5, 6,
+};
+static uint8_t CUBE_C[12];   // filled per frame (wireframe is unshaded: brightest)
+
+static constexpr r3dfx H = R3D_ONE * 3 / 5;
+static const R3dVec OCTA_V[6] = {
+  { H, 0, 0 }, { -H, 0, 0 }, { 0, H, 0 }, { 0, -H, 0 }, { 0, 0, H }, { 0, 0, -H },
+};
+static const uint16_t OCTA_T[24] = {
+  2, 0, 4,  2, 4, 1,  2, 1, 5,  2, 5, 0,
+  3, 4, 0,  3, 1, 4,  3, 5, 1,  3, 0, 5,
+};
+
+static const R3dMesh CUBE = { CUBE_V, CUBE_T, CUBE_C, 8, 12 };
+static const R3dMesh OCTA = { OCTA_V, OCTA_T, nullptr, 6, 8 };
+
+
+// =========================================================
+//  STATE
+// =========================================================
+static uint16_t yaw, pitch;
+static bool     wire, zbuf;
+
+static void demoInit() {
+  for (int r = 0; r < 6; ++r) {
+    uint32_t c = RAMPS[r];
+    for (int s = 0; s < SHADES; ++s) {
+      uint32_t k = 64 + s * 192 / (SHADES - 1);   // 25 % .. 100 %
+      uint32_t rr = ((c >> 16) & 0xFF) * k >> 8, gg = ((c >> 8) & 0xFF) * k >> 8, bb = (c & 0xFF) * k >> 8;
+      fconPal(ramp(r) + s, ((rr & 0xF8) << 8) | ((gg & 0xFC) << 3) | (bb >> 3));
+    }
+  }
+
+  // Dark checker behind everything
+  uint8_t px[64];
+  for (int i = 0; i < 64; ++i) px[i] = ((i >> 3) < 4) == ((i & 7) < 4) ? 1 : 0;
+  fconSetTile(0, px);
+  for (int ty = 0; ty < FCON_MAP_H; ++ty)
+    for (int tx = 0; tx < FCON_MAP_W; ++tx) fconMapSet(tx, ty, 0);
+  fconMapShow(true);
+  fconScroll(0, 0);
+
+  r3dCamera(FCON_H << 16, R3D_ONE / 4);
+  r3dLight({ R3D_ONE / 2, R3D_ONE, -R3D_ONE }, SHADES);
+  yaw = pitch = 0;
+  wire = false;
+  zbuf = true;
+}
+
+
+// =========================================================
+//  UPDATE / DRAW
+// =========================================================
+static void demoUpdate() {
+  yaw += 180;
+  if (fconBtn(FCON_LEFT))  yaw -= 600;
+  if (fconBtn(FCON_RIGHT)) yaw += 600;
+  if (fconBtn(FCON_UP))    pitch -= 500;
+  if (fconBtn(FCON_DOWN))  pitch += 500;
+  if (fconBtnp(FCON_A)) wire = !wire;
+  if (fconBtnp(FCON_B)) zbuf = !zbuf;
+}
+
+static void demoDraw() {
+  fconCls(0);
+
+  const uint8_t lift = wire ? SHADES - 1 : 0;
+  for (int f = 0; f < 12; ++f) CUBE_C[f] = ramp(f / 2 % 5) + lift;
+  r3dBegin((wire ? R3D_WIRE : R3D_SHADE) | (zbuf ? R3D_ZBUF : 0) | R3D_CULL);
+
+  R3dMat m;
+  r3dIdentity(m);
+  r3dRotate(m, 'y', yaw);
+  r3dRotate(m, 'x', pitch);
+  r3dTranslate(m, 0, 0, 4 * R3D_ONE);
+  r3dMesh(CUBE, m, ramp(0));
+
+  // Orbit on a tilted circle that cuts through the cube's faces
+  uint16_t t = (uint16_t)(fconFrame() * 350);
+  r3dIdentity(m);
+  r3dRotate(m, 'z', t * 2);
+  r3dRotate(m, 'y', t * 3);
+  r3dTranslate(m, r3dCos(t) * 6 / 5, r3dSin(t) / 3, 4 * R3D_ONE + r3dSin(t) * 6 / 5);
+  r3dMesh(OCTA, m, ramp(5) + lift);
+
+  r3dEnd();
+
+  R3dStats st = r3dStats();
+  char hud[48];
+  fconRect(0, 0, FCON_W, 7, 0x01);
+  snprintf(hud, sizeof(hud), "TRIS %lu/%lu  %lu US  %s", (unsigned long)st.drawn,
+           (unsigned long)st.submitted, (unsigned long)st.us, zbuf ? "ZBUF" : "SORT");
+  fconPrint(hud, 2, 1, 7);
+  fconPrint("A WIRE  B DEPTH", FCON_W - 15 * 4 - 2, 1, 6);
+}
+
+const FconCart FCON_DEMO3D = { "3D Demo", demoInit, demoUpdate, demoDraw };
+
+// ======================= End of File =======================
@@ -0,0 +1,119 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  gallery.cpp — Media Gallery
+//
+//  Lists the playable media in GALLERY_DIR as a regular
+//  EditMenu, styled like whichever menu opened it, and hands
+//  the selected file to its player.
+//
+//  Notes:
+//   - The list is rebuilt on every open, so SD changes show
+//     up without a reboot.
+// =========================================================
+
+#include "gallery.h"
+#include "config.h"
+#include "controls.h"
+#include "dither.h"
+#include "blend.h"
+#include "icons.h"
+#include "video.h"
+#include "gif.h"
+#include "split.h"
+#include "channel.h"
+#include "sdcard.h"
+#include <SD.h>
+
+extern TFT_eSPI tft;
+
+// =========================================================
+//  STATE
+// =========================================================
+static EditMenu* galMenu = nullptr;
+static String    mediaPaths[MAX_OPT];
+static uint16_t  mediaCount = 0;
+
+EditMenu* galleryMenu() { return galMenu; }
+
+
+// =========================================================
+//  SCAN
+// =========================================================
+// "/gallery/Intro.avi" -> "Intro"
+static String displayName(const String& name) {
+  int slash = name.lastIndexOf('/');
+  int dot   = name.lastIndexOf('.');
+  return name.substring(slash + 1, dot > slash ? dot : name.length());
+}
+
+static void scanMedia() {
+  mediaCount = 0;
+  galMenu->clearItems();
+
+  {
+    SdBus bus;
+    File dir = SD.open(GALLERY_DIR);
+    if (dir && dir.isDirectory()) {
+      File f = dir.openNextFile();
+      while (f && mediaCount < MAX_OPT) {
+        String name = f.name();
+        if (!f.isDirectory() && (videoIsFile(name) || gifIsFile(name))) {
+          mediaPaths[mediaCount++] = f.path();
+          galMenu->addItem(makeLabel(displayName(name)));
+        }
+        f = dir.openNextFile();
+      }
+    }
+  }
+
+  if (mediaCount == 0) {
+    galMenu->addItem(makeLabel("No media in " GALLERY_DIR));
+    galMenu->setItemEnabled(0, false);
+  }
+  DBG_IF(VIDEO, "[Gallery] %u file(s) in %s\n", mediaCount, GALLERY_DIR);
+}
+
+
+// =========================================================
+//  OPEN + ACTIVATE
+// =========================================================
+void openGallery() {
+  EditMenu* parent = currentMenu();
+  if (!galMenu) galMenu = new EditMenu(tft);
+
+  // Inherit look + input from the launching menu
+  if (parent) {
+    galMenu->setTheme(parent->theme());
+    galMenu->setInputMode(parent->inputMode());
+    galMenu->settings = parent->settings;
+  }
+
+  scanMedia();
+  pushMenu(galMenu);
+  setMenuInputLockUntil(millis() + 150);
+}
+
+void handleGalleryActivation(EditMenu& menu, int idx) {
+  if (idx < 0 || idx >= mediaCount) return;
+  const char* path = mediaPaths[idx].c_str();
+
+  // Diagnostics build only: blocks the UI until all are done
+  if (Debug::BENCHMARKS && controls.select()) {
+    ditherBenchmark();
+    blendBenchmark();
+    iconBenchmark();
+    splitBenchmark();
+    channelBenchmark();
+    menu.forceRedraw();
+    return;
+  }
+
+  bool ok = gifIsFile(mediaPaths[idx]) ? gifPlay(path) : videoPlay(path);
+  if (!ok) {
+    DBG_IF(VIDEO, "[Gallery] Can't play %s\n", path);
+    menu.forceRedraw();
+  }
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,33 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  gallery.h — Media Gallery (Header)
+//
+//  Provides:
+//   • openGallery()              — Scan GALLERY_DIR and push the list
+//   • galleryMenu()              — The menu instance (for dispatch)
+//   • handleGalleryActivation()  — Play the selected video / GIF
+//
+//  Notes:
+//   - Up to MAX_OPT files are listed (menu item limit).
+//   - With Debug::BENCHMARKS, holding SELECT while confirming
+//     runs, over Serial: the RGB888 → RGB565 conversion modes
+//     (dither.h), the blending kernels (blend.h), the icon
+//     rasterizer (icons.h), one core vs two (split.h) and the
+//     channel stress test + benchmark (channel.h). The UI is
+//     blocked until all five are done (the channel test alone
+//     takes seconds).
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include "MenuUI.h"
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+void      openGallery();
+EditMenu* galleryMenu();
+void      handleGalleryActivation(EditMenu& menu, int idx);
+
+// ======================= End of File =======================
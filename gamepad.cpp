@@ -9,11 +9,17 @@
 //   • Real-time button & axis state mapping
 //   • Debounce handling for onboard pairing button
 //   • Hooks for MenuUI (gpA(), gpLX(), etc.)
+//
+//  Notes:
+//   - Pairing-button sampling (debounce), the long hold, the
+//     pairing blink and its timeout are timerwheel.h timers;
+//     the LED is only written when its state changes.
 // =========================================================
 
 #include "gamepad.h"
 #include "config.h"
 #include "MenuUI.h"
+#include "timerwheel.h"
 #include "nvs_flash.h"
 #include <Bluepad32.h>
 
@@ -23,17 +29,23 @@
 static ControllerPtr ctl = nullptr;
 static bool connected     = false;
 static bool pairingMode   = false;
-static unsigned long pressStart   = 0;
-static unsigned long lastBlink    = 0;
-static unsigned long pairingStart = 0;
-static bool buttonLast   = false;
-static bool ledState     = false;
-static bool firstLoop    = true;
+static bool buttonLast    = false;   // debounced pairing button
+static bool ledState      = false;
+static TimerId sampleTimer = 0;     // every DEBOUNCE_MS
+static TimerId holdTimer   = 0;     // HOLD_TIME_MS after press
+static TimerId blinkTimer  = 0;     // pairing blink
+static TimerId pairTimer   = 0;     // pairing timeout
 
 // LED driver channel settings
 const int LED_CHANNEL = 0;
 const int LED_FREQ    = 5000;
 const int LED_RES     = 8;
+const int LED_BRIGHT  = 40;
+
+// Solid when connected, off otherwise
+static void showLink() { ledcWrite(LED_CHANNEL, connected ? LED_BRIGHT : 0); }
+
+static void stopPairing();
 
 // Shared gamepad state structure
 static GamepadState state;
@@ -46,17 +58,17 @@ const GamepadState& getGamepadState() { return state; }
 static void onConnectedController(ControllerPtr c) {
   ctl = c;
   connected = true;
-  pairingMode = false;
-  pressStart = 0;
+  timerCancel(holdTimer);
+  if (pairingMode) stopPairing();
 
-  ledcWrite(LED_CHANNEL, 40);
+  showLink();
   Serial.printf("[Pad] Connected: %s\n", c ? c->getModelName().c_str() : "unknown");
 }
 
 static void onDisconnectedController(ControllerPtr c) {
   if (ctl == c) ctl = nullptr;
   connected = false;
-  ledcWrite(LED_CHANNEL, 0);
+  if (!pairingMode) showLink();
   Serial.println("[Pad] Disconnected");
 }
 
@@ -64,25 +76,49 @@ static void onDisconnectedController(ControllerPtr c) {
 // =========================================================
 //  PAIRING HELPERS
 // =========================================================
+static void pairingBlink(void*) {
+  ledState = !ledState;
+  ledcWrite(LED_CHANNEL, ledState ? LED_BRIGHT : 0);
+}
+
+static void pairingTimeout(void*) { stopPairing(); }
+
 static void startPairing() {
   pairingMode = true;
-  pairingStart = millis();
-  lastBlink = pairingStart;
   ledState = false;
 
   BP32.enableNewBluetoothConnections(true);
   ledcWrite(LED_CHANNEL, 0);
+  blinkTimer = timerEvery(BLINK_PERIOD_MS, pairingBlink, nullptr);
+  pairTimer = timerAfter(FLASH_TIME_MS, pairingTimeout, nullptr);
 
   Serial.println("[Pad] Pairing mode...");
 }
 
 static void stopPairing() {
   pairingMode = false;
+  timerCancel(blinkTimer);
+  timerCancel(pairTimer);
   BP32.enableNewBluetoothConnections(false);
-  ledcWrite(LED_CHANNEL, 0);
+  showLink();
   Serial.println("[Pad] Pairing stopped");
 }
 
+// Long hold with nothing connected starts pairing
+static void pairingHold(void*) {
+  if (!connected && !pairingMode) startPairing();
+}
+
+// Sampling every DEBOUNCE_MS is the debounce: bounces
+// shorter than that are never seen
+static void sampleButton(void*) {
+  bool btn = !digitalRead(BTN_PIN);
+  if (btn == buttonLast) return;
+  buttonLast = btn;
+  if (btn) holdTimer = timerAfter(HOLD_TIME_MS, pairingHold, nullptr);
+  else     timerCancel(holdTimer);
+}
+
 
 // =========================================================
 //  SETUP
@@ -104,18 +140,23 @@ void setupGamepad() {
   BP32.setup(&onConnectedController, &onDisconnectedController);
   delay(300);
   BP32.enableNewBluetoothConnections(false);
+
+  // A button already held at boot doesn't count as a press
+  buttonLast = !digitalRead(BTN_PIN);
+  sampleTimer = timerEvery(DEBOUNCE_MS, sampleButton, nullptr);
 }
 
 
 // =========================================================
 //  LOOP UPDATE
 // =========================================================
-// Handles input state refresh, pairing button logic,
-// LED blinking, and controller connection management.
+// Refreshes input state and tracks the connection; the
+// pairing button and LED run on timers (see PAIRING HELPERS).
 void updateGamepad() {
   BP32.update();
 
   // --- Update Gamepad State ---
+  bool was = connected;
   if (!ctl || !ctl->isConnected()) {
     connected = false;
     state = GamepadState();
@@ -133,64 +174,11 @@ void updateGamepad() {
     state.y = ctl->y();
   }
 
-  // --- Button Debounce ---
-  unsigned long now = millis();
-  bool btn = !digitalRead(BTN_PIN);
-  static unsigned long lastDebounce = 0;
-  static bool debounced = false;
-
-  if (now - lastDebounce >= DEBOUNCE_MS) {
-    debounced = btn;
-    lastDebounce = now;
-  }
-
-  // Skip first iteration
-  if (firstLoop) {
-    firstLoop = false;
-    buttonLast = debounced;
-    return;
-  }
-
-  // --- Pairing Button Logic ---
-  if (debounced && !buttonLast)
-    pressStart = now;
-  if (!debounced && buttonLast)
-    pressStart = 0;
-  buttonLast = debounced;
-
-  // Long-hold initiates pairing mode
-  if (debounced && !connected && !pairingMode && pressStart &&
-      (now - pressStart >= HOLD_TIME_MS)) {
-    startPairing();
-  }
-
-  // --- LED Feedback ---
-  const int LED_BRIGHT = 40;
-  const int LED_DIM = 0;
-
-  if (pairingMode && !connected) {
-    // Blink during pairing
-    if (now - lastBlink >= BLINK_PERIOD_MS) {
-      lastBlink = now;
-      ledState = !ledState;
-      ledcWrite(LED_CHANNEL, ledState ? LED_BRIGHT : LED_DIM);
-    }
-    // Timeout pairing mode
-    if (now - pairingStart >= FLASH_TIME_MS)
-      stopPairing();
-  } 
-  else if (connected) {
-    // Solid LED when connected
-    ledcWrite(LED_CHANNEL, LED_BRIGHT);
-  } 
-  else {
-    // LED off otherwise
-    ledcWrite(LED_CHANNEL, 0);
-  }
-
   // Auto-stop pairing once connected
   if (connected && pairingMode)
     stopPairing();
+  else if (connected != was && !pairingMode)
+    showLink();
 }
 
 
@@ -0,0 +1,736 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  gif.cpp — Animated GIF Player
+//
+//  The file is read into PSRAM once; frames are composed into
+//  an RGB565 canvas of the logical screen and only the part
+//  that changed is pushed.
+//
+//  Per frame:
+//   - The previous frame's disposal runs first (2 = clear to
+//     black, 3 = restore the pixels it covered).
+//   - LZW decodes the sub-rectangle into an index buffer with
+//     a fixed 4096-entry table (prefix, suffix, first, length):
+//     every code is written back-to-front in one pass, no
+//     string stack, no allocation.
+//   - Indices are mapped through the frame's palette onto the
+//     canvas, skipping the transparent index — in bands, half
+//     of them on core 0 (split.h).
+//   - The dirty rect (frame rect ∪ disposed rect) is pushed
+//     over DMA, so cost follows the changed area rather than
+//     the screen size.
+//
+//  Frame cache:
+//   - During the first loop each pushed rect is also copied
+//     into GIF_CACHE_KB of PSRAM. If the whole loop fits, later
+//     loops replay those rects without decoding at all.
+//   - Every loop starts from a cleared canvas (as browsers do),
+//     and frame 0 pushes the whole view, so a replay is exact.
+//
+//  Notes:
+//   - A frame whose successor is already due is decoded but
+//     not pushed; its rect joins the next push.
+//   - Delays under 20 ms play at 100 ms, like browsers.
+// =========================================================
+
+#include "gif.h"
+#include "config.h"
+#include "controls.h"
+#include "MenuUI.h"
+#include "split.h"
+#include "esp_heap_caps.h"
+#include <TFT_eSPI.h>
+#include "sdcard.h"
+#include <SD.h>
+
+extern TFT_eSPI tft;
+
+// =========================================================
+//  STATE
+// =========================================================
+struct Rect {
+  int32_t x, y, w, h;
+  bool empty() const { return w <= 0 || h <= 0; }
+};
+
+// Code → string as a chain of prefixes; `first` and `len`
+// let a code be written in place without walking it twice
+struct LzwTable {
+  uint16_t prefix[4096];
+  uint16_t len[4096];
+  uint8_t  suffix[4096];
+  uint8_t  first[4096];
+};
+
+struct CacheEntry {
+  Rect     r;
+  uint32_t offset;   // into cacheArena
+  uint16_t delayMs;
+};
+
+enum class Cache : uint8_t { OFF, FILLING, READY };
+
+static constexpr uint32_t LATE_RESYNC_US = 100000;  // too late to catch up: push and resync
+
+// File
+static uint8_t* data = nullptr;
+static uint32_t dataLen = 0, pos = 0, firstFrame = 0;
+static int32_t  loopsLeft = 0;          // -1 = forever
+static uint32_t pass = 0;
+
+// Picture
+static uint16_t  scrW = 0, scrH = 0;
+static uint16_t* canvas = nullptr;      // byte-swapped RGB565
+static Rect      view;                  // part of the canvas on the panel
+static int32_t   dstX = 0, dstY = 0;    // panel position of canvas (0,0)
+static uint16_t  globalLut[256], frameLut[256];
+static bool      swapWas = false;
+
+// Frame
+static LzwTable* lzw = nullptr;
+static uint8_t*  indices = nullptr;
+static uint32_t  indicesCap = 0;
+static uint16_t* backup = nullptr;      // pixels under a disposal-3 frame
+static uint32_t  backupCap = 0;
+static uint8_t   disposal = 0, prevDisposal = 0;
+static int16_t   transIndex = -1;
+static uint16_t  delayCs = 0;
+static Rect      prevRect = {}, pending = {};
+static uint32_t  frameNo = 0, due = 0;
+
+// Push
+static uint16_t* ring[2] = {};          // DMA blocks, internal SRAM
+static uint32_t  ringPixels = 0;
+static bool      running = false;
+
+// Cache
+static Cache       cache = Cache::OFF;
+static uint8_t*    cacheArena = nullptr;
+static uint32_t    cacheUsed = 0;
+static CacheEntry* cacheFrames = nullptr;
+static uint32_t    cacheCount = 0, cacheCap = 0, replayAt = 0;
+
+// Stats
+static uint32_t startMs = 0, decoded = 0, shown = 0, skipped = 0;
+static uint32_t decodeUs = 0, pushUs = 0;
+static uint64_t pushedPx = 0;
+static uint32_t logAt = 0, logShown = 0, logDecoded = 0, logDecodeUs = 0, logPushUs = 0;
+static uint64_t logPushedPx = 0;
+
+static uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+
+
+// =========================================================
+//  RECTS
+// =========================================================
+static Rect unite(const Rect& a, const Rect& b) {
+  if (a.empty()) return b;
+  if (b.empty()) return a;
+  int32_t x0 = min(a.x, b.x), y0 = min(a.y, b.y);
+  int32_t x1 = max(a.x + a.w, b.x + b.w), y1 = max(a.y + a.h, b.y + b.h);
+  return { x0, y0, x1 - x0, y1 - y0 };
+}
+
+static Rect intersect(const Rect& a, const Rect& b) {
+  int32_t x0 = max(a.x, b.x), y0 = max(a.y, b.y);
+  int32_t x1 = min(a.x + a.w, b.x + b.w), y1 = min(a.y + a.h, b.y + b.h);
+  if (x1 <= x0 || y1 <= y0) return {};
+  return { x0, y0, x1 - x0, y1 - y0 };
+}
+
+
+// =========================================================
+//  BLOCKS
+// =========================================================
+// RGB888 palette → byte-swapped RGB565 (pushed with swap off)
+static void buildLut(uint16_t* lut, const uint8_t* rgb, int count) {
+  for (int i = 0; i < count; ++i, rgb += 3) {
+    uint16_t c = ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+    lut[i] = (c >> 8) | (c << 8);
+  }
+  for (int i = count; i < 256; ++i) lut[i] = 0;
+}
+
+static void skipBlocks() {
+  while (pos < dataLen) {
+    uint8_t n = data[pos++];
+    if (!n) return;
+    pos += n;
+  }
+}
+
+// Walks extensions up to the next image descriptor. Returns
+// false at the trailer (or wherever a truncated file ends).
+static bool nextImage(Rect& r, bool& interlace, const uint16_t*& lut) {
+  disposal = 0;
+  transIndex = -1;
+  delayCs = 0;
+
+  while (pos < dataLen) {
+    uint8_t b = data[pos++];
+    if (b == 0x3B) return false;
+
+    if (b == 0x21 && pos < dataLen) {
+      uint8_t label = data[pos++];
+      if (label == 0xF9 && pos + 5 <= dataLen && data[pos] == 4) {
+        // Graphic control: disposal, delay, transparency
+        uint8_t f  = data[pos + 1];
+        delayCs    = le16(data + pos + 2);
+        disposal   = (f >> 2) & 7;
+        transIndex = (f & 1) ? data[pos + 4] : -1;
+        pos += 5;
+      } else if (label == 0xFF && pos + 12 <= dataLen && data[pos] == 11 &&
+                 memcmp(data + pos + 1, "NETSCAPE2.0", 11) == 0) {
+        // Loop count: 0 = forever, n = n more times
+        pos += 12;
+        if (pass == 0 && pos + 4 <= dataLen && data[pos] == 3 && data[pos + 1] == 1) {
+          uint16_t n = le16(data + pos + 2);
+          loopsLeft = n ? n : -1;
+        }
+      }
+      skipBlocks();
+      continue;
+    }
+
+    if (b == 0x2C && pos + 9 <= dataLen) {
+      r = { le16(data + pos), le16(data + pos + 2), le16(data + pos + 4), le16(data + pos + 6) };
+      uint8_t f = data[pos + 8];
+      pos += 9;
+      interlace = f & 0x40;
+      lut = globalLut;
+      if (f & 0x80) {
+        int count = 2 << (f & 7);
+        if (pos + count * 3 > dataLen) return false;
+        buildLut(frameLut, data + pos, count);
+        lut = frameLut;
+        pos += count * 3;
+      }
+      return true;
+    }
+    break;  // unknown block: treat as the end
+  }
+  return false;
+}
+
+
+// =========================================================
+//  LZW
+// =========================================================
+// Decodes one image's data sub-blocks into `out` (n pixels).
+// Returns how many pixels a damaged stream actually produced.
+static uint32_t decodeLzw(uint8_t* out, uint32_t n) {
+  if (pos >= dataLen) return 0;
+  uint8_t minSize = data[pos++];
+  if (minSize < 1 || minSize > 11) { skipBlocks(); return 0; }
+
+  uint16_t clear = 1 << minSize, eoi = clear + 1;
+  for (uint16_t i = 0; i < clear; ++i) {
+    lzw->len[i] = 1;
+    lzw->suffix[i] = lzw->first[i] = (uint8_t)i;
+  }
+
+  uint16_t next = clear + 2;
+  uint8_t  size = minSize + 1;
+  int32_t  prev = -1;
+  uint32_t bits = 0, got = 0;
+  uint8_t  nbits = 0, block = 0;
+  bool     ended = false;  // block terminator already consumed
+
+  while (got < n) {
+    while (nbits < size) {
+      if (!block && (pos >= dataLen || !(block = data[pos++]))) { ended = true; break; }
+      if (pos >= dataLen) { ended = true; break; }
+      bits |= (uint32_t)data[pos++] << nbits;
+      nbits += 8;
+      block--;
+    }
+    if (ended) break;
+
+    uint16_t code = bits & ((1u << size) - 1);
+    bits >>= size;
+    nbits -= size;
+
+    if (code == clear) {
+      next = clear + 2;
+      size = minSize + 1;
+      prev = -1;
+      continue;
+    }
+    if (code == eoi) break;
+    if (prev < 0) {
+      if (code >= clear) break;
+      out[got++] = (uint8_t)code;
+      prev = code;
+      continue;
+    }
+
+    // New entry: prev + first char of code (or of prev, KwKwK)
+    uint8_t head;
+    if (code < next)       head = lzw->first[code];
+    else if (code == next) head = lzw->first[prev];
+    else break;  // corrupt
+    if (next < 4096) {
+      lzw->prefix[next] = prev;
+      lzw->suffix[next] = head;
+      lzw->first[next]  = lzw->first[prev];
+      lzw->len[next]    = lzw->len[prev] + 1;
+      if (++next == (1u << size) && size < 12) size++;
+    }
+
+    // Emit back-to-front; anything past n is dropped
+    uint32_t end = got + lzw->len[code];
+    uint16_t c = code;
+    for (uint32_t p = end; p-- > got; c = lzw->prefix[c])
+      if (p < n) out[p] = lzw->suffix[c];
+    got = min(end, n);
+    prev = code;
+  }
+
+  if (!ended) {
+    pos += block;
+    skipBlocks();
+  }
+  return got;
+}
+
+
+// =========================================================
+//  CANVAS
+// =========================================================
+static void dispose() {
+  Rect r = prevRect;
+  if (r.empty()) return;
+  if (prevDisposal == 2) {
+    for (int32_t y = r.y; y < r.y + r.h; ++y)
+      memset(canvas + (size_t)y * scrW + r.x, 0, r.w * sizeof(uint16_t));
+  } else if (prevDisposal == 3 && backup) {
+    for (int32_t y = 0; y < r.h; ++y)
+      memcpy(canvas + (size_t)(r.y + y) * scrW + r.x, backup + (size_t)y * r.w, r.w * sizeof(uint16_t));
+  }
+}
+
+static bool saveBackup(const Rect& r) {
+  uint32_t need = (uint32_t)r.w * r.h;
+  if (need > backupCap) {
+    uint16_t* p = (uint16_t*)ps_realloc(backup, need * sizeof(uint16_t));
+    if (!p) return false;
+    backup = p;
+    backupCap = need;
+  }
+  for (int32_t y = 0; y < r.h; ++y)
+    memcpy(backup + (size_t)y * r.w, canvas + (size_t)(r.y + y) * scrW + r.x, r.w * sizeof(uint16_t));
+  return true;
+}
+
+// Maps the decoded indices of frame rect `r` onto the canvas,
+// COMPOSITE_BAND rows per band, split across both cores
+static constexpr uint16_t COMPOSITE_BAND = 16;
+static SplitStats compositeStats;
+
+struct CompositeJob {
+  Rect            r;
+  bool            interlace;
+  const uint16_t* lut;
+  uint32_t        got;
+};
+
+// Canvas row of the i-th stored row (passes: every 8th from 0,
+// every 8th from 4, every 4th from 2, every 2nd from 1)
+static int32_t interlacedRow(int32_t i, int32_t h) {
+  int32_t n = (h + 7) / 8;
+  if (i < n) return i * 8;
+  i -= n; n = (h + 3) / 8;
+  if (i < n) return 4 + i * 8;
+  i -= n; n = (h + 1) / 4;
+  if (i < n) return 2 + i * 4;
+  return 1 + (i - n) * 2;
+}
+
+static void compositeBand(void* ctx, uint16_t band) {
+  const CompositeJob& j = *(const CompositeJob*)ctx;
+  const Rect& r = j.r;
+  int32_t x1 = min(r.x + r.w, (int32_t)scrW);
+  int32_t end = min<int32_t>((band + 1) * COMPOSITE_BAND, r.h);
+
+  for (int32_t i = band * COMPOSITE_BAND; i < end && (uint32_t)i * r.w < j.got; ++i) {
+    int32_t y = r.y + (j.interlace ? interlacedRow(i, r.h) : i);
+    if (y >= scrH) continue;
+
+    const uint8_t* src = indices + (size_t)i * r.w;
+    uint16_t* dst = canvas + (size_t)y * scrW + r.x;
+    int32_t w = min(x1, r.x + (int32_t)(j.got - (uint32_t)i * r.w)) - r.x;
+    if (transIndex < 0) {
+      for (int32_t x = 0; x < w; ++x) dst[x] = j.lut[src[x]];
+    } else {
+      for (int32_t x = 0; x < w; ++x)
+        if (src[x] != transIndex) dst[x] = j.lut[src[x]];
+    }
+  }
+}
+
+static void composite(const Rect& r, bool interlace, const uint16_t* lut, uint32_t got) {
+  CompositeJob j = { r, interlace, lut, got };
+  splitRun((r.h + COMPOSITE_BAND - 1) / COMPOSITE_BAND, compositeBand, nullptr, &j, &compositeStats);
+}
+
+
+// =========================================================
+//  PUSH
+// =========================================================
+// Streams rect `r` (canvas coords) from `src` with row pitch
+// `stride` through two DMA blocks; narrow rects pack more
+// lines per block.
+static void pushPixels(const uint16_t* src, uint32_t stride, const Rect& r) {
+  if (r.empty()) return;
+  uint32_t t0 = micros();
+  int32_t per = max<int32_t>(1, ringPixels / r.w);
+  uint8_t b = 0;
+
+  tft.startWrite();
+  tft.setAddrWindow(r.x + dstX, r.y + dstY, r.w, r.h);
+  for (int32_t y = 0; y < r.h; y += per) {
+    int32_t lines = min(per, r.h - y);
+    for (int32_t l = 0; l < lines; ++l)
+      memcpy(ring[b] + l * r.w, src + (size_t)(y + l) * stride, r.w * sizeof(uint16_t));
+    tft.pushPixelsDMA(ring[b], (uint32_t)lines * r.w);  // waits for the previous block
+    b ^= 1;
+  }
+  tft.dmaWait();
+  tft.endWrite();
+
+  pushUs += micros() - t0;
+  pushedPx += (uint32_t)r.w * r.h;
+}
+
+static void pushCanvas(const Rect& r) {
+  pushPixels(canvas + (size_t)r.y * scrW + r.x, scrW, r);
+}
+
+
+// =========================================================
+//  FRAME CACHE
+// =========================================================
+static void cacheFree() {
+  free(cacheArena);
+  free(cacheFrames);
+  cacheArena = nullptr;
+  cacheFrames = nullptr;
+  cacheUsed = cacheCount = cacheCap = replayAt = 0;
+  cache = Cache::OFF;
+}
+
+static void cacheStore(const Rect& r, uint16_t delayMs) {
+  if (cache != Cache::FILLING) return;
+
+  uint32_t bytes = r.empty() ? 0 : (uint32_t)r.w * r.h * sizeof(uint16_t);
+  if (cacheCount == cacheCap) {
+    CacheEntry* p = (CacheEntry*)ps_realloc(cacheFrames, (cacheCap + 64) * sizeof(CacheEntry));
+    if (p) { cacheFrames = p; cacheCap += 64; }
+  }
+  if (cacheCount == cacheCap || cacheUsed + bytes > GIF_CACHE_KB * 1024) {
+    DBG_IF(GIF, "[GIF] Loop exceeds the %lu KB frame cache; decoding every loop\n",
+           (unsigned long)GIF_CACHE_KB);
+    cacheFree();
+    return;
+  }
+
+  uint16_t* dst = (uint16_t*)(cacheArena + cacheUsed);
+  for (int32_t y = 0; y < r.h; ++y)
+    memcpy(dst + (size_t)y * r.w, canvas + (size_t)(r.y + y) * scrW + r.x, r.w * sizeof(uint16_t));
+  cacheFrames[cacheCount++] = { r, cacheUsed, delayMs };
+  cacheUsed += bytes;
+}
+
+
+// =========================================================
+//  PLAYBACK
+// =========================================================
+// Pushes now, or — if the next frame is already due — defers
+// to the next push. Hopelessly late playback pushes and
+// resyncs instead.
+static void present(const Rect& dirty) {
+  pending = unite(pending, dirty);
+  int32_t late = (int32_t)(micros() - due);
+  if (late >= 0 && late <= (int32_t)LATE_RESYNC_US) { skipped++; return; }
+  if (late > 0) due = micros();
+  pushCanvas(pending);
+  pending = {};
+  shown++;
+}
+
+// Back to the first frame: false when the loop count is spent
+static bool restart() {
+  if (loopsLeft == 0) return false;
+  if (loopsLeft > 0) loopsLeft--;
+  pass++;
+  if (cache == Cache::FILLING && cacheCount) {
+    cache = Cache::READY;
+    DBG_IF(GIF, "[GIF] %lu frames cached in %lu KB; replaying\n",
+           (unsigned long)cacheCount, (unsigned long)(cacheUsed / 1024));
+  }
+
+  pos = firstFrame;
+  memset(canvas, 0, (size_t)scrW * scrH * sizeof(uint16_t));
+  prevRect = {};
+  prevDisposal = 0;
+  frameNo = 0;
+  return true;
+}
+
+static void replay() {
+  if (replayAt == cacheCount) {
+    if (loopsLeft == 0) { gifStop(); return; }
+    if (loopsLeft > 0) loopsLeft--;
+    replayAt = 0;
+  }
+  const CacheEntry& e = cacheFrames[replayAt++];
+  if ((int32_t)(micros() - due) > (int32_t)LATE_RESYNC_US) due = micros();
+  pushPixels((const uint16_t*)(cacheArena + e.offset), e.r.w, e.r);
+  shown++;
+  due += e.delayMs * 1000;
+}
+
+static void step() {
+  uint32_t t0 = micros();
+  Rect fr;
+  bool interlace = false;
+  const uint16_t* lut = globalLut;
+
+  if (!nextImage(fr, interlace, lut)) {
+    if (!restart()) { gifStop(); return; }
+    if (cache == Cache::READY) { replay(); return; }
+    if (!nextImage(fr, interlace, lut)) { gifStop(); return; }
+  }
+
+  uint32_t need = (uint32_t)fr.w * fr.h;
+  if (need > indicesCap) {
+    uint8_t* p = need <= (1u << 22) ? (uint8_t*)ps_realloc(indices, need) : nullptr;
+    if (!p) {
+      DBG_IF(GIF, "[GIF] Frame %lu: %ldx%ld too large\n", (unsigned long)frameNo, (long)fr.w, (long)fr.h);
+      gifStop();
+      return;
+    }
+    indices = p;
+    indicesCap = need;
+  }
+
+  // Frame 0 paints the whole view; later frames what changed
+  Rect dirty = frameNo == 0 ? view : Rect{};
+  if (prevDisposal == 2 || prevDisposal == 3) {
+    dispose();
+    dirty = unite(dirty, intersect(prevRect, view));
+  }
+
+  Rect clip = intersect(fr, { 0, 0, scrW, scrH });
+  if (disposal == 3 && !saveBackup(clip)) disposal = 1;
+  uint32_t got = decodeLzw(indices, need);
+  composite(fr, interlace, lut, got);
+  dirty = unite(dirty, intersect(clip, view));
+
+  prevRect = clip;
+  prevDisposal = disposal;
+  uint16_t delayMs = delayCs < 2 ? 100 : delayCs * 10;
+  cacheStore(dirty, delayMs);
+  decodeUs += micros() - t0;
+  decoded++;
+  frameNo++;
+
+  due += delayMs * 1000;
+  present(dirty);
+}
+
+static void logStats() {
+  uint32_t now = millis();
+  if (now - logAt < 5000) return;
+  float secs = (now - logAt) / 1000.0f;
+  uint32_t n = shown - logShown, d = decoded - logDecoded;
+  uint32_t busy = (decodeUs - logDecodeUs) + (pushUs - logPushUs);
+  float area = n ? 100.0f * (pushedPx - logPushedPx) / ((float)n * view.w * view.h) : 0.0f;
+
+  DBG_IF(GIF, "[GIF] %.1f FPS, %.1f%% of %ldx%ld changed per frame, CPU %.1f%% (decode %.1f ms, push %.1f ms per frame)%s\n",
+         n / secs, area, (long)view.w, (long)view.h, busy / (secs * 10000.0f),
+         d ? (decodeUs - logDecodeUs) / 1000.0f / d : 0.0f,
+         n ? (pushUs - logPushUs) / 1000.0f / n : 0.0f,
+         cache == Cache::READY ? ", cached" : "");
+  splitLog("GIF composite", compositeStats);
+
+  logAt = now;
+  logShown = shown;
+  logDecoded = decoded;
+  logDecodeUs = decodeUs;
+  logPushUs = pushUs;
+  logPushedPx = pushedPx;
+}
+
+
+// =========================================================
+//  BUFFERS
+// =========================================================
+static void freeAll() {
+  cacheFree();
+  free(data);
+  free(canvas);
+  free(indices);
+  free(backup);
+  heap_caps_free(lzw);
+  for (int i = 0; i < 2; ++i) { heap_caps_free(ring[i]); ring[i] = nullptr; }
+  data = nullptr;
+  canvas = nullptr;
+  indices = nullptr;
+  backup = nullptr;
+  lzw = nullptr;
+  indicesCap = backupCap = 0;
+}
+
+static bool loadFile(const char* path) {
+  SdBus bus;
+  File f = SD.open(path, FILE_READ);
+  bool ok = false;
+  if (f) {
+    dataLen = f.size();
+    if (dataLen >= 13 && dataLen <= GIF_MAX_KB * 1024 && (data = (uint8_t*)ps_malloc(dataLen)))
+      ok = f.read(data, dataLen) == dataLen;
+    f.close();
+  }
+  return ok;
+}
+
+static bool allocAll() {
+  size_t blockPixels = (size_t)tft.width() * SCANOUT_BLOCK_LINES;
+  if (!(canvas = (uint16_t*)ps_malloc((size_t)scrW * scrH * sizeof(uint16_t)))) return false;
+  memset(canvas, 0, (size_t)scrW * scrH * sizeof(uint16_t));
+
+  // The table is hit for every code: keep it in internal RAM
+  lzw = (LzwTable*)heap_caps_malloc(sizeof(LzwTable), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (!lzw) return false;
+  for (int i = 0; i < 2; ++i) {
+    ring[i] = (uint16_t*)heap_caps_malloc(blockPixels * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!ring[i]) return false;
+  }
+  ringPixels = blockPixels;
+
+  // No cache beats no playback
+  if (GIF_CACHE_KB && (cacheArena = (uint8_t*)ps_malloc(GIF_CACHE_KB * 1024)))
+    cache = Cache::FILLING;
+  return true;
+}
+
+
+// =========================================================
+//  SESSION LIFECYCLE
+// =========================================================
+bool gifIsFile(const String& name) {
+  String lower = name;
+  lower.toLowerCase();
+  return lower.endsWith(".gif");
+}
+
+bool gifPlay(const char* path) {
+  if (running) gifStop();
+
+  if (!loadFile(path) || memcmp(data, "GIF8", 4) != 0) {
+    DBG_IF(GIF, "[GIF] %s: can't load (not a GIF, or over %lu KB)\n", path, (unsigned long)GIF_MAX_KB);
+    freeAll();
+    return false;
+  }
+
+  // Logical screen + global palette
+  scrW = le16(data + 6);
+  scrH = le16(data + 8);
+  uint8_t flags = data[10];
+  pos = 13;
+  for (int i = 0; i < 256; ++i) globalLut[i] = 0;
+  if (flags & 0x80) {
+    int count = 2 << (flags & 7);
+    if (pos + count * 3 <= dataLen) buildLut(globalLut, data + pos, count);
+    pos += count * 3;
+  }
+  firstFrame = pos;
+  loopsLeft = 0;  // no NETSCAPE2.0 block: play once
+  pass = 0;
+
+  // Needs at least one image to be worth opening
+  Rect r;
+  bool interlace;
+  const uint16_t* lut;
+  // Header sizes go up to 65535 x 65535: cap the canvas before
+  // any size_t math (32-bit here) can wrap
+  uint64_t canvasBytes = (uint64_t)scrW * scrH * sizeof(uint16_t);
+  if (canvasBytes > (uint64_t)GIF_CANVAS_KB * 1024) {
+    DBG_IF(GIF, "[GIF] %s: %ux%u canvas is over %lu KB\n", path, scrW, scrH, (unsigned long)GIF_CANVAS_KB);
+    freeAll();
+    return false;
+  }
+
+  bool any = scrW && scrH && nextImage(r, interlace, lut);
+  pos = firstFrame;
+  if (!any || !allocAll()) {
+    DBG_IF(GIF, "[GIF] %s: %s\n", path, any ? "out of memory" : "no frames");
+    freeAll();
+    return false;
+  }
+
+  // Centered; a canvas larger than the panel shows its middle
+  dstX = ((int32_t)tft.width()  - scrW) / 2;
+  dstY = ((int32_t)tft.height() - scrH) / 2;
+  view = intersect({ 0, 0, scrW, scrH }, { -dstX, -dstY, tft.width(), tft.height() });
+
+  prevRect = pending = {};
+  prevDisposal = 0;
+  frameNo = decoded = shown = skipped = 0;
+  decodeUs = pushUs = logDecodeUs = logPushUs = logShown = logDecoded = 0;
+  pushedPx = logPushedPx = 0;
+
+  tft.fillScreen(0x0000);
+  tft.initDMA();
+  swapWas = tft.getSwapBytes();
+  tft.setSwapBytes(false);
+
+  running = true;
+  startMs = logAt = millis();
+  due = micros();
+  DBG_IF(GIF, "[GIF] %s: %ux%u, %lu KB, plays %ld (0 = forever), cache %s\n",
+         path, scrW, scrH, (unsigned long)(dataLen / 1024),
+         (long)(loopsLeft + 1), cache == Cache::OFF ? "off" : "on");
+  return true;
+}
+
+bool gifRunning() { return running; }
+
+void gifUpdate() {
+  if (!running) return;
+
+  controls.update(controls.mode());
+  if (controls.b() || (controls.start() && controls.select())) { gifStop(); return; }
+
+  if ((int32_t)(micros() - due) >= 0) {
+    if (cache == Cache::READY) replay();
+    else step();
+  }
+  if (running) logStats();
+}
+
+void gifStop() {
+  if (!running) return;
+  running = false;
+
+  tft.dmaWait();
+  tft.setSwapBytes(swapWas);
+  tft.deInitDMA();
+
+  float secs = (millis() - startMs) / 1000.0f;
+  DBG_IF(GIF, "[GIF] Stopped after %.1f s: %lu frames decoded, %lu pushes (%lu deferred), "
+              "%.1f%% of the view per push, CPU %.1f%%\n",
+         secs, (unsigned long)decoded, (unsigned long)shown, (unsigned long)skipped,
+         shown ? 100.0f * pushedPx / ((float)shown * view.w * view.h) : 0.0f,
+         secs > 0 ? (decodeUs + pushUs) / (secs * 10000.0f) : 0.0f);
+  freeAll();
+
+  // Hand the screen back to the menus
+  tft.fillScreen(COL_BG);
+  setMenuInputLockUntil(millis() + 300);
+  if (EditMenu* m = currentMenu()) m->forceRedraw();
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,37 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  gif.h — Animated GIF Player (Header)
+//
+//  Provides:
+//   • gifIsFile()  — *.gif filter for the Gallery
+//   • gifPlay()    — Load a GIF into PSRAM and start playback
+//   • gifUpdate()  — Decode / push the next due frame
+//                    (call from loop)
+//   • gifStop()    — End playback, log the averages
+//
+//  Format:
+//   - GIF87a / GIF89a: global and local palettes, frame
+//     sub-rectangles, transparency, interlacing, disposal
+//     modes 0–3 and the NETSCAPE2.0 loop count.
+//   - A logical screen larger than the panel is cropped to
+//     its centre; a smaller one is centered.
+//
+//  Notes:
+//   - B or START + SELECT stops playback.
+//   - While playing, loop() should skip the menus.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool gifIsFile(const String& name);
+bool gifPlay(const char* path);
+bool gifRunning();
+void gifUpdate();
+void gifStop();
+
+// ======================= End of File =======================
@@ -0,0 +1,129 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  homebrew.cpp — Homebrew Launcher
+//
+//  Lists the carts available to the fantasy-console runtime
+//  as a regular EditMenu, styled like whichever menu opened
+//  it, and starts the selected one.
+//
+//  Notes:
+//   - Built-in carts come first (CARTS[]), then the *.lua
+//     scripts found in HOMEBREW_DIR (luaapp.h).
+//   - The list is rebuilt on every open, so SD changes show
+//     up without a reboot.
+// =========================================================
+
+#include "homebrew.h"
+#include "config.h"
+#include "controls.h"
+#include "fcon.h"
+#include "r3d.h"
+#include "luaapp.h"
+#include "resume.h"
+#include "sdcard.h"
+#include <SD.h>
+
+extern TFT_eSPI tft;
+
+// =========================================================
+//  CART TABLE
+// =========================================================
+static const FconCart* const CARTS[] = {
+  &FCON_DEMO,
+  &FCON_DEMO3D,
+};
+static constexpr int CART_COUNT = sizeof(CARTS) / sizeof(CARTS[0]);
+
+static EditMenu* hbMenu = nullptr;
+static String    scriptPaths[MAX_OPT];
+static uint16_t  scriptCount = 0;
+
+EditMenu* homebrewMenu() { return hbMenu; }
+
+
+// =========================================================
+//  SCAN
+// =========================================================
+// "/homebrew/snake.lua" -> "snake.lua"
+static String displayName(const String& path) {
+  return path.substring(path.lastIndexOf('/') + 1);
+}
+
+static void scanScripts() {
+  scriptCount = 0;
+
+  {
+    SdBus bus;
+    File dir = SD.open(HOMEBREW_DIR);
+    if (dir && dir.isDirectory()) {
+      File f = dir.openNextFile();
+      while (f && CART_COUNT + scriptCount < MAX_OPT) {
+        String name = f.name();
+        if (!f.isDirectory() && luaIsScript(name)) {
+          scriptPaths[scriptCount++] = f.path();
+          hbMenu->addItem(makeLabel(displayName(name)));
+        }
+        f = dir.openNextFile();
+      }
+    }
+  }
+  DBG_IF(FCON, "[Homebrew] %u script(s) in %s\n", scriptCount, HOMEBREW_DIR);
+}
+
+
+// =========================================================
+//  OPEN + ACTIVATE
+// =========================================================
+void openHomebrew() {
+  EditMenu* parent = currentMenu();
+  if (!hbMenu) hbMenu = new EditMenu(tft);
+
+  // Inherit look + input from the launching menu
+  if (parent) {
+    hbMenu->setTheme(parent->theme());
+    hbMenu->setInputMode(parent->inputMode());
+    hbMenu->settings = parent->settings;
+  }
+
+  hbMenu->clearItems();
+  for (int i = 0; i < CART_COUNT && i < MAX_OPT; ++i)
+    hbMenu->addItem(makeLabel(CARTS[i]->name));
+  scanScripts();
+
+  pushMenu(hbMenu);
+  setMenuInputLockUntil(millis() + 150);
+}
+
+void handleHomebrewActivation(EditMenu& menu, int idx) {
+  if (idx < 0 || idx >= CART_COUNT + scriptCount) return;
+
+  if (idx >= CART_COUNT) {
+    const char* path = scriptPaths[idx - CART_COUNT].c_str();
+    if (controls.select()) {
+      luaBenchmark(path);
+      menu.forceRedraw();
+      return;
+    }
+    if (luaLaunch(path)) resumeNote(ResumeKind::LUA, path);
+    else DBG_IF(FCON, "[Homebrew] Launch failed: %s\n", path);
+    return;
+  }
+
+  if (controls.select()) {
+    fconBenchmark(FCON_BENCH_FRAMES);
+    r3dBenchmark();
+    menu.forceRedraw();
+    return;
+  }
+  if (fconLaunch(*CARTS[idx])) resumeNote(ResumeKind::CART, CARTS[idx]->name);
+  else DBG_IF(FCON, "[Homebrew] Launch failed: %s\n", CARTS[idx]->name);
+}
+
+bool homebrewLaunch(const char* name) {
+  for (int i = 0; i < CART_COUNT; ++i)
+    if (strcmp(CARTS[i]->name, name) == 0) return fconLaunch(*CARTS[i]);
+  return false;
+}
+
+// ======================= End of File =======================
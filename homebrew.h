@@ -0,0 +1,31 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  homebrew.h — Homebrew Launcher (Header)
+//
+//  Provides:
+//   • openHomebrew()             — Build the cart list and push it
+//   • homebrewMenu()             — The menu instance (for dispatch)
+//   • handleHomebrewActivation() — Run / benchmark a cart
+//   • homebrewLaunch()           — Run a built-in cart by name
+//
+//  Notes:
+//   - Carts run on the fantasy-console runtime (fcon.h); Lua
+//     scripts from HOMEBREW_DIR are listed after the built-ins.
+//   - Hold SELECT while confirming to benchmark: the renderer for
+//     built-in carts, source vs cached bytecode for scripts.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include "MenuUI.h"
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+void      openHomebrew();
+EditMenu* homebrewMenu();
+void      handleHomebrewActivation(EditMenu& menu, int idx);
+bool      homebrewLaunch(const char* name);
+
+// ======================= End of File =======================
@@ -0,0 +1,412 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  icons.cpp — Vector Icons + Icon Cache
+//
+//  Rasterizer (coverage accumulation):
+//   - Each edge adds, to an accumulation buffer, the signed
+//     area it sweeps through every pixel it crosses, split
+//     exactly between the pixels it touches. A running sum
+//     along each row then gives the winding-weighted coverage
+//     of every pixel: no sorting of edges, no active-edge list,
+//     and anti-aliasing comes for free.
+//   - The buffer is one flat run of size * size + 2 cells, so
+//     an edge on the right border carries its cancellation
+//     into the start of the next row.
+//   - Everything is Q16.16 fixed point (the S3 has no fast
+//     double, and float adds nothing here); curves are split
+//     into lines of a few pixels each.
+//
+//  Cache (device):
+//   - ICON_CACHE_SLOTS masks of up to ICON_MAX_PX, keyed by
+//     (path, size), least recently used one replaced. Nodes
+//     come from a Pool, kept in use order; masks sit in PSRAM,
+//     one per pool index. The tint
+//     is applied by blendMask4() at draw time, so one mask
+//     serves every theme colour and selection state.
+//
+//  Host benchmark:
+//    g++ -O2 -DICON_BENCH_MAIN -x c++ icons.cpp -o icon_bench
+// =========================================================
+
+#include "icons.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+  #include "config.h"
+  #include "blend.h"
+  #include "arena.h"
+  #define BENCH_LOG(...) DBG_IF(MENU, __VA_ARGS__)
+  static uint32_t benchUs() { return micros(); }
+#else
+  #include <stdio.h>
+  #include <chrono>
+  #define BENCH_LOG(...) printf(__VA_ARGS__)
+  static uint32_t benchUs() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+  static constexpr uint16_t ICON_MAX_PX    = 96;
+  static constexpr int16_t  MENU_ICON_SIZE = 48;
+#endif
+
+// =========================================================
+//  BUILT-IN ICONS
+// =========================================================
+const uint8_t ICON_GAMEPAD[] = {
+  'M', 60, 72, 'L', 196, 72, 'Q', 240, 72, 240, 116, 'L', 240, 144,
+  'Q', 240, 188, 196, 188, 'L', 60, 188, 'Q', 16, 188, 16, 144, 'L',
+  16, 116, 'Q', 16, 72, 60, 72, 'Z', 'M', 56, 116, 'L', 56, 132, 'L',
+  72, 132, 'L', 72, 148, 'L', 88, 148, 'L', 88, 132, 'L', 104, 132,
+  'L', 104, 116, 'L', 88, 116, 'L', 88, 100, 'L', 72, 100, 'L', 72,
+  116, 'L', 56, 116, 'Z', 'M', 181, 136, 'Q', 181, 131, 177, 127, 'Q',
+  173, 123, 168, 123, 'Q', 163, 123, 159, 127, 'Q', 155, 131, 155, 136,
+  'Q', 155, 141, 159, 145, 'Q', 163, 149, 168, 149, 'Q', 173, 149, 177,
+  145, 'Q', 181, 141, 181, 136, 'Z', 'M', 211, 110, 'Q', 211, 105, 207,
+  101, 'Q', 203, 97, 198, 97, 'Q', 193, 97, 189, 101, 'Q', 185, 105,
+  185, 110, 'Q', 185, 115, 189, 119, 'Q', 193, 123, 198, 123, 'Q', 203,
+  123, 207, 119, 'Q', 211, 115, 211, 110, 'Z', 'E'
+};
+
+const uint8_t ICON_GALLERY[] = {
+  'M', 24, 48, 'L', 232, 48, 'L', 232, 208, 'L', 24, 208, 'Z', 'M', 40,
+  64, 'L', 40, 192, 'L', 216, 192, 'L', 216, 64, 'L', 40, 64, 'Z', 'M',
+  52, 180, 'L', 112, 108, 'L', 148, 152, 'L', 172, 128, 'L', 204, 180,
+  'Z', 'M', 188, 92, 'Q', 188, 99, 183, 103, 'Q', 179, 108, 172, 108,
+  'Q', 165, 108, 161, 103, 'Q', 156, 99, 156, 92, 'Q', 156, 85, 161,
+  81, 'Q', 165, 76, 172, 76, 'Q', 179, 76, 183, 81, 'Q', 188, 85, 188,
+  92, 'Z', 'E'
+};
+
+const uint8_t ICON_MUSIC[] = {
+  'M', 108, 188, 'Q', 108, 200, 100, 208, 'Q', 92, 216, 80, 216, 'Q',
+  68, 216, 60, 208, 'Q', 52, 200, 52, 188, 'Q', 52, 176, 60, 168, 'Q',
+  68, 160, 80, 160, 'Q', 92, 160, 100, 168, 'Q', 108, 176, 108, 188,
+  'Z', 'M', 216, 164, 'Q', 216, 176, 208, 184, 'Q', 200, 192, 188, 192,
+  'Q', 176, 192, 168, 184, 'Q', 160, 176, 160, 164, 'Q', 160, 152, 168,
+  144, 'Q', 176, 136, 188, 136, 'Q', 200, 136, 208, 144, 'Q', 216, 152,
+  216, 164, 'Z', 'M', 96, 188, 'L', 96, 76, 'L', 108, 76, 'L', 108,
+  188, 'L', 96, 188, 'Z', 'M', 204, 164, 'L', 204, 52, 'L', 216, 52,
+  'L', 216, 164, 'L', 204, 164, 'Z', 'M', 96, 76, 'L', 216, 52, 'L',
+  216, 84, 'L', 96, 108, 'Z', 'E'
+};
+
+const uint8_t ICON_SETTINGS[] = {
+  'M', 208, 103, 'L', 238, 106, 'L', 238, 150, 'L', 208, 153, 'L', 202,
+  167, 'L', 221, 190, 'L', 190, 221, 'L', 167, 202, 'L', 153, 208, 'L',
+  150, 238, 'L', 106, 238, 'L', 103, 208, 'L', 89, 202, 'L', 66, 221,
+  'L', 35, 190, 'L', 54, 167, 'L', 48, 153, 'L', 18, 150, 'L', 18, 106,
+  'L', 48, 103, 'L', 54, 89, 'L', 35, 66, 'L', 66, 35, 'L', 89, 54,
+  'L', 103, 48, 'L', 106, 18, 'L', 150, 18, 'L', 153, 48, 'L', 167, 54,
+  'L', 190, 35, 'L', 221, 66, 'L', 202, 89, 'Z', 'M', 164, 128, 'Q',
+  164, 113, 153, 103, 'Q', 143, 92, 128, 92, 'Q', 113, 92, 103, 103,
+  'Q', 92, 113, 92, 128, 'Q', 92, 143, 103, 153, 'Q', 113, 164, 128,
+  164, 'Q', 143, 164, 153, 153, 'Q', 164, 143, 164, 128, 'Z', 'E'
+};
+
+const uint8_t ICON_FOLDER[] = {
+  'M', 24, 56, 'L', 100, 56, 'L', 120, 76, 'L', 232, 76, 'L', 232, 204,
+  'L', 24, 204, 'Z', 'M', 40, 100, 'L', 40, 188, 'L', 216, 188, 'L',
+  216, 100, 'L', 40, 100, 'Z', 'E'
+};
+
+const uint8_t ICON_HOMEBREW[] = {
+  'M', 84, 60, 'L', 104, 80, 'L', 56, 128, 'L', 104, 176, 'L', 84, 196,
+  'L', 16, 128, 'Z', 'M', 172, 60, 'L', 240, 128, 'L', 172, 196, 'L',
+  152, 176, 'L', 200, 128, 'L', 152, 80, 'Z', 'M', 140, 44, 'L', 164,
+  44, 'L', 116, 212, 'L', 92, 212, 'Z', 'E'
+};
+
+const uint8_t ICON_POWER[] = {
+  'M', 180, 51, 'L', 200, 67, 'L', 216, 88, 'L', 225, 112, 'L', 228,
+  138, 'L', 224, 163, 'L', 214, 187, 'L', 198, 207, 'L', 178, 223, 'L',
+  154, 233, 'L', 128, 236, 'L', 102, 233, 'L', 78, 223, 'L', 58, 207,
+  'L', 42, 187, 'L', 32, 163, 'L', 28, 138, 'L', 31, 112, 'L', 40, 88,
+  'L', 56, 67, 'L', 76, 51, 'L', 88, 71, 'L', 73, 84, 'L', 61, 99, 'L',
+  54, 118, 'L', 52, 137, 'L', 55, 157, 'L', 63, 175, 'L', 75, 190, 'L',
+  90, 202, 'L', 109, 209, 'L', 128, 212, 'L', 147, 209, 'L', 166, 202,
+  'L', 181, 190, 'L', 193, 175, 'L', 201, 157, 'L', 204, 137, 'L', 202,
+  118, 'L', 195, 99, 'L', 183, 84, 'L', 168, 71, 'Z', 'M', 128, 16,
+  'L', 128, 16, 'Q', 140, 16, 140, 28, 'L', 140, 116, 'Q', 140, 128,
+  128, 128, 'L', 128, 128, 'Q', 116, 128, 116, 116, 'L', 116, 28, 'Q',
+  116, 16, 128, 16, 'Z', 'E'
+};
+
+
+// =========================================================
+//  FIXED POINT
+// =========================================================
+typedef int32_t fx;                      // Q16.16
+static constexpr int FX  = 16;
+static constexpr fx  ONE = 1 << FX;
+
+static inline fx  fmul(fx a, fx b)  { return (fx)(((int64_t)a * b) >> FX); }
+static inline fx  fdiv(fx a, fx b)  { return (fx)(((int64_t)a << FX) / b); }
+static inline int ffloor(fx a)      { return a >> FX; }
+static inline int fceil(fx a)       { return (a + ONE - 1) >> FX; }
+static inline fx  fmin(fx a, fx b)  { return a < b ? a : b; }
+static inline fx  fmax(fx a, fx b)  { return a > b ? a : b; }
+
+
+// =========================================================
+//  RASTERIZER
+// =========================================================
+struct Raster {
+  int32_t* acc;   // size * size + 2 cells, Q16 area
+  int      size;
+};
+
+static inline void accAdd(Raster& r, int32_t* row, int x, fx v) {
+  if (x < 0) x = 0;
+  if (x > r.size) x = r.size;
+  row[x] += v;
+}
+
+static void rasterLine(Raster& r, fx x0, fx y0, fx x1, fx y1) {
+  if (y0 == y1) return;
+  fx dir = ONE;
+  if (y0 > y1) {
+    fx t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+    dir = -ONE;
+  }
+  const fx dxdy = fdiv(x1 - x0, y1 - y0);
+  fx x = x0;
+  int ys = ffloor(y0);
+  if (ys < 0) { x -= fmul(y0, dxdy); ys = 0; }
+  const int ye = fceil(y1) < r.size ? fceil(y1) : r.size;
+
+  for (int y = ys; y < ye; ++y) {
+    int32_t* row = r.acc + (size_t)y * r.size;
+    const fx yt = (fx)y << FX;
+    const fx dy = fmin(yt + ONE, y1) - fmax(yt, y0);
+    const fx xnext = x + fmul(dxdy, dy);
+    const fx d = fmul(dy, dir);
+    const fx xa = fmin(x, xnext), xb = fmax(x, xnext);
+    const int x0i = ffloor(xa), x1i = fceil(xb);
+    const fx x0f = xa - ((fx)x0i << FX);
+
+    if (x1i <= x0i + 1) {
+      // Within one pixel: split by the mean x
+      fx xm = ((x + xnext) >> 1) - ((fx)x0i << FX);
+      accAdd(r, row, x0i,     d - fmul(d, xm));
+      accAdd(r, row, x0i + 1, fmul(d, xm));
+    } else {
+      // Across several: triangle, trapezoids, triangle
+      const fx s   = fdiv(ONE, xb - xa);
+      const fx t0  = ONE - x0f;
+      const fx a0  = fmul(s, fmul(t0, t0)) >> 1;
+      const fx x1f = xb - ((fx)x1i << FX) + ONE;
+      const fx am  = fmul(s, fmul(x1f, x1f)) >> 1;
+      accAdd(r, row, x0i, fmul(d, a0));
+      if (x1i == x0i + 2) {
+        accAdd(r, row, x0i + 1, fmul(d, ONE - a0 - am));
+      } else {
+        const fx a1 = fmul(s, ONE + ONE / 2 - x0f);
+        accAdd(r, row, x0i + 1, fmul(d, a1 - a0));
+        const fx ds = fmul(d, s);
+        for (int xi = x0i + 2; xi < x1i - 1; ++xi) accAdd(r, row, xi, ds);
+        const fx a2 = a1 + (x1i - x0i - 3) * s;
+        accAdd(r, row, x1i - 1, fmul(d, ONE - a2 - am));
+      }
+      accAdd(r, row, x1i, fmul(d, am));
+    }
+    x = xnext;
+  }
+}
+
+// Grid unit (0..255) → pixels, Q16
+static inline fx toPx(uint8_t u, int size) { return (fx)u * size << (FX - 8); }
+
+static void rasterQuad(Raster& r, fx x0, fx y0, fx cx, fx cy, fx x1, fx y1) {
+  // About one segment per 4 px of control polygon
+  fx len = (fx)(labs((long)(cx - x0)) + labs((long)(cy - y0)) +
+                labs((long)(x1 - cx)) + labs((long)(y1 - cy)));
+  int n = ffloor(len) / 4;
+  n = n < 2 ? 2 : (n > 16 ? 16 : n);
+
+  fx px = x0, py = y0;
+  for (int i = 1; i <= n; ++i) {
+    fx t = (fx)(((int64_t)i << FX) / n), u = ONE - t;
+    fx uu = fmul(u, u), ut2 = 2 * fmul(u, t), tt = fmul(t, t);
+    fx qx = fmul(uu, x0) + fmul(ut2, cx) + fmul(tt, x1);
+    fx qy = fmul(uu, y0) + fmul(ut2, cy) + fmul(tt, y1);
+    if (i == n) { qx = x1; qy = y1; }
+    rasterLine(r, px, py, qx, qy);
+    px = qx; py = qy;
+  }
+}
+
+static int32_t* scratch = nullptr;  // accumulation buffer for ICON_MAX_PX
+
+bool iconRasterize(const uint8_t* path, uint16_t size, uint8_t* mask) {
+  if (!path || !size || size > ICON_MAX_PX) return false;
+  if (!scratch) scratch = (int32_t*)malloc(((size_t)ICON_MAX_PX * ICON_MAX_PX + 2) * sizeof(int32_t));
+  if (!scratch) return false;
+
+  Raster r = { scratch, size };
+  memset(r.acc, 0, ((size_t)size * size + 2) * sizeof(int32_t));
+
+  fx sx = 0, sy = 0, cx = 0, cy = 0;  // contour start, pen
+  for (const uint8_t* p = path; *p != 'E'; ) {
+    switch (*p++) {
+      case 'M':
+        sx = cx = toPx(p[0], size);
+        sy = cy = toPx(p[1], size);
+        p += 2;
+        break;
+      case 'L': {
+        fx x = toPx(p[0], size), y = toPx(p[1], size);
+        rasterLine(r, cx, cy, x, y);
+        cx = x; cy = y; p += 2;
+        break;
+      }
+      case 'Q': {
+        fx qx = toPx(p[0], size), qy = toPx(p[1], size);
+        fx x  = toPx(p[2], size), y  = toPx(p[3], size);
+        rasterQuad(r, cx, cy, qx, qy, x, y);
+        cx = x; cy = y; p += 4;
+        break;
+      }
+      case 'Z':
+        rasterLine(r, cx, cy, sx, sy);
+        cx = sx; cy = sy;
+        break;
+      default:
+        return false;  // malformed path
+    }
+  }
+
+  // Running sum → coverage → 4 bpp
+  const int stride = (size + 1) / 2;
+  memset(mask, 0, (size_t)stride * size);
+  int32_t sum = 0;
+  for (int y = 0; y < size; ++y) {
+    const int32_t* acc = r.acc + (size_t)y * size;
+    uint8_t* out = mask + (size_t)y * stride;
+    for (int x = 0; x < size; ++x) {
+      sum += acc[x];
+      int32_t c = sum < 0 ? -sum : sum;
+      if (c > ONE) c = ONE;
+      uint8_t nib = (uint8_t)((c * 15 + ONE / 2) >> FX);
+      out[x >> 1] |= (x & 1) ? nib : (uint8_t)(nib << 4);
+    }
+  }
+  return true;
+}
+
+
+// =========================================================
+//  CACHE + DRAW
+// =========================================================
+#ifdef ARDUINO
+struct IconSlot {
+  const uint8_t* path;
+  uint16_t       size;
+  IconSlot*      next;   // most recently used first
+};
+
+static constexpr size_t ICON_SLOT_BYTES = (size_t)(ICON_MAX_PX + 1) / 2 * ICON_MAX_PX;
+
+static Pool<IconSlot, ICON_CACHE_SLOTS> iconPool;
+static IconSlot* iconList = nullptr;
+static uint8_t*  iconMasks = nullptr;   // PSRAM, one mask per pool index
+
+static const uint8_t* iconMask(const uint8_t* path, uint16_t size) {
+  if (!iconMasks) iconMasks = (uint8_t*)ps_malloc(ICON_SLOT_BYTES * ICON_CACHE_SLOTS);
+  if (!iconMasks) return nullptr;
+
+  IconSlot** link = &iconList;
+  IconSlot** last = nullptr;
+  for (; *link; link = &(*link)->next) {
+    IconSlot* s = *link;
+    if (s->path == path && s->size == size) {
+      if (s != iconList) { *link = s->next; s->next = iconList; iconList = s; }
+      return iconMasks + iconPool.indexOf(s) * ICON_SLOT_BYTES;
+    }
+    last = link;
+  }
+
+  // A free node, or the least recently used one recycled
+  if (iconPool.inUse() == ICON_CACHE_SLOTS) {
+    IconSlot* old = *last;
+    *last = nullptr;
+    iconPool.destroy(old);
+  }
+  IconSlot* s = iconPool.make(IconSlot{ path, size, nullptr });
+  uint8_t* mask = iconMasks + iconPool.indexOf(s) * ICON_SLOT_BYTES;
+  if (!iconRasterize(path, size, mask)) { iconPool.destroy(s); return nullptr; }
+  s->next = iconList;
+  iconList = s;
+  return mask;
+}
+
+void iconDraw(TFT_eSprite& spr, const uint8_t* path, int32_t x, int32_t y,
+              uint16_t size, uint16_t tint) {
+  if (!spr.created()) return;
+  const uint8_t* mask = iconMask(path, size);
+  if (!mask) return;
+
+  // Whole icon inside horizontally (the carousel drops items
+  // that aren't); rows are clipped
+  const int16_t W = spr.width(), H = spr.height();
+  if (x < 0 || x + size > W) return;
+  uint16_t* fb = (uint16_t*)spr.getPointer();
+  const int stride = (size + 1) / 2;
+  for (int r = 0; r < size; ++r) {
+    if (y + r < 0 || y + r >= H) continue;
+    blendMask4(fb + (size_t)(y + r) * W + x, mask + (size_t)r * stride, size, tint, true);
+  }
+}
+
+void iconCacheClear() {
+  while (IconSlot* s = iconList) { iconList = s->next; iconPool.destroy(s); }
+}
+#endif
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+static volatile uint8_t benchSink;  // keeps the output live
+
+// Cold rasterization of the Home carousel at MENU_ICON_SIZE,
+// against a 60 fps frame
+void iconBenchmark() {
+  static const uint8_t* const SET[] = {
+    ICON_GAMEPAD, ICON_GALLERY, ICON_MUSIC, ICON_SETTINGS,
+    ICON_FOLDER, ICON_HOMEBREW, ICON_POWER,
+  };
+  static constexpr int N = sizeof(SET) / sizeof(SET[0]), ROUNDS = 20;
+  const uint16_t size = MENU_ICON_SIZE;
+  uint8_t* mask = (uint8_t*)malloc((size_t)(size + 1) / 2 * size);
+  if (!mask) {
+    BENCH_LOG("[Icons] Out of memory for the benchmark\n");
+    return;
+  }
+
+  uint32_t worst = 0, total = 0;
+  for (int i = 0; i < N; ++i) {
+    uint32_t t0 = benchUs();
+    for (int r = 0; r < ROUNDS; ++r) {
+      iconRasterize(SET[i], size, mask);
+      benchSink = mask[r % size];
+    }
+    uint32_t us = (benchUs() - t0) / ROUNDS;
+    total += us;
+    if (us > worst) worst = us;
+  }
+  BENCH_LOG("[Icons] %d icons at %dpx: %lu us warm-up (worst %lu us), %lu%% of a 16.7 ms frame\n",
+            N, size, (unsigned long)total, (unsigned long)worst, (unsigned long)(total * 100 / 16667));
+  free(mask);
+}
+
+#ifdef ICON_BENCH_MAIN
+int main() {
+  iconBenchmark();
+  return 0;
+}
+#endif
+
+// ======================= End of File =======================
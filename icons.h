@@ -0,0 +1,66 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  icons.h — Vector Icons + Icon Cache (Header)
+//
+//  Provides:
+//   • ICON_* paths       — Built-in icons for the Home menu
+//   • iconRasterize()    — Path → anti-aliased 4-bpp mask
+//   • iconDraw()         — Cached draw at any size and tint
+//   • iconBenchmark()    — µs per icon / per carousel warm-up
+//
+//  Path format (bytes, coordinates on a 0..255 grid):
+//     'M' x y           start a contour
+//     'L' x y           line to
+//     'Q' cx cy x y     quadratic curve to
+//     'Z'               close the contour
+//     'E'               end of icon
+//   Filled non-zero: a contour wound the other way cuts a hole.
+//
+//  Notes:
+//   - One icon is ~100–300 bytes for every size and theme,
+//     instead of an RGB565 bitmap per size.
+//   - The rasterizer is plain C++ (builds on a PC, see
+//     icons.cpp); the cache and iconDraw() are device-side.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#ifdef ARDUINO
+  #include <TFT_eSPI.h>
+#endif
+
+// =========================================================
+//  BUILT-IN ICONS
+// =========================================================
+extern const uint8_t ICON_GAMEPAD[];
+extern const uint8_t ICON_GALLERY[];
+extern const uint8_t ICON_MUSIC[];
+extern const uint8_t ICON_SETTINGS[];
+extern const uint8_t ICON_FOLDER[];
+extern const uint8_t ICON_HOMEBREW[];
+extern const uint8_t ICON_POWER[];
+
+// =========================================================
+//  RASTERIZER
+// =========================================================
+// size x size, rows of (size + 1) / 2 bytes, left pixel in
+// the high nibble (blendMask4() order). size <= ICON_MAX_PX.
+bool iconRasterize(const uint8_t* path, uint16_t size, uint8_t* mask);
+
+// =========================================================
+//  CACHE + DRAW
+// =========================================================
+#ifdef ARDUINO
+// (x, y) is the top-left corner; blended over the sprite
+void iconDraw(TFT_eSprite& spr, const uint8_t* path, int32_t x, int32_t y,
+              uint16_t size, uint16_t tint);
+void iconCacheClear();
+#endif
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+void iconBenchmark();
+
+// ======================= End of File =======================
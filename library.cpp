@@ -0,0 +1,116 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  library.cpp — Game Library Launcher
+//
+//  Lists the ROMs found in ROM_DIR as a regular EditMenu,
+//  styled like whichever menu opened it, and hands the
+//  selected file to the emulator frontend.
+//
+//  Notes:
+//   - The list is rebuilt on every open, so SD changes show
+//     up without a reboot.
+// =========================================================
+
+#include "library.h"
+#include "config.h"
+#include "controls.h"
+#include "emulator.h"
+#include "resume.h"
+#include "sdcard.h"
+#include <SD.h>
+
+extern TFT_eSPI tft;
+
+// =========================================================
+//  STATE
+// =========================================================
+static EditMenu* libMenu = nullptr;
+static String    romPaths[MAX_OPT];
+static uint16_t  romCount = 0;
+
+EditMenu* gameLibraryMenu() { return libMenu; }
+
+
+// =========================================================
+//  SCAN
+// =========================================================
+static bool isRomFile(const String& name) {
+  String lower = name;
+  lower.toLowerCase();
+  return lower.endsWith(".nes");
+}
+
+// "/roms/Super Mario Bros.nes" -> "Super Mario Bros"
+static String displayName(const String& name) {
+  int slash = name.lastIndexOf('/');
+  int dot   = name.lastIndexOf('.');
+  return name.substring(slash + 1, dot > slash ? dot : name.length());
+}
+
+static void scanRoms() {
+  romCount = 0;
+  libMenu->clearItems();
+
+  {
+    SdBus bus;
+    File dir = SD.open(ROM_DIR);
+    if (dir && dir.isDirectory()) {
+      File f = dir.openNextFile();
+      while (f && romCount < MAX_OPT) {
+        String name = f.name();
+        if (!f.isDirectory() && isRomFile(name)) {
+          romPaths[romCount++] = f.path();
+          libMenu->addItem(makeLabel(displayName(name)));
+        }
+        f = dir.openNextFile();
+      }
+    }
+  }
+
+  if (romCount == 0) {
+    libMenu->addItem(makeLabel("No ROMs in " ROM_DIR));
+    libMenu->setItemEnabled(0, false);
+  }
+  DBG_IF(EMU, "[Library] %u ROM(s) in %s\n", romCount, ROM_DIR);
+}
+
+
+// =========================================================
+//  OPEN + ACTIVATE
+// =========================================================
+void openGameLibrary() {
+  EditMenu* parent = currentMenu();
+  if (!libMenu) libMenu = new EditMenu(tft);
+
+  // Inherit look + input from the launching menu
+  if (parent) {
+    libMenu->setTheme(parent->theme());
+    libMenu->setInputMode(parent->inputMode());
+    libMenu->settings = parent->settings;
+  }
+
+  scanRoms();
+  pushMenu(libMenu);
+  setMenuInputLockUntil(millis() + 150);
+}
+
+void handleLibraryActivation(EditMenu& menu, int idx) {
+  if (idx < 0 || idx >= romCount) return;
+  const char* path = romPaths[idx].c_str();
+
+  if (controls.select()) {
+    emuBenchmark(path, EMU_BENCH_FRAMES);
+    menu.forceRedraw();
+    return;
+  }
+  if (!emuLaunch(path)) {
+    DBG_IF(EMU, "[Library] Launch failed: %s\n", path);
+    return;
+  }
+  resumeNote(ResumeKind::NES, path);
+  DBG_IF(EMU, "[Library] %s ready in %lu ms (%s)\n",
+         displayName(romPaths[idx]).c_str(), (unsigned long)emuLaunchMs(), emuLaunchSource());
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,27 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  library.h — Game Library Launcher (Header)
+//
+//  Provides:
+//   • openGameLibrary()         — Scan ROM_DIR and push the list
+//   • gameLibraryMenu()         — The menu instance (for dispatch)
+//   • handleLibraryActivation() — Launch / benchmark a ROM
+//
+//  Notes:
+//   - Up to MAX_OPT ROMs are listed (menu item limit).
+//   - Hold SELECT while confirming to run the headless benchmark.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include "MenuUI.h"
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+void      openGameLibrary();
+EditMenu* gameLibraryMenu();
+void      handleLibraryActivation(EditMenu& menu, int idx);
+
+// ======================= End of File =======================
@@ -0,0 +1,653 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  luaapp.cpp — Lua Cart Runtime
+//
+//  One Lua VM per running script, wrapped as an FconCart so
+//  the fantasy console does pacing, rendering and audio.
+//
+//  Memory:
+//   - A LUA_ARENA_KB block of PSRAM is registered as its own
+//     multi_heap and handed to lua_newstate() as the allocator.
+//     Nothing a script does can touch the system heap, and
+//     exit frees the whole block regardless of leaks.
+//
+//  Bytecode cache:
+//   - Key = FNV-1a over the source (seeded with the Lua
+//     version), file = LUA_CACHE_DIR/<key>.luac: a small
+//     header (length + FNV-1a of the chunk), then lua_dump().
+//   - Lua's binary loader trusts its input, so a hit is only
+//     loaded in binary mode once length and checksum match; a
+//     truncated or corrupt file, a miss or a chunk the VM
+//     rejects falls back to the parser and rewrites the entry.
+//
+//  Garbage collection:
+//   - The automatic collector is stopped. After _draw() the
+//     runtime runs LUA_GCSTEP slices until the cycle finishes
+//     or LUA_GC_BUDGET_US is spent, and starts a new cycle only
+//     once the heap has grown LUA_GC_PAUSE % past the last one.
+//   - Only an arena-full emergency collection (done by Lua
+//     itself) can exceed the budget; those are counted.
+//
+//  Notes:
+//   - Scripts get base / table / string / math / coroutine /
+//     utf8 only; no io, os or package, and no dofile/loadfile.
+//   - A count hook ends any callback that runs longer than
+//     LUA_CALL_LIMIT_MS, so a runaway loop can't hang the unit.
+//   - Without the Lua library (no <lua.h>) the rest of the
+//     firmware still builds: scripts are listed, and launching
+//     one logs that Lua isn't built in.
+// =========================================================
+
+#include "luaapp.h"
+#include "config.h"
+#include "fcon.h"
+#include "r3d.h"
+#include "sdcard.h"
+#include <SD.h>
+#include <math.h>
+#include <multi_heap.h>
+
+#if __has_include(<lua.h>)
+  #define LUA_BUILT_IN 1
+  extern "C" {
+  #include <lua.h>
+  #include <lauxlib.h>
+  #include <lualib.h>
+  }
+#else
+  #define LUA_BUILT_IN 0
+#endif
+
+#if LUA_BUILT_IN
+
+// =========================================================
+//  STATE
+// =========================================================
+static constexpr size_t ARENA_BYTES = (size_t)LUA_ARENA_KB * 1024;
+
+static lua_State*          L = nullptr;
+static uint8_t*            arenaMem = nullptr;
+static multi_heap_handle_t arena = nullptr;
+static uint32_t            arenaFails = 0;
+
+// Session
+static char     scriptPath[96];
+static char     cartName[40];
+static bool     failed = false;
+static char     errMsg[200];
+static uint32_t callStart = 0;
+
+// Last load
+static uint32_t loadUs = 0;
+static bool     loadCached = false;
+
+// Collector
+static bool     gcIdle = true;
+static int      gcBaseKB = 0;
+static uint32_t gcFrames = 0, gcTotalUs = 0, gcMaxUs = 0, gcCycles = 0;
+
+static void cartInit();
+static void cartUpdate();
+static void cartDraw();
+static void cartQuit();
+
+static const FconCart LUA_CART = { cartName, cartInit, cartUpdate, cartDraw, cartQuit };
+
+
+// =========================================================
+//  ARENA
+// =========================================================
+static bool arenaBegin() {
+  arenaMem = (uint8_t*)ps_malloc(ARENA_BYTES);
+  if (!arenaMem) return false;
+  arena = multi_heap_register(arenaMem, ARENA_BYTES);
+  if (!arena) {
+    free(arenaMem);
+    arenaMem = nullptr;
+    return false;
+  }
+  arenaFails = 0;
+  return true;
+}
+
+static void arenaEnd() {
+  arena = nullptr;
+  free(arenaMem);
+  arenaMem = nullptr;
+}
+
+static uint32_t arenaUsedKB() { return (ARENA_BYTES - multi_heap_free_size(arena)) / 1024; }
+static uint32_t arenaPeakKB() { return (ARENA_BYTES - multi_heap_minimum_free_size(arena)) / 1024; }
+
+// lua_Alloc over the arena. Lua runs an emergency collection
+// and retries when this returns null; shrinking must not fail.
+static void* arenaAlloc(void*, void* ptr, size_t osize, size_t nsize) {
+  if (nsize == 0) {
+    if (ptr) multi_heap_free(arena, ptr);
+    return nullptr;
+  }
+  void* p = ptr ? multi_heap_realloc(arena, ptr, nsize) : multi_heap_malloc(arena, nsize);
+  if (!p) {
+    if (ptr && nsize <= osize) return ptr;
+    arenaFails++;
+  }
+  return p;
+}
+
+
+// =========================================================
+//  SD HELPERS
+// =========================================================
+static uint8_t* readFile(const char* path, size_t& len) {
+  SdBus bus;
+  File f = SD.open(path, FILE_READ);
+  if (!f) return nullptr;
+
+  len = f.size();
+  uint8_t* buf = (uint8_t*)ps_malloc(len ? len : 1);
+  if (buf && f.read(buf, len) != len) { free(buf); buf = nullptr; }
+
+  f.close();
+  return buf;
+}
+
+static bool writeFile(const char* path, const uint8_t* data, size_t len) {
+  SdBus bus;
+  if (!SD.exists(LUA_CACHE_DIR)) SD.mkdir(LUA_CACHE_DIR);
+  File f = SD.open(path, FILE_WRITE);
+  bool ok = f && f.write(data, len) == len;
+  if (f) f.close();
+  if (!ok) SD.remove(path);
+  return ok;
+}
+
+
+// =========================================================
+//  BYTECODE CACHE
+// =========================================================
+static uint32_t fnv1a(const uint8_t* p, size_t n) {
+  uint32_t h = 2166136261u ^ LUA_VERSION_NUM;
+  while (n--) { h ^= *p++; h *= 16777619u; }
+  return h;
+}
+
+struct CacheHeader {
+  uint32_t magic;   // "RBLC"
+  uint32_t len;     // chunk bytes after the header
+  uint32_t sum;     // fnv1a() of those bytes
+};
+static constexpr uint32_t CACHE_MAGIC = 0x434C4252;
+
+struct DumpBuf {
+  uint8_t* p = nullptr;
+  size_t   len = 0, cap = 0;
+};
+
+static int dumpWriter(lua_State*, const void* data, size_t n, void* ud) {
+  DumpBuf& b = *(DumpBuf*)ud;
+  if (b.len + n > b.cap) {
+    size_t cap = b.cap * 2 > b.len + n ? b.cap * 2 : b.len + n + 1024;
+    uint8_t* p = (uint8_t*)ps_realloc(b.p, cap);
+    if (!p) return 1;
+    b.p = p;
+    b.cap = cap;
+  }
+  memcpy(b.p + b.len, data, n);
+  b.len += n;
+  return 0;
+}
+
+// Writes the function on top of the stack to `path`.
+static void storeBytecode(const char* path) {
+  DumpBuf b;
+  CacheHeader h = { CACHE_MAGIC, 0, 0 };
+  if (dumpWriter(L, &h, sizeof(h), &b) == 0 && lua_dump(L, dumpWriter, &b, 0) == 0) {
+    h.len = b.len - sizeof(h);
+    h.sum = fnv1a(b.p + sizeof(h), h.len);
+    memcpy(b.p, &h, sizeof(h));
+    if (writeFile(path, b.p, b.len))
+      DBG_IF(LUA, "[Lua] Cached %s (%u bytes)\n", path, (unsigned)h.len);
+  }
+  free(b.p);
+}
+
+// Only a complete, unmodified chunk goes to the binary loader
+static bool cacheIntact(const uint8_t* bc, size_t blen) {
+  CacheHeader h;
+  if (blen < sizeof(h)) return false;
+  memcpy(&h, bc, sizeof(h));
+  return h.magic == CACHE_MAGIC && h.len == blen - sizeof(h) &&
+         h.sum == fnv1a(bc + sizeof(h), h.len);
+}
+
+// Pushes the compiled chunk (or an error message) for `path`.
+// With useCache, a hit skips the parser and a miss is stored.
+static int loadScript(const char* path, bool useCache) {
+  size_t len = 0;
+  uint8_t* src = readFile(path, len);
+  if (!src) {
+    lua_pushfstring(L, "cannot read %s", path);
+    return LUA_ERRFILE;
+  }
+
+  char cache[48], chunk[100];
+  snprintf(cache, sizeof(cache), LUA_CACHE_DIR "/%08lx.luac", (unsigned long)fnv1a(src, len));
+  snprintf(chunk, sizeof(chunk), "@%s", path);
+
+  uint32_t t0 = micros();
+  int rc = LUA_ERRFILE;
+  if (useCache) {
+    size_t blen = 0;
+    if (uint8_t* bc = readFile(cache, blen)) {
+      if (cacheIntact(bc, blen)) {
+        rc = luaL_loadbufferx(L, (const char*)bc + sizeof(CacheHeader),
+                              blen - sizeof(CacheHeader), chunk, "b");
+        if (rc != LUA_OK) lua_pop(L, 1);  // other VM build: reparse
+      } else {
+        DBG_IF(LUA, "[Lua] Cache entry %s damaged; reparsing\n", cache);
+      }
+      free(bc);
+    }
+  }
+
+  loadCached = (rc == LUA_OK);
+  if (!loadCached) rc = luaL_loadbufferx(L, (const char*)src, len, chunk, "t");
+  loadUs = micros() - t0;
+  free(src);
+
+  if (rc == LUA_OK && useCache && !loadCached) storeBytecode(cache);
+  return rc;
+}
+
+
+// =========================================================
+//  BINDINGS
+// =========================================================
+// Numbers are floored, so x / 2 works wherever ints are taken.
+static int num(lua_State* s, int i)             { return (int)floor(luaL_checknumber(s, i)); }
+static int opt(lua_State* s, int i, int dflt)   { return (int)floor(luaL_optnumber(s, i, dflt)); }
+
+static uint8_t hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return 0;
+}
+
+// --- Screen ---
+static int l_cls(lua_State* s)  { fconCls(opt(s, 1, 0)); return 0; }
+static int l_pset(lua_State* s) { fconPset(num(s, 1), num(s, 2), num(s, 3)); return 0; }
+static int l_pget(lua_State* s) { lua_pushinteger(s, fconPget(num(s, 1), num(s, 2))); return 1; }
+
+static int l_rect(lua_State* s) {
+  fconRect(num(s, 1), num(s, 2), num(s, 3), num(s, 4), num(s, 5), false);
+  return 0;
+}
+
+static int l_rectfill(lua_State* s) {
+  fconRect(num(s, 1), num(s, 2), num(s, 3), num(s, 4), num(s, 5), true);
+  return 0;
+}
+
+static int l_line(lua_State* s) {
+  fconLine(num(s, 1), num(s, 2), num(s, 3), num(s, 4), num(s, 5));
+  return 0;
+}
+
+// print(v, [x], [y], [c]) — draws; use log() for Serial
+static int l_print(lua_State* s) {
+  const char* str = luaL_tolstring(s, 1, nullptr);
+  fconPrint(str, opt(s, 2, 0), opt(s, 3, 0), opt(s, 4, 7));
+  lua_pop(s, 1);
+  return 0;
+}
+
+// pal(i, 0xRRGGBB)
+static int l_pal(lua_State* s) {
+  uint32_t rgb = (uint32_t)luaL_checkinteger(s, 2);
+  fconPal(num(s, 1), ((rgb >> 8) & 0xF800) | ((rgb >> 5) & 0x07E0) | ((rgb >> 3) & 0x001F));
+  return 0;
+}
+
+// --- Tiles + map ---
+// tile(i, "0123...") — 64 hex digits, or a table of 64 indices
+static int l_tile(lua_State* s) {
+  uint8_t px[64] = {};
+  if (lua_istable(s, 2)) {
+    for (int i = 0; i < 64; ++i) {
+      lua_geti(s, 2, i + 1);
+      px[i] = (uint8_t)lua_tointeger(s, -1);
+      lua_pop(s, 1);
+    }
+  } else {
+    size_t n = 0;
+    const char* hex = luaL_checklstring(s, 2, &n);
+    for (size_t i = 0; i < 64 && i < n; ++i) px[i] = hexDigit(hex[i]);
+  }
+  fconSetTile(num(s, 1), px);
+  return 0;
+}
+
+static int l_mset(lua_State* s)    { fconMapSet(num(s, 1), num(s, 2), num(s, 3)); return 0; }
+static int l_mget(lua_State* s)    { lua_pushinteger(s, fconMapGet(num(s, 1), num(s, 2))); return 1; }
+static int l_showmap(lua_State* s) { fconMapShow(lua_toboolean(s, 1)); return 0; }
+static int l_scroll(lua_State* s)  { fconScroll(num(s, 1), num(s, 2)); return 0; }
+
+// --- Sprites ---
+static int l_spr(lua_State* s) {
+  fconSpr(num(s, 1), num(s, 2), num(s, 3), num(s, 4), opt(s, 5, 0));
+  return 0;
+}
+
+static int l_sprhide(lua_State* s) { fconSprHide(num(s, 1)); return 0; }
+
+// --- Input ---
+// btn(i) / btnp(i): 0 up, 1 down, 2 left, 3 right, 4 A, 5 B,
+// 6 X, 7 Y, 8 start, 9 select
+static uint16_t buttonArg(lua_State* s) {
+  int i = num(s, 1);
+  luaL_argcheck(s, i >= 0 && i <= 9, 1, "button 0-9");
+  return 1u << i;
+}
+
+static int l_btn(lua_State* s)  { lua_pushboolean(s, fconBtn(buttonArg(s)));  return 1; }
+static int l_btnp(lua_State* s) { lua_pushboolean(s, fconBtnp(buttonArg(s))); return 1; }
+
+// --- Sound ---
+// sfx(voice, wave, hz, [vol], [frames], [slide], [fade], [duty])
+static int l_sfx(lua_State* s) {
+  static const char* const WAVES[] = { "pulse", "triangle", "saw", "noise", nullptr };
+  SfxNote n;
+  n.wave   = (SfxWave)luaL_checkoption(s, 2, "pulse", WAVES);
+  n.hz     = (float)luaL_checknumber(s, 3);
+  n.vol    = constrain(opt(s, 4, n.vol), 0, 15);
+  n.frames = opt(s, 5, n.frames);
+  n.slide  = (float)luaL_optnumber(s, 6, 0);
+  n.fade   = lua_toboolean(s, 7);
+  n.duty   = opt(s, 8, n.duty);
+  fconSfx(num(s, 1), n);
+  return 0;
+}
+
+static int l_sfxstop(lua_State* s) { sfxStop(opt(s, 1, -1)); return 0; }
+
+// --- 3D (r3d.h) ---
+// begin3d([flags]) ... tri3d(x0,y0,z0, x1,y1,z1, x2,y2,z2, c) ... end3d()
+// flags: 1 wire, 2 z-buffer, 4 cull, 8 shade (default 14)
+static r3dfx fx(lua_State* s, int i) { return r3dFx((float)luaL_checknumber(s, i)); }
+
+static int l_begin3d(lua_State* s)  { r3dBegin(opt(s, 1, R3D_ZBUF | R3D_CULL | R3D_SHADE)); return 0; }
+static int l_end3d(lua_State* s)    { r3dEnd(); lua_pushinteger(s, r3dStats().drawn); return 1; }
+static int l_camera3d(lua_State* s) { r3dCamera(fx(s, 1), r3dFx((float)luaL_optnumber(s, 2, 0.25))); return 0; }
+
+// light3d(x, y, z, shades): direction toward the light
+static int l_light3d(lua_State* s) {
+  r3dLight({ fx(s, 1), fx(s, 2), fx(s, 3) }, (uint8_t)opt(s, 4, 4));
+  return 0;
+}
+
+static int l_tri3d(lua_State* s) {
+  R3dVec v[3];
+  for (int i = 0; i < 3; ++i) v[i] = { fx(s, i * 3 + 1), fx(s, i * 3 + 2), fx(s, i * 3 + 3) };
+  lua_pushboolean(s, r3dTriangle(v[0], v[1], v[2], num(s, 10)));
+  return 1;
+}
+
+// --- Misc ---
+static int l_frame(lua_State* s) { lua_pushinteger(s, fconFrame()); return 1; }
+
+static int l_log(lua_State* s) {
+  char line[160];
+  size_t at = 0;
+  int n = lua_gettop(s);
+  for (int i = 1; i <= n && at < sizeof(line) - 1; ++i) {
+    at += snprintf(line + at, sizeof(line) - at, i > 1 ? " %s" : "%s", luaL_tolstring(s, i, nullptr));
+    lua_pop(s, 1);
+  }
+  line[at < sizeof(line) ? at : sizeof(line) - 1] = 0;
+  DBG_IF(LUA, "[Lua] %s\n", line);
+  return 0;
+}
+
+static const luaL_Reg API[] = {
+  { "cls", l_cls },         { "pset", l_pset },       { "pget", l_pget },
+  { "rect", l_rect },       { "rectfill", l_rectfill }, { "line", l_line },
+  { "print", l_print },     { "pal", l_pal },
+  { "tile", l_tile },       { "mset", l_mset },       { "mget", l_mget },
+  { "showmap", l_showmap }, { "scroll", l_scroll },
+  { "spr", l_spr },         { "sprhide", l_sprhide },
+  { "btn", l_btn },         { "btnp", l_btnp },
+  { "sfx", l_sfx },         { "sfxstop", l_sfxstop },
+  { "begin3d", l_begin3d }, { "end3d", l_end3d },     { "tri3d", l_tri3d },
+  { "camera3d", l_camera3d }, { "light3d", l_light3d },
+  { "frame", l_frame },     { "log", l_log },
+};
+
+
+// =========================================================
+//  VM LIFECYCLE
+// =========================================================
+static void watchdog(lua_State* s, lua_Debug*) {
+  if (micros() - callStart > LUA_CALL_LIMIT_MS * 1000UL)
+    luaL_error(s, "callback ran longer than %d ms", (int)LUA_CALL_LIMIT_MS);
+}
+
+static bool vmOpen() {
+  if (!arenaBegin()) return false;
+  L = lua_newstate(arenaAlloc, nullptr);
+  if (!L) { arenaEnd(); return false; }
+
+  static const luaL_Reg LIBS[] = {
+    { "_G", luaopen_base },       { "table", luaopen_table },
+    { "string", luaopen_string }, { "math", luaopen_math },
+    { "coroutine", luaopen_coroutine }, { "utf8", luaopen_utf8 },
+  };
+  for (const luaL_Reg& lib : LIBS) {
+    luaL_requiref(L, lib.name, lib.func, 1);
+    lua_pop(L, 1);
+  }
+  lua_pushnil(L); lua_setglobal(L, "dofile");
+  lua_pushnil(L); lua_setglobal(L, "loadfile");
+
+  for (const luaL_Reg& fn : API) lua_register(L, fn.name, fn.func);
+  lua_pushinteger(L, FCON_FLIP_X); lua_setglobal(L, "FLIP_X");
+  lua_pushinteger(L, FCON_FLIP_Y); lua_setglobal(L, "FLIP_Y");
+  lua_pushinteger(L, FCON_W);      lua_setglobal(L, "SCREEN_W");
+  lua_pushinteger(L, FCON_H);      lua_setglobal(L, "SCREEN_H");
+
+  lua_gc(L, LUA_GCSTOP, 0);
+  lua_sethook(L, watchdog, LUA_MASKCOUNT, LUA_HOOK_COUNT);
+  return true;
+}
+
+// lua_close() runs finalizers; the arena goes either way.
+static void vmClose() {
+  if (L) lua_close(L);
+  L = nullptr;
+  arenaEnd();
+}
+
+
+// =========================================================
+//  CALLS + COLLECTOR
+// =========================================================
+static void fail(const char* msg) {
+  failed = true;
+  strlcpy(errMsg, msg ? msg : "(error object is not a string)", sizeof(errMsg));
+  sfxStop();
+  DBG_IF(LUA, "[Lua] Error: %s\n", errMsg);
+}
+
+// Calls the function on the stack below `nargs` arguments.
+static bool call(int nargs) {
+  callStart = micros();
+  if (lua_pcall(L, nargs, 0, 0) == LUA_OK) return true;
+  fail(lua_tostring(L, -1));
+  lua_pop(L, 1);
+  return false;
+}
+
+static void callGlobal(const char* fn) {
+  if (failed) return;
+  lua_getglobal(L, fn);
+  if (!lua_isfunction(L, -1)) { lua_pop(L, 1); return; }
+  call(0);
+}
+
+static void gcSlice() {
+  uint32_t t0 = micros();
+
+  if (gcIdle && lua_gc(L, LUA_GCCOUNT, 0) * 100 >= gcBaseKB * LUA_GC_PAUSE)
+    gcIdle = false;
+  while (!gcIdle) {
+    if (lua_gc(L, LUA_GCSTEP, (int)LUA_GC_STEP_KB)) {
+      gcIdle = true;
+      gcBaseKB = max(lua_gc(L, LUA_GCCOUNT, 0), 16);
+      gcCycles++;
+    }
+    if (micros() - t0 >= LUA_GC_BUDGET_US) break;
+  }
+
+  uint32_t us = micros() - t0;
+  gcTotalUs += us;
+  if (us > gcMaxUs) gcMaxUs = us;
+  if (++gcFrames == 300) {
+    DBG_IF(LUA, "[Lua] GC %.3f ms avg, %.3f ms max (budget %.2f), %lu cycles, heap %d KB, arena peak %lu/%lu KB, %lu full\n",
+           gcTotalUs / 1000.0f / gcFrames, gcMaxUs / 1000.0f, LUA_GC_BUDGET_US / 1000.0f,
+           (unsigned long)gcCycles, lua_gc(L, LUA_GCCOUNT, 0),
+           (unsigned long)arenaPeakKB(), (unsigned long)LUA_ARENA_KB, (unsigned long)arenaFails);
+    gcFrames = gcTotalUs = gcMaxUs = gcCycles = 0;
+  }
+}
+
+// Error screen, drawn every frame until START + SELECT
+static void drawError() {
+  fconMapShow(false);
+  for (int i = 0; i < FCON_SPRITES; ++i) fconSprHide(i);
+  fconCls(1);
+  fconPrint("SCRIPT ERROR", 4, 4, 8);
+
+  constexpr int COLS = (FCON_W - 8) / 4;
+  char line[COLS + 1];
+  const char* p = errMsg;
+  for (int y = 16; *p && y < FCON_H - 16; y += 7) {
+    int n = strnlen(p, COLS);
+    memcpy(line, p, n);
+    line[n] = 0;
+    fconPrint(line, 4, y, 7);
+    p += n;
+  }
+  fconPrint("START + SELECT TO EXIT", 4, FCON_H - 9, 6);
+}
+
+
+// =========================================================
+//  CART CALLBACKS
+// =========================================================
+static void cartInit() {
+  failed = false;
+  gcIdle = true;
+  gcBaseKB = 0;
+  gcFrames = gcTotalUs = gcMaxUs = gcCycles = 0;
+
+  if (loadScript(scriptPath, true) != LUA_OK) {
+    fail(lua_tostring(L, -1));
+    lua_pop(L, 1);
+    return;
+  }
+  DBG_IF(LUA, "[Lua] %s loaded from %s in %.2f ms\n",
+         scriptPath, loadCached ? "bytecode cache" : "source", loadUs / 1000.0f);
+
+  if (call(0)) callGlobal("_init");
+  gcBaseKB = max(lua_gc(L, LUA_GCCOUNT, 0), 16);
+}
+
+static void cartUpdate() { callGlobal("_update"); }
+
+static void cartDraw() {
+  if (failed) { drawError(); return; }
+  callGlobal("_draw");
+  gcSlice();
+}
+
+static void cartQuit() {
+  DBG_IF(LUA, "[Lua] %s closed, arena peak %lu KB\n", cartName, (unsigned long)arenaPeakKB());
+  vmClose();
+}
+
+
+#endif  // LUA_BUILT_IN
+
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool luaIsScript(const String& name) {
+  String lower = name;
+  lower.toLowerCase();
+  return lower.endsWith(".lua");
+}
+
+#if LUA_BUILT_IN
+bool luaLaunch(const char* path) {
+  if (fconRunning()) fconStop();
+  if (!vmOpen()) {
+    DBG_IF(LUA, "[Lua] No memory for a %lu KB arena\n", (unsigned long)LUA_ARENA_KB);
+    return false;
+  }
+
+  strlcpy(scriptPath, path, sizeof(scriptPath));
+  const char* base = strrchr(path, '/');
+  strlcpy(cartName, base ? base + 1 : path, sizeof(cartName));
+
+  if (!fconLaunch(LUA_CART)) {
+    vmClose();
+    return false;
+  }
+  return true;
+}
+
+void luaBenchmark(const char* path) {
+  if (fconRunning()) fconStop();
+  if (!vmOpen()) return;
+
+  // Warm-up load makes sure the cache entry exists
+  bool ok = loadScript(path, true) == LUA_OK;
+  lua_pop(L, 1);
+
+  uint32_t us[2] = { 0, 0 };
+  bool hits = true;
+  for (int pass = 0; pass < 2 && ok; ++pass) {
+    for (int i = 0; i < LUA_BENCH_LOADS && ok; ++i) {
+      ok = loadScript(path, pass == 1) == LUA_OK;
+      if (pass == 1) hits &= loadCached;
+      us[pass] += loadUs;
+      lua_pop(L, 1);
+      lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+  }
+
+  if (!ok) {
+    DBG_IF(LUA, "[Lua] Benchmark: %s does not compile\n", path);
+  } else {
+    float src = us[0] / 1000.0f / LUA_BENCH_LOADS;
+    float bin = us[1] / 1000.0f / LUA_BENCH_LOADS;
+    DBG_IF(LUA, "[Lua] %s: source %.2f ms, bytecode %.2f ms per load (%.1fx)%s\n",
+           path, src, bin, bin > 0 ? src / bin : 0.0f, hits ? "" : " [cache unavailable]");
+  }
+  vmClose();
+}
+
+#else
+bool luaLaunch(const char* path) {
+  DBG_IF(LUA, "[Lua] Lua not built in (no lua.h library); can't run %s\n", path);
+  return false;
+}
+
+void luaBenchmark(const char* path) {
+  DBG_IF(LUA, "[Lua] Lua not built in; no benchmark for %s\n", path);
+}
+#endif
+
+// ======================= End of File =======================
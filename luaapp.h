@@ -0,0 +1,43 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  luaapp.h — Lua Cart Runtime (Header)
+//
+//  Runs .lua scripts from HOMEBREW_DIR as fantasy-console
+//  carts (fcon.h).
+//
+//  Provides:
+//   • luaIsScript()  — *.lua filter for the launcher
+//   • luaLaunch()    — load a script and start its session
+//   • luaBenchmark() — source vs cached-bytecode load times
+//
+//  Script shape (all optional, PICO-8 style):
+//   - top level runs once at load; _init() once after it
+//   - _update() then _draw() on every 60 Hz tick
+//
+//  Notes:
+//   - Each script gets its own PSRAM arena (LUA_ARENA_KB); the
+//     whole VM lives in it and is dropped in one go on exit.
+//   - Compiled chunks are cached in LUA_CACHE_DIR, keyed by a
+//     hash of the source, so unchanged scripts skip the parser.
+//   - The collector only runs in per-frame slices of at most
+//     LUA_GC_BUDGET_US; pauses are logged every 300 frames.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool luaIsScript(const String& name);
+
+// Starts the script as an fcon session. Script errors don't
+// fail the launch: they end up on an error screen instead.
+bool luaLaunch(const char* path);
+
+// Loads `path` LUA_BENCH_LOADS times from source and from the
+// bytecode cache and logs the time per load.
+void luaBenchmark(const char* path);
+
+// ======================= End of File =======================
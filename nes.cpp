@@ -0,0 +1,484 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  nes.cpp — NES System: Cartridge Load, Frame Loop, I/O
+//
+//  Provides:
+//   • iNES header parsing + CHR pre-decode on load
+//   • Scanline-batched frame loop (262 lines, NTSC timing)
+//   • CPU-side I/O: PPU registers, APU, OAM DMA, controller port
+//   • Save states (fixed layout, see _stateIO)
+//
+//  Notes:
+//   - Each line renders first, then the CPU runs for 341 dots.
+//     Raster effects land with one-line granularity, which is
+//     what the batched design trades for speed.
+//   - The APU catches up once per line, after the CPU slice.
+//
+//  Host benchmark (headless; test ROMs are optional). Each ROM
+//  runs on the plain and the cached interpreter, which must end
+//  in the same state; without ROMs, random-code carts are
+//  checked the same way:
+//    g++ -O2 -DNES_BENCH_MAIN -x c++ nes.cpp nes_cpu.cpp nes_ppu.cpp
+//        nes_apu.cpp nes_mapper.cpp blipbuf.cpp -o nes_bench
+//    ./nes_bench [frames] [rom.nes ...]
+// =========================================================
+
+#include "nes.h"
+#include <stdlib.h>
+#include <string.h>
+
+// =========================================================
+//  CONSTRUCTION
+// =========================================================
+NES::NES() {
+  memset(_prgRam, 0, sizeof(_prgRam));
+  memset(_ram, 0, sizeof(_ram));
+  memset(_vram, 0, sizeof(_vram));
+  memset(_palette, 0, sizeof(_palette));
+  memset(_oam, 0, sizeof(_oam));
+  setSampleRate(44100);
+}
+
+NES::~NES() { unload(); }
+
+
+// =========================================================
+//  CARTRIDGE LOAD
+// =========================================================
+bool NES::load(const uint8_t* image, size_t len) {
+  unload();
+  if (!image || len < 16 || memcmp(image, "NES\x1A", 4) != 0) return false;
+
+  const uint8_t* h = image;
+  bool nes2    = (h[7] & 0x0C) == 0x08;
+  bool dirty   = !nes2 && (h[12] | h[13] | h[14] | h[15]);  // "DiskDude!" style junk
+  int  mapper  = (h[6] >> 4) | (dirty ? 0 : (h[7] & 0xF0));
+  bool trainer = h[6] & 0x04;
+
+  size_t off     = 16 + (trainer ? 512 : 0);
+  size_t prgSize = (size_t)h[4] * 0x4000;
+  size_t chrSize = (size_t)h[5] * 0x2000;
+  if (prgSize == 0 || off + prgSize + chrSize > len) return false;
+
+  _prg        = image + off;
+  _prgSize    = prgSize;
+  _chrRam     = (chrSize == 0);
+  _chrSize    = _chrRam ? 0x2000 : chrSize;
+  _battery    = h[6] & 0x02;
+  _fourScreen = h[6] & 0x08;
+  _mapperId   = mapper;
+
+  // Decoded rows take exactly as much room as the source planes
+  _chr = (uint16_t*)malloc(_chrSize);
+  if (!_chr) { unload(); return false; }
+  if (_chrRam) memset(_chr, 0, _chrSize);
+  else         _decodeChr(image + off + prgSize);
+
+  if (trainer) memcpy(_prgRam + 0x1000, image + 16, 512);
+
+  _mapper = createNesMapper(mapper, *this);
+  if (!_mapper) { unload(); return false; }
+
+  _setMirroring(_fourScreen    ? MIRROR_FOUR
+              : (h[6] & 0x01) ? MIRROR_VERTICAL
+                              : MIRROR_HORIZONTAL);
+  reset();
+  return true;
+}
+
+void NES::unload() {
+  delete _mapper;
+  _mapper = nullptr;
+  free(_chr);
+  _chr = nullptr;
+  _prg = nullptr;
+  _prgSize = _chrSize = 0;
+}
+
+void NES::reset() {
+  if (!_mapper) return;
+  _mapper->reset();
+
+  memset(_ram, 0, sizeof(_ram));
+  _a = _x = _y = 0;
+  _s = 0xFD;
+  _p = 0x24;
+  _pc = _prgBank[3][0x1FFC] | (_prgBank[3][0x1FFD] << 8);
+  _nmiPending = false;
+  _irqLines = 0;
+  _dots = 0;
+
+  _ctrl = _mask = _status = _oamAddr = 0;
+  _v = _t = 0;
+  _fx = 0;
+  _w = false;
+  _readBuf = _openBus = 0;
+  _strobe = false;
+  _padShift = 0;
+  _frame = 0;
+  _apuReset();
+  _cache.flush();
+}
+
+
+// =========================================================
+//  FRAME LOOP
+// =========================================================
+// 240 visible lines, 1 idle, 20 vblank, 1 pre-render.
+void NES::runFrame() {
+  for (int line = 0; line < 262; ++line) {
+    if (line < 240) {
+      _renderLine(line);
+    } else if (line == 241) {
+      _status |= 0x80;
+      if (_ctrl & 0x80) _nmiPending = true;
+    } else if (line == 261) {
+      _status &= ~0xE0;  // vblank, sprite 0, overflow
+    }
+
+    _runCpu();
+
+    // 341 dots = 113⅔ CPU cycles; carry the remainder
+    _apuDots += 341;
+    int cycles = _apuDots / 3;
+    _apuDots -= cycles * 3;
+    _apuRun(cycles);
+
+    if (_rendering() && (line < 240 || line == 261)) {
+      if (line == 261) {
+        _v = _t;  // vertical + horizontal reload before line 0
+      } else {
+        _incY();
+        _v = (_v & ~0x041F) | (_t & 0x041F);
+      }
+      _mapper->scanline();
+    }
+  }
+  _apuEndFrame();
+  _frame++;
+}
+
+
+// =========================================================
+//  CPU I/O ($2000–$5FFF)
+// =========================================================
+uint8_t NES::_ioRead(uint16_t addr) {
+  if (addr < 0x4000) return _regRead(addr & 7);
+
+  if (addr == 0x4016) {
+    if (_strobe) _padShift = _pad;
+    uint8_t bit = _padShift & 1;
+    _padShift = (_padShift >> 1) | 0x80;  // official pads read 1 after 8 bits
+    return 0x40 | bit;
+  }
+  if (addr == 0x4017) return 0x40;  // no second controller
+  if (addr == 0x4015) return _apuStatus();
+  return 0;
+}
+
+void NES::_ioWrite(uint16_t addr, uint8_t v) {
+  if (addr < 0x4000) { _regWrite(addr & 7, v); return; }
+
+  if (addr == 0x4014) {
+    // OAM DMA: copy one CPU page, stall for 513 cycles
+    uint16_t page = v << 8;
+    for (int i = 0; i < 256; ++i)
+      _oam[(uint8_t)(_oamAddr + i)] = _read(page | i);
+    _dots -= 513 * 3;
+  } else if (addr == 0x4016) {
+    _strobe = v & 1;
+    if (_strobe) _padShift = _pad;
+  } else if (addr <= 0x4017) {
+    _apuWrite(addr, v);
+  }
+}
+
+
+// =========================================================
+//  SAVE STATES
+// =========================================================
+// One walk over every field: dir > 0 saves, dir < 0 loads,
+// dir == 0 only measures. Keeping the layout in one place
+// means save and load can never disagree.
+size_t NES::_stateIO(uint8_t* buf, int dir) {
+  size_t off = 0;
+  auto io = [&](void* field, size_t n) {
+    if (dir > 0)      memcpy(buf + off, field, n);
+    else if (dir < 0) memcpy(field, buf + off, n);
+    off += n;
+  };
+#define IO(x) io(&(x), sizeof(x))
+
+  uint32_t tag = 0x3154534E;  // "NST1"
+  IO(tag);
+
+  // CPU + input
+  IO(_pc); IO(_a); IO(_x); IO(_y); IO(_s); IO(_p);
+  IO(_nmiPending); IO(_irqLines); IO(_dots);
+  IO(_ram);
+  IO(_prgRam);
+  IO(_padShift); IO(_strobe);
+
+  // PPU
+  IO(_ctrl); IO(_mask); IO(_status); IO(_oamAddr);
+  IO(_v); IO(_t); IO(_fx); IO(_w);
+  IO(_readBuf); IO(_openBus);
+  IO(_vram); IO(_palette); IO(_oam);
+  IO(_frame);
+  if (_chrRam) io(_chr, _chrSize);
+
+  // APU
+  IO(_pulse); IO(_tri); IO(_noise); IO(_dmc);
+  IO(_apuEnable); IO(_frameMode5); IO(_frameIrqOff); IO(_frameIrq);
+  IO(_frameSeq); IO(_apuDots);
+
+  // Mapper registers first, then nametables (mappers may remap them)
+  uint8_t m[NesMapper::STATE_SIZE] = {};
+  if (dir > 0 && _mapper) _mapper->saveState(m);
+  IO(m);
+  if (dir < 0 && _mapper) _mapper->loadState(m);
+
+  uint16_t nt[4];
+  for (int i = 0; i < 4; ++i) nt[i] = (uint16_t)(_nt[i] - _vram);
+  IO(nt);
+  if (dir < 0)
+    for (int i = 0; i < 4; ++i) _nt[i] = _vram + (nt[i] & 0xC00);
+
+#undef IO
+  return off;
+}
+
+size_t NES::stateSize() { return _stateIO(nullptr, 0); }
+
+size_t NES::saveState(uint8_t* out) {
+  if (!_mapper) return 0;
+  return _stateIO(out, 1);
+}
+
+bool NES::loadState(const uint8_t* in, size_t len) {
+  if (!_mapper || !in || len != stateSize()) return false;
+  if (memcmp(in, "NST1", 4) != 0) return false;
+  _stateIO(const_cast<uint8_t*>(in), -1);  // dir < 0 only reads
+  _cache.flush();  // RAM / PRG-RAM code may differ now
+  return true;
+}
+
+
+// =========================================================
+//  HOST BENCHMARK
+// =========================================================
+#ifdef NES_BENCH_MAIN
+#include <stdio.h>
+#include <chrono>
+#include <initializer_list>
+
+static uint64_t benchNs() {
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Tiny emitter for the built-in ROM (backward branches only)
+struct BenchAsm {
+  uint8_t* prg;        // 16 KB, mapped at $C000
+  uint16_t pc = 0xC000;
+  void op(std::initializer_list<int> b) { for (int v : b) prg[pc++ - 0xC000] = (uint8_t)v; }
+  void abs(int opc, uint16_t a) { op({ opc, a & 0xFF, a >> 8 }); }
+  void br(int opc, uint16_t to) { op({ opc, (uint8_t)(to - (pc + 2)) }); }
+};
+
+// NROM-128 with rendering, sprites, OAM DMA, scroll writes and
+// two APU channels on, plus a RAM-heavy main loop: stands in
+// for a game when no ROM is given
+static size_t buildBenchRom(uint8_t* img) {
+  memset(img, 0, 16 + 0x4000 + 0x2000);
+  memcpy(img, "NES\x1A\x01\x01\x01", 7);   // 1x PRG, 1x CHR, vertical
+  BenchAsm a{ img + 16 };
+
+  a.op({ 0x78, 0xD8, 0xA2, 0xFF, 0x9A });                  // SEI CLD LDX #$FF TXS
+  a.op({ 0xA9, 0x00 }); a.abs(0x8D, 0x2000); a.abs(0x8D, 0x2001);
+  for (int i = 0; i < 2; ++i) {                            // two vblanks
+    uint16_t w = a.pc; a.abs(0x2C, 0x2002); a.br(0x10, w);
+  }
+  a.op({ 0xA9, 0x3F }); a.abs(0x8D, 0x2006); a.op({ 0xA9, 0x00 }); a.abs(0x8D, 0x2006);
+  a.op({ 0xA2, 0x00 });                                    // palette: 0..31
+  { uint16_t l = a.pc; a.op({ 0x8A }); a.abs(0x8D, 0x2007); a.op({ 0xE8, 0xE0, 32 }); a.br(0xD0, l); }
+  a.op({ 0xA9, 0x20 }); a.abs(0x8D, 0x2006); a.op({ 0xA9, 0x00 }); a.abs(0x8D, 0x2006);
+  a.op({ 0xA0, 0x04, 0xA2, 0x00 });                        // 1 KB of nametable
+  { uint16_t l = a.pc; a.op({ 0x8A }); a.abs(0x8D, 0x2007); a.op({ 0xE8 }); a.br(0xD0, l);
+    a.op({ 0x88 }); a.br(0xD0, l); }
+  a.op({ 0xA2, 0x00 });                                    // OAM page $0200
+  { uint16_t l = a.pc; a.op({ 0x8A }); a.abs(0x9D, 0x0200); a.op({ 0xE8 }); a.br(0xD0, l); }
+  a.op({ 0xA9, 0x0F }); a.abs(0x8D, 0x4015);               // pulse 1 + triangle
+  a.op({ 0xA9, 0xBF }); a.abs(0x8D, 0x4000); a.op({ 0xA9, 0xFD }); a.abs(0x8D, 0x4002);
+  a.op({ 0xA9, 0x00 }); a.abs(0x8D, 0x4003);
+  a.op({ 0xA9, 0xFF }); a.abs(0x8D, 0x4008); a.op({ 0xA9, 0x80 }); a.abs(0x8D, 0x400A);
+  a.op({ 0xA9, 0x01 }); a.abs(0x8D, 0x400B);
+  a.op({ 0xA9, 0x80 }); a.abs(0x8D, 0x2000); a.op({ 0xA9, 0x1E }); a.abs(0x8D, 0x2001);
+
+  uint16_t main = a.pc;                                    // churn RAM forever
+  a.op({ 0xA2, 0x00 });
+  { uint16_t l = a.pc;
+    a.abs(0xBD, 0x0300); a.op({ 0x18, 0x69, 0x03 }); a.abs(0x9D, 0x0300);
+    a.abs(0x5D, 0x0200); a.abs(0x9D, 0x0400); a.op({ 0xE8 }); a.br(0xD0, l); }
+  a.abs(0x4C, main);
+
+  uint16_t nmi = a.pc;                                     // DMA, scroll, pitch
+  a.op({ 0x48, 0x8A, 0x48 });
+  a.op({ 0xA9, 0x02 }); a.abs(0x8D, 0x4014);
+  a.op({ 0xE6, 0x10, 0xA5, 0x10 }); a.abs(0x8D, 0x2005);
+  a.op({ 0xA9, 0x00 }); a.abs(0x8D, 0x2005);
+  a.op({ 0xA5, 0x10 }); a.abs(0x8D, 0x4002);
+  a.op({ 0x68, 0xAA, 0x68, 0x40 });
+  uint16_t irq = a.pc;
+  a.op({ 0x40 });
+
+  uint8_t* vec = img + 16 + 0x3FFA;
+  vec[0] = nmi & 0xFF;    vec[1] = nmi >> 8;
+  vec[2] = 0x00;          vec[3] = 0xC0;
+  vec[4] = irq & 0xFF;    vec[5] = irq >> 8;
+
+  uint32_t x = 0x2545F491;                                 // CHR: noise tiles
+  for (int i = 0; i < 0x2000; ++i) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    img[16 + 0x4000 + i] = (uint8_t)x;
+  }
+  return 16 + 0x4000 + 0x2000;
+}
+
+static uint32_t frameHash;
+static void hashLine(void*, int /*line*/, const uint8_t* px) {
+  for (int i = 0; i < NES::SCREEN_W; ++i) frameHash = (frameHash ^ px[i]) * 16777619u;
+}
+
+// Same convention as the device: blargg's ROMs report at $6000
+static void printTestRom(NES& nes) {
+  const uint8_t* r = nes.prgRam();
+  if (r[1] != 0xDE || r[2] != 0xB0 || r[3] != 0x61) return;
+  printf("  test ROM: %s (status %02X): %.*s\n",
+         r[0] == 0 ? "passed" : r[0] == 0x80 ? "still running" : "FAILED", r[0], 96, (const char*)r + 4);
+}
+
+// One pass over `frames` from power-on (a fresh NES: reset()
+// keeps VRAM, OAM and PRG-RAM, like the console); `cache` null
+// runs the plain interpreter
+struct BenchPass { uint64_t ns; uint32_t hash; int32_t audio; size_t stateLen; uint32_t blocks, flushes, smc; };
+static uint32_t fuzzBlocks = 0, fuzzSmc = 0;
+static BenchPass runPass(const uint8_t* img, size_t len, void* cache, size_t cacheBytes,
+                         int frames, uint8_t* state, bool report) {
+  BenchPass p = {};
+  NES* nes = new NES();
+  if (!nes->load(img, len)) { delete nes; return p; }
+  nes->setLineSink(hashLine, nullptr);
+  nes->setCodeCache(cache, cacheBytes);
+  nes->reset();
+  frameHash = 2166136261u;
+
+  uint64_t t0 = benchNs();
+  for (int i = 0; i < frames; ++i) {
+    nes->runFrame();
+    p.audio += nes->audioSampleCount();
+  }
+  p.ns = benchNs() - t0;
+  p.hash = frameHash;
+  p.stateLen = nes->saveState(state);
+
+  const NesBlockCache& c = nes->codeCache();
+  p.blocks = c.translated();
+  p.flushes = c.flushes();
+  p.smc = c.invalidations();
+  if (report && !cache) printTestRom(*nes);
+  delete nes;
+  return p;
+}
+
+// Plain vs cached: both must end in the same machine state and
+// draw the same frames; `quiet` only reports mismatches
+static bool benchRom(const char* name, const uint8_t* img, size_t len, int frames, bool quiet = false) {
+  static uint8_t cache[48 * 1024];   // EMU_CODE_CACHE_KB
+  static uint8_t plainState[64 * 1024], cachedState[64 * 1024];
+  NES probe;
+  if (!probe.load(img, len) || probe.stateSize() > sizeof(plainState)) {
+    printf("%s: not a supported iNES image\n", name);
+    return false;
+  }
+  int mapper = probe.mapperId();
+  probe.unload();
+
+  BenchPass plain  = runPass(img, len, nullptr, 0, frames, plainState, !quiet);
+  BenchPass cached = runPass(img, len, cache, sizeof(cache), frames, cachedState, !quiet);
+  bool same = plain.hash == cached.hash && plain.audio == cached.audio &&
+              plain.stateLen == cached.stateLen && !memcmp(plainState, cachedState, plain.stateLen);
+
+  if (!quiet || !same)
+    printf("%s: mapper %d, %d frames: plain %.0f FPS (%.3f ms/frame), cached %.0f FPS "
+           "(%.3f ms/frame), %.2fx; %ld audio samples, video hash %08X; %s\n",
+           name, mapper, frames,
+           frames * 1e9 / plain.ns, plain.ns / 1e6 / frames,
+           frames * 1e9 / cached.ns, cached.ns / 1e6 / frames, (double)plain.ns / cached.ns,
+           (long)plain.audio, (unsigned)plain.hash,
+           same ? "cached matches plain" : "CACHED DIFFERS FROM PLAIN");
+  if (!quiet)
+    printf("  code cache: %lu blocks translated, %lu flushes, %lu SMC drops\n",
+           (unsigned long)cached.blocks, (unsigned long)cached.flushes, (unsigned long)cached.smc);
+  fuzzBlocks += cached.blocks;
+  fuzzSmc += cached.smc;
+  return same;
+}
+
+// Random PRG: every opcode (legal or not), bus and register
+// writes. Odd seeds first copy a page of it into RAM and run
+// it there, so code keeps overwriting itself (SMC drops).
+static bool fuzzCache(int roms, int frames) {
+  static uint8_t img[16 + 0x4000 + 0x2000];
+  static const uint8_t TO_RAM[] = { 0xA2, 0x00, 0xBD, 0x00, 0xC1, 0x9D, 0x00, 0x03,
+                                    0xE8, 0xD0, 0xF7, 0x4C, 0x00, 0x03 };
+  int bad = 0;
+  fuzzBlocks = fuzzSmc = 0;
+  for (int seed = 1; seed <= roms; ++seed) {
+    memset(img, 0, 16);
+    memcpy(img, "NES\x1A\x01\x01", 6);
+    uint32_t x = 0x9E3779B9u * seed;
+    for (size_t i = 16; i < sizeof(img); ++i) {
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      img[i] = (uint8_t)x;
+    }
+    uint8_t* vec = img + 16 + 0x3FFA;
+    vec[2] = 0x00; vec[3] = 0xC0;                            // reset → $C000
+    if (seed & 1) memcpy(img + 16, TO_RAM, sizeof(TO_RAM));
+    char name[24];
+    snprintf(name, sizeof(name), "random #%d", seed);
+    if (!benchRom(name, img, sizeof(img), frames, true)) bad++;
+  }
+  printf("random code: %d ROMs x %d frames, %lu blocks translated, %lu SMC drops, %d mismatched\n",
+         roms, frames, (unsigned long)fuzzBlocks, (unsigned long)fuzzSmc, bad);
+  return !bad;
+}
+
+int main(int argc, char** argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 0;
+  if (frames <= 0) frames = 1800;
+
+  bool ok = true;
+  if (argc <= 2) {
+    static uint8_t img[16 + 0x4000 + 0x2000];
+    ok = benchRom("built-in", img, buildBenchRom(img), frames);
+    ok = fuzzCache(200, 20) && ok;
+  }
+  for (int i = 2; i < argc; ++i) {
+    FILE* f = fopen(argv[i], "rb");
+    if (!f) { printf("%s: can't open\n", argv[i]); ok = false; continue; }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* img = (uint8_t*)malloc(len > 0 ? len : 1);
+    bool read = img && fread(img, 1, len, f) == (size_t)len;
+    fclose(f);
+    ok = read && benchRom(argv[i], img, len, frames) && ok;
+    free(img);
+  }
+  return ok ? 0 : 1;
+}
+#endif
+
+// ======================= End of File =======================
@@ -0,0 +1,355 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  nes.h — NES Emulator Core (Header)
+//
+//  Provides:
+//   • NES — 6502 CPU, 2C02 PPU and cartridge bus in one object
+//   • NesMapper — bank-switching base for cartridge boards
+//   • Mapper support: NROM (0), MMC1 (1), UxROM (2), MMC3 (4)
+//   • 2A03 APU: two pulses, triangle, noise, DMC → mono PCM
+//
+//  Design:
+//   - The CPU is table-driven: one entry per opcode holding the
+//     handler, addressing mode and base cycle count.
+//   - The PPU works a whole scanline at a time. Pattern tables
+//     are pre-decoded into 2-bit interleaved rows (one uint16_t
+//     per tile row), so a tile row is a single load + shifts.
+//   - Bank switching only swaps pointers: PRG in 8 KB slots,
+//     CHR in 1 KB slots. PRG is referenced in place, never copied.
+//   - With a code cache attached, guest blocks are decoded once
+//     into handler + operand runs (see blockcache.h).
+//
+//  Notes:
+//   - This core has no Arduino dependency; the frontend lives
+//     in emulator.cpp and feeds it input + consumes scanlines.
+//   - Output lines are 256 NES colour indices (0–63); convert
+//     them with NES::PALETTE_RGB or your own LUT.
+//   - Audio is produced per frame at setSampleRate() and read
+//     back with audioSamples() / audioSampleCount(). Channels
+//     are band-limited through a BlipBuf (see blipbuf.h).
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "blockcache.h"
+#include "blipbuf.h"
+
+class NES;
+
+// =========================================================
+//  MAPPER BASE
+// =========================================================
+// Boards only touch the NES through these helpers, so every
+// bank switch stays a pointer update.
+class NesMapper {
+public:
+  explicit NesMapper(NES& n) : _n(n) {}
+  virtual ~NesMapper() {}
+
+  virtual void reset() = 0;
+  virtual void write(uint16_t addr, uint8_t v) = 0;  // $8000–$FFFF
+  virtual void scanline() {}                         // once per rendered line
+
+  // Register snapshot for save states; loadState() re-applies banks.
+  static constexpr size_t STATE_SIZE = 16;
+  virtual void saveState(uint8_t* /*out*/) const {}
+  virtual void loadState(const uint8_t* /*in*/) {}
+
+protected:
+  NES& _n;
+
+  // --- Bank helpers (bank numbers wrap to the ROM size) ---
+  void mapPrg8(int slot, int bank);
+  void mapPrg16(int slot, int bank);
+  void mapPrg32(int bank);
+  void mapChr1(int slot, int bank);
+  void mapChr4(int slot, int bank);
+  void mapChr8(int bank);
+  void setMirroring(uint8_t mode);
+  bool fourScreen() const;
+  void setIrq(bool asserted);
+
+  int prg8Count() const;
+  int chr1Count() const;
+};
+
+// Factory for the boards above; returns nullptr if unsupported.
+NesMapper* createNesMapper(int id, NES& n);
+
+
+// =========================================================
+//  APU CHANNEL STATE
+// =========================================================
+struct NesEnvelope {
+  bool    start = false, loop = false, constant = false;
+  uint8_t period = 0, divider = 0, decay = 0;
+};
+struct NesPulse {
+  NesEnvelope env;
+  uint8_t  duty = 0, step = 0, length = 0;
+  bool     halt = false;
+  uint16_t period = 0;
+  int32_t  timer = 0;
+  bool     sweepOn = false, sweepNeg = false, sweepReload = false;
+  uint8_t  sweepPeriod = 0, sweepShift = 0, sweepDiv = 0;
+};
+struct NesTriangle {
+  uint8_t  step = 0, length = 0, linear = 0, linearLoad = 0;
+  bool     control = false, reload = false;
+  uint16_t period = 0;
+  int32_t  timer = 0;
+};
+struct NesNoise {
+  NesEnvelope env;
+  uint8_t  length = 0;
+  bool     halt = false, mode = false;
+  uint16_t shift = 1, period = 4;
+  int32_t  timer = 0;
+};
+struct NesDmc {
+  bool     irqOn = false, loop = false, silent = true, irq = false;
+  uint8_t  level = 0, shift = 0, bits = 0;
+  uint16_t rate = 428, addr = 0xC000, len = 1, cur = 0, left = 0;
+  int32_t  timer = 0;
+  int16_t  buffer = -1;              // -1 = empty
+};
+
+
+// =========================================================
+//  TRANSLATED CODE
+// =========================================================
+// One decoded instruction. `run` is the handler specialised for
+// its addressing mode; it returns the cycles taken. `operand`
+// is the final address for fixed modes (IMM/ZP/ABS/REL) and the
+// base, zero-page pointer or indirect pointer for the others.
+struct NesCachedOp {
+  int    (*run)(NES&, const NesCachedOp&);
+  uint16_t operand;
+  uint16_t next;           // PC after this instruction
+  uint8_t  cycles;
+};
+
+// Writable code pages: 8 x 256 B of RAM, then 32 x 256 B of PRG-RAM
+typedef BlockCache<NesCachedOp, 32, 40> NesBlockCache;
+
+
+// =========================================================
+//  NES CLASS
+// =========================================================
+class NES {
+public:
+  // Controller bits, in $4016 shift order
+  enum Button : uint8_t {
+    BTN_A      = 0x01,
+    BTN_B      = 0x02,
+    BTN_SELECT = 0x04,
+    BTN_START  = 0x08,
+    BTN_UP     = 0x10,
+    BTN_DOWN   = 0x20,
+    BTN_LEFT   = 0x40,
+    BTN_RIGHT  = 0x80,
+  };
+
+  // Nametable layouts (set by the header or by the mapper)
+  enum Mirroring : uint8_t { MIRROR_HORIZONTAL, MIRROR_VERTICAL, MIRROR_SINGLE0, MIRROR_SINGLE1, MIRROR_FOUR };
+
+  // Called once per visible line with 256 colour indices (0–63)
+  typedef void (*LineSink)(void* ctx, int line, const uint8_t* px);
+
+  static const uint32_t PALETTE_RGB[64];     // 2C02 palette, 0xRRGGBB
+  static constexpr int  SCREEN_W = 256;
+  static constexpr int  SCREEN_H = 240;
+  static constexpr int  AUDIO_MAX = 1024;    // samples per frame, upper bound
+
+  NES();
+  ~NES();
+
+  // --- Lifecycle ---
+  // Loads an iNES image. PRG data is referenced in place and must
+  // outlive the session; CHR is pre-decoded into an owned buffer.
+  bool load(const uint8_t* image, size_t len);
+  void unload();
+  void reset();
+  bool loaded() const { return _mapper != nullptr; }
+
+  // --- Per-frame ---
+  void runFrame();
+  void setButtons(uint8_t pad) { _pad = pad; }
+  void setLineSink(LineSink s, void* ctx) { _sink = s; _sinkCtx = ctx; }
+
+  // Skips line composition + sink for the next frames; sprite 0
+  // lines are still rendered so hit timing stays correct.
+  void setVideoSkip(bool skip) { _skipVideo = skip; }
+
+  // --- Audio ---
+  void           setSampleRate(uint32_t hz);
+  const int16_t* audioSamples() const     { return _audioBuf; }
+  int            audioSampleCount() const { return _audioLen; }
+
+  // One bit per channel in $4015 order (pulse 1, pulse 2,
+  // triangle, noise, DMC); cleared bits are muted.
+  enum : uint8_t { CH_ALL = 0x1F };
+  void setChannelMask(uint8_t mask) { _chMask = mask; }
+
+  // --- Code cache ---
+  // Memory for translated blocks; nullptr runs the plain
+  // interpreter. The caller owns the buffer.
+  void setCodeCache(void* mem, size_t bytes) { _cache.attach(mem, bytes); }
+  const NesBlockCache& codeCache() const     { return _cache; }
+
+  // --- Save states ---
+  // Fixed size and layout per cartridge, so two states line up
+  // byte for byte (the rewind buffer XORs them).
+  size_t stateSize();
+  size_t saveState(uint8_t* out);
+  bool   loadState(const uint8_t* in, size_t len);
+
+  // --- Info ---
+  int      mapperId() const   { return _mapperId; }
+  bool     hasBattery() const { return _battery; }
+  uint8_t* prgRam()           { return _prgRam; }
+  size_t   prgRamSize() const { return sizeof(_prgRam); }
+  uint32_t frameCount() const { return _frame; }
+
+private:
+  friend class NesMapper;
+  friend struct NesOps;
+
+  // --- Cartridge ---
+  NesMapper*     _mapper = nullptr;
+  int            _mapperId = 0;
+  bool           _battery = false;
+  const uint8_t* _prg = nullptr;
+  size_t         _prgSize = 0;
+  uint16_t*      _chr = nullptr;       // pre-decoded rows, 8 per tile
+  size_t         _chrSize = 0;         // in source bytes
+  bool           _chrRam = false;
+  bool           _fourScreen = false;
+  const uint8_t* _prgBank[4] = {};     // $8000/$A000/$C000/$E000
+  uint16_t*      _chrBank[8] = {};     // 1 KB each → 512 rows
+  uint8_t        _prgRam[0x2000];
+
+  // --- CPU ---
+  uint16_t _pc = 0;
+  uint8_t  _a = 0, _x = 0, _y = 0, _s = 0xFD, _p = 0x24;
+  uint8_t  _extra = 0;                 // page-cross / branch cycles
+  bool     _nmiPending = false;
+  uint8_t  _irqLines = 0;              // bitmask of asserted sources
+  int32_t  _dots = 0;                  // PPU dot budget for this line
+  uint8_t  _ram[0x800];
+  NesBlockCache _cache;
+
+  // --- Input ---
+  uint8_t _pad = 0, _padShift = 0;
+  bool    _strobe = false;
+
+  // --- PPU ---
+  uint8_t  _ctrl = 0, _mask = 0, _status = 0, _oamAddr = 0;
+  uint16_t _v = 0, _t = 0;
+  uint8_t  _fx = 0;
+  bool     _w = false;
+  uint8_t  _readBuf = 0, _openBus = 0;
+  uint8_t  _vram[0x1000];              // 4 KB so four-screen boards fit
+  uint8_t* _nt[4] = {};
+  uint8_t  _palette[32];
+  uint8_t  _oam[256];
+  uint8_t  _bgLine[256 + 16];
+  uint8_t  _sprLine[256];
+  uint8_t  _outLine[256];
+  LineSink _sink = nullptr;
+  void*    _sinkCtx = nullptr;
+  bool     _skipVideo = false;
+  uint32_t _frame = 0;
+
+  // --- APU ---
+  NesPulse    _pulse[2];
+  NesTriangle _tri;
+  NesNoise    _noise;
+  NesDmc      _dmc;
+  uint8_t  _apuEnable = 0;
+  bool     _frameMode5 = false, _frameIrqOff = false, _frameIrq = false;
+  int32_t  _frameSeq = 0;              // CPU cycles into the sequence
+  uint16_t _apuDots = 0;               // leftover dots (3 per CPU cycle)
+  uint32_t _apuClock = 0;              // CPU cycles into this frame
+  uint8_t  _chMask = CH_ALL;
+  int16_t  _pulseOut = 0, _tndOut = 0; // mixer levels already in _blip
+  BlipBuf  _blip;
+  int16_t  _audioBuf[AUDIO_MAX];
+  int      _audioLen = 0;
+
+  // --- Bus ---
+  uint8_t _read(uint16_t addr);
+  void    _write(uint16_t addr, uint8_t v);
+  uint8_t _ioRead(uint16_t addr);
+  void    _ioWrite(uint16_t addr, uint8_t v);
+
+  // --- CPU helpers ---
+  int  _step();
+  void _runCpu();
+  void _interrupt(uint16_t vector, bool brk);
+  NesBlockCache::Block* _translate(uint16_t pc);
+  void _runBlock(const NesBlockCache::Block* b);
+  void _smc(int page) { if (_cache.pageHasCode(page)) _cache.invalidatePage(page); }
+  void _push(uint8_t v) { _ram[0x100 | _s--] = v; _smc(1); }
+  uint8_t _pop()        { return _ram[0x100 | ++_s]; }
+
+  // --- PPU helpers ---
+  uint8_t _ppuRead(uint16_t addr);
+  void    _ppuWrite(uint16_t addr, uint8_t v);
+  uint8_t _regRead(uint16_t reg);
+  void    _regWrite(uint16_t reg, uint8_t v);
+  void    _renderLine(int line);
+  void    _renderBackground();
+  void    _renderSprites(int line);
+  void    _incY();
+  bool    _rendering() const { return (_mask & 0x18) != 0; }
+  void    _setMirroring(uint8_t mode);
+  void    _decodeChr(const uint8_t* src);
+  size_t  _stateIO(uint8_t* buf, int dir);
+
+  // --- APU helpers ---
+  void    _apuReset();
+  void    _apuWrite(uint16_t addr, uint8_t v);
+  uint8_t _apuStatus();
+  void    _apuRun(int cycles);
+  void    _apuAdvance(int cycles);
+  void    _apuQuarter();
+  void    _apuHalf();
+  void    _apuEndFrame();
+  void    _apuMix(uint32_t t);
+  void    _mixPulses(uint32_t t);
+  void    _mixTnd(uint32_t t, bool fast);
+  void    _apuIrq();
+};
+
+
+// =========================================================
+//  BUS (fast path)
+// =========================================================
+// RAM and PRG are served inline; everything else goes
+// through the I/O handlers in nes.cpp. Writes to pages that
+// hold translated code drop those blocks.
+inline uint8_t NES::_read(uint16_t addr) {
+  if (addr < 0x2000)  return _ram[addr & 0x7FF];
+  if (addr >= 0x8000) return _prgBank[(addr >> 13) & 3][addr & 0x1FFF];
+  if (addr >= 0x6000) return _prgRam[addr & 0x1FFF];
+  return _ioRead(addr);
+}
+
+inline void NES::_write(uint16_t addr, uint8_t v) {
+  if (addr < 0x2000) {
+    _ram[addr & 0x7FF] = v;
+    _smc((addr & 0x7FF) >> 8);
+  } else if (addr >= 0x8000) {
+    _mapper->write(addr, v);
+  } else if (addr >= 0x6000) {
+    _prgRam[addr & 0x1FFF] = v;
+    _smc(8 + ((addr & 0x1FFF) >> 8));
+  } else {
+    _ioWrite(addr, v);
+  }
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,427 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  nes_apu.cpp — NES Audio (2A03 APU)
+//
+//  Provides:
+//   • Pulse ×2 (envelope, sweep), triangle, noise, DMC
+//   • Frame sequencer (4/5-step) with frame + DMC IRQs
+//   • Non-linear mixer → band-limited steps (BlipBuf) → mono PCM
+//   • Per-channel mute mask
+//
+//  Notes:
+//   - Catch-up design: the APU is advanced once per scanline
+//     (~113.7 CPU cycles), in chunks that end on sequencer
+//     events, so register writes land with the same one-line
+//     granularity as the PPU.
+//   - No per-sample work: each change of the pulse group or
+//     the triangle/noise/DMC group is one delta at the CPU
+//     cycle it happens. Noise uses the cheap 2-tap delta, the
+//     rest the full kernel; silent channels only run timers.
+//   - The group levels come from the non-linear mixer tables,
+//     so the mix is exact within a group.
+//   - DMC fetches don't steal CPU cycles.
+// =========================================================
+
+#include "nes.h"
+#include <string.h>
+
+// =========================================================
+//  TABLES
+// =========================================================
+static const uint32_t CPU_HZ = 1789773;
+
+static const uint8_t LENGTHS[32] = {
+  10, 254, 20,  2, 40,  4, 80,  6, 160,  8, 60, 10, 14, 12, 26, 14,
+  12,  16, 24, 18, 48, 20, 96, 22, 192, 24, 72, 26, 16, 28, 32, 30
+};
+
+static const uint8_t DUTY[4] = { 0x02, 0x06, 0x1E, 0xF9 };  // bit = step
+
+static const uint8_t TRI_STEPS[32] = {
+  15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15
+};
+
+static const uint16_t NOISE_PERIODS[16] = {
+  4, 8, 16, 32, 64, 96, 128, 160, 202, 254, 380, 508, 762, 1016, 2034, 4068
+};
+
+static const uint16_t DMC_RATES[16] = {
+  428, 380, 340, 320, 286, 254, 226, 214, 190, 160, 142, 128, 106, 84, 72, 54
+};
+
+// Sequencer events in CPU cycles (last one wraps)
+static const int32_t SEQ4[4] = { 7457, 14913, 22371, 29829 };
+static const int32_t SEQ5[4] = { 7457, 14913, 22371, 37281 };
+
+// Non-linear mixer, pre-scaled to 0..~30000
+static int16_t pulseMix[31];
+static int16_t tndMix[203];
+static bool    mixReady = false;
+
+static void buildMix() {
+  pulseMix[0] = 0;
+  for (int i = 1; i < 31; ++i)
+    pulseMix[i] = (int16_t)(30000.0f * 95.52f / (8128.0f / i + 100.0f));
+  tndMix[0] = 0;
+  for (int i = 1; i < 203; ++i)
+    tndMix[i] = (int16_t)(30000.0f * 163.67f / (24329.0f / i + 100.0f));
+  mixReady = true;
+}
+
+
+// =========================================================
+//  CHANNEL HELPERS
+// =========================================================
+static inline uint8_t envVolume(const NesEnvelope& e) { return e.constant ? e.period : e.decay; }
+
+static inline int sweepTarget(const NesPulse& p, int ch) {
+  int d = p.period >> p.sweepShift;
+  return p.sweepNeg ? p.period - d - (ch == 0 ? 1 : 0) : p.period + d;
+}
+
+static inline bool pulseMuted(const NesPulse& p, int ch) {
+  return p.period < 8 || sweepTarget(p, ch) > 0x7FF;
+}
+
+// Volume the pulse is outputting right now (0–15)
+static inline int pulseLevel(const NesPulse& p, int ch) {
+  return (p.length && !pulseMuted(p, ch) && ((DUTY[p.duty] >> p.step) & 1)) ? envVolume(p.env) : 0;
+}
+
+static inline bool triRunning(const NesTriangle& t) {
+  return t.linear && t.length && t.period >= 2;
+}
+
+static void clockEnvelope(NesEnvelope& e) {
+  if (e.start) {
+    e.start = false;
+    e.decay = 15;
+    e.divider = e.period;
+  } else if (e.divider) {
+    e.divider--;
+  } else {
+    e.divider = e.period;
+    if (e.decay)      e.decay--;
+    else if (e.loop)  e.decay = 15;
+  }
+}
+
+// Runs a down-counter `timer` for n cycles; returns how many times it expired.
+static inline int runTimer(int32_t& timer, int n, int32_t period) {
+  timer -= n;
+  if (timer > 0) return 0;
+  int k = (-timer) / period + 1;
+  timer += k * period;
+  return k;
+}
+
+
+// =========================================================
+//  REGISTERS
+// =========================================================
+void NES::setSampleRate(uint32_t hz) {
+  if (!mixReady) buildMix();
+  _blip.setRates(CPU_HZ, hz);
+  _pulseOut = _tndOut = 0;
+}
+
+void NES::_apuReset() {
+  _pulse[0] = NesPulse();
+  _pulse[1] = NesPulse();
+  _tri   = NesTriangle();
+  _noise = NesNoise();
+  _dmc   = NesDmc();
+  _dmc.bits = 8;
+  _apuEnable = 0;
+  _frameMode5 = _frameIrqOff = _frameIrq = false;
+  _frameSeq = 0;
+  _apuDots = 0;
+  _apuClock = 0;
+  _blip.clear();
+  _pulseOut = _tndOut = 0;
+  _audioLen = 0;
+  _apuIrq();
+}
+
+void NES::_apuIrq() {
+  if (_frameIrq) _irqLines |= 0x02; else _irqLines &= ~0x02;
+  if (_dmc.irq)  _irqLines |= 0x04; else _irqLines &= ~0x04;
+}
+
+void NES::_apuWrite(uint16_t addr, uint8_t v) {
+  if (addr < 0x4008) {
+    int ch = (addr >> 2) & 1;
+    NesPulse& p = _pulse[ch];
+    switch (addr & 3) {
+      case 0:
+        p.duty = v >> 6;
+        p.halt = p.env.loop = v & 0x20;
+        p.env.constant = v & 0x10;
+        p.env.period = v & 0x0F;
+        break;
+      case 1:
+        p.sweepOn = v & 0x80;
+        p.sweepPeriod = (v >> 4) & 7;
+        p.sweepNeg = v & 0x08;
+        p.sweepShift = v & 7;
+        p.sweepReload = true;
+        break;
+      case 2:
+        p.period = (p.period & 0x700) | v;
+        break;
+      case 3:
+        p.period = (p.period & 0xFF) | ((v & 7) << 8);
+        if (_apuEnable & (1 << ch)) p.length = LENGTHS[v >> 3];
+        p.step = 0;
+        p.env.start = true;
+        break;
+    }
+    _mixPulses(_apuClock);
+    return;
+  }
+
+  switch (addr) {
+    case 0x4008:
+      _tri.control = v & 0x80;
+      _tri.linearLoad = v & 0x7F;
+      break;
+    case 0x400A:
+      _tri.period = (_tri.period & 0x700) | v;
+      break;
+    case 0x400B:
+      _tri.period = (_tri.period & 0xFF) | ((v & 7) << 8);
+      if (_apuEnable & 0x04) _tri.length = LENGTHS[v >> 3];
+      _tri.reload = true;
+      break;
+
+    case 0x400C:
+      _noise.halt = _noise.env.loop = v & 0x20;
+      _noise.env.constant = v & 0x10;
+      _noise.env.period = v & 0x0F;
+      break;
+    case 0x400E:
+      _noise.mode = v & 0x80;
+      _noise.period = NOISE_PERIODS[v & 0x0F];
+      break;
+    case 0x400F:
+      if (_apuEnable & 0x08) _noise.length = LENGTHS[v >> 3];
+      _noise.env.start = true;
+      break;
+
+    case 0x4010:
+      _dmc.irqOn = v & 0x80;
+      _dmc.loop = v & 0x40;
+      _dmc.rate = DMC_RATES[v & 0x0F];
+      if (!_dmc.irqOn) { _dmc.irq = false; _apuIrq(); }
+      break;
+    case 0x4011: _dmc.level = v & 0x7F; break;
+    case 0x4012: _dmc.addr = 0xC000 | (v << 6); break;
+    case 0x4013: _dmc.len = (v << 4) | 1; break;
+
+    case 0x4015:
+      _apuEnable = v & 0x1F;
+      if (!(v & 0x01)) _pulse[0].length = 0;
+      if (!(v & 0x02)) _pulse[1].length = 0;
+      if (!(v & 0x04)) _tri.length = 0;
+      if (!(v & 0x08)) _noise.length = 0;
+      if (!(v & 0x10))        _dmc.left = 0;
+      else if (!_dmc.left)  { _dmc.cur = _dmc.addr; _dmc.left = _dmc.len; }
+      _dmc.irq = false;
+      _apuIrq();
+      break;
+
+    case 0x4017:
+      _frameMode5 = v & 0x80;
+      _frameIrqOff = v & 0x40;
+      if (_frameIrqOff) _frameIrq = false;
+      _frameSeq = 0;
+      if (_frameMode5) { _apuQuarter(); _apuHalf(); }
+      _apuIrq();
+      break;
+  }
+  _apuMix(_apuClock);
+}
+
+uint8_t NES::_apuStatus() {
+  uint8_t s = 0;
+  if (_pulse[0].length) s |= 0x01;
+  if (_pulse[1].length) s |= 0x02;
+  if (_tri.length)      s |= 0x04;
+  if (_noise.length)    s |= 0x08;
+  if (_dmc.left)        s |= 0x10;
+  if (_frameIrq)        s |= 0x40;
+  if (_dmc.irq)         s |= 0x80;
+  _frameIrq = false;
+  _apuIrq();
+  return s;
+}
+
+
+// =========================================================
+//  FRAME SEQUENCER
+// =========================================================
+void NES::_apuQuarter() {
+  clockEnvelope(_pulse[0].env);
+  clockEnvelope(_pulse[1].env);
+  clockEnvelope(_noise.env);
+
+  if (_tri.reload)      _tri.linear = _tri.linearLoad;
+  else if (_tri.linear) _tri.linear--;
+  if (!_tri.control) _tri.reload = false;
+}
+
+void NES::_apuHalf() {
+  for (int ch = 0; ch < 2; ++ch) {
+    NesPulse& p = _pulse[ch];
+    if (!p.halt && p.length) p.length--;
+
+    if (p.sweepDiv == 0 && p.sweepOn && p.sweepShift && !pulseMuted(p, ch))
+      p.period = sweepTarget(p, ch);
+    if (p.sweepDiv == 0 || p.sweepReload) {
+      p.sweepDiv = p.sweepPeriod;
+      p.sweepReload = false;
+    } else {
+      p.sweepDiv--;
+    }
+  }
+  if (!_tri.control && _tri.length) _tri.length--;
+  if (!_noise.halt && _noise.length) _noise.length--;
+}
+
+
+// =========================================================
+//  MIXER
+// =========================================================
+// Re-reads the channels and puts any level change into the
+// step buffer at CPU cycle `t` of this frame.
+void NES::_mixPulses(uint32_t t) {
+  int p = ((_chMask & 0x01) ? pulseLevel(_pulse[0], 0) : 0)
+        + ((_chMask & 0x02) ? pulseLevel(_pulse[1], 1) : 0);
+  int v = pulseMix[p];
+  if (v != _pulseOut) { _blip.addDelta(t, v - _pulseOut); _pulseOut = v; }
+}
+
+void NES::_mixTnd(uint32_t t, bool fast) {
+  int tri   = (_chMask & 0x04) ? TRI_STEPS[_tri.step] : 0;
+  int noise = ((_chMask & 0x08) && _noise.length && !(_noise.shift & 1)) ? envVolume(_noise.env) : 0;
+  int dmc   = (_chMask & 0x10) ? _dmc.level : 0;
+  int v = tndMix[3 * tri + 2 * noise + dmc];
+  if (v == _tndOut) return;
+  if (fast) _blip.addDeltaFast(t, v - _tndOut);
+  else      _blip.addDelta(t, v - _tndOut);
+  _tndOut = v;
+}
+
+void NES::_apuMix(uint32_t t) {
+  _mixPulses(t);
+  _mixTnd(t, false);
+}
+
+void NES::_apuEndFrame() {
+  _blip.endFrame(_apuClock);
+  _apuClock = 0;
+  _audioLen = _blip.readSamples(_audioBuf, AUDIO_MAX);
+}
+
+
+// =========================================================
+//  CATCH-UP
+// =========================================================
+// Runs the channel timers for n CPU cycles from _apuClock. A
+// timer due at `t` (1..n) expires at cycle _apuClock + t.
+void NES::_apuAdvance(int n) {
+  const uint32_t t0 = _apuClock;
+
+  for (int ch = 0; ch < 2; ++ch) {
+    NesPulse& p = _pulse[ch];
+    int32_t period = (p.period + 1) * 2;
+    if (!(_chMask & (1 << ch)) || !p.length || pulseMuted(p, ch)) {
+      p.step = (p.step + runTimer(p.timer, n, period)) & 7;
+      continue;
+    }
+    int32_t t = p.timer;
+    for (; t <= n; t += period) {
+      p.step = (p.step + 1) & 7;
+      _mixPulses(t0 + t);
+    }
+    p.timer = t - n;
+  }
+
+  // Ultrasonic periods are frozen rather than aliased
+  if (triRunning(_tri)) {
+    int32_t t = _tri.timer;
+    for (; t <= n; t += _tri.period + 1) {
+      _tri.step = (_tri.step + 1) & 31;
+      if (_chMask & 0x04) _mixTnd(t0 + t, false);
+    }
+    _tri.timer = t - n;
+  } else {
+    runTimer(_tri.timer, n, _tri.period + 1);
+  }
+
+  bool noisy = (_chMask & 0x08) && _noise.length && envVolume(_noise.env);
+  int32_t t = _noise.timer;
+  for (; t <= n; t += _noise.period) {
+    uint16_t s = _noise.shift;
+    uint16_t fb = (s ^ (s >> (_noise.mode ? 6 : 1))) & 1;
+    _noise.shift = (s >> 1) | (fb << 14);
+    if (noisy) _mixTnd(t0 + t, true);
+  }
+  _noise.timer = t - n;
+
+  t = _dmc.timer;
+  for (; t <= n; t += _dmc.rate) {
+    if (!_dmc.silent) {
+      uint8_t was = _dmc.level;
+      if (_dmc.shift & 1) { if (_dmc.level <= 125) _dmc.level += 2; }
+      else                { if (_dmc.level >= 2)   _dmc.level -= 2; }
+      _dmc.shift >>= 1;
+      if (_dmc.level != was && (_chMask & 0x10)) _mixTnd(t0 + t, false);
+    }
+    if (--_dmc.bits == 0) {
+      _dmc.bits = 8;
+      _dmc.silent = _dmc.buffer < 0;
+      if (!_dmc.silent) { _dmc.shift = (uint8_t)_dmc.buffer; _dmc.buffer = -1; }
+    }
+    // Refill the sample buffer from PRG
+    if (_dmc.buffer < 0 && _dmc.left) {
+      _dmc.buffer = _read(_dmc.cur);
+      _dmc.cur = (_dmc.cur == 0xFFFF) ? 0x8000 : _dmc.cur + 1;
+      if (--_dmc.left == 0) {
+        if (_dmc.loop)        { _dmc.cur = _dmc.addr; _dmc.left = _dmc.len; }
+        else if (_dmc.irqOn)  { _dmc.irq = true; _apuIrq(); }
+      }
+    }
+  }
+  _dmc.timer = t - n;
+}
+
+void NES::_apuRun(int cycles) {
+  const int32_t* seq = _frameMode5 ? SEQ5 : SEQ4;
+
+  while (cycles > 0) {
+    int i = 0;
+    while (i < 3 && _frameSeq >= seq[i]) ++i;
+    int n = cycles;
+    if (n > seq[i] - _frameSeq) n = seq[i] - _frameSeq;
+
+    _apuAdvance(n);
+    _apuClock += n;
+    cycles -= n;
+
+    _frameSeq += n;
+    if (_frameSeq == seq[i]) {
+      _apuQuarter();
+      if (i & 1) _apuHalf();
+      if (i == 3) {
+        if (!_frameMode5 && !_frameIrqOff) { _frameIrq = true; _apuIrq(); }
+        _frameSeq = 0;
+      }
+      _apuMix(_apuClock);  // envelopes, lengths, sweeps
+    }
+  }
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,477 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  nes_cpu.cpp — Table-Driven 6502 (Ricoh 2A03)
+//
+//  Provides:
+//   • Opcode table: handler + addressing mode + base cycles
+//   • Official opcodes plus the stable unofficial ones
+//     (LAX, SAX, DCP, ISB, SLO, RLA, SRE, RRA, NOPs)
+//   • Cached interpreter: basic blocks translated once into
+//     NesCachedOp runs (handler + pre-extracted operand)
+//
+//  Notes:
+//   - Decimal mode does not exist on the 2A03; D is just a flag.
+//   - Reads marked with a page-cross penalty add one cycle.
+//   - Dummy reads are not emulated.
+//   - Cached blocks end at anything that changes control flow
+//     or the I flag, so interrupts are taken at the same
+//     instruction boundaries as in the plain interpreter.
+// =========================================================
+
+#include "nes.h"
+
+// =========================================================
+//  FLAGS + ADDRESSING MODES
+// =========================================================
+enum : uint8_t {
+  FLAG_C = 0x01, FLAG_Z = 0x02, FLAG_I = 0x04, FLAG_D = 0x08,
+  FLAG_B = 0x10, FLAG_U = 0x20, FLAG_V = 0x40, FLAG_N = 0x80,
+};
+
+enum AddrMode : uint8_t { IMP, ACC, IMM, ZP, ZPX, ZPY, ABS, ABX, ABY, IND, IZX, IZY, REL };
+
+
+// =========================================================
+//  INSTRUCTION HANDLERS
+// =========================================================
+// Each handler receives the resolved effective address.
+// IMM passes the operand address, REL the branch target.
+struct NesOps {
+  static inline void zn(NES& n, uint8_t v) {
+    n._p = (n._p & ~(FLAG_Z | FLAG_N)) | (v ? 0 : FLAG_Z) | (v & FLAG_N);
+  }
+  static inline void setC(NES& n, bool c) { n._p = c ? (n._p | FLAG_C) : (n._p & ~FLAG_C); }
+
+  static inline void adc(NES& n, uint8_t m) {
+    uint16_t sum = n._a + m + (n._p & FLAG_C);
+    uint8_t  r   = (uint8_t)sum;
+    n._p = (n._p & ~(FLAG_C | FLAG_V))
+         | (sum > 0xFF ? FLAG_C : 0)
+         | ((~(n._a ^ m) & (n._a ^ r) & 0x80) ? FLAG_V : 0);
+    n._a = r;
+    zn(n, r);
+  }
+  static inline void cmp(NES& n, uint8_t reg, uint8_t m) {
+    setC(n, reg >= m);
+    zn(n, (uint8_t)(reg - m));
+  }
+  static inline void branch(NES& n, bool take, uint16_t target) {
+    if (!take) return;
+    n._extra += ((n._pc ^ target) & 0xFF00) ? 2 : 1;
+    n._pc = target;
+  }
+
+  // --- RMW cores (shared with the unofficial combos) ---
+  static inline uint8_t asl(NES& n, uint8_t v) { setC(n, v & 0x80); v <<= 1; zn(n, v); return v; }
+  static inline uint8_t lsr(NES& n, uint8_t v) { setC(n, v & 0x01); v >>= 1; zn(n, v); return v; }
+  static inline uint8_t rol(NES& n, uint8_t v) {
+    uint8_t c = n._p & FLAG_C; setC(n, v & 0x80); v = (v << 1) | c; zn(n, v); return v;
+  }
+  static inline uint8_t ror(NES& n, uint8_t v) {
+    uint8_t c = n._p & FLAG_C; setC(n, v & 0x01); v = (v >> 1) | (c << 7); zn(n, v); return v;
+  }
+
+  // --- Loads / stores ---
+  static void LDA(NES& n, uint16_t ea) { n._a = n._read(ea); zn(n, n._a); }
+  static void LDX(NES& n, uint16_t ea) { n._x = n._read(ea); zn(n, n._x); }
+  static void LDY(NES& n, uint16_t ea) { n._y = n._read(ea); zn(n, n._y); }
+  static void STA(NES& n, uint16_t ea) { n._write(ea, n._a); }
+  static void STX(NES& n, uint16_t ea) { n._write(ea, n._x); }
+  static void STY(NES& n, uint16_t ea) { n._write(ea, n._y); }
+
+  // --- Transfers ---
+  static void TAX(NES& n, uint16_t) { n._x = n._a; zn(n, n._x); }
+  static void TAY(NES& n, uint16_t) { n._y = n._a; zn(n, n._y); }
+  static void TXA(NES& n, uint16_t) { n._a = n._x; zn(n, n._a); }
+  static void TYA(NES& n, uint16_t) { n._a = n._y; zn(n, n._a); }
+  static void TSX(NES& n, uint16_t) { n._x = n._s; zn(n, n._x); }
+  static void TXS(NES& n, uint16_t) { n._s = n._x; }
+
+  // --- Stack ---
+  static void PHA(NES& n, uint16_t) { n._push(n._a); }
+  static void PHP(NES& n, uint16_t) { n._push(n._p | FLAG_B | FLAG_U); }
+  static void PLA(NES& n, uint16_t) { n._a = n._pop(); zn(n, n._a); }
+  static void PLP(NES& n, uint16_t) { n._p = (n._pop() & ~FLAG_B) | FLAG_U; }
+
+  // --- Logic / arithmetic ---
+  static void AND(NES& n, uint16_t ea) { n._a &= n._read(ea); zn(n, n._a); }
+  static void ORA(NES& n, uint16_t ea) { n._a |= n._read(ea); zn(n, n._a); }
+  static void EOR(NES& n, uint16_t ea) { n._a ^= n._read(ea); zn(n, n._a); }
+  static void ADC(NES& n, uint16_t ea) { adc(n, n._read(ea)); }
+  static void SBC(NES& n, uint16_t ea) { adc(n, ~n._read(ea)); }
+  static void CMP(NES& n, uint16_t ea) { cmp(n, n._a, n._read(ea)); }
+  static void CPX(NES& n, uint16_t ea) { cmp(n, n._x, n._read(ea)); }
+  static void CPY(NES& n, uint16_t ea) { cmp(n, n._y, n._read(ea)); }
+  static void BIT(NES& n, uint16_t ea) {
+    uint8_t m = n._read(ea);
+    n._p = (n._p & ~(FLAG_Z | FLAG_V | FLAG_N)) | (m & (FLAG_V | FLAG_N)) | ((n._a & m) ? 0 : FLAG_Z);
+  }
+
+  // --- Increments ---
+  static void INC(NES& n, uint16_t ea) { uint8_t v = n._read(ea) + 1; n._write(ea, v); zn(n, v); }
+  static void DEC(NES& n, uint16_t ea) { uint8_t v = n._read(ea) - 1; n._write(ea, v); zn(n, v); }
+  static void INX(NES& n, uint16_t) { zn(n, ++n._x); }
+  static void INY(NES& n, uint16_t) { zn(n, ++n._y); }
+  static void DEX(NES& n, uint16_t) { zn(n, --n._x); }
+  static void DEY(NES& n, uint16_t) { zn(n, --n._y); }
+
+  // --- Shifts (memory + accumulator) ---
+  static void ASL(NES& n, uint16_t ea) { n._write(ea, asl(n, n._read(ea))); }
+  static void LSR(NES& n, uint16_t ea) { n._write(ea, lsr(n, n._read(ea))); }
+  static void ROL(NES& n, uint16_t ea) { n._write(ea, rol(n, n._read(ea))); }
+  static void ROR(NES& n, uint16_t ea) { n._write(ea, ror(n, n._read(ea))); }
+  static void ASLA(NES& n, uint16_t) { n._a = asl(n, n._a); }
+  static void LSRA(NES& n, uint16_t) { n._a = lsr(n, n._a); }
+  static void ROLA(NES& n, uint16_t) { n._a = rol(n, n._a); }
+  static void RORA(NES& n, uint16_t) { n._a = ror(n, n._a); }
+
+  // --- Jumps / calls ---
+  static void JMP(NES& n, uint16_t ea) { n._pc = ea; }
+  static void JSR(NES& n, uint16_t ea) {
+    uint16_t ret = n._pc - 1;
+    n._push(ret >> 8); n._push(ret & 0xFF);
+    n._pc = ea;
+  }
+  static void RTS(NES& n, uint16_t) {
+    uint16_t lo = n._pop(); uint16_t hi = n._pop();
+    n._pc = ((hi << 8) | lo) + 1;
+  }
+  static void RTI(NES& n, uint16_t) {
+    n._p = (n._pop() & ~FLAG_B) | FLAG_U;
+    uint16_t lo = n._pop(); uint16_t hi = n._pop();
+    n._pc = (hi << 8) | lo;
+  }
+  static void BRK(NES& n, uint16_t) { n._pc++; n._interrupt(0xFFFE, true); }
+
+  // --- Branches ---
+  static void BPL(NES& n, uint16_t ea) { branch(n, !(n._p & FLAG_N), ea); }
+  static void BMI(NES& n, uint16_t ea) { branch(n,  (n._p & FLAG_N), ea); }
+  static void BVC(NES& n, uint16_t ea) { branch(n, !(n._p & FLAG_V), ea); }
+  static void BVS(NES& n, uint16_t ea) { branch(n,  (n._p & FLAG_V), ea); }
+  static void BCC(NES& n, uint16_t ea) { branch(n, !(n._p & FLAG_C), ea); }
+  static void BCS(NES& n, uint16_t ea) { branch(n,  (n._p & FLAG_C), ea); }
+  static void BNE(NES& n, uint16_t ea) { branch(n, !(n._p & FLAG_Z), ea); }
+  static void BEQ(NES& n, uint16_t ea) { branch(n,  (n._p & FLAG_Z), ea); }
+
+  // --- Flags ---
+  static void CLC(NES& n, uint16_t) { n._p &= ~FLAG_C; }
+  static void SEC(NES& n, uint16_t) { n._p |=  FLAG_C; }
+  static void CLI(NES& n, uint16_t) { n._p &= ~FLAG_I; }
+  static void SEI(NES& n, uint16_t) { n._p |=  FLAG_I; }
+  static void CLV(NES& n, uint16_t) { n._p &= ~FLAG_V; }
+  static void CLD(NES& n, uint16_t) { n._p &= ~FLAG_D; }
+  static void SED(NES& n, uint16_t) { n._p |=  FLAG_D; }
+
+  static void NOP(NES&, uint16_t) {}
+  static void NOPR(NES& n, uint16_t ea) { (void)n._read(ea); }  // NOP with operand read
+
+  // --- Unofficial (stable) ---
+  static void LAX(NES& n, uint16_t ea) { n._a = n._x = n._read(ea); zn(n, n._a); }
+  static void SAX(NES& n, uint16_t ea) { n._write(ea, n._a & n._x); }
+  static void DCP(NES& n, uint16_t ea) { uint8_t v = n._read(ea) - 1; n._write(ea, v); cmp(n, n._a, v); }
+  static void ISB(NES& n, uint16_t ea) { uint8_t v = n._read(ea) + 1; n._write(ea, v); adc(n, ~v); }
+  static void SLO(NES& n, uint16_t ea) { uint8_t v = asl(n, n._read(ea)); n._write(ea, v); n._a |= v; zn(n, n._a); }
+  static void RLA(NES& n, uint16_t ea) { uint8_t v = rol(n, n._read(ea)); n._write(ea, v); n._a &= v; zn(n, n._a); }
+  static void SRE(NES& n, uint16_t ea) { uint8_t v = lsr(n, n._read(ea)); n._write(ea, v); n._a ^= v; zn(n, n._a); }
+  static void RRA(NES& n, uint16_t ea) { uint8_t v = ror(n, n._read(ea)); n._write(ea, v); adc(n, v); }
+  static void ANC(NES& n, uint16_t ea) { n._a &= n._read(ea); zn(n, n._a); setC(n, n._a & 0x80); }
+  static void ALR(NES& n, uint16_t ea) { n._a = lsr(n, n._a & n._read(ea)); }
+  static void AXS(NES& n, uint16_t ea) {
+    uint8_t m = n._read(ea), ax = n._a & n._x;
+    setC(n, ax >= m); n._x = ax - m; zn(n, n._x);
+  }
+  static void JAM(NES& n, uint16_t) { n._pc--; }  // lock up on the same opcode
+
+  // --- Threaded form (cached interpreter) ---
+  // One copy per opcode with the addressing mode baked in, so
+  // the handler inlines and dispatch is a single call.
+  template <void (*F)(NES&, uint16_t), uint8_t M, uint8_t PEN>
+  static int threaded(NES& n, const NesCachedOp& op) {
+    uint16_t ea = op.operand;
+    n._pc = op.next;
+    n._extra = 0;
+    if (M == ZPX) ea = (uint8_t)(ea + n._x);
+    if (M == ZPY) ea = (uint8_t)(ea + n._y);
+    if (M == ABX || M == ABY) {
+      uint16_t base = ea;
+      ea = base + (M == ABX ? n._x : n._y);
+      if (PEN && ((base ^ ea) & 0xFF00)) n._extra = 1;
+    }
+    if (M == IND) ea = n._read(ea) | (n._read((ea & 0xFF00) | ((ea + 1) & 0xFF)) << 8);
+    if (M == IZX) {
+      uint8_t zp = ea + n._x;
+      ea = n._ram[zp] | (n._ram[(uint8_t)(zp + 1)] << 8);
+    }
+    if (M == IZY) {
+      uint16_t base = n._ram[ea] | (n._ram[(uint8_t)(ea + 1)] << 8);
+      ea = base + n._y;
+      if (PEN && ((base ^ ea) & 0xFF00)) n._extra = 1;
+    }
+    F(n, ea);
+    return op.cycles + n._extra;
+  }
+};
+
+
+// =========================================================
+//  OPCODE TABLE
+// =========================================================
+// { handler, addressing mode, base cycles, page-cross penalty,
+//   threaded handler }
+struct NesOp {
+  void    (*fn)(NES&, uint16_t);
+  uint8_t mode;
+  uint8_t cycles;
+  uint8_t penalty;
+  int     (*threaded)(NES&, const NesCachedOp&);
+};
+
+#define O(f, m, c)  { &NesOps::f, m, c, 0, &NesOps::threaded<&NesOps::f, m, 0> }
+#define OP(f, m, c) { &NesOps::f, m, c, 1, &NesOps::threaded<&NesOps::f, m, 1> }   // +1 on page cross
+
+static const NesOp OPS[256] = {
+  // 0x00
+  O(BRK,IMP,7),  O(ORA,IZX,6),  O(JAM,IMP,2),  O(SLO,IZX,8),  O(NOPR,ZP,3),  O(ORA,ZP,3),   O(ASL,ZP,5),   O(SLO,ZP,5),
+  O(PHP,IMP,3),  O(ORA,IMM,2),  O(ASLA,ACC,2), O(ANC,IMM,2),  O(NOPR,ABS,4), O(ORA,ABS,4),  O(ASL,ABS,6),  O(SLO,ABS,6),
+  // 0x10
+  O(BPL,REL,2),  OP(ORA,IZY,5), O(JAM,IMP,2),  O(SLO,IZY,8),  O(NOPR,ZPX,4), O(ORA,ZPX,4),  O(ASL,ZPX,6),  O(SLO,ZPX,6),
+  O(CLC,IMP,2),  OP(ORA,ABY,4), O(NOP,IMP,2),  O(SLO,ABY,7),  OP(NOPR,ABX,4),OP(ORA,ABX,4), O(ASL,ABX,7),  O(SLO,ABX,7),
+  // 0x20
+  O(JSR,ABS,6),  O(AND,IZX,6),  O(JAM,IMP,2),  O(RLA,IZX,8),  O(BIT,ZP,3),   O(AND,ZP,3),   O(ROL,ZP,5),   O(RLA,ZP,5),
+  O(PLP,IMP,4),  O(AND,IMM,2),  O(ROLA,ACC,2), O(ANC,IMM,2),  O(BIT,ABS,4),  O(AND,ABS,4),  O(ROL,ABS,6),  O(RLA,ABS,6),
+  // 0x30
+  O(BMI,REL,2),  OP(AND,IZY,5), O(JAM,IMP,2),  O(RLA,IZY,8),  O(NOPR,ZPX,4), O(AND,ZPX,4),  O(ROL,ZPX,6),  O(RLA,ZPX,6),
+  O(SEC,IMP,2),  OP(AND,ABY,4), O(NOP,IMP,2),  O(RLA,ABY,7),  OP(NOPR,ABX,4),OP(AND,ABX,4), O(ROL,ABX,7),  O(RLA,ABX,7),
+  // 0x40
+  O(RTI,IMP,6),  O(EOR,IZX,6),  O(JAM,IMP,2),  O(SRE,IZX,8),  O(NOPR,ZP,3),  O(EOR,ZP,3),   O(LSR,ZP,5),   O(SRE,ZP,5),
+  O(PHA,IMP,3),  O(EOR,IMM,2),  O(LSRA,ACC,2), O(ALR,IMM,2),  O(JMP,ABS,3),  O(EOR,ABS,4),  O(LSR,ABS,6),  O(SRE,ABS,6),
+  // 0x50
+  O(BVC,REL,2),  OP(EOR,IZY,5), O(JAM,IMP,2),  O(SRE,IZY,8),  O(NOPR,ZPX,4), O(EOR,ZPX,4),  O(LSR,ZPX,6),  O(SRE,ZPX,6),
+  O(CLI,IMP,2),  OP(EOR,ABY,4), O(NOP,IMP,2),  O(SRE,ABY,7),  OP(NOPR,ABX,4),OP(EOR,ABX,4), O(LSR,ABX,7),  O(SRE,ABX,7),
+  // 0x60
+  O(RTS,IMP,6),  O(ADC,IZX,6),  O(JAM,IMP,2),  O(RRA,IZX,8),  O(NOPR,ZP,3),  O(ADC,ZP,3),   O(ROR,ZP,5),   O(RRA,ZP,5),
+  O(PLA,IMP,4),  O(ADC,IMM,2),  O(RORA,ACC,2), O(NOPR,IMM,2), O(JMP,IND,5),  O(ADC,ABS,4),  O(ROR,ABS,6),  O(RRA,ABS,6),
+  // 0x70
+  O(BVS,REL,2),  OP(ADC,IZY,5), O(JAM,IMP,2),  O(RRA,IZY,8),  O(NOPR,ZPX,4), O(ADC,ZPX,4),  O(ROR,ZPX,6),  O(RRA,ZPX,6),
+  O(SEI,IMP,2),  OP(ADC,ABY,4), O(NOP,IMP,2),  O(RRA,ABY,7),  OP(NOPR,ABX,4),OP(ADC,ABX,4), O(ROR,ABX,7),  O(RRA,ABX,7),
+  // 0x80
+  O(NOPR,IMM,2), O(STA,IZX,6),  O(NOPR,IMM,2), O(SAX,IZX,6),  O(STY,ZP,3),   O(STA,ZP,3),   O(STX,ZP,3),   O(SAX,ZP,3),
+  O(DEY,IMP,2),  O(NOPR,IMM,2), O(TXA,IMP,2),  O(NOPR,IMM,2), O(STY,ABS,4),  O(STA,ABS,4),  O(STX,ABS,4),  O(SAX,ABS,4),
+  // 0x90
+  O(BCC,REL,2),  O(STA,IZY,6),  O(JAM,IMP,2),  O(NOP,IZY,6),  O(STY,ZPX,4),  O(STA,ZPX,4),  O(STX,ZPY,4),  O(SAX,ZPY,4),
+  O(TYA,IMP,2),  O(STA,ABY,5),  O(TXS,IMP,2),  O(NOP,ABY,5),  O(NOP,ABX,5),  O(STA,ABX,5),  O(NOP,ABY,5),  O(NOP,ABY,5),
+  // 0xA0
+  O(LDY,IMM,2),  O(LDA,IZX,6),  O(LDX,IMM,2),  O(LAX,IZX,6),  O(LDY,ZP,3),   O(LDA,ZP,3),   O(LDX,ZP,3),   O(LAX,ZP,3),
+  O(TAY,IMP,2),  O(LDA,IMM,2),  O(TAX,IMP,2),  O(LAX,IMM,2),  O(LDY,ABS,4),  O(LDA,ABS,4),  O(LDX,ABS,4),  O(LAX,ABS,4),
+  // 0xB0
+  O(BCS,REL,2),  OP(LDA,IZY,5), O(JAM,IMP,2),  OP(LAX,IZY,5), O(LDY,ZPX,4),  O(LDA,ZPX,4),  O(LDX,ZPY,4),  O(LAX,ZPY,4),
+  O(CLV,IMP,2),  OP(LDA,ABY,4), O(TSX,IMP,2),  OP(NOPR,ABY,4),OP(LDY,ABX,4), OP(LDA,ABX,4), OP(LDX,ABY,4), OP(LAX,ABY,4),
+  // 0xC0
+  O(CPY,IMM,2),  O(CMP,IZX,6),  O(NOPR,IMM,2), O(DCP,IZX,8),  O(CPY,ZP,3),   O(CMP,ZP,3),   O(DEC,ZP,5),   O(DCP,ZP,5),
+  O(INY,IMP,2),  O(CMP,IMM,2),  O(DEX,IMP,2),  O(AXS,IMM,2),  O(CPY,ABS,4),  O(CMP,ABS,4),  O(DEC,ABS,6),  O(DCP,ABS,6),
+  // 0xD0
+  O(BNE,REL,2),  OP(CMP,IZY,5), O(JAM,IMP,2),  O(DCP,IZY,8),  O(NOPR,ZPX,4), O(CMP,ZPX,4),  O(DEC,ZPX,6),  O(DCP,ZPX,6),
+  O(CLD,IMP,2),  OP(CMP,ABY,4), O(NOP,IMP,2),  O(DCP,ABY,7),  OP(NOPR,ABX,4),OP(CMP,ABX,4), O(DEC,ABX,7),  O(DCP,ABX,7),
+  // 0xE0
+  O(CPX,IMM,2),  O(SBC,IZX,6),  O(NOPR,IMM,2), O(ISB,IZX,8),  O(CPX,ZP,3),   O(SBC,ZP,3),   O(INC,ZP,5),   O(ISB,ZP,5),
+  O(INX,IMP,2),  O(SBC,IMM,2),  O(NOP,IMP,2),  O(SBC,IMM,2),  O(CPX,ABS,4),  O(SBC,ABS,4),  O(INC,ABS,6),  O(ISB,ABS,6),
+  // 0xF0
+  O(BEQ,REL,2),  OP(SBC,IZY,5), O(JAM,IMP,2),  O(ISB,IZY,8),  O(NOPR,ZPX,4), O(SBC,ZPX,4),  O(INC,ZPX,6),  O(ISB,ZPX,6),
+  O(SED,IMP,2),  OP(SBC,ABY,4), O(NOP,IMP,2),  O(ISB,ABY,7),  OP(NOPR,ABX,4),OP(SBC,ABX,4), O(INC,ABX,7),  O(ISB,ABX,7),
+};
+
+#undef O
+#undef OP
+
+
+// =========================================================
+//  EXECUTION
+// =========================================================
+void NES::_interrupt(uint16_t vector, bool brk) {
+  _push(_pc >> 8);
+  _push(_pc & 0xFF);
+  _push((_p & ~FLAG_B) | FLAG_U | (brk ? FLAG_B : 0));
+  _p |= FLAG_I;
+  _pc = _read(vector) | (_read(vector + 1) << 8);
+}
+
+// Executes one instruction (or services an interrupt) and
+// returns the CPU cycles it took.
+int NES::_step() {
+  if (_nmiPending) {
+    _nmiPending = false;
+    _interrupt(0xFFFA, false);
+    return 7;
+  }
+  if (_irqLines && !(_p & FLAG_I)) {
+    _interrupt(0xFFFE, false);
+    return 7;
+  }
+
+  const NesOp& op = OPS[_read(_pc++)];
+  uint16_t ea = 0;
+  _extra = 0;
+
+  switch (op.mode) {
+    case IMP: case ACC: break;
+    case IMM: ea = _pc++; break;
+    case ZP:  ea = _read(_pc++); break;
+    case ZPX: ea = (uint8_t)(_read(_pc++) + _x); break;
+    case ZPY: ea = (uint8_t)(_read(_pc++) + _y); break;
+    case ABS:
+      ea = _read(_pc) | (_read(_pc + 1) << 8);
+      _pc += 2;
+      break;
+    case ABX: case ABY: {
+      uint16_t base = _read(_pc) | (_read(_pc + 1) << 8);
+      _pc += 2;
+      ea = base + (op.mode == ABX ? _x : _y);
+      if (op.penalty && ((base ^ ea) & 0xFF00)) _extra = 1;
+      break;
+    }
+    case IND: {
+      uint16_t ptr = _read(_pc) | (_read(_pc + 1) << 8);
+      _pc += 2;
+      // 6502 bug: the high byte wraps within the page
+      ea = _read(ptr) | (_read((ptr & 0xFF00) | ((ptr + 1) & 0xFF)) << 8);
+      break;
+    }
+    case IZX: {
+      uint8_t zp = _read(_pc++) + _x;
+      ea = _ram[zp] | (_ram[(uint8_t)(zp + 1)] << 8);
+      break;
+    }
+    case IZY: {
+      uint8_t zp = _read(_pc++);
+      uint16_t base = _ram[zp] | (_ram[(uint8_t)(zp + 1)] << 8);
+      ea = base + _y;
+      if (op.penalty && ((base ^ ea) & 0xFF00)) _extra = 1;
+      break;
+    }
+    case REL: {
+      int8_t off = (int8_t)_read(_pc++);
+      ea = _pc + off;
+      break;
+    }
+  }
+
+  op.fn(*this, ea);
+  return op.cycles + _extra;
+}
+
+// Runs the CPU until this scanline's dot budget is spent.
+// Leftover (negative) budget carries into the next line.
+void NES::_runCpu() {
+  _dots += 341;
+  if (!_cache.enabled()) {
+    while (_dots > 0) _dots -= _step() * 3;
+    return;
+  }
+
+  while (_dots > 0) {
+    // Interrupts and uncacheable code go through the interpreter
+    if (_nmiPending || (_irqLines && !(_p & FLAG_I))) { _dots -= _step() * 3; continue; }
+    const NesBlockCache::Block* b = _translate(_pc);
+    if (b) _runBlock(b);
+    else   _dots -= _step() * 3;
+  }
+}
+
+
+// =========================================================
+//  CACHED INTERPRETER
+// =========================================================
+static const uint8_t MODE_LEN[13] = {
+  1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 2, 2, 2   // IMP ACC IMM ZP ZPX ZPY ABS ABX ABY IND IZX IZY REL
+};
+
+// Control flow, I-flag changes and JAM close a block.
+static bool endsBlock(uint8_t opc) {
+  switch (opc) {
+    case 0x00: case 0x20: case 0x40: case 0x60:  // BRK JSR RTI RTS
+    case 0x4C: case 0x6C:                        // JMP
+    case 0x28: case 0x58: case 0x78:             // PLP CLI SEI
+      return true;
+  }
+  return OPS[opc].mode == REL || OPS[opc].fn == &NesOps::JAM;
+}
+
+// Finds or builds the block starting at `pc`. Returns nullptr
+// for code the cache doesn't handle (I/O space, page-straddling
+// first instruction, pages that keep rewriting themselves);
+// the caller falls back to _step().
+NesBlockCache::Block* NES::_translate(uint16_t pc) {
+  const uint8_t* key;
+  int   limit;  // last guest address the block may touch
+  int16_t page;
+  if (pc < 0x2000) {
+    key = _ram + (pc & 0x7FF);
+    limit = pc | 0xFF;
+    page = (pc & 0x7FF) >> 8;
+  } else if (pc >= 0x8000) {
+    key = _prgBank[(pc >> 13) & 3] + (pc & 0x1FFF);
+    limit = pc | 0x1FFF;
+    page = -1;
+  } else if (pc >= 0x6000) {
+    key = _prgRam + (pc & 0x1FFF);
+    limit = pc | 0xFF;
+    page = 8 + ((pc & 0x1FFF) >> 8);
+  } else {
+    return nullptr;
+  }
+
+  NesBlockCache::Block* b = _cache.find(key, pc);
+  if (b) return b;
+  if (_cache.pageIsHot(page)) return nullptr;
+  b = _cache.alloc();
+  if (!b) return nullptr;
+
+  uint16_t n = 0;
+  int at = pc;
+  while (n < 32) {
+    uint8_t opc = _read(at);
+    const NesOp& op = OPS[opc];
+    int len = MODE_LEN[op.mode];
+    if (at + len - 1 > limit) break;
+
+    NesCachedOp& c = b->ops[n++];
+    c.run    = op.threaded;
+    c.cycles = op.cycles;
+    c.next   = (uint16_t)(at + len);
+    switch (op.mode) {
+      case IMP: case ACC: c.operand = 0; break;
+      case IMM: c.operand = (uint16_t)(at + 1); break;
+      case REL: c.operand = (uint16_t)(c.next + (int8_t)_read(at + 1)); break;
+      case ZP: case ZPX: case ZPY: case IZX: case IZY:
+        c.operand = _read(at + 1);
+        break;
+      default:
+        c.operand = _read(at + 1) | (_read(at + 2) << 8);
+        break;
+    }
+    at += len;
+    if (endsBlock(opc)) break;
+  }
+  if (n == 0) return nullptr;
+
+  _cache.commit(b, key, pc, n, page);
+  return b;
+}
+
+// Same semantics as _step(), minus the fetch and decode.
+void NES::_runBlock(const NesBlockCache::Block* b) {
+  const uint32_t gen = _cache.generation();
+  const NesCachedOp* op  = b->ops;
+  const NesCachedOp* end = op + b->count;
+
+  while (op < end) {
+    _dots -= op->run(*this, *op) * 3;
+    ++op;
+    // Budget spent, NMI raised by a $2000 write, or the block
+    // just overwrote code: resume from _pc on the next lookup
+    if (_dots <= 0 || _nmiPending || _cache.generation() != gen) return;
+  }
+}
+
+// ======================= End of File =======================
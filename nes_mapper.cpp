@@ -0,0 +1,296 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  nes_mapper.cpp — NES Cartridge Boards
+//
+//  Provides:
+//   • NesMapper bank helpers (PRG 8 KB / CHR 1 KB slots)
+//   • NROM (0), MMC1 (1), UxROM (2), MMC3 (4)
+//   • createNesMapper() factory
+//
+//  Notes:
+//   - MMC3's IRQ counter is clocked once per rendered line
+//     instead of by PPU A12 edges; fine for nearly every game.
+//   - MMC1 ignores the consecutive-write quirk.
+// =========================================================
+
+#include "nes.h"
+
+// =========================================================
+//  BANK HELPERS
+// =========================================================
+int NesMapper::prg8Count() const { return (int)(_n._prgSize / 0x2000); }
+int NesMapper::chr1Count() const { return (int)(_n._chrSize / 0x400); }
+
+void NesMapper::mapPrg8(int slot, int bank) {
+  int n = prg8Count();
+  bank %= n; if (bank < 0) bank += n;
+  _n._prgBank[slot & 3] = _n._prg + (size_t)bank * 0x2000;
+}
+
+void NesMapper::mapPrg16(int slot, int bank) {
+  mapPrg8(slot * 2,     bank * 2);
+  mapPrg8(slot * 2 + 1, bank * 2 + 1);
+}
+
+void NesMapper::mapPrg32(int bank) {
+  for (int i = 0; i < 4; ++i) mapPrg8(i, bank * 4 + i);
+}
+
+void NesMapper::mapChr1(int slot, int bank) {
+  int n = chr1Count();
+  bank %= n; if (bank < 0) bank += n;
+  _n._chrBank[slot & 7] = _n._chr + (size_t)bank * 0x200;  // 512 rows per KB
+}
+
+void NesMapper::mapChr4(int slot, int bank) {
+  for (int i = 0; i < 4; ++i) mapChr1(slot * 4 + i, bank * 4 + i);
+}
+
+void NesMapper::mapChr8(int bank) {
+  for (int i = 0; i < 8; ++i) mapChr1(i, bank * 8 + i);
+}
+
+void NesMapper::setMirroring(uint8_t mode) { _n._setMirroring(mode); }
+bool NesMapper::fourScreen() const          { return _n._fourScreen; }
+
+void NesMapper::setIrq(bool asserted) {
+  if (asserted) _n._irqLines |= 0x01;
+  else          _n._irqLines &= ~0x01;
+}
+
+
+// =========================================================
+//  NROM (mapper 0)
+// =========================================================
+// 16 or 32 KB PRG (16 KB is mirrored), 8 KB CHR. No registers.
+class MapperNROM : public NesMapper {
+public:
+  using NesMapper::NesMapper;
+  void reset() override {
+    mapPrg16(0, 0);
+    mapPrg16(1, prg8Count() > 2 ? 1 : 0);
+    mapChr8(0);
+  }
+  void write(uint16_t, uint8_t) override {}
+};
+
+
+// =========================================================
+//  MMC1 (mapper 1)
+// =========================================================
+// Five-write serial port into control / CHR0 / CHR1 / PRG.
+class MapperMMC1 : public NesMapper {
+public:
+  using NesMapper::NesMapper;
+
+  void reset() override {
+    _shift = 0x10;
+    _control = 0x0C;  // PRG mode 3: switch $8000, fix last bank
+    _chr0 = _chr1 = _prg = 0;
+    _apply();
+  }
+
+  void write(uint16_t addr, uint8_t v) override {
+    if (v & 0x80) {
+      _shift = 0x10;
+      _control |= 0x0C;
+      _apply();
+      return;
+    }
+    bool done = _shift & 1;
+    _shift = (_shift >> 1) | ((v & 1) << 4);
+    if (!done) return;
+
+    switch ((addr >> 13) & 3) {
+      case 0: _control = _shift; break;
+      case 1: _chr0 = _shift; break;
+      case 2: _chr1 = _shift; break;
+      case 3: _prg = _shift; break;
+    }
+    _shift = 0x10;
+    _apply();
+  }
+
+  void saveState(uint8_t* out) const override {
+    out[0] = _shift; out[1] = _control; out[2] = _chr0; out[3] = _chr1; out[4] = _prg;
+  }
+  void loadState(const uint8_t* in) override {
+    _shift = in[0]; _control = in[1]; _chr0 = in[2]; _chr1 = in[3]; _prg = in[4];
+    _apply();
+  }
+
+private:
+  uint8_t _shift = 0x10, _control = 0x0C, _chr0 = 0, _chr1 = 0, _prg = 0;
+
+  void _apply() {
+    static const uint8_t MIRROR[4] = {
+      NES::MIRROR_SINGLE0, NES::MIRROR_SINGLE1, NES::MIRROR_VERTICAL, NES::MIRROR_HORIZONTAL
+    };
+    setMirroring(MIRROR[_control & 3]);
+
+    // SUROM: CHR0 bit 4 picks the 256 KB half of a 512 KB PRG
+    int outer = (prg8Count() > 32) ? (_chr0 & 0x10) : 0;
+    int bank  = outer | (_prg & 0x0F);
+    switch ((_control >> 2) & 3) {
+      case 0: case 1:
+        mapPrg16(0, bank & ~1);
+        mapPrg16(1, bank | 1);
+        break;
+      case 2:
+        mapPrg16(0, outer);
+        mapPrg16(1, bank);
+        break;
+      case 3:
+        mapPrg16(0, bank);
+        mapPrg16(1, outer | 0x0F);
+        break;
+    }
+
+    if (_control & 0x10) {
+      mapChr4(0, _chr0);
+      mapChr4(1, _chr1);
+    } else {
+      mapChr4(0, _chr0 & ~1);
+      mapChr4(1, _chr0 | 1);
+    }
+  }
+};
+
+
+// =========================================================
+//  UxROM (mapper 2)
+// =========================================================
+// Switchable 16 KB at $8000, last bank fixed at $C000, CHR RAM.
+class MapperUxROM : public NesMapper {
+public:
+  using NesMapper::NesMapper;
+  void reset() override {
+    _bank = 0;
+    mapPrg16(0, 0);
+    mapPrg16(1, -1);
+    mapChr8(0);
+  }
+  void write(uint16_t, uint8_t v) override { _bank = v; mapPrg16(0, v); }
+
+  void saveState(uint8_t* out) const override { out[0] = _bank; }
+  void loadState(const uint8_t* in) override  { _bank = in[0]; mapPrg16(0, _bank); }
+
+private:
+  uint8_t _bank = 0;
+};
+
+
+// =========================================================
+//  MMC3 (mapper 4)
+// =========================================================
+// Eight bank registers, two PRG/CHR layouts, scanline IRQ.
+class MapperMMC3 : public NesMapper {
+public:
+  using NesMapper::NesMapper;
+
+  void reset() override {
+    _select = 0;
+    const uint8_t init[8] = { 0, 2, 4, 5, 6, 7, 0, 1 };
+    for (int i = 0; i < 8; ++i) _regs[i] = init[i];
+    _irqLatch = _irqCounter = 0;
+    _irqReload = _irqEnabled = false;
+    setIrq(false);
+    _apply();
+  }
+
+  void write(uint16_t addr, uint8_t v) override {
+    bool odd = addr & 1;
+    switch (addr & 0xE000) {
+      case 0x8000:
+        if (odd) _regs[_select & 7] = v;
+        else     _select = v;
+        _apply();
+        break;
+      case 0xA000:
+        // Odd = PRG-RAM protect; RAM is always open here
+        if (!odd && !fourScreen())
+          setMirroring((v & 1) ? NES::MIRROR_HORIZONTAL : NES::MIRROR_VERTICAL);
+        break;
+      case 0xC000:
+        if (odd) { _irqCounter = 0; _irqReload = true; }
+        else     _irqLatch = v;
+        break;
+      case 0xE000:
+        _irqEnabled = odd;
+        if (!odd) setIrq(false);
+        break;
+    }
+  }
+
+  void scanline() override {
+    if (_irqCounter == 0 || _irqReload) {
+      _irqCounter = _irqLatch;
+      _irqReload = false;
+    } else {
+      _irqCounter--;
+    }
+    if (_irqCounter == 0 && _irqEnabled) setIrq(true);
+  }
+
+  void saveState(uint8_t* out) const override {
+    out[0] = _select;
+    for (int i = 0; i < 8; ++i) out[1 + i] = _regs[i];
+    out[9]  = _irqLatch;
+    out[10] = _irqCounter;
+    out[11] = (_irqReload ? 1 : 0) | (_irqEnabled ? 2 : 0);
+  }
+  void loadState(const uint8_t* in) override {
+    _select = in[0];
+    for (int i = 0; i < 8; ++i) _regs[i] = in[1 + i];
+    _irqLatch   = in[9];
+    _irqCounter = in[10];
+    _irqReload  = in[11] & 1;
+    _irqEnabled = in[11] & 2;
+    _apply();
+  }
+
+private:
+  uint8_t _select = 0;
+  uint8_t _regs[8] = {};
+  uint8_t _irqLatch = 0, _irqCounter = 0;
+  bool    _irqReload = false, _irqEnabled = false;
+
+  void _apply() {
+    int last = prg8Count() - 1;
+    if (_select & 0x40) {
+      mapPrg8(0, last - 1);
+      mapPrg8(2, _regs[6]);
+    } else {
+      mapPrg8(0, _regs[6]);
+      mapPrg8(2, last - 1);
+    }
+    mapPrg8(1, _regs[7]);
+    mapPrg8(3, last);
+
+    // CHR: two 2 KB + four 1 KB, halves swapped by bit 7
+    int lo = (_select & 0x80) ? 4 : 0;
+    int hi = lo ^ 4;
+    mapChr1(lo + 0, _regs[0] & 0xFE);
+    mapChr1(lo + 1, _regs[0] | 0x01);
+    mapChr1(lo + 2, _regs[1] & 0xFE);
+    mapChr1(lo + 3, _regs[1] | 0x01);
+    for (int i = 0; i < 4; ++i) mapChr1(hi + i, _regs[2 + i]);
+  }
+};
+
+
+// =========================================================
+//  FACTORY
+// =========================================================
+NesMapper* createNesMapper(int id, NES& n) {
+  switch (id) {
+    case 0: return new MapperNROM(n);
+    case 1: return new MapperMMC1(n);
+    case 2: return new MapperUxROM(n);
+    case 4: return new MapperMMC3(n);
+    default: return nullptr;
+  }
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,308 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  nes_ppu.cpp — Scanline-Batched 2C02 PPU
+//
+//  Provides:
+//   • PPU register file ($2000–$2007) with loopy v/t/x/w
+//   • Pattern pre-decode (planes → 2-bit interleaved rows)
+//   • Whole-scanline background + sprite rendering
+//   • Sprite 0 hit / overflow at line granularity
+//
+//  Notes:
+//   - A decoded row keeps pixel 0 in bits 15–14 and pixel 7
+//     in bits 1–0, so flipping is just reading from the other end.
+//   - Colour emphasis bits are ignored; greyscale is honoured.
+// =========================================================
+
+#include "nes.h"
+#include <string.h>
+
+// =========================================================
+//  2C02 PALETTE (0xRRGGBB)
+// =========================================================
+const uint32_t NES::PALETTE_RGB[64] = {
+  0x666666, 0x002A88, 0x1412A7, 0x3B00A4, 0x5C007E, 0x6E0040, 0x6C0600, 0x561D00,
+  0x333500, 0x0B4800, 0x005200, 0x004F08, 0x00404D, 0x000000, 0x000000, 0x000000,
+  0xADADAD, 0x155FD9, 0x4240FF, 0x7527FE, 0xA01ACC, 0xB71E7B, 0xB53120, 0x994E00,
+  0x6B6D00, 0x388700, 0x0C9300, 0x008F32, 0x007C8D, 0x000000, 0x000000, 0x000000,
+  0xFFFEFF, 0x64B0FF, 0x9290FF, 0xC676FF, 0xF36AFF, 0xFE6ECC, 0xFE8170, 0xEA9E22,
+  0xBCBE00, 0x88D800, 0x5CE430, 0x45E082, 0x48CDDE, 0x4F4F4F, 0x000000, 0x000000,
+  0xFFFEFF, 0xC0DFFF, 0xD3D2FF, 0xE8C8FF, 0xFBC2FF, 0xFEC4EA, 0xFECCC5, 0xF7D8A5,
+  0xE4E594, 0xCFEF96, 0xBDF4AB, 0xB3F3CC, 0xB5EBF2, 0xB8B8B8, 0x000000, 0x000000,
+};
+
+
+// =========================================================
+//  PATTERN PRE-DECODE
+// =========================================================
+// Spreads bit k of a plane byte to bit 2k (and back again).
+static inline uint16_t spreadBits(uint8_t b) {
+  uint16_t x = b;
+  x = (x | (x << 4)) & 0x0F0F;
+  x = (x | (x << 2)) & 0x3333;
+  x = (x | (x << 1)) & 0x5555;
+  return x;
+}
+
+static inline uint8_t gatherBits(uint16_t x) {
+  x &= 0x5555;
+  x = (x | (x >> 1)) & 0x3333;
+  x = (x | (x >> 2)) & 0x0F0F;
+  x = (x | (x >> 4)) & 0x00FF;
+  return (uint8_t)x;
+}
+
+// Index of a pattern-table address inside its 1 KB decoded bank
+static inline uint16_t rowIndex(uint16_t addr) {
+  return ((addr & 0x3F0) >> 1) | (addr & 7);
+}
+
+void NES::_decodeChr(const uint8_t* src) {
+  size_t tiles = _chrSize / 16;
+  for (size_t t = 0; t < tiles; ++t) {
+    const uint8_t* p = src + t * 16;
+    uint16_t* dst = _chr + t * 8;
+    for (int r = 0; r < 8; ++r)
+      dst[r] = spreadBits(p[r]) | (spreadBits(p[r + 8]) << 1);
+  }
+}
+
+
+// =========================================================
+//  PPU MEMORY
+// =========================================================
+void NES::_setMirroring(uint8_t mode) {
+  static const uint8_t LAYOUT[5][4] = {
+    { 0, 0, 1, 1 },  // horizontal
+    { 0, 1, 0, 1 },  // vertical
+    { 0, 0, 0, 0 },  // single-screen A
+    { 1, 1, 1, 1 },  // single-screen B
+    { 0, 1, 2, 3 },  // four-screen
+  };
+  if (mode > MIRROR_FOUR) return;
+  for (int i = 0; i < 4; ++i) _nt[i] = _vram + LAYOUT[mode][i] * 0x400;
+}
+
+uint8_t NES::_ppuRead(uint16_t addr) {
+  if (addr < 0x2000) {
+    uint16_t row = _chrBank[addr >> 10][rowIndex(addr)];
+    return gatherBits(row >> ((addr >> 3) & 1));
+  }
+  if (addr < 0x3F00) return _nt[(addr >> 10) & 3][addr & 0x3FF];
+
+  uint8_t idx = addr & 0x1F;
+  if ((idx & 0x13) == 0x10) idx &= 0x0F;
+  return _palette[idx];
+}
+
+void NES::_ppuWrite(uint16_t addr, uint8_t v) {
+  if (addr < 0x2000) {
+    if (!_chrRam) return;
+    uint16_t& row = _chrBank[addr >> 10][rowIndex(addr)];
+    if (addr & 0x08) row = (row & 0x5555) | (spreadBits(v) << 1);
+    else             row = (row & 0xAAAA) | spreadBits(v);
+    return;
+  }
+  if (addr < 0x3F00) { _nt[(addr >> 10) & 3][addr & 0x3FF] = v; return; }
+
+  uint8_t idx = addr & 0x1F;
+  if ((idx & 0x13) == 0x10) idx &= 0x0F;
+  _palette[idx] = v & 0x3F;
+}
+
+
+// =========================================================
+//  REGISTERS ($2000–$2007)
+// =========================================================
+uint8_t NES::_regRead(uint16_t reg) {
+  switch (reg) {
+    case 2: {
+      uint8_t r = (_status & 0xE0) | (_openBus & 0x1F);
+      _status &= ~0x80;
+      _w = false;
+      _openBus = r;
+      return r;
+    }
+    case 4:
+      return _oam[_oamAddr];
+    case 7: {
+      uint16_t a = _v & 0x3FFF;
+      uint8_t r;
+      if (a >= 0x3F00) {
+        r = _ppuRead(a);              // palette reads are immediate
+        _readBuf = _ppuRead(a - 0x1000);
+      } else {
+        r = _readBuf;
+        _readBuf = _ppuRead(a);
+      }
+      _v += (_ctrl & 0x04) ? 32 : 1;
+      return r;
+    }
+  }
+  return _openBus;
+}
+
+void NES::_regWrite(uint16_t reg, uint8_t v) {
+  _openBus = v;
+  switch (reg) {
+    case 0: {
+      bool nmiWasOn = _ctrl & 0x80;
+      _ctrl = v;
+      _t = (_t & ~0x0C00) | ((v & 0x03) << 10);
+      if (!nmiWasOn && (v & 0x80) && (_status & 0x80)) _nmiPending = true;
+      break;
+    }
+    case 1: _mask = v; break;
+    case 3: _oamAddr = v; break;
+    case 4: _oam[_oamAddr++] = v; break;
+    case 5:
+      if (!_w) {
+        _t = (_t & ~0x001F) | (v >> 3);
+        _fx = v & 0x07;
+      } else {
+        _t = (_t & ~0x73E0) | ((v & 0x07) << 12) | ((v & 0xF8) << 2);
+      }
+      _w = !_w;
+      break;
+    case 6:
+      if (!_w) {
+        _t = (_t & 0x00FF) | ((v & 0x3F) << 8);
+      } else {
+        _t = (_t & 0xFF00) | v;
+        _v = _t;
+      }
+      _w = !_w;
+      break;
+    case 7:
+      _ppuWrite(_v & 0x3FFF, v);
+      _v += (_ctrl & 0x04) ? 32 : 1;
+      break;
+  }
+}
+
+
+// =========================================================
+//  SCROLL HELPERS
+// =========================================================
+void NES::_incY() {
+  if ((_v & 0x7000) != 0x7000) { _v += 0x1000; return; }
+  _v &= ~0x7000;
+  int y = (_v & 0x03E0) >> 5;
+  if (y == 29)      { y = 0; _v ^= 0x0800; }
+  else if (y == 31) { y = 0; }
+  else              { y++; }
+  _v = (_v & ~0x03E0) | (y << 5);
+}
+
+
+// =========================================================
+//  SCANLINE RENDERING
+// =========================================================
+// Background: 33 tiles into _bgLine; pixel x is _bgLine[x + fx].
+// Values are (palette << 2) | pixel, 0 = transparent.
+void NES::_renderBackground() {
+  if (!(_mask & 0x08)) { memset(_bgLine, 0, sizeof(_bgLine)); return; }
+
+  uint8_t* dst    = _bgLine;
+  uint16_t v      = _v;
+  uint16_t base   = (_ctrl & 0x10) << 8;
+  uint16_t fineY  = (v >> 12) & 7;
+
+  for (int t = 0; t < 33; ++t) {
+    const uint8_t* nt = _nt[(v >> 10) & 3];
+    uint8_t  tile = nt[v & 0x3FF];
+    uint8_t  at   = nt[0x3C0 | ((v >> 4) & 0x38) | ((v >> 2) & 0x07)];
+    uint8_t  pal  = ((at >> (((v >> 4) & 4) | (v & 2))) & 3) << 2;
+    uint16_t addr = base | (tile << 4) | fineY;
+    uint16_t bits = _chrBank[addr >> 10][rowIndex(addr)];
+
+    if (!bits) {
+      memset(dst, 0, 8);
+    } else {
+      for (int p = 0; p < 8; ++p) {
+        uint8_t px = (bits >> (14 - 2 * p)) & 3;
+        dst[p] = px ? (pal | px) : 0;
+      }
+    }
+    dst += 8;
+
+    // Coarse X, wrapping into the neighbouring nametable
+    if ((v & 0x1F) == 31) { v &= ~0x1F; v ^= 0x0400; }
+    else                  { v++; }
+  }
+
+  if (!(_mask & 0x02)) memset(_bgLine + _fx, 0, 8);
+}
+
+// Sprites: first 8 in OAM order, earlier ones win. Entries are
+// (palette << 2) | pixel, 0x20 = behind background, 0x40 = sprite 0.
+void NES::_renderSprites(int line) {
+  memset(_sprLine, 0, sizeof(_sprLine));
+  if (!(_mask & 0x10)) return;
+
+  const int h = (_ctrl & 0x20) ? 16 : 8;
+  int found = 0;
+
+  for (int i = 0; i < 64; ++i) {
+    const uint8_t* s = _oam + i * 4;
+    int row = line - 1 - s[0];
+    if (row < 0 || row >= h) continue;
+    if (++found > 8) { _status |= 0x20; break; }
+
+    uint8_t tile = s[1], attr = s[2], sx = s[3];
+    if (attr & 0x80) row = h - 1 - row;
+
+    uint16_t addr;
+    if (h == 16) addr = ((tile & 1) << 12) | ((tile & 0xFE) << 4) | ((row & 8) << 1) | (row & 7);
+    else         addr = ((_ctrl & 0x08) << 9) | (tile << 4) | row;
+
+    uint16_t bits = _chrBank[addr >> 10][rowIndex(addr)];
+    if (!bits) continue;
+
+    uint8_t tag  = ((attr & 3) << 2) | (attr & 0x20) | (i == 0 ? 0x40 : 0);
+    bool    flip = attr & 0x40;
+    for (int p = 0; p < 8 && sx + p < 256; ++p) {
+      uint8_t px = flip ? (bits >> (2 * p)) & 3 : (bits >> (14 - 2 * p)) & 3;
+      if (px && !_sprLine[sx + p]) _sprLine[sx + p] = tag | px;
+    }
+  }
+
+  if (!(_mask & 0x04)) memset(_sprLine, 0, 8);
+}
+
+void NES::_renderLine(int line) {
+  // Skipped frames only compose the lines sprite 0 can hit on
+  if (_skipVideo) {
+    int row = line - 1 - _oam[0];
+    if (!_rendering() || (_status & 0x40) || row < 0 || row >= ((_ctrl & 0x20) ? 16 : 8)) return;
+  }
+
+  uint8_t* out = _outLine;
+  uint8_t  grey = (_mask & 0x01) ? 0x30 : 0x3F;
+
+  if (!_rendering()) {
+    memset(out, _palette[0] & grey, 256);
+  } else {
+    // Per-line LUT: 0–15 background, 16–31 sprites; pixel 0 = backdrop
+    uint8_t pal[32];
+    for (int i = 0; i < 32; ++i) pal[i] = _palette[(i & 3) ? i : 0] & grey;
+
+    _renderBackground();
+    _renderSprites(line);
+
+    const uint8_t* bg = _bgLine + _fx;
+    for (int x = 0; x < 256; ++x) {
+      uint8_t b = bg[x], s = _sprLine[x];
+      if (s) {
+        if ((s & 0x40) && (b & 3) && x != 255) _status |= 0x40;
+        if (!(s & 0x20) || !(b & 3)) { out[x] = pal[16 | (s & 0x0F)]; continue; }
+      }
+      out[x] = pal[b];
+    }
+  }
+
+  if (_sink && !_skipVideo) _sink(_sinkCtx, line, out);
+}
+
+// ======================= End of File =======================
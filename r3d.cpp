@@ -0,0 +1,530 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  r3d.cpp — Fixed-Point 3D for Homebrew
+//
+//  Submit (r3dTriangle / r3dMesh):
+//   - Vertices are projected straight away (x * focal / z) to
+//     Q16.16 screen coordinates; culling, Lambert shading and
+//     the depth plane are all worked out here, once per
+//     triangle, and the result goes into a flat display list.
+//   - Depth is 16-bit, near * 65535 / z: linear in screen
+//     space, so it is a plane per triangle and each pixel
+//     costs one add. Larger = closer.
+//   - Each triangle records the first and last band of rows
+//     it touches (its bins).
+//
+//  Rasterize (r3dEnd):
+//   - The screen is walked in bands of R3D_BAND rows. A band
+//     of colour indices (the strip) and, with R3D_ZBUF, its
+//     16-bit depth live in internal SRAM; the strip is loaded
+//     from the target, every triangle binned to the band is
+//     span-filled into it, and it is written back.
+//   - Spans follow the top-left rule at pixel centres, so
+//     shared edges are drawn exactly once.
+//   - Without R3D_ZBUF the list is sorted back to front
+//     (mean depth) and drawn in that order.
+//   - R3D_WIRE skips bands and draws edges straight into the
+//     target.
+//
+//  Host benchmark:
+//    g++ -O2 -DR3D_BENCH_MAIN -x c++ r3d.cpp -o r3d_bench
+// =========================================================
+
+#include "r3d.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#ifdef ARDUINO
+  #include "config.h"
+  #include "fcon.h"
+  #include "esp_heap_caps.h"
+  #define BENCH_LOG(...) DBG_IF(FCON, __VA_ARGS__)
+  static uint32_t benchUs() { return micros(); }
+  static void* fastAlloc(size_t n) {
+    void* p = heap_caps_malloc(n, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    return p ? p : ps_malloc(n);
+  }
+  static void* listAlloc(size_t n) {
+    void* p = ps_malloc(n);
+    return p ? p : malloc(n);
+  }
+#else
+  #include <stdio.h>
+  #include <chrono>
+  #define BENCH_LOG(...) printf(__VA_ARGS__)
+  static uint32_t benchUs() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+  static void* fastAlloc(size_t n) { return malloc(n); }
+  static void* listAlloc(size_t n) { return malloc(n); }
+  static constexpr uint16_t R3D_MAX_TRIS  = 2048;
+  static constexpr uint16_t R3D_MAX_VERTS = 1024;
+  static constexpr uint8_t  R3D_BAND      = 16;
+  static constexpr int16_t  R3D_MAX_W     = 320;
+#endif
+
+// =========================================================
+//  FIXED POINT
+// =========================================================
+static constexpr int   FX   = 16;
+static constexpr r3dfx HALF = R3D_ONE / 2;
+static constexpr r3dfx SCREEN_LIMIT = 4096 << FX;   // projected coords beyond this are dropped
+
+static inline r3dfx fmul(r3dfx a, r3dfx b) { return (r3dfx)(((int64_t)a * b) >> FX); }
+
+// First pixel whose centre is at or past v (top-left rule)
+static inline int firstPixel(r3dfx v) { return (v - HALF + R3D_ONE - 1) >> FX; }
+
+static uint64_t isqrt64(uint64_t v) {
+  uint64_t r = 0, bit = (uint64_t)1 << 62;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= r + bit) { v -= r + bit; r = (r >> 1) + bit; }
+    else r >>= 1;
+    bit >>= 2;
+  }
+  return r;
+}
+
+
+// =========================================================
+//  MODULE STATE
+// =========================================================
+struct Tri {
+  r3dfx    x[3], y[3];      // screen, sorted by y
+  int64_t  d0;             // depth plane at (0, 0), Q8 of the 16-bit depth
+  int32_t  ddx, ddy;        // Q8 per pixel
+  uint16_t key;             // mean depth (painter's order)
+  uint8_t  color;
+  uint8_t  band0, band1;
+};
+
+static Tri*      tris = nullptr;
+static uint16_t* order = nullptr;
+static R3dVec*   xformed = nullptr;     // r3dMesh camera-space vertices
+static uint8_t*  strip = nullptr;       // R3D_BAND rows of colour indices
+static uint16_t* zband = nullptr;       // R3D_BAND rows of depth
+// The list and vertices go to PSRAM; the strip and depth band,
+// touched once per pixel, to internal SRAM.
+static uint16_t  triCount = 0;
+
+static uint8_t*  (*targetRow)(int y) = nullptr;
+static int16_t   targetW = 0, targetH = 0;
+
+static r3dfx     focal = 240 << FX, nearZ = R3D_ONE / 4;
+static R3dVec    light = { 0, 0, -R3D_ONE };
+static uint8_t   shades = 4;
+static uint8_t   flags = 0;
+static R3dStats  stats = {}, last = {};
+
+static bool allocBuffers() {
+  if (tris) return true;
+  tris    = (Tri*)listAlloc(sizeof(Tri) * R3D_MAX_TRIS);
+  order   = (uint16_t*)listAlloc(sizeof(uint16_t) * R3D_MAX_TRIS);
+  xformed = (R3dVec*)listAlloc(sizeof(R3dVec) * R3D_MAX_VERTS);
+  strip   = (uint8_t*)fastAlloc((size_t)R3D_MAX_W * R3D_BAND);
+  zband   = (uint16_t*)fastAlloc((size_t)R3D_MAX_W * R3D_BAND * sizeof(uint16_t));
+  if (tris && order && xformed && strip && zband) return true;
+  free(tris); free(order); free(xformed); free(strip); free(zband);
+  tris = nullptr; order = nullptr; xformed = nullptr; strip = nullptr; zband = nullptr;
+  static bool warned = false;
+  if (!warned) BENCH_LOG("[R3d] Out of memory for the display list\n");
+  warned = true;
+  return false;
+}
+
+
+// =========================================================
+//  MATH
+// =========================================================
+static r3dfx* sinTable = nullptr;   // 1024 steps per turn (+1 for interpolation)
+
+r3dfx r3dSin(uint16_t a) {
+  if (!sinTable) {
+    sinTable = (r3dfx*)malloc(1025 * sizeof(r3dfx));
+    if (!sinTable) return 0;
+    for (int i = 0; i <= 1024; ++i) sinTable[i] = (r3dfx)lroundf(sinf(i * 6.2831853f / 1024) * R3D_ONE);
+  }
+  int i = a >> 6, f = a & 63;
+  return sinTable[i] + (((sinTable[i + 1] - sinTable[i]) * f) >> 6);
+}
+r3dfx r3dCos(uint16_t a) { return r3dSin((uint16_t)(a + 16384)); }
+
+void r3dIdentity(R3dMat& m) {
+  memset(&m, 0, sizeof(m));
+  m.m[0][0] = m.m[1][1] = m.m[2][2] = R3D_ONE;
+}
+
+void r3dMul(R3dMat& out, const R3dMat& a, const R3dMat& b) {
+  R3dMat r;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      int64_t s = (int64_t)a.m[i][0] * b.m[0][j] + (int64_t)a.m[i][1] * b.m[1][j] +
+                  (int64_t)a.m[i][2] * b.m[2][j];
+      r.m[i][j] = (r3dfx)(s >> FX) + (j == 3 ? a.m[i][3] : 0);
+    }
+  }
+  out = r;
+}
+
+void r3dRotate(R3dMat& m, char axis, uint16_t a) {
+  R3dMat r;
+  r3dIdentity(r);
+  r3dfx s = r3dSin(a), c = r3dCos(a);
+  int i = axis == 'x' ? 1 : 0, j = axis == 'z' ? 1 : 2;   // the plane that turns
+  r.m[i][i] = c; r.m[i][j] = -s;
+  r.m[j][i] = s; r.m[j][j] = c;
+  r3dMul(m, r, m);
+}
+
+void r3dTranslate(R3dMat& m, r3dfx x, r3dfx y, r3dfx z) {
+  m.m[0][3] += x;
+  m.m[1][3] += y;
+  m.m[2][3] += z;
+}
+
+void r3dScale(R3dMat& m, r3dfx s) {
+  for (auto& row : m.m)
+    for (auto& v : row) v = fmul(v, s);
+}
+
+R3dVec r3dApply(const R3dMat& m, const R3dVec& v) {
+  R3dVec o;
+  r3dfx* out[3] = { &o.x, &o.y, &o.z };
+  for (int i = 0; i < 3; ++i)
+    *out[i] = (r3dfx)(((int64_t)m.m[i][0] * v.x + (int64_t)m.m[i][1] * v.y +
+                       (int64_t)m.m[i][2] * v.z) >> FX) + m.m[i][3];
+  return o;
+}
+
+
+// =========================================================
+//  SETUP
+// =========================================================
+void r3dTarget(uint8_t* (*row)(int y), int16_t w, int16_t h) {
+  targetRow = row;
+  targetW = w < R3D_MAX_W ? w : R3D_MAX_W;
+  targetH = h;
+}
+
+void r3dCamera(r3dfx f, r3dfx n) {
+  focal = f;
+  nearZ = n > 0 ? n : 1;
+}
+
+void r3dLight(R3dVec d, uint8_t n) {
+  uint64_t len = isqrt64((uint64_t)((int64_t)d.x * d.x + (int64_t)d.y * d.y + (int64_t)d.z * d.z));
+  if (len) light = { (r3dfx)(((int64_t)d.x << FX) / (int64_t)len),
+                     (r3dfx)(((int64_t)d.y << FX) / (int64_t)len),
+                     (r3dfx)(((int64_t)d.z << FX) / (int64_t)len) };
+  shades = n ? n : 1;
+}
+
+void r3dBegin(uint8_t f) {
+#ifdef ARDUINO
+  if (!targetRow) r3dTarget(fconDrawRow, FCON_W, FCON_H);
+#endif
+  allocBuffers();   // on failure every triangle counts as dropped
+  flags = f;
+  triCount = 0;
+  stats = {};
+}
+
+// Flat shade from the camera-space face normal
+static uint8_t shadeLevel(const R3dVec& a, const R3dVec& b, const R3dVec& c) {
+  int64_t ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+  int64_t vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+  int64_t nx = uy * vz - uz * vy, ny = uz * vx - ux * vz, nz = ux * vy - uy * vx;
+
+  // Q32 components: shift down until the squares fit
+  int64_t big = std::max(std::max(llabs(nx), llabs(ny)), llabs(nz));
+  while (big >= ((int64_t)1 << 30)) { nx >>= 1; ny >>= 1; nz >>= 1; big >>= 1; }
+  uint64_t len = isqrt64((uint64_t)(nx * nx + ny * ny + nz * nz));
+  if (!len) return 0;
+
+  // u x v points away from the camera for a front face
+  // (left-handed camera space), so the lit side is -n
+  int64_t dot = -(nx * light.x + ny * light.y + nz * light.z) / (int64_t)len;  // Q16
+  if (dot <= 0) return 0;
+  int level = (int)((dot * shades) >> FX);
+  return (uint8_t)(level >= shades ? shades - 1 : level);
+}
+
+bool r3dTriangle(const R3dVec& a, const R3dVec& b, const R3dVec& c, uint8_t color) {
+  stats.submitted++;
+  if (!tris || triCount >= R3D_MAX_TRIS || !targetW) { stats.dropped++; return false; }
+  const R3dVec* v[3] = { &a, &b, &c };
+
+  Tri& t = tris[triCount];
+  int32_t d[3];
+  const r3dfx cx = (r3dfx)targetW << (FX - 1), cy = (r3dfx)targetH << (FX - 1);
+  for (int i = 0; i < 3; ++i) {
+    if (v[i]->z < nearZ) { stats.dropped++; return false; }
+    int64_t sx = cx + (int64_t)v[i]->x * focal / v[i]->z;
+    int64_t sy = cy - (int64_t)v[i]->y * focal / v[i]->z;
+    if (sx < -SCREEN_LIMIT || sx > SCREEN_LIMIT || sy < -SCREEN_LIMIT || sy > SCREEN_LIMIT) {
+      stats.dropped++;
+      return false;
+    }
+    t.x[i] = (r3dfx)sx;
+    t.y[i] = (r3dfx)sy;
+    d[i] = (int32_t)(((int64_t)nearZ * (65535 << 8)) / v[i]->z);  // Q8
+  }
+
+  // Screen area, y down: negative = counter-clockwise = front
+  int64_t area = (int64_t)(t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) -
+                 (int64_t)(t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+  if (area == 0 || ((flags & R3D_CULL) && area > 0)) { stats.culled++; return false; }
+
+  // Sort by y (keeping depth with its vertex)
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 2 - i; ++j)
+      if (t.y[j] > t.y[j + 1]) {
+        std::swap(t.y[j], t.y[j + 1]);
+        std::swap(t.x[j], t.x[j + 1]);
+        std::swap(d[j], d[j + 1]);
+      }
+  int y0 = firstPixel(t.y[0]), y1 = firstPixel(t.y[2]) - 1;   // rows covered
+  if (y1 < 0 || y0 >= targetH || y0 > y1) { stats.culled++; return false; }
+  y0 = y0 < 0 ? 0 : y0;
+  y1 = y1 >= targetH ? targetH - 1 : y1;
+  t.band0 = (uint8_t)(y0 / R3D_BAND);
+  t.band1 = (uint8_t)(y1 / R3D_BAND);
+
+  // Depth plane in pixels: coordinates to Q4 so the products
+  // fit; (Q8 depth * Q4) << 4 / Q8 area = Q8 per pixel
+  if (!(flags & R3D_WIRE)) {
+    int64_t x10 = (t.x[1] - t.x[0]) >> 12, y10 = (t.y[1] - t.y[0]) >> 12;
+    int64_t x20 = (t.x[2] - t.x[0]) >> 12, y20 = (t.y[2] - t.y[0]) >> 12;
+    int64_t a4 = x10 * y20 - x20 * y10;  // Q8
+    int64_t ddx = 0, ddy = 0;
+    if (a4) {
+      ddx = (((int64_t)(d[1] - d[0]) * y20 - (int64_t)(d[2] - d[0]) * y10) << 4) / a4;
+      ddy = (((int64_t)(d[2] - d[0]) * x10 - (int64_t)(d[1] - d[0]) * x20) << 4) / a4;
+    }
+    const int64_t LIM = 1 << 22;
+    t.ddx = (int32_t)std::min(std::max(ddx, -LIM), LIM);
+    t.ddy = (int32_t)std::min(std::max(ddy, -LIM), LIM);
+    t.d0  = d[0] - (((int64_t)t.ddx * t.x[0] + (int64_t)t.ddy * t.y[0]) >> FX);
+  }
+  t.key = (uint16_t)((d[0] + d[1] + d[2]) / 3 >> 8);
+
+  t.color = (flags & R3D_SHADE) ? (uint8_t)(color + shadeLevel(a, b, c)) : color;
+  triCount++;
+  return true;
+}
+
+void r3dMesh(const R3dMesh& mesh, const R3dMat& model, uint8_t color) {
+  if (!tris) return;
+  uint16_t n = mesh.vertCount < R3D_MAX_VERTS ? mesh.vertCount : R3D_MAX_VERTS;
+  for (uint16_t i = 0; i < n; ++i) xformed[i] = r3dApply(model, mesh.verts[i]);
+
+  const uint16_t* idx = mesh.tris;
+  for (uint16_t t = 0; t < mesh.triCount; ++t, idx += 3) {
+    if (idx[0] >= n || idx[1] >= n || idx[2] >= n) { stats.submitted++; stats.dropped++; continue; }
+    r3dTriangle(xformed[idx[0]], xformed[idx[1]], xformed[idx[2]],
+                mesh.colors ? mesh.colors[t] : color);
+  }
+}
+
+
+// =========================================================
+//  RASTERIZE
+// =========================================================
+// x at pixel-centre row yc along edge (x0, y0) → (x1, y1)
+static inline r3dfx edgeX(r3dfx x0, r3dfx y0, r3dfx x1, r3dfx y1, r3dfx yc) {
+  return x0 + (r3dfx)(((int64_t)(x1 - x0) * (yc - y0)) / (y1 - y0));
+}
+
+static void fillTri(const Tri& t, int rowFirst, int rowLast, bool zbuf) {
+  int y0 = std::max(firstPixel(t.y[0]), rowFirst);
+  int y1 = std::min(firstPixel(t.y[2]) - 1, rowLast);
+  const int w = targetW;
+
+  for (int y = y0; y <= y1; ++y) {
+    r3dfx yc = ((r3dfx)y << FX) + HALF;
+    r3dfx xl = edgeX(t.x[0], t.y[0], t.x[2], t.y[2], yc);
+    r3dfx xr = (yc < t.y[1]) ? edgeX(t.x[0], t.y[0], t.x[1], t.y[1], yc)
+                             : edgeX(t.x[1], t.y[1], t.x[2], t.y[2], yc);
+    if (xl > xr) std::swap(xl, xr);
+    int xs = std::max(firstPixel(xl), 0);
+    int xe = std::min(firstPixel(xr), w);
+    if (xs >= xe) continue;
+
+    uint8_t* dst = strip + (size_t)(y - rowFirst) * w;
+    if (!zbuf) { memset(dst + xs, t.color, xe - xs); continue; }
+
+    uint16_t* zr = zband + (size_t)(y - rowFirst) * w;
+    int32_t d = (int32_t)(t.d0 + (int64_t)t.ddx * xs + (((int64_t)t.ddy * yc) >> FX) + (t.ddx >> 1));
+    for (int x = xs; x < xe; ++x, d += t.ddx) {
+      int32_t z = d >> 8;
+      z = z < 1 ? 1 : (z > 0xFFFF ? 0xFFFF : z);
+      if (z > zr[x]) { zr[x] = (uint16_t)z; dst[x] = t.color; }
+    }
+  }
+}
+
+static void plot(int x, int y, uint8_t c) {
+  if ((unsigned)x >= (unsigned)targetW || (unsigned)y >= (unsigned)targetH) return;
+  if (uint8_t* r = targetRow(y)) r[x] = c;
+}
+
+static void wireLine(int x0, int y0, int x1, int y1, uint8_t c) {
+  int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+  for (;;) {
+    plot(x0, y0, c);
+    if (x0 == x1 && y0 == y1) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+void r3dEnd() {
+  uint32_t t0 = benchUs();
+  if (!tris || !targetRow) { last = stats; return; }
+
+  if (flags & R3D_WIRE) {
+    for (uint16_t i = 0; i < triCount; ++i) {
+      const Tri& t = tris[i];
+      for (int e = 0; e < 3; ++e) {
+        int f = (e + 1) % 3;
+        wireLine(t.x[e] >> FX, t.y[e] >> FX, t.x[f] >> FX, t.y[f] >> FX, t.color);
+      }
+    }
+  } else {
+    const bool zbuf = flags & R3D_ZBUF;
+    for (uint16_t i = 0; i < triCount; ++i) order[i] = i;
+    if (!zbuf)
+      std::sort(order, order + triCount, [](uint16_t a, uint16_t b) { return tris[a].key < tris[b].key; });
+
+    const int w = targetW, bands = (targetH + R3D_BAND - 1) / R3D_BAND;
+    for (int b = 0; b < bands; ++b) {
+      const int rowFirst = b * R3D_BAND;
+      const int rows = std::min((int)R3D_BAND, targetH - rowFirst);
+
+      // Load the band (anything already drawn stays behind)
+      for (int r = 0; r < rows; ++r) {
+        const uint8_t* src = targetRow(rowFirst + r);
+        if (src) memcpy(strip + (size_t)r * w, src, w);
+        else     memset(strip + (size_t)r * w, 0, w);
+      }
+      if (zbuf) memset(zband, 0, (size_t)rows * w * sizeof(uint16_t));
+
+      bool touched = false;
+      for (uint16_t i = 0; i < triCount; ++i) {
+        const Tri& t = tris[order[i]];
+        if (b < t.band0 || b > t.band1) continue;
+        fillTri(t, rowFirst, rowFirst + rows - 1, zbuf);
+        touched = true;
+      }
+      if (!touched) continue;
+
+      for (int r = 0; r < rows; ++r)
+        if (uint8_t* dst = targetRow(rowFirst + r)) memcpy(dst, strip + (size_t)r * w, w);
+    }
+  }
+
+  stats.drawn = triCount;
+  stats.us = benchUs() - t0;
+  last = stats;
+}
+
+R3dStats r3dStats() { return last; }
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+// A ring of lat-long spheres spinning in front of the camera,
+// drawn into a private 240x160 target in three modes.
+static uint8_t* benchFb = nullptr;
+static uint8_t* benchRow(int y) { return benchFb + (size_t)y * 240; }
+
+void r3dBenchmark() {
+  static constexpr int SEG = 16, RINGS = 10, BALLS = 6, FRAMES = 60;
+  static constexpr int VERTS = SEG * (RINGS + 1), TRIS = SEG * RINGS * 2;
+  R3dVec*   v   = (R3dVec*)malloc(sizeof(R3dVec) * VERTS);
+  uint16_t* idx = (uint16_t*)malloc(sizeof(uint16_t) * TRIS * 3);
+  benchFb = (uint8_t*)malloc(240 * 160);
+  if (!v || !idx || !benchFb || !allocBuffers()) {
+    BENCH_LOG("[R3d] Out of memory for the benchmark\n");
+    free(v); free(idx); free(benchFb); benchFb = nullptr;
+    return;
+  }
+
+  // Unit sphere, counter-clockwise from outside
+  for (int r = 0; r <= RINGS; ++r)
+    for (int s = 0; s < SEG; ++s) {
+      uint16_t lat = (uint16_t)(r * 32768 / RINGS - 16384), lon = (uint16_t)(s * 65536 / SEG);
+      r3dfx cl = r3dCos(lat);
+      v[r * SEG + s] = { fmul(cl, r3dCos(lon)), r3dSin(lat), fmul(cl, r3dSin(lon)) };
+    }
+  uint16_t* p = idx;
+  for (int r = 0; r < RINGS; ++r)
+    for (int s = 0; s < SEG; ++s) {
+      uint16_t a = r * SEG + s, b = r * SEG + (s + 1) % SEG, c = a + SEG, d = b + SEG;
+      *p++ = a; *p++ = b; *p++ = c;
+      *p++ = b; *p++ = d; *p++ = c;
+    }
+  const R3dMesh sphere = { v, idx, nullptr, VERTS, TRIS };
+
+  auto savedRow = targetRow;
+  int16_t savedW = targetW, savedH = targetH;
+  r3dTarget(benchRow, 240, 160);
+  r3dCamera(200 << FX, R3D_ONE / 4);
+  r3dLight({ R3D_ONE, R3D_ONE, -R3D_ONE }, 4);
+
+  static const uint8_t MODES[3] = { R3D_ZBUF | R3D_CULL | R3D_SHADE, R3D_CULL | R3D_SHADE, R3D_WIRE | R3D_CULL };
+  static const char* const NAMES[3] = { "flat+z", "flat+sort", "wire" };
+  float ktps[3] = {};
+  uint32_t drawn = 0, per = 0;
+  for (int m = 0; m < 3; ++m) {
+    uint32_t sent = 0, us = 0;
+    for (int f = 0; f < FRAMES; ++f) {
+      memset(benchFb, 0, 240 * 160);
+      uint32_t t0 = benchUs();
+      r3dBegin(MODES[m]);
+      for (int i = 0; i < BALLS; ++i) {
+        R3dMat mat;
+        r3dIdentity(mat);
+        r3dRotate(mat, 'y', (uint16_t)(f * 700 + i * 3000));
+        r3dRotate(mat, 'x', (uint16_t)(f * 300));
+        r3dTranslate(mat, (i - BALLS / 2) * (R3D_ONE * 3 / 4) + R3D_ONE / 3,
+                     ((i & 1) ? 1 : -1) * R3D_ONE / 3, 4 * R3D_ONE + i * R3D_ONE / 2);
+        r3dMesh(sphere, mat, (uint8_t)(16 + i * 4));
+      }
+      r3dEnd();
+      us += benchUs() - t0;
+      sent += r3dStats().submitted;
+      drawn = r3dStats().drawn;
+    }
+    per = sent / FRAMES;
+    ktps[m] = us ? sent * 1000.0f / us : 0.0f;   // thousand triangles per second
+  }
+
+  BENCH_LOG("[R3d] %d spheres, %lu tris/frame (%lu front-facing), k tris/s: %s %.0f, %s %.0f, %s %.0f\n",
+            BALLS, (unsigned long)per, (unsigned long)drawn,
+            NAMES[0], ktps[0], NAMES[1], ktps[1], NAMES[2], ktps[2]);
+
+  r3dTarget(savedRow, savedW, savedH);
+  free(v);
+  free(idx);
+  free(benchFb);
+  benchFb = nullptr;
+}
+
+#ifdef R3D_BENCH_MAIN
+int main() {
+  r3dBenchmark();
+  return 0;
+}
+#endif
+
+// ======================= End of File =======================
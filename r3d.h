@@ -0,0 +1,94 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  r3d.h — Fixed-Point 3D for Homebrew (Header)
+//
+//  Provides:
+//   • R3dMat / R3dVec — Q16.16 transforms (rotate, translate,
+//                       scale, multiply)
+//   • r3dBegin() / r3dTriangle() / r3dMesh() / r3dEnd()
+//                     — one frame of triangles into the fcon
+//                       draw layer (colour indices)
+//   • Wireframe or flat-filled, back-face culling, optional
+//     Lambert shading along a palette ramp
+//   • r3dBenchmark()  — triangles per second (Serial / stdout)
+//
+//  Conventions:
+//   - Camera space: camera at the origin looking down +z,
+//     x right, y up. Front faces are counter-clockwise as the
+//     camera sees them.
+//   - Triangles with a vertex closer than the near plane are
+//     dropped, not clipped.
+//   - Plain C++ apart from the default target: builds on a PC
+//     too (see r3d.cpp).
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+
+// =========================================================
+//  TYPES
+// =========================================================
+typedef int32_t r3dfx;                 // Q16.16
+static constexpr r3dfx R3D_ONE = 1 << 16;
+constexpr r3dfx r3dFx(float v) { return (r3dfx)(v * 65536.0f); }
+
+struct R3dVec { r3dfx x, y, z; };
+struct R3dMat { r3dfx m[3][4]; };     // [row][col], col 3 = translation
+
+struct R3dMesh {
+  const R3dVec*   verts;
+  const uint16_t* tris;     // 3 vertex indices per triangle
+  const uint8_t*  colors;   // one per triangle, or nullptr
+  uint16_t        vertCount;
+  uint16_t        triCount;
+};
+
+enum : uint8_t {
+  R3D_WIRE  = 0x01,  // edges only
+  R3D_ZBUF  = 0x02,  // 16-bit depth per band (else: painter's sort)
+  R3D_CULL  = 0x04,  // drop back faces
+  R3D_SHADE = 0x08,  // colour + 0 .. shades-1 by light angle
+};
+
+// =========================================================
+//  MATH
+// =========================================================
+// Angles: 65536 = one full turn
+r3dfx  r3dSin(uint16_t a);
+r3dfx  r3dCos(uint16_t a);
+
+void   r3dIdentity(R3dMat& m);
+void   r3dMul(R3dMat& out, const R3dMat& a, const R3dMat& b);  // out = a * b
+void   r3dRotate(R3dMat& m, char axis, uint16_t a);            // m = R * m
+void   r3dTranslate(R3dMat& m, r3dfx x, r3dfx y, r3dfx z);     // m = T * m
+void   r3dScale(R3dMat& m, r3dfx s);                           // m = S * m
+R3dVec r3dApply(const R3dMat& m, const R3dVec& v);
+
+// =========================================================
+//  FRAME
+// =========================================================
+// Rows of colour indices to draw into (nullptr = skip the row).
+// On the device this defaults to the fcon draw layer.
+void r3dTarget(uint8_t* (*row)(int y), int16_t w, int16_t h);
+
+void r3dCamera(r3dfx focal, r3dfx nearZ);     // focal length in pixels
+void r3dLight(R3dVec towardLight, uint8_t shades);
+
+void r3dBegin(uint8_t flags);
+bool r3dTriangle(const R3dVec& a, const R3dVec& b, const R3dVec& c, uint8_t color);
+void r3dMesh(const R3dMesh& mesh, const R3dMat& model, uint8_t color = 7);
+void r3dEnd();
+
+struct R3dStats {
+  uint32_t submitted, culled, dropped, drawn;  // dropped: near plane / too big / list full
+  uint32_t us;                                 // r3dEnd() time
+};
+R3dStats r3dStats();   // last frame
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+void r3dBenchmark();
+
+// ======================= End of File =======================
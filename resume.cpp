@@ -0,0 +1,235 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  resume.cpp — Quick-Resume
+//
+//  Remembers the last app launched and, at boot, offers to
+//  jump straight back into it instead of the home menu.
+//
+//  Boot pipeline:
+//   - resumeBegin() reads RESUME_FILE, puts up the splash and,
+//     for a game, starts emuPrepare() on a core 0 task: ROM
+//     mapping, battery save and resume state load while
+//     setup() brings up the gamepad, audio and menus.
+//   - resumeWait() joins the task before setup() goes back to
+//     SD for the settings.
+//   - The boot flow gives the splash whatever is left of
+//     RESUME_SPLASH_MS (B = home, A = now), awaiting between
+//     resumeChoice() reads so loop() keeps running; then
+//     resumeFinish() starts the app, runs its first frame and
+//     logs time-to-gameplay.
+//
+//  Notes:
+//   - Times are millis(), i.e. from app start after the ROM
+//     bootloader — close enough to power-on for comparisons.
+// =========================================================
+
+#include "resume.h"
+#include "config.h"
+#include "controls.h"
+#include "emulator.h"
+#include "homebrew.h"
+#include "luaapp.h"
+#include "fcon.h"
+#include "MenuUI.h"
+#include "sdcard.h"
+#include <SD.h>
+#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+extern TFT_eSPI tft;
+
+// =========================================================
+//  STATE
+// =========================================================
+static const char* const KIND_NAMES[] = { "", "nes", "lua", "cart" };
+
+// Last app launched this session
+static ResumeKind lastKind = ResumeKind::NONE;
+static String     lastPath;
+static bool       dirty = false;
+
+// Boot
+static ResumeKind   bootKind = ResumeKind::NONE;
+static String       bootPath;
+static TaskHandle_t waiter = nullptr;
+static bool         restoring = false;
+static bool         restoreOk = false;
+static uint32_t     splashMs = 0, restoreMs = 0, readyMs = 0;
+
+
+// =========================================================
+//  RECORD
+// =========================================================
+static ResumeKind kindFromName(const char* name) {
+  for (int i = 1; i < 4; ++i)
+    if (strcmp(name, KIND_NAMES[i]) == 0) return (ResumeKind)i;
+  return ResumeKind::NONE;
+}
+
+static bool readRecord() {
+  StaticJsonDocument<256> doc;
+  DeserializationError err;
+  {
+    SdBus bus;
+    File f = SD.open(RESUME_FILE, FILE_READ);
+    if (!f) return false;
+    err = deserializeJson(doc, f);
+    f.close();
+  }
+  if (err) return false;
+
+  bootKind = kindFromName(doc["kind"] | "");
+  bootPath = (const char*)(doc["path"] | "");
+  return bootKind != ResumeKind::NONE && bootPath.length() > 0;
+}
+
+void resumeNote(ResumeKind kind, const char* path) {
+  if (kind == lastKind && lastPath == path) return;
+  lastKind = kind;
+  lastPath = path;
+  dirty = true;
+}
+
+void resumeSave() {
+  if (!RESUME_ENABLED || !dirty) return;
+
+  SdBus bus;
+  File f = SD.open(RESUME_FILE, FILE_WRITE);
+  if (f) {
+    StaticJsonDocument<256> doc;
+    doc["kind"] = KIND_NAMES[(int)lastKind];
+    doc["path"] = lastPath;
+    serializeJson(doc, f);
+    f.close();
+    dirty = false;
+    DBG_IF(RESUME, "[Resume] Recorded %s %s\n", KIND_NAMES[(int)lastKind], lastPath.c_str());
+  }
+}
+
+
+// =========================================================
+//  SPLASH
+// =========================================================
+// "/roms/Super Mario Bros.nes" -> "Super Mario Bros"
+static String displayName(const String& path) {
+  if (bootKind == ResumeKind::CART) return path;
+  int slash = path.lastIndexOf('/');
+  int dot   = path.lastIndexOf('.');
+  return path.substring(slash + 1, dot > slash ? dot : path.length());
+}
+
+static void drawSplash() {
+  int16_t cx = tft.width() / 2, cy = tft.height() / 2;
+  tft.fillScreen(COL_BG);
+  tft.setTextDatum(MC_DATUM);
+  tft.setTextFont(MENU_TEXT_FONT_ID);
+  tft.setTextColor(COL_MUTED, COL_BG);
+  tft.drawString("Resume", cx, cy - 28);
+  tft.setTextFont(4);
+  tft.setTextColor(COL_FG, COL_BG);
+  tft.drawString(displayName(bootPath).c_str(), cx, cy);
+  tft.setTextFont(MENU_TEXT_FONT_ID);
+  tft.setTextColor(COL_MUTED, COL_BG);
+  tft.drawString("A: Play now    B: Home", cx, cy + 32);
+}
+
+
+// =========================================================
+//  BOOT PIPELINE
+// =========================================================
+static void restore() {
+  uint32_t t0 = millis();
+  restoreOk = emuPrepare(bootPath.c_str(), true);
+  restoreMs = millis() - t0;
+}
+
+static void restoreTask(void*) {
+  restore();
+  xTaskNotifyGive(waiter);
+  vTaskDelete(nullptr);
+}
+
+bool resumeBegin() {
+  if (!RESUME_ENABLED || !readRecord()) return false;
+  lastKind = bootKind;  // already on record
+  lastPath = bootPath;
+
+  splashMs = millis();
+  drawSplash();
+
+  // Scripts and carts have nothing worth preloading
+  if (bootKind == ResumeKind::NES) {
+    waiter = xTaskGetCurrentTaskHandle();
+    restoring = xTaskCreatePinnedToCore(restoreTask, "resume", RESUME_TASK_STACK,
+                                        nullptr, 3, nullptr, 0) == pdPASS;
+    if (!restoring) restore();  // no task: restore inline
+  }
+  DBG_IF(RESUME, "[Resume] Offering %s %s at %lu ms\n",
+         KIND_NAMES[(int)bootKind], bootPath.c_str(), (unsigned long)splashMs);
+  return true;
+}
+
+void resumeWait() {
+  if (!restoring) return;
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  restoring = false;
+  DBG_IF(RESUME, "[Resume] Restore %s in %lu ms\n", restoreOk ? "ready" : "failed", (unsigned long)restoreMs);
+}
+
+static bool launch() {
+  switch (bootKind) {
+    case ResumeKind::NES:  return restoreOk && emuStart();
+    case ResumeKind::LUA:  return luaLaunch(bootPath.c_str());
+    case ResumeKind::CART: return homebrewLaunch(bootPath.c_str());
+    default:               return false;
+  }
+}
+
+bool resumeReady() {
+  if (bootKind == ResumeKind::NONE) return false;
+  resumeWait();
+  readyMs = millis();
+  return true;
+}
+
+uint32_t resumeSplashLeft() {
+  uint32_t shown = millis() - splashMs;
+  return shown < RESUME_SPLASH_MS ? RESUME_SPLASH_MS - shown : 0;
+}
+
+int8_t resumeChoice() {
+  controls.update(controls.mode());
+  if (controls.b()) return 0;
+  if (controls.a()) return 1;
+  return -1;
+}
+
+void resumeFinish(bool go) {
+  if (bootKind == ResumeKind::NONE) return;
+  uint32_t waitMs = millis() - readyMs;
+
+  uint32_t t0 = millis();
+  if (!go || !launch()) {
+    emuCancel();
+    tft.fillScreen(COL_BG);
+    setMenuInputLockUntil(millis() + 300);
+    if (EditMenu* m = currentMenu()) m->forceRedraw();
+    DBG_IF(RESUME, "[Resume] %s; home menu\n", go ? "Launch failed" : "Declined");
+    bootKind = ResumeKind::NONE;
+    return;
+  }
+
+  if (emuRunning())       emuUpdate();   // first frame
+  else if (fconRunning()) fconUpdate();
+  uint32_t now = millis();
+
+  DBG_IF(RESUME, "[Resume] %s: gameplay at %lu ms (%lu ms without the splash wait); "
+                 "restore %lu ms in background, boot ready at %lu ms, start + first frame %lu ms\n",
+         displayName(bootPath).c_str(), (unsigned long)now, (unsigned long)(now - waitMs),
+         (unsigned long)restoreMs, (unsigned long)readyMs, (unsigned long)(now - t0));
+  bootKind = ResumeKind::NONE;
+}
+
+// ======================= End of File =======================
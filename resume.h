@@ -0,0 +1,61 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  resume.h — Quick-Resume (Header)
+//
+//  Provides:
+//   • resumeNote() / resumeSave() — remember the last app
+//   • resumeBegin()  — boot: splash + background restore
+//   • resumeWait()   — boot: hand SD back to setup()
+//   • resumeReady() / resumeSplashLeft() / resumeChoice()
+//                    — boot flow: wait out the splash, read A / B
+//   • resumeFinish() — boot: resume or go home, log timing
+//
+//  Boot sequence (setup(), then the boot flow):
+//   setupSD → romstoreBegin → resumeBegin → gamepad / audio /
+//   menus → resumeWait → settings → resumeReady → splash wait
+//   → resumeFinish
+//
+//  Notes:
+//   - Between resumeBegin() and resumeWait() the restore task
+//     owns the SPI bus: setup() must not touch SD or the panel.
+//   - Games come back from their exit save state (emulator.h);
+//     homebrew carts and scripts restart from the top.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  TYPES
+// =========================================================
+enum class ResumeKind : uint8_t {
+  NONE,
+  NES,    // path = ROM
+  LUA,    // path = script
+  CART,   // path = built-in cart name
+};
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+// Launchers call this once an app is running; resumeSave()
+// writes it to RESUME_FILE when it changed (session end,
+// sleep, reboot, shutdown).
+void resumeNote(ResumeKind kind, const char* path);
+void resumeSave();
+
+// Returns true if a resume is on offer (splash is up).
+bool resumeBegin();
+void resumeWait();
+
+// The splash wait is the caller's, so a coroutine can await
+// between resumeChoice() reads instead of blocking the loop:
+// resumeReady() is false with nothing on offer; resumeChoice()
+// is 1 for A (play now), 0 for B (home), -1 for neither.
+bool     resumeReady();
+uint32_t resumeSplashLeft();   // ms, 0 once it's over
+int8_t   resumeChoice();
+void     resumeFinish(bool go);
+
+// ======================= End of File =======================
@@ -0,0 +1,302 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  rewind.cpp — Compressed Rewind Buffer
+//
+//  Provides:
+//   • XOR delta + zero-run/literal encoder
+//   • Combined decode-and-XOR for stepping back
+//   • Record ring in PSRAM with oldest-first eviction
+//
+//  Record encoding (delta bytes):
+//   0x00–0x7F  literal run of (c + 1) bytes follows
+//   0x80–0xFE  (c - 0x7F) zero bytes
+//   0xFF lo hi zero run of (hi:lo) bytes
+//
+//  Notes:
+//   - Most of a NES state is unchanged between snapshots, so
+//     a delta is mostly one long zero run; decoding those is
+//     a pointer skip, not a loop.
+//   - Records never wrap: one that doesn't fit at the end is
+//     placed at offset 0 instead.
+//
+//  Host check + benchmark (synthetic NES-sized states):
+//    g++ -O2 -DREWIND_BENCH_MAIN -x c++ rewind.cpp -o rewind_bench
+// =========================================================
+
+#include "rewind.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+  #include "config.h"
+#else
+  #include <stdio.h>
+  #include <chrono>
+  static constexpr uint8_t  REWIND_INTERVAL  = 4;
+  static constexpr uint16_t REWIND_MAX_SNAPS = 4096;
+  static void* ps_malloc(size_t n) { return malloc(n); }
+  static uint32_t micros() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+// =========================================================
+//  STATE
+// =========================================================
+struct Record { uint32_t off, len; };
+
+static uint8_t* ring = nullptr;      // compressed records
+static size_t   ringSize = 0;
+static size_t   writePos = 0;
+
+static Record*  recs = nullptr;      // index ring, oldest at recFirst
+static uint16_t recFirst = 0, recCount = 0;
+
+static uint8_t* ref = nullptr;       // newest snapshot, whole
+static uint8_t* scratch = nullptr;   // one worst-case record
+static size_t   stateLen = 0;
+static bool     haveRef = false;
+
+// Stats
+static uint32_t pushUs = 0, pushN = 0, popUs = 0, popN = 0;
+static uint32_t bytesHeld = 0;
+
+
+// =========================================================
+//  SETUP / TEARDOWN
+// =========================================================
+static void* bigAlloc(size_t n) {
+  void* p = ps_malloc(n);
+  return p ? p : malloc(n);
+}
+
+bool rewindBegin(size_t stateSize, size_t ringBytes) {
+  rewindEnd();
+
+  stateLen = stateSize;
+  ringSize = ringBytes;
+  ring     = (uint8_t*)ps_malloc(ringBytes);
+  recs     = (Record*)bigAlloc(REWIND_MAX_SNAPS * sizeof(Record));
+  ref      = (uint8_t*)bigAlloc(stateSize);
+  scratch  = (uint8_t*)bigAlloc(stateSize + stateSize / 128 + 16);
+  if (!ring || !recs || !ref || !scratch) { rewindEnd(); return false; }
+
+  writePos = 0;
+  recFirst = recCount = 0;
+  haveRef = false;
+  pushUs = pushN = popUs = popN = 0;
+  bytesHeld = 0;
+  return true;
+}
+
+void rewindEnd() {
+  free(ring);    ring = nullptr;
+  free(recs);    recs = nullptr;
+  free(ref);     ref = nullptr;
+  free(scratch); scratch = nullptr;
+  ringSize = stateLen = 0;
+  recCount = 0;
+  haveRef = false;
+}
+
+bool rewindActive() { return ring != nullptr; }
+
+
+// =========================================================
+//  CODEC
+// =========================================================
+// Encodes a ^ b into out; returns the encoded length.
+static size_t encodeDelta(const uint8_t* a, const uint8_t* b, size_t n, uint8_t* out) {
+  uint8_t* o = out;
+  size_t i = 0;
+
+  while (i < n) {
+    // Zero run (identical bytes)
+    size_t z = i;
+    while (z < n && a[z] == b[z]) ++z;
+    size_t run = z - i;
+    while (run) {
+      if (run < 0x80) { *o++ = (uint8_t)(0x7F + run); run = 0; }
+      else {
+        size_t r = run > 0xFFFF ? 0xFFFF : run;
+        *o++ = 0xFF; *o++ = r & 0xFF; *o++ = r >> 8;
+        run -= r;
+      }
+    }
+    i = z;
+
+    // Literal run; a single equal byte doesn't end it
+    size_t start = i;
+    while (i < n && i - start < 128) {
+      if (a[i] == b[i] && (i + 1 >= n || a[i + 1] == b[i + 1])) break;
+      ++i;
+    }
+    if (i > start) {
+      *o++ = (uint8_t)(i - start - 1);
+      for (size_t k = start; k < i; ++k) *o++ = a[k] ^ b[k];
+    }
+  }
+  return o - out;
+}
+
+// XORs an encoded delta into state in place.
+static void applyDelta(const uint8_t* in, size_t len, uint8_t* state) {
+  const uint8_t* end = in + len;
+  while (in < end) {
+    uint8_t c = *in++;
+    if (c < 0x80) {
+      for (int k = 0; k <= c; ++k) *state++ ^= *in++;
+    } else if (c < 0xFF) {
+      state += c - 0x7F;
+    } else {
+      state += in[0] | (in[1] << 8);
+      in += 2;
+    }
+  }
+}
+
+
+// =========================================================
+//  RING
+// =========================================================
+static inline Record& oldest() { return recs[recFirst]; }
+static inline Record& newest() { return recs[(recFirst + recCount - 1) % REWIND_MAX_SNAPS]; }
+
+static void dropOldest() {
+  bytesHeld -= oldest().len;
+  recFirst = (recFirst + 1) % REWIND_MAX_SNAPS;
+  recCount--;
+}
+
+static void store(const uint8_t* data, size_t len) {
+  if (len > ringSize) return;
+  if (recCount == REWIND_MAX_SNAPS) dropOldest();
+
+  // Wrap: anything past writePos belongs to the previous lap
+  if (writePos + len > ringSize) {
+    while (recCount && oldest().off >= writePos) dropOldest();
+    writePos = 0;
+  }
+  while (recCount && oldest().off < writePos + len && writePos < oldest().off + oldest().len)
+    dropOldest();
+
+  memcpy(ring + writePos, data, len);
+  recs[(recFirst + recCount) % REWIND_MAX_SNAPS] = { (uint32_t)writePos, (uint32_t)len };
+  recCount++;
+  writePos += len;
+  bytesHeld += len;
+}
+
+
+// =========================================================
+//  PUSH / POP
+// =========================================================
+void rewindPush(const uint8_t* state) {
+  if (!ring) return;
+  uint32_t t0 = micros();
+
+  if (haveRef) {
+    size_t len = encodeDelta(state, ref, stateLen, scratch);
+    store(scratch, len);
+  }
+  memcpy(ref, state, stateLen);
+  haveRef = true;
+
+  pushUs += micros() - t0;
+  pushN++;
+}
+
+const uint8_t* rewindPop() {
+  if (!ring || !haveRef) return nullptr;
+  if (!recCount) return ref;  // out of history: hold the oldest
+
+  uint32_t t0 = micros();
+  Record& r = newest();
+  applyDelta(ring + r.off, r.len, ref);
+  writePos = r.off;           // reuse its space
+  bytesHeld -= r.len;
+  recCount--;
+
+  popUs += micros() - t0;
+  popN++;
+  return ref;
+}
+
+uint16_t rewindDepth() { return recCount; }
+
+RewindStats rewindStats() {
+  RewindStats s;
+  s.pushMs       = pushN ? pushUs / 1000.0f / pushN : 0;
+  s.popMs        = popN  ? popUs  / 1000.0f / popN  : 0;
+  s.bytesHeld    = bytesHeld;
+  s.bytesPerSnap = recCount ? (float)bytesHeld / recCount : 0;
+  return s;
+}
+
+
+// =========================================================
+//  HOST CHECK + BENCHMARK
+// =========================================================
+#ifdef REWIND_BENCH_MAIN
+static uint32_t rng = 0x9E3779B9;
+static uint32_t rnd() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+// Roughly what changes in a NES state between snapshots: a few
+// hundred bytes of CPU RAM, some OAM, a little VRAM + registers
+static void step(uint8_t* s, size_t n, bool noisy) {
+  if (noisy) { for (size_t i = 0; i < n; ++i) s[i] = (uint8_t)rnd(); return; }
+  for (int i = 0; i < 240; ++i) s[64 + rnd() % 0x800] = (uint8_t)rnd();
+  for (int i = 0; i < 64; ++i)  s[0x2900 + rnd() % 256] = (uint8_t)rnd();
+  for (int i = 0; i < 24; ++i)  s[0x2A00 + rnd() % 0x1000] = (uint8_t)rnd();
+  for (int i = 0; i < 16; ++i)  s[i] = (uint8_t)rnd();
+}
+
+// Pushes `snaps` states, then pops all the way back; every
+// popped state must match the one pushed at that depth
+static bool run(const char* name, size_t stateLen, size_t ringBytes, int snaps, int noisyEvery) {
+  uint8_t* hist = (uint8_t*)malloc(stateLen * snaps);
+  memset(hist, 0, stateLen);
+  for (int i = 1; i < snaps; ++i) {
+    memcpy(hist + i * stateLen, hist + (i - 1) * stateLen, stateLen);
+    step(hist + i * stateLen, stateLen, noisyEvery && i % noisyEvery == 0);
+  }
+
+  if (!rewindBegin(stateLen, ringBytes)) { printf("%s: no memory\n", name); return false; }
+  for (int i = 0; i < snaps; ++i) rewindPush(hist + i * stateLen);
+  RewindStats pushed = rewindStats();
+  uint16_t depth = rewindDepth();
+
+  int bad = 0;
+  for (int back = 1; back <= depth; ++back) {
+    const uint8_t* s = rewindPop();
+    if (!s || memcmp(s, hist + (snaps - 1 - back) * stateLen, stateLen)) bad++;
+  }
+  const uint8_t* last = rewindPop();   // out of history: holds the oldest
+  if (!last || memcmp(last, hist + (snaps - 1 - depth) * stateLen, stateLen)) bad++;
+  RewindStats popped = rewindStats();
+  rewindEnd();
+  free(hist);
+
+  float perSec = 60.0f / REWIND_INTERVAL;
+  printf("%s: %u B state, %d pushed, %u held in %u KB (%.1f s); %.0f B/record, "
+         "%.1f KB per second of history; push %.1f us (%.2f us/frame), pop %.1f us; %s\n",
+         name, (unsigned)stateLen, snaps, (unsigned)depth, (unsigned)(ringBytes / 1024),
+         depth / perSec, pushed.bytesPerSnap, pushed.bytesPerSnap * perSec / 1024,
+         pushed.pushMs * 1000, pushed.pushMs * 1000 / REWIND_INTERVAL, popped.popMs * 1000,
+         bad ? "FAIL" : "ok");
+  return !bad;
+}
+
+int main() {
+  const size_t STATE = 23 * 1024;
+  bool ok = true;
+  ok &= run("typical", STATE, 2048 * 1024, 3000, 0);
+  ok &= run("evicting", STATE, 64 * 1024, 3000, 0);          // ring far too small
+  ok &= run("scene cuts", STATE, 512 * 1024, 600, 50);       // some incompressible deltas
+  return ok ? 0 : 1;
+}
+#endif
+
+// ======================= End of File =======================
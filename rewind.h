@@ -0,0 +1,48 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  rewind.h — Compressed Rewind Buffer (Header)
+//
+//  Provides:
+//   • rewindBegin() — Allocate the PSRAM ring for one session
+//   • rewindPush()  — Store a snapshot as a compressed delta
+//   • rewindPop()   — Step back one snapshot
+//   • rewindStats() — Cost + memory per second of history
+//
+//  Notes:
+//   - Only the newest snapshot is kept whole. Each record is
+//     the XOR of two consecutive snapshots, zero-run encoded,
+//     so stepping back is "decode + XOR" in one pass.
+//   - When the ring is full the oldest records are dropped;
+//     nothing ever needs them to decode newer ones.
+//   - Snapshots must all be the same size (see NES::stateSize).
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool rewindBegin(size_t stateSize, size_t ringBytes);
+void rewindEnd();
+bool rewindActive();
+
+void rewindPush(const uint8_t* state);
+
+// Returns the previous snapshot (valid until the next call), or
+// the oldest one once history runs out; nullptr if none exists.
+const uint8_t* rewindPop();
+
+uint16_t rewindDepth();   // records held (snapshots - 1)
+
+struct RewindStats {
+  float    pushMs;        // average per snapshot (save excluded)
+  float    popMs;         // average per step back
+  uint32_t bytesHeld;     // compressed bytes in the ring
+  float    bytesPerSnap;  // average record size
+};
+RewindStats rewindStats();
+
+// ======================= End of File =======================
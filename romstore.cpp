@@ -0,0 +1,217 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  romstore.cpp — Flash ROM Store
+//
+//  Provides:
+//   • One-sector index: path hash + size + SD timestamp → offset
+//   • SD → flash copy (erase + write in 4 KB steps)
+//   • esp_partition_mmap() of stored images
+//
+//  Layout:
+//   0x0000  index sector (header + entries)
+//   0x1000  ROM images, each starting on a 4 KB sector
+//
+//  Notes:
+//   - Space is handed out front to back. When a new ROM no
+//     longer fits, the store is reset and refilled from the
+//     start; replaced or edited ROMs just leave dead space
+//     until then.
+//   - An image is erased + written before its index entry is
+//     added, so a failed copy leaves the index as it was.
+// =========================================================
+
+#include "romstore.h"
+#include "config.h"
+#include "esp_partition.h"
+#include "sdcard.h"
+#include <SD.h>
+
+// =========================================================
+//  INDEX FORMAT
+// =========================================================
+static constexpr uint32_t INDEX_MAGIC = 0x53524252;  // "RBRS"
+static constexpr uint32_t SECTOR      = 0x1000;
+static constexpr uint32_t DATA_START  = SECTOR;
+
+struct IndexHeader {
+  uint32_t magic;
+  uint16_t count;
+  uint16_t reserved;
+  uint32_t nextFree;
+};
+
+struct IndexEntry {
+  uint32_t key;      // FNV-1a of the SD path
+  uint32_t size;
+  uint32_t stamp;    // SD last-write time
+  uint32_t offset;
+};
+
+static constexpr int MAX_ENTRIES = (SECTOR - sizeof(IndexHeader)) / sizeof(IndexEntry);
+
+static struct {
+  IndexHeader h;
+  IndexEntry  e[MAX_ENTRIES];
+} index_;
+
+static const esp_partition_t*  part = nullptr;
+static spi_flash_mmap_handle_t mapHandle;
+static bool                    mapped = false;
+
+
+// =========================================================
+//  HELPERS
+// =========================================================
+static uint32_t fnv1a(const char* s) {
+  uint32_t h = 2166136261u;
+  while (*s) { h ^= (uint8_t)*s++; h *= 16777619u; }
+  return h;
+}
+
+static void resetIndex() {
+  memset(&index_, 0xFF, sizeof(index_));
+  index_.h.magic = INDEX_MAGIC;
+  index_.h.count = 0;
+  index_.h.reserved = 0;
+  index_.h.nextFree = DATA_START;
+}
+
+static bool writeIndex() {
+  return esp_partition_erase_range(part, 0, SECTOR) == ESP_OK &&
+         esp_partition_write(part, 0, &index_, sizeof(index_)) == ESP_OK;
+}
+
+static int findEntry(uint32_t key) {
+  for (int i = 0; i < index_.h.count; ++i)
+    if (index_.e[i].key == key) return i;
+  return -1;
+}
+
+static void dropEntry(int i) {
+  memmove(&index_.e[i], &index_.e[i + 1], (index_.h.count - i - 1) * sizeof(IndexEntry));
+  index_.h.count--;
+}
+
+
+// =========================================================
+//  SETUP
+// =========================================================
+bool romstoreBegin() {
+  part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                  (esp_partition_subtype_t)ROMSTORE_SUBTYPE,
+                                  ROMSTORE_LABEL);
+  if (!part) {
+    DBG_IF(EMU, "[RomStore] No '%s' partition; ROMs load from SD\n", ROMSTORE_LABEL);
+    return false;
+  }
+
+  if (esp_partition_read(part, 0, &index_, sizeof(index_)) != ESP_OK ||
+      index_.h.magic != INDEX_MAGIC || index_.h.count > MAX_ENTRIES) {
+    resetIndex();
+    if (!writeIndex()) { part = nullptr; return false; }
+  }
+  DBG_IF(EMU, "[RomStore] %u ROM(s), %lu/%lu KB used\n",
+         index_.h.count,
+         (unsigned long)(index_.h.nextFree / 1024),
+         (unsigned long)(part->size / 1024));
+  return true;
+}
+
+bool romstoreReady() { return part != nullptr; }
+
+
+// =========================================================
+//  STORE (SD → flash)
+// =========================================================
+static int storeRom(File& f, uint32_t key, uint32_t size, uint32_t stamp) {
+  uint32_t span = (size + SECTOR - 1) & ~(SECTOR - 1);
+  if (DATA_START + span > part->size) return -1;
+
+  // Full: forget everything on flash first, so a failed or cut
+  // copy can't leave the index pointing at half-erased images
+  int old = findEntry(key);
+  if (index_.h.count - (old >= 0) >= MAX_ENTRIES || index_.h.nextFree + span > part->size) {
+    DBG_IF(EMU, "[RomStore] Full, starting over\n");
+    resetIndex();
+    old = -1;
+    if (!writeIndex()) { part = nullptr; return -1; }
+  }
+
+  // Copy into free space; the index only changes once it's there
+  uint32_t off = index_.h.nextFree;
+  if (esp_partition_erase_range(part, off, span) != ESP_OK) return -1;
+
+  uint8_t* buf = (uint8_t*)malloc(SECTOR);
+  if (!buf) return -1;
+  uint32_t done = 0;
+  while (done < size) {
+    size_t n = f.read(buf, min((uint32_t)SECTOR, size - done));
+    if (n == 0 || esp_partition_write(part, off + done, buf, n) != ESP_OK) break;
+    done += n;
+  }
+  free(buf);
+  if (done != size) return -1;
+
+  if (old >= 0) dropEntry(old);
+  IndexEntry& e = index_.e[index_.h.count];
+  e.key = key; e.size = size; e.stamp = stamp; e.offset = off;
+  index_.h.count++;
+  index_.h.nextFree = off + span;
+  if (!writeIndex()) {   // flash index unknown: off until reboot
+    part = nullptr;
+    return -1;
+  }
+  return index_.h.count - 1;
+}
+
+
+// =========================================================
+//  MAP / UNMAP
+// =========================================================
+const uint8_t* romstoreMap(const char* path, size_t& len, bool& stored) {
+  stored = false;
+  if (!part) return nullptr;
+  romstoreUnmap();
+
+  uint32_t key = fnv1a(path);
+  uint32_t size;
+  int i;
+  {
+    SdBus bus;
+    File f = SD.open(path, FILE_READ);
+    if (!f) return nullptr;
+
+    size = f.size();
+    uint32_t stamp = (uint32_t)f.getLastWrite();
+
+    i = findEntry(key);
+    if (i < 0 || index_.e[i].size != size || index_.e[i].stamp != stamp) {
+      i = storeRom(f, key, size, stamp);
+      stored = true;
+    }
+    f.close();
+  }
+
+  if (i < 0) {
+    DBG_IF(EMU, "[RomStore] Could not store %s\n", path);
+    return nullptr;
+  }
+
+  const void* ptr = nullptr;
+  if (esp_partition_mmap(part, index_.e[i].offset, size, ESP_PARTITION_MMAP_DATA,
+                         &ptr, &mapHandle) != ESP_OK)
+    return nullptr;
+
+  mapped = true;
+  len = size;
+  return (const uint8_t*)ptr;
+}
+
+void romstoreUnmap() {
+  if (!mapped) return;
+  spi_flash_munmap(mapHandle);
+  mapped = false;
+}
+
+// ======================= End of File =======================
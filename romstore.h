@@ -0,0 +1,36 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  romstore.h — Flash ROM Store (Header)
+//
+//  Provides:
+//   • romstoreBegin() — Find the "roms" partition, load its index
+//   • romstoreMap()   — Map a ROM straight out of flash, copying
+//                       it from SD first if it isn't stored yet
+//   • romstoreUnmap() — Release the current mapping
+//
+//  Notes:
+//   - A ROM is written to flash once; later launches only set
+//     up MMU pages, so PRG is read in place through the cache
+//     and bank switches stay pointer updates.
+//   - One mapping at a time (one running game).
+//   - Needs a "roms" data partition: 16 MB modules can use
+//     partitions/rowboy_16MB.csv (see README); without one,
+//     romstoreBegin() returns false and ROMs load from SD.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool romstoreBegin();
+bool romstoreReady();
+
+// Returns the mapped image (nullptr on failure). `stored` is set
+// when the ROM had to be copied into flash first.
+const uint8_t* romstoreMap(const char* path, size_t& len, bool& stored);
+void           romstoreUnmap();
+
+// ======================= End of File =======================
@@ -0,0 +1,152 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  scanout.cpp — Direct-to-DMA Scanline Output
+//
+//  Provides:
+//   • Nearest-neighbour scaling via a precomputed X map
+//   • Palette conversion straight into DMA-capable SRAM
+//   • Block ring: fill block N while block N-1 is on the wire
+//
+//  Notes:
+//   - One address window per frame; blocks are streamed into
+//     it with pushPixelsDMA (which waits for the previous one).
+//   - The LUT holds byte-swapped RGB565 so no swap pass is
+//     needed before DMA.
+//   - Ring size: SCANOUT_RING_BLOCKS x SCANOUT_BLOCK_LINES lines
+//     (2 x 16 x 341 px ≈ 22 KB for a scaled NES picture).
+// =========================================================
+
+#include "scanout.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+
+// =========================================================
+//  STATE
+// =========================================================
+static TFT_eSPI* panel = nullptr;
+static uint16_t* ring[SCANOUT_RING_BLOCKS] = {};
+static uint16_t  lut[256];
+static uint16_t  xmap[480];            // dst x → src x
+
+static int16_t srcW = 0, srcH = 0;
+static int16_t dstX = 0, dstY = 0, dstW = 0, dstH = 0;
+
+static uint8_t   blk = 0;              // block being filled
+static uint8_t   blkLines = 0;         // lines already in it
+static int16_t   dstLine = 0;          // next output line this frame
+static uint16_t* lastRow = nullptr;    // most recent converted row
+static bool      inFrame = false;
+static bool      swapWas = false;
+
+
+// =========================================================
+//  SETUP / TEARDOWN
+// =========================================================
+bool scanoutBegin(TFT_eSPI& tft, int16_t sw, int16_t sh, int16_t dw, int16_t dh) {
+  scanoutStop();
+  if (dw > (int16_t)(sizeof(xmap) / sizeof(xmap[0]))) return false;
+
+  size_t bytes = (size_t)dw * SCANOUT_BLOCK_LINES * sizeof(uint16_t);
+  for (int i = 0; i < SCANOUT_RING_BLOCKS; ++i) {
+    ring[i] = (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!ring[i]) { scanoutStop(); return false; }
+  }
+
+  panel = &tft;
+  srcW = sw; srcH = sh;
+  dstW = dw; dstH = dh;
+  dstX = (tft.width()  - dw) / 2;
+  dstY = (tft.height() - dh) / 2;
+
+  for (int x = 0; x < dstW; ++x) xmap[x] = (uint32_t)x * srcW / dstW;
+
+  panel->initDMA();
+  swapWas = panel->getSwapBytes();
+  panel->setSwapBytes(false);
+  return true;
+}
+
+void scanoutStop() {
+  if (panel) {
+    if (inFrame) scanoutFrameEnd();
+    panel->dmaWait();
+    panel->setSwapBytes(swapWas);
+    panel->deInitDMA();
+  }
+  for (int i = 0; i < SCANOUT_RING_BLOCKS; ++i) {
+    heap_caps_free(ring[i]);
+    ring[i] = nullptr;
+  }
+  panel = nullptr;
+}
+
+bool scanoutActive() { return panel != nullptr; }
+
+void scanoutSetPalette(const uint16_t* rgb565, uint16_t count) {
+  if (count > 256) count = 256;
+  for (uint16_t i = 0; i < count; ++i)
+    lut[i] = (rgb565[i] >> 8) | (rgb565[i] << 8);
+}
+
+
+// =========================================================
+//  FRAME STREAMING
+// =========================================================
+static void flushBlock() {
+  if (!blkLines) return;
+  panel->pushPixelsDMA(ring[blk], (uint32_t)dstW * blkLines);  // waits for the previous block
+  blk = (blk + 1) % SCANOUT_RING_BLOCKS;
+  blkLines = 0;
+}
+
+void scanoutFrameBegin() {
+  if (!panel) return;
+  panel->startWrite();
+  panel->setAddrWindow(dstX, dstY, dstW, dstH);
+  blkLines = 0;
+  dstLine = 0;
+  lastRow = nullptr;
+  inFrame = true;
+}
+
+// Emits every output line whose nearest source line is `line`.
+void scanoutLine(int line, const uint8_t* px) {
+  if (!inFrame) return;
+
+  int16_t end = (int16_t)(((int32_t)(line + 1) * dstH + srcH - 1) / srcH);
+  if (end > dstH) end = dstH;
+
+  bool fresh = true;
+  while (dstLine < end) {
+    uint16_t* row = ring[blk] + (size_t)blkLines * dstW;
+    if (fresh) {
+      for (int x = 0; x < dstW; ++x) row[x] = lut[px[xmap[x]]];
+      fresh = false;
+    } else {
+      memcpy(row, lastRow, dstW * sizeof(uint16_t));  // still valid while its block drains
+    }
+    lastRow = row;
+    dstLine++;
+    if (++blkLines == SCANOUT_BLOCK_LINES) flushBlock();
+  }
+}
+
+void scanoutFrameEnd() {
+  if (!inFrame) return;
+
+  // Keep the address window consistent if a source line went missing
+  while (dstLine < dstH) {
+    uint16_t* row = ring[blk] + (size_t)blkLines * dstW;
+    memset(row, 0, dstW * sizeof(uint16_t));
+    dstLine++;
+    if (++blkLines == SCANOUT_BLOCK_LINES) flushBlock();
+  }
+  flushBlock();
+
+  panel->dmaWait();
+  panel->endWrite();
+  inFrame = false;
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,43 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  scanout.h — Direct-to-DMA Scanline Output (Header)
+//
+//  "Racing the beam" video path for emulators and other
+//  line-based renderers: no full-size framebuffer at all.
+//
+//  Provides:
+//   • scanoutBegin()   — Pick source/target size, allocate ring
+//   • scanoutSetPalette() — Indexed colour → RGB565 LUT
+//   • scanoutFrameBegin() / scanoutLine() / scanoutFrameEnd()
+//   • scanoutStop()    — Release ring + DMA
+//
+//  Notes:
+//   - Lines are scaled (nearest) and palette-converted into a
+//     small ring of blocks in internal SRAM; each full block
+//     is handed to the ST7796 via pushPixelsDMA while the next
+//     one is being filled.
+//   - Lines must arrive in order, once per frame.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+
+// Sets up a srcW x srcH → dstW x dstH path, centered on the panel.
+bool scanoutBegin(TFT_eSPI& tft, int16_t srcW, int16_t srcH, int16_t dstW, int16_t dstH);
+void scanoutStop();
+bool scanoutActive();
+
+// Up to 256 entries, plain RGB565 (byte order handled here).
+void scanoutSetPalette(const uint16_t* rgb565, uint16_t count);
+
+void scanoutFrameBegin();
+void scanoutLine(int line, const uint8_t* px);
+void scanoutFrameEnd();
+
+// ======================= End of File =======================
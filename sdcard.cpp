@@ -5,7 +5,7 @@
 //
 //  Provides:
 //   • SPI-based SD mount via shared TFT bus
-//   • Safe CS toggling (prevents draw interference)
+//   • SdBus: safe CS toggling (prevents draw interference)
 //   • Recursive directory listing (for debug)
 //   • Optional serial logging (toggled in config.h)
 //
@@ -19,6 +19,13 @@
 #include "sdcard.h"
 #include "config.h"
 
+// =========================================================
+//  SD BUS GUARD
+// =========================================================
+SdBus::SdBus()  { pinMode(TFT_CS, OUTPUT); digitalWrite(TFT_CS, HIGH); }
+SdBus::~SdBus() { digitalWrite(TFT_CS, LOW); }
+
+
 // =========================================================
 //  DIRECTORY LISTING (recursive)
 // =========================================================
@@ -46,31 +53,27 @@ void listDir(fs::FS &fs, const char *dirname, uint8_t levels) {
 // =========================================================
 //  SD SETUP
 // =========================================================
-// Initializes the SD interface on HSPI and safely toggles TFT_CS.
+// Initializes the SD interface on HSPI, TFT off the bus.
 // Automatically logs card stats and contents if enabled.
 void setupSD() {
-  // Disable TFT during SPI mount
-  pinMode(TFT_CS, OUTPUT);
-  digitalWrite(TFT_CS, HIGH);
-
-  static SPIClass hspi(HSPI);
-  hspi.begin(TFT_SCLK, TFT_MISO, TFT_MOSI, SD_CS);
+  {
+    SdBus bus;
 
-  if (Debug::SERIAL_EN && Debug::SD_LOGS)
-    Serial.print("[SD] Mounting... ");
+    static SPIClass hspi(HSPI);
+    hspi.begin(TFT_SCLK, TFT_MISO, TFT_MOSI, SD_CS);
 
-  if (!SD.begin(SD_CS, hspi, 10000000)) {
     if (Debug::SERIAL_EN && Debug::SD_LOGS)
-      Serial.println("FAILED (check wiring or CS conflict)");
-    digitalWrite(TFT_CS, LOW);
-    return;
-  }
+      Serial.print("[SD] Mounting... ");
 
-  if (Debug::SERIAL_EN && Debug::SD_LOGS)
-    Serial.println("OK");
+    if (!SD.begin(SD_CS, hspi, 10000000)) {
+      if (Debug::SERIAL_EN && Debug::SD_LOGS)
+        Serial.println("FAILED (check wiring or CS conflict)");
+      return;
+    }
 
-  // Re-enable TFT for drawing
-  digitalWrite(TFT_CS, LOW);
+    if (Debug::SERIAL_EN && Debug::SD_LOGS)
+      Serial.println("OK");
+  }
 
   // Optional card info
   uint64_t cardSize   = SD.cardSize() / (1024 * 1024);
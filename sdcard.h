@@ -6,6 +6,7 @@
 //  Provides:
 //   • setupSD()  — Mounts SD card over shared SPI bus
 //   • listDir()  — Recursive directory listing utility
+//   • SdBus      — Scope guard for SD access (TFT off the bus)
 // =========================================================
 
 #pragma once
@@ -13,6 +14,24 @@
 #include <SPI.h>
 #include <SD.h>
 
+// =========================================================
+//  SD BUS GUARD
+// =========================================================
+// TFT and SD share the SPI bus: hold one for the span of any
+// SD access so TFT_CS stays high (no ghost drawing). It lets
+// go at scope end, early returns included; declare Files
+// after it so they close first.
+//   { SdBus bus; File f = SD.open(path); ... }
+// Not nestable: the inner one would release the bus early.
+class SdBus {
+public:
+  SdBus();
+  ~SdBus();
+  SdBus(const SdBus&) = delete;
+  SdBus& operator=(const SdBus&) = delete;
+};
+
+
 // =========================================================
 //  PUBLIC API
 // =========================================================
@@ -0,0 +1,136 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  sfx.cpp — SFX Mixer
+//
+//  Provides:
+//   • Voice state: 32-step wave position in .8 fixed-point µs
+//   • Per-frame pitch / volume update + step catch-up
+//   • BlipBuf mixdown (noise uses the 2-tap delta)
+//
+//  Notes:
+//   - Voices run on a 1 MHz timeline; a frame is 16666 or
+//     16667 ticks so 60 frames are exactly one second.
+//   - Output peak is SFX_VOICES x 15 x 15 x AMP < 32767.
+// =========================================================
+
+#include "sfx.h"
+#include "config.h"
+#include "blipbuf.h"
+
+// =========================================================
+//  TABLES + STATE
+// =========================================================
+static constexpr uint32_t CLOCK = 1000000;
+static constexpr int      AMP   = 32000 / (SFX_VOICES * 15 * 15);
+
+static const uint8_t TRI_WAVE[32] = {
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+  15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0
+};
+
+struct Voice {
+  SfxNote  note;
+  bool     on = false;
+  uint16_t age = 0;          // frames played
+  uint32_t timer = 0;        // ticks to next step, .8
+  uint8_t  step = 0;
+  uint16_t lfsr = 1;
+  int      level = 0;        // amplitude already in the buffer
+};
+
+static Voice    voices[SFX_VOICES];
+static BlipBuf  blip;
+static uint32_t frameRem = 0;  // CLOCK % 60 carry
+
+
+// =========================================================
+//  VOICES
+// =========================================================
+void sfxBegin(uint32_t sampleRate) {
+  blip.setRates(CLOCK, sampleRate);
+  for (Voice& v : voices) v = Voice();
+  frameRem = 0;
+}
+
+void sfxPlay(uint8_t voice, const SfxNote& note) {
+  if (voice >= SFX_VOICES) return;
+  Voice& v = voices[voice];
+  v.note = note;
+  v.on = true;
+  v.age = 0;
+  v.step = 0;
+  v.timer = 0;
+}
+
+void sfxStop(int voice) {
+  for (int i = 0; i < SFX_VOICES; ++i)
+    if (voice < 0 || voice == i) voices[i].on = false;
+}
+
+bool sfxBusy(uint8_t voice) { return voice < SFX_VOICES && voices[voice].on; }
+
+// Wave height (0–15) at the voice's current step
+static inline int waveValue(const Voice& v) {
+  switch (v.note.wave) {
+    case SfxWave::PULSE:    return v.step < v.note.duty ? 15 : 0;
+    case SfxWave::TRIANGLE: return TRI_WAVE[v.step];
+    case SfxWave::SAW:      return v.step >> 1;
+    case SfxWave::NOISE:    return (v.lfsr & 1) ? 15 : 0;
+  }
+  return 0;
+}
+
+static void setLevel(Voice& v, uint32_t t, int level, bool fast) {
+  if (level == v.level) return;
+  if (fast) blip.addDeltaFast(t, level - v.level);
+  else      blip.addDelta(t, level - v.level);
+  v.level = level;
+}
+
+// Advances one voice through a frame of `ticks`.
+static void runVoice(Voice& v, uint32_t ticks) {
+  if (!v.on) { setLevel(v, 0, 0, false); return; }
+
+  const SfxNote& n = v.note;
+  float hz = n.hz + n.slide * v.age;
+  int vol = n.vol;
+  if (n.fade && n.frames) vol = vol * (n.frames - v.age) / n.frames;
+  if (hz < 20.0f || hz > 12000.0f || vol <= 0) { v.on = false; setLevel(v, 0, 0, false); return; }
+
+  const bool fast = n.wave == SfxWave::NOISE;
+  const int  amp  = vol * AMP;
+  setLevel(v, 0, waveValue(v) * amp, fast);  // volume change lands at frame start
+
+  uint32_t period = (uint32_t)((CLOCK << 8) / (hz * 32.0f));
+  if (period < 256) period = 256;
+  uint32_t end = ticks << 8;
+  while (v.timer < end) {
+    v.step = (v.step + 1) & 31;
+    if (n.wave == SfxWave::NOISE) {
+      uint16_t s = v.lfsr;
+      v.lfsr = (s >> 1) | ((uint16_t)((s ^ (s >> 1)) & 1) << 14);
+    }
+    setLevel(v, v.timer >> 8, waveValue(v) * amp, fast);
+    v.timer += period;
+  }
+  v.timer -= end;
+
+  if (n.frames && ++v.age >= n.frames) v.on = false;
+}
+
+
+// =========================================================
+//  MIXDOWN
+// =========================================================
+int sfxRender(int16_t* out, int max) {
+  frameRem += CLOCK % 60;
+  uint32_t ticks = CLOCK / 60 + frameRem / 60;
+  frameRem %= 60;
+
+  for (Voice& v : voices) runVoice(v, ticks);
+  blip.endFrame(ticks);
+  return blip.readSamples(out, max);
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,49 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  sfx.h — SFX Mixer (Header)
+//
+//  Provides:
+//   • sfxBegin()  — Reset voices for an output sample rate
+//   • sfxPlay()   — Start a note on one of SFX_VOICES voices
+//   • sfxStop()   — Silence one voice (or all)
+//   • sfxRender() — Mix one 60 Hz frame of mono PCM
+//
+//  Notes:
+//   - Chip-style voices: 32-step pulse / triangle / saw tables
+//     plus an LFSR noise, synthesized through a BlipBuf, so
+//     high notes stay clean without oversampling.
+//   - Pitch slide and fade are applied once per frame.
+//   - Rendering only; the caller queues the PCM (audio.h).
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  TYPES
+// =========================================================
+enum class SfxWave : uint8_t { PULSE, TRIANGLE, SAW, NOISE };
+
+struct SfxNote {
+  SfxWave  wave   = SfxWave::PULSE;
+  float    hz     = 440.0f;
+  uint8_t  vol    = 12;      // 0–15
+  uint16_t frames = 10;      // length at 60 Hz; 0 = until sfxStop()
+  float    slide  = 0.0f;    // Hz added per frame
+  bool     fade   = false;   // ramp down to 0 over `frames`
+  uint8_t  duty   = 16;      // pulse: high steps out of 32
+};
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+void sfxBegin(uint32_t sampleRate);
+void sfxPlay(uint8_t voice, const SfxNote& note);
+void sfxStop(int voice = -1);      // -1 = all voices
+bool sfxBusy(uint8_t voice);
+
+// Renders the next 1/60 s; returns the sample count (~rate / 60).
+int  sfxRender(int16_t* out, int max);
+
+// ======================= End of File =======================
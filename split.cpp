@@ -0,0 +1,196 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  split.cpp — Split-Frame Rendering on Both Cores
+//
+//  One worker task pinned to core 0 (SPLIT_TASK_PRIO, above
+//  the MJPEG decoder and below the audio feeder). A frame is
+//  a job {render, ctx, first, last}; the worker is woken with
+//  a task notification and gives a binary semaphore back when
+//  its bands are done — the join barrier.
+//
+//  Speedup is measured, not assumed: the serial cost of a
+//  frame is the time both cores spent on it, so
+//  speedup = (caller + worker) / wall.
+// =========================================================
+
+#include "split.h"
+#include "config.h"
+#include "blend.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+// =========================================================
+//  MODULE STATE
+// =========================================================
+struct SplitJob {
+  SplitRender render;
+  void*       ctx;
+  uint16_t    first, last;
+  uint32_t    busyUs;
+};
+
+static TaskHandle_t      worker = nullptr;
+static SemaphoreHandle_t joined = nullptr;
+static SplitJob          job;
+static bool              failed = false;   // no worker: stay serial
+
+
+// =========================================================
+//  WORKER (core 0)
+// =========================================================
+static void workerTask(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    uint32_t t0 = micros();
+    for (uint16_t b = job.first; b < job.last; ++b) job.render(job.ctx, b);
+    job.busyUs = micros() - t0;
+    xSemaphoreGive(joined);
+  }
+}
+
+static bool startWorker() {
+  if (worker) return true;
+  if (failed) return false;
+  joined = xSemaphoreCreateBinary();
+  if (joined && xTaskCreatePinnedToCore(workerTask, "split", SPLIT_TASK_STACK, nullptr,
+                                        SPLIT_TASK_PRIO, &worker, 0) == pdPASS)
+    return true;
+  if (joined) vSemaphoreDelete(joined);
+  joined = nullptr;
+  worker = nullptr;
+  failed = true;
+  DBG_IF(SPLIT, "[Split] No worker task; frames render on one core\n");
+  return false;
+}
+
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+void splitRun(uint16_t bands, SplitRender render, SplitPresent present, void* ctx,
+              SplitStats* stats) {
+  if (!bands) return;
+  uint32_t t0 = micros();
+
+  // One core: the caller's core is core 0 already, or too
+  // little work to be worth a hand-off
+  if (bands < 2 || xPortGetCoreID() == 0 || !startWorker()) {
+    for (uint16_t b = 0; b < bands; ++b) render(ctx, b);
+    if (present) present(ctx, 0, bands);
+    if (stats) {
+      uint32_t us = micros() - t0;
+      stats->frames++;
+      stats->serial++;
+      stats->wallUs += us;
+      stats->callerUs += us;
+    }
+    return;
+  }
+
+  // --- Fork ---
+  const uint16_t half = (bands + 1) / 2;
+  job = { render, ctx, half, bands, 0 };
+  xTaskNotifyGive(worker);
+
+  for (uint16_t b = 0; b < half; ++b) render(ctx, b);
+  if (present) present(ctx, 0, half);
+  uint32_t callerUs = micros() - t0;
+
+  // --- Join ---
+  xSemaphoreTake(joined, portMAX_DELAY);
+  uint32_t t1 = micros();
+  if (present) present(ctx, half, bands - half);
+  callerUs += micros() - t1;
+
+  if (stats) {
+    stats->frames++;
+    stats->wallUs += micros() - t0;
+    stats->callerUs += callerUs;
+    stats->workerUs += job.busyUs;
+  }
+}
+
+void splitLog(const char* tag, SplitStats& s) {
+  if (!s.frames || !s.wallUs) return;
+  DBG_IF(SPLIT, "[Split] %s: %lu frames (%lu serial), %.2f ms/frame, core 1 %.0f %%, core 0 %.0f %%, speedup %.2fx\n",
+         tag, (unsigned long)s.frames, (unsigned long)s.serial, s.wallUs / 1000.0f / s.frames,
+         100.0f * s.callerUs / s.wallUs, 100.0f * s.workerUs / s.wallUs,
+         (float)(s.callerUs + s.workerUs) / s.wallUs);
+  s = {};
+}
+
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+struct BenchFrame {
+  uint16_t*       out;
+  const uint16_t* a;
+  const uint16_t* b;
+  const uint8_t*  idx;
+  const uint16_t* lut;
+  int16_t         w, h;
+};
+static constexpr uint16_t BENCH_BAND = 16;
+
+static void benchFade(void* ctx, uint16_t band) {
+  const BenchFrame& f = *(const BenchFrame*)ctx;
+  size_t at = (size_t)band * BENCH_BAND * f.w;
+  uint32_t n = (uint32_t)min<int>(BENCH_BAND, f.h - band * BENCH_BAND) * f.w;
+  blendBuffers(f.out + at, f.a + at, f.b + at, n, 100, true);
+}
+
+static void benchComposite(void* ctx, uint16_t band) {
+  const BenchFrame& f = *(const BenchFrame*)ctx;
+  size_t at = (size_t)band * BENCH_BAND * f.w;
+  uint32_t n = (uint32_t)min<int>(BENCH_BAND, f.h - band * BENCH_BAND) * f.w;
+  for (uint32_t i = 0; i < n; ++i) f.out[at + i] = f.lut[f.idx[at + i]];
+}
+
+void splitBenchmark() {
+  static constexpr int FRAMES = 30;
+  BenchFrame f;
+  f.w = 480;
+  f.h = 320;
+  const size_t px = (size_t)f.w * f.h;
+  uint16_t* out = (uint16_t*)ps_malloc(px * 2);
+  uint16_t* a   = (uint16_t*)ps_malloc(px * 2);
+  uint16_t* b   = (uint16_t*)ps_malloc(px * 2);
+  uint8_t*  idx = (uint8_t*)ps_malloc(px);
+  static uint16_t lut[256];
+  if (!out || !a || !b || !idx) {
+    DBG_IF(SPLIT, "[Split] Out of memory for the benchmark\n");
+    free(out); free(a); free(b); free(idx);
+    return;
+  }
+  for (size_t i = 0; i < px; ++i) {
+    a[i] = (uint16_t)(i * 2654435761u >> 16);
+    b[i] = (uint16_t)(i * 40503u);
+    idx[i] = (uint8_t)(i * 7 + (i >> 9));
+  }
+  for (int i = 0; i < 256; ++i) lut[i] = (uint16_t)(i * 0x0841);
+  f.out = out; f.a = a; f.b = b; f.idx = idx; f.lut = lut;
+
+  const uint16_t bands = (f.h + BENCH_BAND - 1) / BENCH_BAND;
+  static const SplitRender KINDS[2] = { benchFade, benchComposite };
+  static const char* const NAMES[2] = { "menu fade", "GIF composite" };
+  for (int k = 0; k < 2; ++k) {
+    uint32_t t0 = micros();
+    for (int i = 0; i < FRAMES; ++i)
+      for (uint16_t band = 0; band < bands; ++band) KINDS[k](&f, band);
+    uint32_t oneUs = micros() - t0;
+
+    SplitStats st = {};
+    for (int i = 0; i < FRAMES; ++i) splitRun(bands, KINDS[k], nullptr, &f, &st);
+    DBG_IF(SPLIT, "[Split] Bench %s %dx%d: one core %.2f ms, both %.2f ms (%.2fx), core 1 %.0f %%, core 0 %.0f %%\n",
+           NAMES[k], f.w, f.h, oneUs / 1000.0f / FRAMES, st.wallUs / 1000.0f / FRAMES,
+           st.wallUs ? (float)oneUs / st.wallUs : 0.0f,
+           st.wallUs ? 100.0f * st.callerUs / st.wallUs : 0.0f,
+           st.wallUs ? 100.0f * st.workerUs / st.wallUs : 0.0f);
+  }
+  free(out); free(a); free(b); free(idx);
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,65 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  split.h — Split-Frame Rendering on Both Cores (Header)
+//
+//  Provides:
+//   • splitRun()   — Render a frame's bands on both cores
+//                    (fork / join), presenting the first half
+//                    while the second is still being drawn
+//   • SplitStats   — Per-core busy time and speedup, kept by
+//                    each caller
+//   • splitLog()   — Print and reset a SplitStats
+//   • splitBenchmark() — One core vs two on synthetic fade /
+//                    GIF buffers (real frames: splitLog)
+//
+//  How a frame runs:
+//   1. Fork: bands [half, n) are handed to a worker task on
+//      core 0.
+//   2. The caller renders bands [0, half) itself, then calls
+//      present(0, half) straight away — the panel push
+//      overlaps the worker's half.
+//   3. Join: wait for the worker, then present(half, n - half).
+//
+//  Notes:
+//   - render() runs on both cores at once: it must only touch
+//     its own band. present() always runs on the caller.
+//   - The worker is created on first use and then sleeps on a
+//     task notification; without it splitRun() runs serially.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  TYPES
+// =========================================================
+typedef void (*SplitRender)(void* ctx, uint16_t band);
+typedef void (*SplitPresent)(void* ctx, uint16_t first, uint16_t count);
+
+struct SplitStats {
+  uint32_t frames;
+  uint32_t wallUs;      // fork → last present done
+  uint32_t callerUs;    // caller: its bands + presents
+  uint32_t workerUs;    // core 0: its bands
+  uint32_t serial;      // frames run on one core
+};
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+// present may be nullptr (plain fork / join)
+void splitRun(uint16_t bands, SplitRender render, SplitPresent present, void* ctx,
+              SplitStats* stats = nullptr);
+
+// "[Split] <tag>: N frames, x.xx ms, core 1 a %, core 0 b %, speedup s.ss x"
+void splitLog(const char* tag, SplitStats& stats);
+
+// =========================================================
+//  BENCHMARK
+// =========================================================
+// A full-screen menu fade step and a full-screen GIF frame
+// composite, one core vs both (Serial).
+void splitBenchmark();
+
+// ======================= End of File =======================
@@ -0,0 +1,215 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  sysmon.cpp — Per-Task CPU + Stack Monitor
+//
+//  Each sample reads every task's run-time counter; the delta
+//  since the last sample over the total counter's delta is its
+//  share of one core. A core's load is 100% minus what its
+//  IDLE task got. Snapshots go to the UI through a
+//  TripleBuffer (channel.h), so the monitor never waits on it.
+//
+//  Notes:
+//   - Stack high-water marks are in bytes (ESP-IDF stacks are
+//     counted in bytes, not words).
+//   - Unpinned tasks show as core "-": their share is real but
+//     may have been spent on either core.
+//   - A task seen for the first time is charged everything it
+//     ran since it started, capped at 100%.
+// =========================================================
+
+#include "sysmon.h"
+#include "config.h"
+#include "channel.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+  #define SYSMON_STATS 1
+#else
+  #define SYSMON_STATS 0
+#endif
+
+// =========================================================
+//  STATE
+// =========================================================
+static TripleBuffer<SysmonSnapshot> snapshots;
+
+#if SYSMON_STATS
+static TaskStatus_t status[SYSMON_MAX_TASKS];
+
+// Last sample's counters, matched by task number
+struct Seen { UBaseType_t num; uint32_t run; uint32_t warnedStack; };
+static Seen     seen[SYSMON_MAX_TASKS], seenNext[SYSMON_MAX_TASKS];
+static uint8_t  seenCount = 0;
+static uint32_t lastTotal = 0, lastMs = 0, lastReport = 0, sampleNo = 0;
+static bool     starved[2] = {};
+static bool     tooMany = false;
+
+static const Seen* findSeen(UBaseType_t num) {
+  for (uint8_t i = 0; i < seenCount; ++i)
+    if (seen[i].num == num) return &seen[i];
+  return nullptr;
+}
+
+
+// =========================================================
+//  REPORT
+// =========================================================
+static const char* coreName(uint8_t core) { return core == 0 ? "0" : core == 1 ? "1" : "-"; }
+
+static void report(const SysmonSnapshot& s) {
+  DBG_IF(SYSMON, "[Sysmon] #%lu over %lu ms: core 0 %.1f%%, core 1 %.1f%%\n",
+         (unsigned long)s.sample, (unsigned long)s.periodMs,
+         s.coreLoad10[0] / 10.0f, s.coreLoad10[1] / 10.0f);
+  DBG_IF(SYSMON, "[Sysmon]   %-16s core prio   cpu%%  stack free\n", "task");
+  for (uint8_t i = 0; i < s.count; ++i) {
+    const SysmonTask& t = s.tasks[i];
+    DBG_IF(SYSMON, "[Sysmon]   %-16s %4s %4u %6.1f %8lu%s\n", t.name, coreName(t.core),
+           (unsigned)t.prio, t.cpu10 / 10.0f, (unsigned long)t.stackFree,
+           t.stackFree < SYSMON_STACK_WARN ? "  LOW" : "");
+  }
+}
+
+// Busiest task pinned to `core`, for the starvation warning
+static const SysmonTask* busiestOn(const SysmonSnapshot& s, uint8_t core, const char* idleName) {
+  for (uint8_t i = 0; i < s.count; ++i)
+    if (s.tasks[i].core == core && strcmp(s.tasks[i].name, idleName)) return &s.tasks[i];
+  return nullptr;
+}
+
+
+// =========================================================
+//  SAMPLE
+// =========================================================
+static void sample() {
+  uint32_t total = 0;
+  UBaseType_t n = uxTaskGetSystemState(status, SYSMON_MAX_TASKS, &total);
+  if (!n) {
+    if (!tooMany) DBG_IF(SYSMON, "[Sysmon] More than %u tasks; raise SYSMON_MAX_TASKS\n",
+                         (unsigned)SYSMON_MAX_TASKS);
+    tooMany = true;
+    return;
+  }
+  uint32_t elapsed = total - lastTotal;
+  if (!elapsed) return;
+
+  const uint32_t nowMs = millis();
+  SysmonSnapshot& s = snapshots.back();
+  s.sample = ++sampleNo;
+  s.periodMs = nowMs - lastMs;
+  s.coreLoad10[0] = s.coreLoad10[1] = 1000;
+  s.count = 0;
+
+  const TaskHandle_t idle[2] = { xTaskGetIdleTaskHandleForCore(0), xTaskGetIdleTaskHandleForCore(1) };
+  char idleName[2][sizeof(SysmonTask::name)] = {};
+
+  for (UBaseType_t i = 0; i < n; ++i) {
+    const TaskStatus_t& t = status[i];
+    const Seen* was = findSeen(t.xTaskNumber);
+    uint32_t ran = t.ulRunTimeCounter - (was ? was->run : 0);
+    uint32_t cpu10 = (uint32_t)((uint64_t)ran * 1000 / elapsed);
+    if (cpu10 > 1000) cpu10 = 1000;
+
+    BaseType_t core = xTaskGetCoreID(t.xHandle);
+    SysmonTask& o = s.tasks[s.count++];
+    strncpy(o.name, t.pcTaskName, sizeof(o.name) - 1);
+    o.name[sizeof(o.name) - 1] = 0;
+    o.core = (core == 0 || core == 1) ? (uint8_t)core : SYSMON_ANY_CORE;
+    o.prio = (uint8_t)t.uxCurrentPriority;
+    o.cpu10 = (uint16_t)cpu10;
+    o.stackFree = t.usStackHighWaterMark;
+
+    for (int c = 0; c < 2; ++c)
+      if (t.xHandle == idle[c]) { s.coreLoad10[c] = (uint16_t)(1000 - cpu10); strcpy(idleName[c], o.name); }
+
+    // Once per task, then again only if it gets lower still
+    uint32_t warned = was ? was->warnedStack : UINT32_MAX;
+    if (o.stackFree < SYSMON_STACK_WARN && o.stackFree < warned) {
+      DBG_IF(SYSMON, "[Sysmon] WARNING: task %s has %lu B of stack left (high-water, prio %u)\n",
+             o.name, (unsigned long)o.stackFree, (unsigned)o.prio);
+      warned = o.stackFree;
+    }
+    seenNext[i] = { t.xTaskNumber, t.ulRunTimeCounter, warned };
+  }
+  memcpy(seen, seenNext, n * sizeof(Seen));
+  seenCount = (uint8_t)n;
+  lastTotal = total;
+  lastMs = nowMs;
+
+  // Busiest first (insertion sort over a few dozen)
+  for (uint8_t i = 1; i < s.count; ++i) {
+    SysmonTask t = s.tasks[i];
+    uint8_t j = i;
+    for (; j > 0 && s.tasks[j - 1].cpu10 < t.cpu10; --j) s.tasks[j] = s.tasks[j - 1];
+    s.tasks[j] = t;
+  }
+
+  // A starved IDLE task can't feed the task watchdog
+  for (uint8_t c = 0; c < 2; ++c) {
+    if (!idleName[c][0]) continue;   // no IDLE task seen for it
+    uint32_t idle10 = 1000 - s.coreLoad10[c];
+    bool low = idle10 < SYSMON_IDLE_WARN_PCT * 10u;
+    if (low && !starved[c]) {
+      const SysmonTask* top = busiestOn(s, c, idleName[c]);
+      DBG_IF(SYSMON, "[Sysmon] WARNING: core %u idle %.1f%% (busiest: %s %.1f%%); "
+                     "the task watchdog fires if IDLE%u can't run\n",
+             (unsigned)c, idle10 / 10.0f, top ? top->name : "?", top ? top->cpu10 / 10.0f : 0.0f,
+             (unsigned)c);
+    } else if (!low && starved[c]) {
+      DBG_IF(SYSMON, "[Sysmon] Core %u idle again (%.1f%%)\n", (unsigned)c, idle10 / 10.0f);
+    }
+    starved[c] = low;
+  }
+
+  if (nowMs - lastReport >= SYSMON_REPORT_MS) {
+    report(s);
+    lastReport = nowMs;
+  }
+  snapshots.publish();
+}
+
+static void monitorTask(void*) {
+  TickType_t wake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(SYSMON_PERIOD_MS));
+    sample();
+  }
+}
+#endif
+
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool sysmonBegin() {
+#if SYSMON_STATS
+  lastMs = lastReport = millis();
+  if (xTaskCreatePinnedToCore(monitorTask, "sysmon", SYSMON_TASK_STACK, nullptr,
+                              SYSMON_TASK_PRIO, nullptr, tskNO_AFFINITY) == pdPASS)
+    return true;
+  DBG_IF(SYSMON, "[Sysmon] Can't start the monitor task\n");
+  return false;
+#else
+  DBG_IF(SYSMON, "[Sysmon] FreeRTOS runtime stats are off in this build; no monitor\n");
+  return false;
+#endif
+}
+
+bool sysmonLatest(const SysmonSnapshot*& s) {
+  bool fresh = snapshots.update();
+  s = &snapshots.front();
+  return fresh && s->sample;
+}
+
+void sysmonLine(const SysmonSnapshot& s, char* out, size_t n) {
+  const SysmonTask* low = nullptr;
+  for (uint8_t i = 0; i < s.count; ++i)
+    if (!low || s.tasks[i].stackFree < low->stackFree) low = &s.tasks[i];
+  snprintf(out, n, "CPU %u/%u%%  stk %lu %s", (unsigned)((s.coreLoad10[0] + 5) / 10),
+           (unsigned)((s.coreLoad10[1] + 5) / 10), low ? (unsigned long)low->stackFree : 0ul,
+           low ? low->name : "");
+}
+
+// ======================= End of File =======================
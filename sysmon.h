@@ -0,0 +1,64 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  sysmon.h — Per-Task CPU + Stack Monitor (Header)
+//
+//  Provides:
+//   • sysmonBegin()   — Start the sampling task (low priority)
+//   • sysmonLatest()  — Newest snapshot, for the UI task
+//   • sysmonLine()    — One-line summary for the corner overlay
+//
+//  Notes:
+//   - Every SYSMON_PERIOD_MS the task reads FreeRTOS runtime
+//     stats: each task's CPU% (of one core) over the period,
+//     each core's load (100% minus its IDLE task) and every
+//     stack's high-water mark (fewest bytes ever left).
+//   - Warnings (SYSMON_LOGS) when a stack gets within
+//     SYSMON_STACK_WARN bytes of overflowing, or a core's idle
+//     falls under SYSMON_IDLE_WARN_PCT — an IDLE task that
+//     never runs is what trips the task watchdog.
+//   - A task table goes to Serial every SYSMON_REPORT_MS.
+//   - Needs runtime stats + trace facility in the FreeRTOS
+//     config; without them sysmonBegin() logs and returns false.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// =========================================================
+//  SNAPSHOT
+// =========================================================
+static constexpr uint8_t SYSMON_MAX_TASKS = 32;
+static constexpr uint8_t SYSMON_ANY_CORE  = 2;   // task not pinned
+
+struct SysmonTask {
+  char     name[16];
+  uint8_t  core;         // 0, 1 or SYSMON_ANY_CORE
+  uint8_t  prio;
+  uint16_t cpu10;        // % of one core x10, last period
+  uint32_t stackFree;    // bytes, high-water mark
+};
+
+struct SysmonSnapshot {
+  uint32_t   sample;         // 1, 2, ... (0: none yet)
+  uint32_t   periodMs;       // actual span measured
+  uint16_t   coreLoad10[2];  // busy % x10 per core
+  uint8_t    count;          // tasks, busiest first
+  SysmonTask tasks[SYSMON_MAX_TASKS];
+};
+
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool sysmonBegin();
+
+// True with a newer snapshot than last call; `s` stays valid
+// until the next call (UI task only)
+bool sysmonLatest(const SysmonSnapshot*& s);
+
+// "CPU 41/87%  stk 412 audio"
+void sysmonLine(const SysmonSnapshot& s, char* out, size_t n);
+
+// ======================= End of File =======================
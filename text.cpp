@@ -0,0 +1,421 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  text.cpp — UTF-8 Text + Paged Glyphs from SD
+//
+//  Font file (GNU Unifont .hex):
+//   - One glyph per line, "XXXX:<bitmap hex>", sorted by code
+//     point; 32 hex digits = 8x16, 64 = 16x16, 1 bpp, rows top
+//     to bottom, MSB = leftmost pixel.
+//   - A page is the 256 code points sharing the high byte. Its
+//     first line is found by binary search over file offsets
+//     (~24 short reads, once per page per boot: the offset is
+//     kept), then the page is read in one sequential pass.
+//
+//  Caches (PSRAM):
+//   - Pages: TEXT_PAGE_SLOTS raw 1-bpp pages, least recently
+//     used one is replaced.
+//   - Glyphs: TEXT_GLYPH_SLOTS glyphs at a given pixel height,
+//     4 bpp, hashed on (code point, height) with an LRU list.
+//     The nodes come from a Pool (internal SRAM); a full pool
+//     recycles the least recently used one. Bitmaps stay in
+//     PSRAM, one per pool index.
+//     Each pixel is the coverage of a 4x4 grid of samples of
+//     the source bitmap, so any height from 8 to
+//     TEXT_GLYPH_MAX_PX stays smooth; drawing is blendMask4().
+// =========================================================
+
+#include "text.h"
+#include "config.h"
+#include "blend.h"
+#include "arena.h"
+#include "sdcard.h"
+#include <SD.h>
+
+// =========================================================
+//  MODULE STATE
+// =========================================================
+static constexpr uint32_t OFF_NONE   = 0xFFFFFFFF;   // page offset not searched yet
+static constexpr uint32_t CP_END     = 0xFFFFFFFF;   // past the last line
+static constexpr uint16_t BUCKETS    = 256;
+static constexpr size_t   SLOT_BYTES = (TEXT_GLYPH_MAX_PX + 1) / 2 * TEXT_GLYPH_MAX_PX;
+
+struct GlyphPage {
+  int16_t  index;          // high byte of the code points, -1 = free
+  uint32_t lastUse;
+  uint8_t  width[256];     // 8, 16, or 0 = not in the font
+  uint8_t  bits[256][32];
+};
+
+struct GlyphSlot {
+  uint32_t   cp;
+  uint8_t    px, w;
+  GlyphSlot* prev;         // LRU list, head = most recent
+  GlyphSlot* next;
+  GlyphSlot* chain;        // hash bucket
+};
+
+static int8_t     fontState = 0;       // 0 untried, 1 ready, -1 no font / no memory
+static GlyphPage* pages = nullptr;
+static uint8_t*   slotBits = nullptr;  // PSRAM, SLOT_BYTES per pool index
+static Pool<GlyphSlot, TEXT_GLYPH_SLOTS> glyphPool;
+static GlyphSlot* buckets[BUCKETS];
+static GlyphSlot* lruHead = nullptr;
+static GlyphSlot* lruTail = nullptr;
+static uint32_t   pageOffset[256];
+static uint32_t   useClock = 0;
+static TextStats  stats = {};
+
+// Box for code points the font doesn't have (8x16)
+static const uint8_t TOFU[32] = {
+  0x00, 0x00, 0x7E, 0x42, 0x42, 0x42, 0x42, 0x42,
+  0x42, 0x42, 0x42, 0x42, 0x42, 0x7E, 0x00, 0x00,
+};
+
+
+// =========================================================
+//  UTF-8
+// =========================================================
+uint32_t utf8Next(const char*& p) {
+  const uint8_t* s = (const uint8_t*)p;
+  uint8_t c = s[0];
+  if (c < 0x80) { if (c) p++; return c; }
+
+  int n; uint32_t cp, min;
+  if      ((c & 0xE0) == 0xC0) { n = 1; cp = c & 0x1F; min = 0x80; }
+  else if ((c & 0xF0) == 0xE0) { n = 2; cp = c & 0x0F; min = 0x800; }
+  else if ((c & 0xF8) == 0xF0) { n = 3; cp = c & 0x07; min = 0x10000; }
+  else { p++; return 0xFFFD; }  // stray continuation / invalid lead
+
+  for (int i = 1; i <= n; ++i) {
+    if ((s[i] & 0xC0) != 0x80) { p += i; return 0xFFFD; }  // truncated
+    cp = (cp << 6) | (s[i] & 0x3F);
+  }
+  p += n + 1;
+  if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0xFFFD;
+  return cp;
+}
+
+bool textIsAscii(const char* s) {
+  for (; *s; ++s)
+    if ((uint8_t)*s >= 0x80) return false;
+  return true;
+}
+
+
+// =========================================================
+//  FONT FILE
+// =========================================================
+static int hexVal(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// Code point of the first line starting at or after `pos`,
+// with that line's offset in `start`
+static uint32_t lineAt(File& f, uint32_t pos, uint32_t& start) {
+  uint8_t buf[96];
+  uint32_t base = pos ? pos - 1 : 0;
+  f.seek(base);
+  int n = f.read(buf, sizeof(buf));
+  int i = 0;
+  if (pos) {
+    while (i < n && buf[i] != '\n') i++;
+    i++;
+  }
+  start = base + i;
+  uint32_t cp = 0;
+  int digits = 0;
+  for (; i < n; ++i, ++digits) {
+    int v = hexVal(buf[i]);
+    if (v < 0) break;
+    cp = (cp << 4) | v;
+  }
+  return (digits && i < n && buf[i] == ':') ? cp : CP_END;
+}
+
+static uint32_t findPage(File& f, uint8_t page) {
+  uint32_t target = (uint32_t)page << 8;
+  uint32_t lo = 0, hi = f.size(), start;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (lineAt(f, mid, start) >= target) hi = mid;
+    else lo = mid + 1;
+  }
+  lineAt(f, lo, start);
+  return start;
+}
+
+// Reads every line of `page` into `pg`, starting at `off`
+static void readPage(File& f, uint32_t off, uint8_t page, GlyphPage& pg) {
+  static uint8_t chunk[1024];
+  uint8_t line[80];
+  int len = 0, have = 0, at = 0;
+  memset(pg.width, 0, sizeof(pg.width));
+  f.seek(off);
+
+  for (;;) {
+    if (at == have) {
+      have = f.read(chunk, sizeof(chunk));
+      at = 0;
+      if (have <= 0) break;
+    }
+    uint8_t c = chunk[at++];
+    if (c != '\n') { if (len < (int)sizeof(line)) line[len++] = c; continue; }
+
+    // "XXXX:" then 32 or 64 digits
+    int i = 0; uint32_t cp = 0;
+    for (int v; i < len && (v = hexVal(line[i])) >= 0; ++i) cp = (cp << 4) | v;
+    if (i == len || line[i] != ':') { len = 0; continue; }
+    if ((cp >> 8) != page) break;
+    int digits = len - i - 1;
+    if (line[len - 1] == '\r') digits--;
+    if (digits == 32 || digits == 64) {
+      uint8_t* dst = pg.bits[cp & 0xFF];
+      const uint8_t* h = line + i + 1;
+      for (int b = 0; b < digits / 2; ++b) dst[b] = (uint8_t)(hexVal(h[2 * b]) << 4 | hexVal(h[2 * b + 1]));
+      pg.width[cp & 0xFF] = (uint8_t)(digits / 4);
+    }
+    len = 0;
+  }
+}
+
+static const GlyphPage* getPage(uint8_t page) {
+  GlyphPage* victim = &pages[0];
+  for (uint8_t i = 0; i < TEXT_PAGE_SLOTS; ++i) {
+    GlyphPage& pg = pages[i];
+    if (pg.index == page) { pg.lastUse = ++useClock; return &pg; }
+    if (pg.lastUse < victim->lastUse) victim = &pg;
+  }
+
+  uint32_t t0 = millis();
+  bool ok = false;
+  {
+    SdBus bus;
+    File f = SD.open(TEXT_FONT_PATH, FILE_READ);
+    if (f) {
+      if (pageOffset[page] == OFF_NONE) pageOffset[page] = findPage(f, page);
+      readPage(f, pageOffset[page], page, *victim);
+      f.close();
+      ok = true;
+    }
+  }
+  if (!ok) return nullptr;
+
+  victim->index = page;
+  victim->lastUse = ++useClock;
+  stats.pageLoads++;
+  DBG_IF(TEXT, "[Text] Page U+%02Xxx loaded in %lu ms\n", page, millis() - t0);
+  return victim;
+}
+
+
+// =========================================================
+//  GLYPH CACHE
+// =========================================================
+static bool textInit() {
+  if (fontState) return fontState > 0;
+  fontState = -1;
+
+  bool present;
+  {
+    SdBus bus;
+    present = SD.exists(TEXT_FONT_PATH);
+  }
+  if (!present) {
+    DBG_IF(TEXT, "[Text] %s not found; non-ASCII shows as '?'\n", TEXT_FONT_PATH);
+    return false;
+  }
+
+  pages    = (GlyphPage*)ps_malloc(sizeof(GlyphPage) * TEXT_PAGE_SLOTS);
+  slotBits = (uint8_t*)ps_malloc(SLOT_BYTES * TEXT_GLYPH_SLOTS);
+  if (!pages || !slotBits) {
+    free(pages); free(slotBits);
+    pages = nullptr; slotBits = nullptr;
+    DBG_IF(TEXT, "[Text] No PSRAM for the glyph caches\n");
+    return false;
+  }
+
+  for (uint8_t i = 0; i < TEXT_PAGE_SLOTS; ++i) { pages[i].index = -1; pages[i].lastUse = 0; }
+  for (auto& b : buckets) b = nullptr;
+  for (auto& o : pageOffset) o = OFF_NONE;
+
+  fontState = 1;
+  DBG_IF(TEXT, "[Text] Glyphs from %s: %u pages, %u glyphs cached\n",
+         TEXT_FONT_PATH, TEXT_PAGE_SLOTS, TEXT_GLYPH_SLOTS);
+  return true;
+}
+
+static uint16_t hashOf(uint32_t cp, uint8_t px) { return (uint16_t)((cp * 31 + px) & (BUCKETS - 1)); }
+
+static void lruUnlink(GlyphSlot* s) {
+  if (s->prev) s->prev->next = s->next; else lruHead = s->next;
+  if (s->next) s->next->prev = s->prev; else lruTail = s->prev;
+}
+
+static void lruPushFront(GlyphSlot* s) {
+  s->prev = nullptr;
+  s->next = lruHead;
+  if (lruHead) lruHead->prev = s;
+  lruHead = s;
+  if (!lruTail) lruTail = s;
+}
+
+// srcW x 16 at 1 bpp → w x px at 4 bpp
+static void rasterize(const uint8_t* bits, uint8_t srcW, uint8_t px, uint8_t w, uint8_t* out) {
+  const int stride = (w + 1) / 2;
+  const int bpr = srcW / 8;
+  memset(out, 0, (size_t)stride * px);
+  for (int ty = 0; ty < px; ++ty) {
+    for (int tx = 0; tx < w; ++tx) {
+      int cov = 0;
+      for (int i = 0; i < 4; ++i) {
+        int sy = ((ty * 4 + i) * 2 + 1) * 16 / (px * 8);
+        const uint8_t* row = bits + sy * bpr;
+        for (int j = 0; j < 4; ++j) {
+          int sx = ((tx * 4 + j) * 2 + 1) * srcW / (w * 8);
+          cov += (row[sx >> 3] >> (7 - (sx & 7))) & 1;
+        }
+      }
+      uint8_t nib = (uint8_t)min(cov, 15);
+      out[ty * stride + tx / 2] |= (tx & 1) ? nib : (uint8_t)(nib << 4);
+    }
+  }
+}
+
+static const GlyphSlot* getGlyph(uint32_t cp, uint8_t px) {
+  uint16_t h = hashOf(cp, px);
+  for (GlyphSlot* s = buckets[h]; s; s = s->chain) {
+    if (s->cp == cp && s->px == px) {
+      stats.hits++;
+      if (s != lruHead) { lruUnlink(s); lruPushFront(s); }
+      return s;
+    }
+  }
+  stats.misses++;
+
+  // Source bitmap (or the box if the font lacks it)
+  const uint8_t* bits = TOFU;
+  uint8_t srcW = 8;
+  const GlyphPage* pg = (cp <= 0xFFFF) ? getPage((uint8_t)(cp >> 8)) : nullptr;
+  if (pg && pg->width[cp & 0xFF]) {
+    bits = pg->bits[cp & 0xFF];
+    srcW = pg->width[cp & 0xFF];
+  } else {
+    stats.missing++;
+  }
+
+  // A free node, or the least recently used one recycled
+  if (glyphPool.inUse() == TEXT_GLYPH_SLOTS) {
+    GlyphSlot* old = lruTail;
+    GlyphSlot** link = &buckets[hashOf(old->cp, old->px)];
+    while (*link != old) link = &(*link)->chain;
+    *link = old->chain;
+    lruUnlink(old);
+    glyphPool.destroy(old);
+  }
+  uint8_t w = (uint8_t)max(1, (srcW * px + 8) / 16);
+  GlyphSlot* s = glyphPool.make(GlyphSlot{ cp, px, w, nullptr, nullptr, buckets[h] });
+  rasterize(bits, srcW, px, w, slotBits + (size_t)glyphPool.indexOf(s) * SLOT_BYTES);
+  buckets[h] = s;
+  lruPushFront(s);
+  return s;
+}
+
+static const uint8_t* glyphBits(const GlyphSlot* g) { return slotBits + (size_t)glyphPool.indexOf(g) * SLOT_BYTES; }
+
+
+// =========================================================
+//  DRAWING
+// =========================================================
+static uint8_t glyphPx(TFT_eSprite& spr) {
+  return (uint8_t)constrain((int)spr.fontHeight(), 8, (int)TEXT_GLYPH_MAX_PX);
+}
+
+// Non-ASCII as '?', for when there is no font to draw it with
+// (into a stack buffer; longer than a screen is cut off)
+static constexpr size_t FALLBACK_MAX = 128;
+
+static const char* asciiFallback(const char* s, char* out) {
+  size_t n = 0;
+  for (const char* p = s; *p && n < FALLBACK_MAX - 1; ) {
+    uint32_t cp = utf8Next(p);
+    out[n++] = (cp < 0x80) ? (char)cp : '?';
+  }
+  out[n] = 0;
+  return out;
+}
+
+static void drawGlyph(TFT_eSprite& spr, const GlyphSlot* g, int32_t x, int32_t y, uint16_t fg) {
+  const int16_t W = spr.width(), H = spr.height();
+  uint16_t* fb = (uint16_t*)spr.getPointer();
+  const uint8_t* mask = glyphBits(g);
+  const int stride = (g->w + 1) / 2;
+  const bool inside = (x >= 0 && x + g->w <= W);
+
+  for (int r = 0; r < g->px; ++r, mask += stride) {
+    int32_t yy = y + r;
+    if (yy < 0 || yy >= H) continue;
+    uint16_t* dst = fb + (size_t)yy * W + x;
+    if (inside) { blendMask4(dst, mask, g->w, fg, true); continue; }
+
+    // Clipped at the sprite edge: pixel by pixel
+    for (int c = 0; c < g->w; ++c) {
+      if (x + c < 0 || x + c >= W) continue;
+      uint8_t nib = (mask[c >> 1] >> ((c & 1) ? 0 : 4)) & 0x0F;
+      if (!nib) continue;
+      uint16_t p = dst[c];
+      p = blendPixel(fg, (uint16_t)((p >> 8) | (p << 8)), (uint8_t)(nib * 17));
+      dst[c] = (uint16_t)((p >> 8) | (p << 8));
+    }
+  }
+}
+
+int16_t textWidth(TFT_eSprite& spr, const char* s) {
+  char buf[FALLBACK_MAX];
+  if (textIsAscii(s)) return spr.textWidth(s);
+  if (!textInit()) return spr.textWidth(asciiFallback(s, buf));
+
+  uint8_t px = glyphPx(spr);
+  int32_t w = 0;
+  for (const char* p = s; *p; ) {
+    uint32_t cp = utf8Next(p);
+    if (cp >= 0x20) w += getGlyph(cp, px)->w;
+  }
+  return (int16_t)min<int32_t>(w, INT16_MAX);
+}
+
+void textDraw(TFT_eSprite& spr, const char* s, int32_t x, int32_t y, uint16_t fg) {
+  char buf[FALLBACK_MAX];
+  if (textIsAscii(s)) { spr.drawString(s, x, y); return; }
+  if (!textInit() || !spr.created()) { spr.drawString(asciiFallback(s, buf), x, y); return; }
+
+  // TL..BR are 0..8 (row-major); the baseline datums 9..11 sit
+  // on the bottom edge here
+  uint8_t datum = spr.getTextDatum();
+  int hd = datum < 9 ? datum % 3 : datum - 9;
+  int vd = datum < 9 ? datum / 3 : 2;
+  uint8_t px = glyphPx(spr);
+  int16_t w = textWidth(spr, s);
+  x -= (hd == 1) ? w / 2 : (hd == 2 ? w : 0);
+  y -= (vd == 1) ? px / 2 : (vd == 2 ? px : 0);
+
+  for (const char* p = s; *p; ) {
+    uint32_t cp = utf8Next(p);
+    if (cp < 0x20) continue;
+    const GlyphSlot* g = getGlyph(cp, px);
+    if (x >= spr.width()) break;
+    if (x + g->w > 0) drawGlyph(spr, g, x, y, fg);
+    x += g->w;
+  }
+}
+
+
+// =========================================================
+//  STATS
+// =========================================================
+TextStats textStats() { return stats; }
+
+// ======================= End of File =======================
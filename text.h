@@ -0,0 +1,57 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  text.h — UTF-8 Text + Paged Glyphs from SD (Header)
+//
+//  Provides:
+//   • utf8Next()     — Decode one code point (U+FFFD on junk)
+//   • textDraw()     — drawString() for UTF-8 labels
+//   • textWidth()    — Matching width in pixels
+//   • textStats()    — Cache hits / misses / page loads
+//
+//  Notes:
+//   - Pure ASCII goes straight to the built-in TFT_eSPI fonts,
+//     unchanged. Anything else is drawn from TEXT_FONT_PATH,
+//     a GNU Unifont .hex file (8x16 / 16x16, the whole BMP).
+//   - The file is read in pages of 256 code points into a
+//     small PSRAM LRU; glyphs are scaled to the sprite's font
+//     height once, anti-aliased to 4 bpp, and kept in an LRU
+//     glyph cache. A warm cache never touches the SD card.
+//   - Without the font file, other characters show as '?'.
+//   - Nothing here touches the heap per call: take const char*
+//     (the String overloads just forward).
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// =========================================================
+//  UTF-8
+// =========================================================
+// Advances p past one code point (stops at the terminator)
+uint32_t utf8Next(const char*& p);
+bool     textIsAscii(const char* s);
+
+// =========================================================
+//  DRAWING
+// =========================================================
+// Like spr.drawString(s, x, y): uses the sprite's font size
+// and datum; glyphs are blended over what is already there.
+void    textDraw(TFT_eSprite& spr, const char* s, int32_t x, int32_t y, uint16_t fg);
+int16_t textWidth(TFT_eSprite& spr, const char* s);
+
+inline void textDraw(TFT_eSprite& spr, const String& s, int32_t x, int32_t y, uint16_t fg) {
+  textDraw(spr, s.c_str(), x, y, fg);
+}
+inline int16_t textWidth(TFT_eSprite& spr, const String& s) { return textWidth(spr, s.c_str()); }
+
+// =========================================================
+//  STATS
+// =========================================================
+struct TextStats {
+  uint32_t hits, misses, pageLoads, missing;  // missing: not in the font (drawn as a box)
+};
+TextStats textStats();
+
+// ======================= End of File =======================
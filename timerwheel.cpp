@@ -0,0 +1,393 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  timerwheel.cpp — Timeouts on a Hierarchical Timer Wheel
+//
+//  Timers live in a fixed node array, linked into one of
+//  4 x 64 slot lists (doubly linked, so cancel is an unlink).
+//  A timer due `delta` ticks ahead sits on the lowest level
+//  whose span covers it, in the slot its due tick maps to.
+//  Each time level 0 wraps, the next level-1 slot is moved
+//  down ("cascade"), and so on upwards.
+//
+//  Notes:
+//   - Each level keeps a 64-bit map of non-empty slots: poll
+//     jumps straight to the next occupied tick or cascade, and
+//     timerNextDue() is a rotate + count-trailing-zeros per level.
+//   - Ids carry a generation, so cancelling an id whose timer
+//     already fired (and whose node was reused) does nothing.
+//   - A due slot is detached before its timers run; a timer
+//     cancelled by an earlier callback in the same slot is
+//     skipped, not fired.
+//   - A periodic timer polled late fires once and skips the
+//     periods it missed, keeping its phase.
+//   - Scheduling never polls, so a callback that re-arms itself
+//     can't dispatch other timers from inside its own call.
+//
+//  Host check + benchmark (against a brute-force list):
+//    g++ -O2 -DTIMER_BENCH_MAIN -x c++ timerwheel.cpp -o timer_bench
+// =========================================================
+
+#include "timerwheel.h"
+#include <string.h>
+
+#ifdef ARDUINO
+  #include "config.h"
+#else
+  #include <stdio.h>
+  static constexpr uint16_t TIMER_SLOTS = 32;
+  static uint32_t benchNow = 0;
+  static uint32_t millis() { return benchNow; }
+#endif
+
+// =========================================================
+//  MODULE STATE
+// =========================================================
+static constexpr uint8_t  LEVELS  = 4;
+static constexpr uint8_t  BITS    = 6;
+static constexpr uint8_t  SLOTS   = 1 << BITS;
+static constexpr uint32_t SPAN    = 1u << (BITS * LEVELS);   // ticks the wheel covers
+static constexpr uint16_t NIL     = 0xFFFF;
+static constexpr uint16_t FIRING  = 0xFFFE;                  // detached, about to run
+
+struct TimerNode {
+  uint32_t due;
+  uint32_t period;     // 0 = one-shot
+  TimerFn  fn;         // nullptr: cancelled while FIRING
+  void*    ctx;
+  uint16_t prev, next;
+  uint16_t where;      // level * SLOTS + slot, NIL (free) or FIRING
+  uint16_t gen;
+};
+
+static TimerNode  nodes[TIMER_SLOTS];
+static uint16_t   heads[LEVELS][SLOTS];
+static uint64_t   occupied[LEVELS];
+static uint16_t   freeHead = NIL;
+static uint32_t   cur = 0;          // next tick to process
+static bool       ready = false;
+static TimerStats stats = {};
+
+static inline uint64_t rotr(uint64_t x, uint8_t r) { return r ? (x >> r) | (x << (64 - r)) : x; }
+
+static void init() {
+  for (auto& l : heads)
+    for (auto& h : l) h = NIL;
+  for (uint16_t i = 0; i < TIMER_SLOTS; ++i) {
+    nodes[i].where = NIL;
+    nodes[i].gen = 1;
+    nodes[i].next = (uint16_t)(i + 1 < TIMER_SLOTS ? i + 1 : NIL);
+  }
+  freeHead = 0;
+  cur = millis();
+  ready = true;
+}
+
+
+// =========================================================
+//  SLOT LISTS
+// =========================================================
+static void link(uint16_t i) {
+  TimerNode& n = nodes[i];
+  uint32_t delta = (int32_t)(n.due - cur) > 0 ? n.due - cur : 0;
+  uint32_t at = delta ? n.due : cur;
+  if (delta >= SPAN) {                // re-linked on each cascade until in range
+    delta = SPAN - 1;
+    at = cur + delta;
+  }
+  uint8_t lvl = 0;
+  while (lvl < LEVELS - 1 && delta >= (1u << (BITS * (lvl + 1)))) lvl++;
+  uint8_t slot = (at >> (BITS * lvl)) & (SLOTS - 1);
+
+  n.where = lvl * SLOTS + slot;
+  n.prev = NIL;
+  n.next = heads[lvl][slot];
+  if (n.next != NIL) nodes[n.next].prev = i;
+  heads[lvl][slot] = i;
+  occupied[lvl] |= 1ull << slot;
+}
+
+static void unlink(uint16_t i) {
+  TimerNode& n = nodes[i];
+  uint8_t lvl = n.where / SLOTS, slot = n.where % SLOTS;
+  if (n.prev != NIL) nodes[n.prev].next = n.next;
+  else               heads[lvl][slot] = n.next;
+  if (n.next != NIL) nodes[n.next].prev = n.prev;
+  if (heads[lvl][slot] == NIL) occupied[lvl] &= ~(1ull << slot);
+  n.where = NIL;
+}
+
+static void release(uint16_t i) {
+  TimerNode& n = nodes[i];
+  n.where = NIL;
+  n.gen = (uint16_t)(n.gen + 1 ? n.gen + 1 : 1);   // never 0: ids stay non-zero
+  n.next = freeHead;
+  freeHead = i;
+  stats.live--;
+}
+
+// Takes a slot's whole list off the wheel
+static uint16_t detach(uint8_t lvl, uint8_t slot) {
+  uint16_t i = heads[lvl][slot];
+  heads[lvl][slot] = NIL;
+  occupied[lvl] &= ~(1ull << slot);
+  return i;
+}
+
+static TimerNode* lookup(TimerId id) {
+  uint16_t i = (uint16_t)(id & 0xFFFF) - 1;
+  if (!id || i >= TIMER_SLOTS) return nullptr;
+  TimerNode& n = nodes[i];
+  return (n.gen == (id >> 16) && n.where != NIL && n.fn) ? &n : nullptr;
+}
+
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+static TimerId schedule(uint32_t ms, uint32_t period, TimerFn fn, void* ctx) {
+  if (!ready) init();
+  if (!fn) return 0;
+  if (freeHead == NIL) { stats.full++; return 0; }
+
+  // link() picks the slot relative to the wheel's own tick, so
+  // it needn't be caught up first (and nothing fires from here:
+  // callbacks schedule too). An empty wheel just jumps to now,
+  // sparing the next poll the walk over idle ticks.
+  const uint32_t now = millis();
+  if (!stats.live && (int32_t)(now - cur) > 0) cur = now;
+
+  uint16_t i = freeHead;
+  TimerNode& n = nodes[i];
+  freeHead = n.next;
+  n.due = now + ms;
+  n.period = period;
+  n.fn = fn;
+  n.ctx = ctx;
+  link(i);
+
+  stats.scheduled++;
+  if (++stats.live > stats.peak) stats.peak = stats.live;
+  return (TimerId)n.gen << 16 | (uint32_t)(i + 1);
+}
+
+TimerId timerAfter(uint32_t ms, TimerFn fn, void* ctx) { return schedule(ms, 0, fn, ctx); }
+TimerId timerEvery(uint32_t ms, TimerFn fn, void* ctx) { return schedule(ms, ms ? ms : 1, fn, ctx); }
+
+void timerCancel(TimerId& id) {
+  TimerNode* n = lookup(id);
+  id = 0;
+  if (!n) return;
+  stats.cancelled++;
+  uint16_t i = (uint16_t)(n - nodes);
+  if (n->where == FIRING) { n->fn = nullptr; return; }   // freed by the poll loop
+  unlink(i);
+  release(i);
+}
+
+bool timerPending(TimerId id) { return lookup(id) != nullptr; }
+
+
+// =========================================================
+//  POLL
+// =========================================================
+static void cascade(uint8_t lvl, uint8_t slot) {
+  for (uint16_t i = detach(lvl, slot), next; i != NIL; i = next) {
+    next = nodes[i].next;
+    link(i);
+  }
+}
+
+static void fire(uint8_t slot, uint32_t now) {
+  uint16_t first = detach(0, slot);
+  for (uint16_t i = first; i != NIL; i = nodes[i].next) nodes[i].where = FIRING;
+
+  for (uint16_t i = first, next; i != NIL; i = next) {
+    TimerNode& n = nodes[i];
+    next = n.next;
+    TimerFn fn = n.fn;
+    void*   ctx = n.ctx;
+    if (!fn) { release(i); continue; }                 // cancelled meanwhile
+
+    if (n.period) {
+      n.due += n.period;
+      if ((int32_t)(n.due - now) <= 0)                  // polled late: skip, don't burst
+        n.due += ((now - n.due) / n.period + 1) * n.period;
+      link(i);
+    } else {
+      release(i);
+    }
+    stats.fired++;
+    fn(ctx);
+  }
+}
+
+void timerPoll() {
+  if (!ready) return;
+  const uint32_t now = millis();
+
+  while ((int32_t)(now - cur) >= 0) {
+    // Jump over ticks with nothing to fire, up to the next cascade
+    uint8_t pos = cur & (SLOTS - 1);
+    uint32_t skip = 0;
+    if (pos) {
+      skip = occupied[0] ? (uint32_t)__builtin_ctzll(rotr(occupied[0], pos)) : SLOTS;
+      if (skip > (uint32_t)(SLOTS - pos)) skip = SLOTS - pos;
+    }
+    if (skip) {
+      cur += (skip < now - cur + 1) ? skip : now - cur + 1;
+      continue;
+    }
+
+    if (!pos) {
+      for (uint8_t l = 1; l < LEVELS; ++l) {
+        uint8_t s = (cur >> (BITS * l)) & (SLOTS - 1);
+        cascade(l, s);
+        if (s) break;
+      }
+    }
+    cur++;
+    if (occupied[0] & (1ull << pos)) fire(pos, now);
+  }
+}
+
+uint32_t timerNextDue() {
+  if (!ready || !stats.live) return UINT32_MAX;
+
+  // Earliest tick any level could hand a timer down (or fire it)
+  uint32_t best = UINT32_MAX;
+  for (uint8_t l = 0; l < LEVELS; ++l) {
+    if (!occupied[l]) continue;
+    const uint32_t unit = 1u << (BITS * l);
+    const uint32_t first = l ? (cur + unit - 1) & ~(unit - 1) : cur;
+    const uint8_t  pos = (first >> (BITS * l)) & (SLOTS - 1);
+    const uint32_t ahead = first - cur + (uint32_t)__builtin_ctzll(rotr(occupied[l], pos)) * unit;
+    if (ahead < best) best = ahead;
+  }
+  if (best == UINT32_MAX) return best;   // only FIRING nodes (inside a callback)
+  const uint32_t late = millis() - cur;  // ticks not polled yet
+  return best > late ? best - late : 0;
+}
+
+TimerStats timerStats() { return stats; }
+
+
+// =========================================================
+//  HOST CHECK + BENCHMARK
+// =========================================================
+#ifdef TIMER_BENCH_MAIN
+#include <chrono>
+
+// Every timer fires once it's due, never early, never late
+// past a poll, never after being cancelled; periodic ones
+// skip the periods a late poll missed
+struct Ref { TimerId id; uint32_t due, period; bool live; uint32_t hits; };
+static Ref refs[TIMER_SLOTS];
+static uint32_t errors = 0;
+
+static void onFire(void* ctx) {
+  Ref& r = *(Ref*)ctx;
+  if (!r.live || (int32_t)(benchNow - r.due) < 0) errors++;
+  r.hits++;
+  if (!r.period) { r.live = false; return; }
+  r.due += r.period;
+  if ((int32_t)(r.due - benchNow) <= 0) r.due += ((benchNow - r.due) / r.period + 1) * r.period;
+}
+
+// Callbacks that re-arm themselves and cancel a sibling due a
+// tick after them, polled far apart so several are due at once:
+// none may run inside another, early or late, and no sibling
+// may ever fire
+struct Rearm { TimerId self, sibling; uint32_t due, period, hits; };
+static Rearm rearms[4];
+static bool  inCallback = false;
+
+static void onSibling(void*) { errors++; }
+
+static void onRearm(void* ctx) {
+  Rearm& r = *(Rearm*)ctx;
+  if (inCallback || (int32_t)(benchNow - r.due) < 0) errors++;
+  inCallback = true;
+  r.hits++;
+  timerCancel(r.sibling);
+  r.due = benchNow + r.period;
+  r.self = timerAfter(r.period, onRearm, &r);
+  r.sibling = timerAfter(r.period + 1, onSibling, nullptr);
+  if (!r.self || !r.sibling) errors++;
+  inCallback = false;
+}
+
+static uint32_t rearmCheck(uint32_t steps) {
+  uint32_t before = errors, hits = 0;
+  for (uint32_t k = 0; k < 4; ++k) {
+    Rearm& r = rearms[k];
+    r.period = 3 + k * 17;
+    r.due = benchNow + r.period;
+    r.self = timerAfter(r.period, onRearm, &r);
+    r.sibling = timerAfter(r.period + 1, onSibling, nullptr);
+  }
+  for (uint32_t step = 0; step < steps; ++step) {
+    benchNow += 1 + step % 97;
+    timerPoll();
+    for (auto& r : rearms) if ((int32_t)(r.due - benchNow) <= 0) errors++;   // missed
+  }
+  for (auto& r : rearms) {
+    hits += r.hits;
+    timerCancel(r.self);
+    timerCancel(r.sibling);
+  }
+  printf("[Timer] %s: %u self re-arms, each cancelling a sibling\n",
+         errors == before ? "no nested, early, missed or cancelled fires" : "ERRORS", (unsigned)hits);
+  return errors - before;
+}
+
+int main() {
+  uint32_t rng = 12345;
+  auto rnd = [&](uint32_t n) { rng = rng * 1664525u + 1013904223u; return (rng >> 8) % n; };
+
+  benchNow = 0xFFFF0000u;   // wrap millis() part-way through
+  uint64_t ops = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t step = 0; step < 2000000; ++step) {
+    Ref& r = refs[rnd(TIMER_SLOTS)];
+    switch (rnd(4)) {
+      case 0:
+        if (r.live) { timerCancel(r.id); r.live = false; }
+        break;
+      case 1: case 2:
+        if (!r.live) {
+          uint32_t ms = 1 + (rnd(8) ? rnd(300) : rnd(20000000));   // mostly UI-scale, some hours out
+          r.period = rnd(4) ? 0 : 1 + rnd(500);
+          r.due = benchNow + (r.period ? r.period : ms);
+          r.id = r.period ? timerEvery(r.period, onFire, &r) : timerAfter(ms, onFire, &r);
+          r.live = r.id != 0;
+        }
+        break;
+      default: {
+        // Sleep as the loop would: to the next deadline, or less
+        uint32_t due = timerNextDue();
+        uint32_t earliest = UINT32_MAX;
+        for (auto& x : refs) if (x.live && x.due - benchNow < earliest) earliest = x.due - benchNow;
+        if (due > earliest) errors++;           // would oversleep a deadline
+        benchNow += rnd(4) ? rnd(10) : rnd(2000);
+        timerPoll();
+        for (auto& x : refs) if (x.live && (int32_t)(x.due - benchNow) <= 0) errors++;  // missed
+      }
+    }
+    ops++;
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  TimerStats s = timerStats();
+  printf("[Timer] %s: %llu ops in %.2f s (%.0f ns/op); %u scheduled, %u fired, %u cancelled, "
+         "peak %u of %u\n", errors ? "ERRORS" : "no early, missed or stale fires", (unsigned long long)ops,
+         secs, secs * 1e9 / ops, (unsigned)s.scheduled, (unsigned)s.fired, (unsigned)s.cancelled,
+         (unsigned)s.peak, (unsigned)TIMER_SLOTS);
+  if (errors) printf("[Timer] %u errors\n", (unsigned)errors);
+
+  for (auto& x : refs) if (x.live) timerCancel(x.id);
+  rearmCheck(100000);
+  return errors ? 1 : 0;
+}
+#endif
+
+// ======================= End of File =======================
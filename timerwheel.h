@@ -0,0 +1,53 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  timerwheel.h — Timeouts on a Hierarchical Timer Wheel (Header)
+//
+//  Provides:
+//   • timerAfter()    — Call fn(ctx) once, ms from now
+//   • timerEvery()    — Call fn(ctx) every ms
+//   • timerCancel()   — O(1); safe on stale or fired ids
+//   • timerPoll()     — Dispatch everything due (loop task)
+//   • timerNextDue()  — ms until the next timer could fire, so
+//                       the loop can sleep instead of spinning
+//
+//  Notes:
+//   - 1 ms ticks (millis()), four levels of 64 slots: level 0
+//     holds the next 64 ms, each level above 64x more, ~4.6 h
+//     in all; longer delays are re-armed when they get there.
+//   - Scheduling and cancelling are O(1); poll skips empty
+//     ticks, and a timer is moved down a level at most 3 times.
+//   - Callbacks run inside timerPoll() on the loop task and may
+//     schedule or cancel any timer, their own included.
+//   - TIMER_SLOTS timers at once; when full, timerAfter()
+//     returns 0 and the caller does the work straight away.
+// =========================================================
+
+#pragma once
+#include <stdint.h>
+
+// =========================================================
+//  TYPES
+// =========================================================
+typedef uint32_t TimerId;             // 0 = none
+typedef void (*TimerFn)(void* ctx);
+
+struct TimerStats {
+  uint32_t scheduled, fired, cancelled, full;
+  uint16_t live, peak;
+};
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+TimerId timerAfter(uint32_t ms, TimerFn fn, void* ctx);
+TimerId timerEvery(uint32_t ms, TimerFn fn, void* ctx);
+void    timerCancel(TimerId& id);     // and sets id to 0
+bool    timerPending(TimerId id);
+
+void     timerPoll();
+uint32_t timerNextDue();              // UINT32_MAX: nothing scheduled
+
+TimerStats timerStats();
+
+// ======================= End of File =======================
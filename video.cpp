@@ -0,0 +1,653 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  video.cpp — MJPEG Video Player
+//
+//  Pipeline (one frame in each stage at once):
+//   • Core 1 (loop): reads chunks from SD into VIDEO_SLOTS
+//     compressed-frame slots (read-ahead), stages audio, and
+//     DMA-pushes the last decoded frame to the panel.
+//   • Core 0 (decoder task): JPEG → RGB565 into one of two
+//     PSRAM frames while core 1 pushes the other.
+//
+//  Timing:
+//   - Frame N is due at N x dwMicroSecPerFrame after start.
+//     A frame already past its slot is skipped unread (SD
+//     seek), dropped before decoding, or — if a newer frame is
+//     ready too — dropped before presenting.
+//   - Audio is staged as mono PCM and fed to the audio queue
+//     up to SYNC_FILL_TARGET; if it drifts VIDEO_AV_SLACK_MS
+//     from the picture it is trimmed or held back.
+//
+//  Notes:
+//   - TFT and SD share the SPI pins, so every SD read and
+//     every panel push happens on core 1; the decoder only
+//     touches memory.
+//   - The decoder's counters reach core 1 as one Seqlock
+//     snapshot (channel.h), so a log line never pairs a new
+//     frame count with an old decode time.
+//   - JPEG decoding is the TJpgDec in the ESP32-S3 mask ROM:
+//     baseline only, output RGB888, scale 1/1 … 1/8.
+//   - RGB888 → RGB565 goes through dither.h (VIDEO_DITHER).
+//     Ordered works per MCU block; Floyd–Steinberg needs rows
+//     in order, so blocks are gathered into one MCU-row strip
+//     first.
+// =========================================================
+
+#include "video.h"
+#include "config.h"
+#include "controls.h"
+#include "MenuUI.h"
+#include "audio.h"
+#include "dither.h"
+#include "channel.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp32s3/rom/tjpgd.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <TFT_eSPI.h>
+#include "sdcard.h"
+#include <SD.h>
+
+extern TFT_eSPI tft;
+
+static_assert((VIDEO_AUDIO_STAGE & (VIDEO_AUDIO_STAGE - 1)) == 0,
+              "VIDEO_AUDIO_STAGE must be a power of two");
+
+// =========================================================
+//  STATE
+// =========================================================
+// A slot or frame buffer index plus the frame number in it
+struct Job {
+  int8_t   idx;
+  uint32_t frame;
+};
+
+static constexpr uint8_t NO_STREAM = 0xFF;
+
+// Container
+static File     file;
+static uint32_t moviEnd = 0;
+static bool     eof = false;
+static uint8_t  vStream = NO_STREAM, aStream = NO_STREAM;
+static uint32_t usPerFrame = 0, totalFrames = 0, nextFrame = 0;
+static uint16_t srcW = 0, srcH = 0;
+
+// Picture
+static uint8_t  scale = 0;              // JPEG 1 / (1 << scale)
+static int16_t  fbW = 0, fbH = 0, dstX = 0, dstY = 0;
+static bool     swapWas = false;
+
+// Audio
+static uint16_t aChannels = 0, aBits = 0;
+static uint32_t aRate = 0;
+static float    aRatio = 1.0f;
+static int16_t* stage = nullptr;        // mono PCM at aRate
+static uint32_t stageHead = 0, stageTail = 0;
+static uint8_t* chunkBuf = nullptr;     // raw audio read buffer
+static uint64_t aFed = 0;               // source samples sent to the queue
+
+// Pipeline
+static uint8_t*      slots[VIDEO_SLOTS] = {};
+static uint32_t      slotLen[VIDEO_SLOTS] = {};
+static uint16_t*     frames[2] = {};
+static uint16_t*     ring[2] = {};      // DMA blocks, internal SRAM
+static DitherFs      diffuse;           // decoder task only
+static uint8_t*      strip = nullptr;   // RGB888 MCU row for diffuse
+static QueueHandle_t freeSlots = nullptr, toDecode = nullptr;
+static QueueHandle_t freeFrames = nullptr, decoded = nullptr;
+static TaskHandle_t  waiter = nullptr;
+static bool          decoderUp = false;  // videoStop() joins it
+static volatile bool quitting = false;
+static volatile bool started = false;
+static volatile int64_t startUs = 0;
+static bool          running = false;
+
+// Stats — the decoder's are published as one snapshot
+struct DecodeStats {
+  uint32_t decodeUs, decoded, dropped, bad;
+};
+static Seqlock<DecodeStats> decodeStats;
+static uint32_t statPushUs = 0, statReadUs = 0, shown = 0, dropRead = 0, dropPresent = 0;
+static uint32_t logShown = 0, logDecoded = 0, logDecodeUs = 0, logPushUs = 0, logReadUs = 0;
+static int64_t  logAt = 0;
+
+static int64_t nowUs() { return esp_timer_get_time() - startUs; }
+static int64_t dueUs(uint32_t frame) { return (int64_t)frame * usPerFrame; }
+
+
+// =========================================================
+//  AVI CONTAINER
+// =========================================================
+static bool rd(void* p, size_t n) { return file.read((uint8_t*)p, n) == n; }
+static bool is(const char* id, const char* cc) { return memcmp(id, cc, 4) == 0; }
+static uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t le32(const uint8_t* p) { return le16(p) | ((uint32_t)le16(p + 2) << 16); }
+
+// strl: strh says what the stream is, strf how it's coded
+static void parseStream(uint32_t end, uint8_t index) {
+  char type[4] = {};
+  char id[4];
+  uint8_t hdr[20];
+  uint32_t size;
+  while (file.position() + 8 <= end && rd(id, 4) && rd(&size, 4)) {
+    uint32_t next = file.position() + size + (size & 1);
+    if (is(id, "strh") && size >= 4) {
+      rd(type, 4);
+    } else if (is(id, "strf") && size >= 16 && rd(hdr, 16)) {
+      // BITMAPINFOHEADER: biCompression at 16 / WAVEFORMATEX
+      if (is(type, "vids") && vStream == NO_STREAM && size >= 20 && rd(hdr + 16, 4) &&
+          is((const char*)hdr + 16, "MJPG")) {
+        vStream = index;
+      } else if (is(type, "auds") && aStream == NO_STREAM && le16(hdr) == 1) {
+        aChannels = le16(hdr + 2);
+        aRate     = le32(hdr + 4);
+        aBits     = le16(hdr + 14);
+        if ((aBits == 8 || aBits == 16) && (aChannels == 1 || aChannels == 2) && aRate)
+          aStream = index;
+      }
+    }
+    file.seek(next);
+  }
+}
+
+// Walks RIFF → hdrl (avih, strl…) up to the start of movi
+static bool openAvi(const char* path) {
+  file = SD.open(path, FILE_READ);
+  if (!file) return false;
+
+  char id[4], form[4];
+  uint32_t size;
+  if (!rd(id, 4) || !rd(&size, 4) || !rd(form, 4) || !is(id, "RIFF") || !is(form, "AVI "))
+    return false;
+
+  uint8_t streams = 0;
+  while (rd(id, 4) && rd(&size, 4)) {
+    uint32_t start = file.position();
+    uint32_t next  = start + size + (size & 1);
+    if (is(id, "LIST") && rd(form, 4)) {
+      if (is(form, "movi")) {
+        moviEnd = start + size;
+        return vStream != NO_STREAM && srcW && srcH;
+      }
+      if (is(form, "hdrl")) continue;  // its chunks follow inline
+      if (is(form, "strl")) parseStream(next, streams++);
+    } else if (is(id, "avih") && size >= 40) {
+      uint8_t h[40];
+      rd(h, 40);
+      usPerFrame  = le32(h);
+      totalFrames = le32(h + 16);
+      srcW        = le32(h + 32);
+      srcH        = le32(h + 36);
+    }
+    file.seek(next);
+  }
+  return false;
+}
+
+// Converts one audio chunk to mono 16-bit and stages it
+static void stageAudio(uint32_t size) {
+  uint32_t frameBytes = aChannels * aBits / 8;
+  while (size >= frameBytes) {
+    uint32_t n = (size < VIDEO_AUDIO_CHUNK ? size : VIDEO_AUDIO_CHUNK) / frameBytes * frameBytes;
+    if (!rd(chunkBuf, n)) return;
+    size -= n;
+
+    for (uint32_t i = 0, count = n / frameBytes; i < count; ++i) {
+      int32_t s;
+      if (aBits == 16) {
+        const int16_t* p = (const int16_t*)chunkBuf + i * aChannels;
+        s = aChannels == 2 ? (p[0] + p[1]) >> 1 : p[0];
+      } else {
+        const uint8_t* p = chunkBuf + i * aChannels;
+        s = ((aChannels == 2 ? (p[0] + p[1]) >> 1 : p[0]) - 128) << 8;
+      }
+      if (stageHead - stageTail < VIDEO_AUDIO_STAGE)
+        stage[stageHead++ & (VIDEO_AUDIO_STAGE - 1)] = (int16_t)s;
+    }
+  }
+}
+
+// Reads chunks until the next frame that can still make its
+// deadline lands in `slot`. Audio is staged on the way; late
+// frames are seeked over without being read.
+static bool readFrame(int8_t slot, uint32_t& frame) {
+  char id[4];
+  uint32_t size;
+  while (file.position() + 8 <= moviEnd && rd(id, 4) && rd(&size, 4)) {
+    if (is(id, "LIST")) { file.seek(file.position() + 4); continue; }  // 'rec ' group
+    uint32_t next   = file.position() + size + (size & 1);
+    uint8_t  stream = (uint8_t)((id[0] - '0') * 10 + (id[1] - '0'));
+
+    if (stream == vStream && id[2] == 'd') {
+      frame = nextFrame++;
+      bool late = started && nowUs() > dueUs(frame + 1);
+      if (late || size == 0 || size > VIDEO_SLOT_KB * 1024) {
+        dropRead++;
+        file.seek(next);
+        continue;
+      }
+      if (!rd(slots[slot], size)) break;
+      slotLen[slot] = size;
+      if (size & 1) file.seek(next);
+      return true;
+    }
+    if (stream == aStream && id[2] == 'w' && stage) stageAudio(size);
+    file.seek(next);
+  }
+  eof = true;
+  return false;
+}
+
+// Fills up to `count` free slots and queues them for decoding
+static void readAhead(int count) {
+  if (eof) return;
+  uint32_t t0 = micros();
+  int8_t slot;
+
+  {
+    SdBus bus;
+    while (count-- > 0 && !eof && xQueueReceive(freeSlots, &slot, 0)) {
+      Job job = { slot, 0 };
+      if (readFrame(slot, job.frame)) xQueueSend(toDecode, &job, 0);
+      else                            xQueueSend(freeSlots, &slot, 0);
+    }
+  }
+  statReadUs += micros() - t0;
+}
+
+
+// =========================================================
+//  DECODER (core 0)
+// =========================================================
+struct JpegSrc {
+  const uint8_t* data;
+  uint32_t       len, pos;
+  uint16_t*      out;
+};
+
+static UINT jpegIn(JDEC* jd, BYTE* buf, UINT n) {
+  JpegSrc& s = *(JpegSrc*)jd->device;
+  if (n > s.len - s.pos) n = s.len - s.pos;
+  if (buf) memcpy(buf, s.data + s.pos, n);
+  s.pos += n;
+  return n;
+}
+
+// One MCU block of RGB888 → byte-swapped RGB565 (DMA order)
+static UINT jpegOut(JDEC* jd, void* bitmap, JRECT* r) {
+  JpegSrc& s = *(JpegSrc*)jd->device;
+  const uint8_t* px = (const uint8_t*)bitmap;
+  int w = r->right - r->left + 1;
+  int n = min(w, fbW - (int)r->left);
+
+  if (!strip) {
+    for (int y = r->top; y <= r->bottom && y < fbH && n > 0; ++y, px += w * 3) {
+      uint16_t* dst = s.out + y * fbW + r->left;
+      if (VIDEO_DITHER == (uint8_t)DitherMode::ORDERED) ditherOrderedRow(px, dst, n, r->left, y, true);
+      else                                              ditherTruncRow(px, dst, n, true);
+    }
+    return 1;
+  }
+
+  // Floyd–Steinberg: gather the MCU row, diffuse once it's whole
+  for (int y = r->top; y <= r->bottom && n > 0; ++y, px += w * 3)
+    memcpy(strip + ((y - r->top) * fbW + r->left) * 3, px, n * 3);
+  if (r->right + 1 < (int)((jd->width + (1 << scale) - 1) >> scale)) return 1;
+  for (int y = r->top; y <= r->bottom && y < fbH; ++y)
+    ditherFsRow(diffuse, strip + (y - r->top) * fbW * 3, s.out + y * fbW, fbW, true);
+  return 1;
+}
+
+static void decoderTask(void*) {
+  static uint8_t pool[VIDEO_JPEG_POOL];  // TJpgDec work area
+  DecodeStats st = {};
+  Job job;
+
+  while (!quitting) {
+    if (!xQueueReceive(toDecode, &job, pdMS_TO_TICKS(20))) continue;
+    if (started && nowUs() > dueUs(job.frame + 1)) {
+      st.dropped++;
+      decodeStats.write(st);
+      xQueueSend(freeSlots, &job.idx, 0);
+      continue;
+    }
+
+    int8_t fb = -1;
+    while (!quitting && !xQueueReceive(freeFrames, &fb, pdMS_TO_TICKS(20))) {}
+    if (quitting) break;
+
+    uint32_t t0 = micros();
+    JpegSrc src = { slots[job.idx], slotLen[job.idx], 0, frames[fb] };
+    JDEC jd;
+    ditherFsReset(diffuse);
+    bool ok = jd_prepare(&jd, jpegIn, pool, sizeof(pool), &src) == JDR_OK &&
+              jd_decomp(&jd, jpegOut, scale) == JDR_OK;
+
+    // Frame first, then the slot: an empty slot queue must
+    // never look like "nothing left in flight"
+    if (ok) {
+      st.decodeUs += micros() - t0;
+      st.decoded++;
+      decodeStats.write(st);
+      Job out = { fb, job.frame };
+      xQueueSend(decoded, &out, 0);
+    } else {
+      st.bad++;
+      decodeStats.write(st);
+      xQueueSend(freeFrames, &fb, 0);
+    }
+    xQueueSend(freeSlots, &job.idx, 0);
+    vTaskDelay(1);  // let IDLE0 feed the task watchdog
+  }
+
+  xTaskNotifyGive(waiter);
+  vTaskDelete(nullptr);
+}
+
+
+// =========================================================
+//  PRESENT + AUDIO (core 1)
+// =========================================================
+// Streams a frame through two internal DMA blocks: block N is
+// copied out of PSRAM while block N-1 is on the wire.
+static void present(int8_t fb) {
+  uint32_t t0 = micros();
+  const uint16_t* src = frames[fb];
+  uint8_t b = 0;
+
+  tft.startWrite();
+  tft.setAddrWindow(dstX, dstY, fbW, fbH);
+  for (int y = 0; y < fbH; y += SCANOUT_BLOCK_LINES) {
+    int lines = min((int)SCANOUT_BLOCK_LINES, fbH - y);
+    memcpy(ring[b], src + (size_t)y * fbW, (size_t)lines * fbW * sizeof(uint16_t));
+    tft.pushPixelsDMA(ring[b], (uint32_t)lines * fbW);  // waits for the previous block
+    b ^= 1;
+  }
+  tft.dmaWait();
+  tft.endWrite();
+  statPushUs += micros() - t0;
+}
+
+static void feedAudio() {
+  if (!stage || !started) return;
+
+  // Where the DAC is against where the picture is
+  uint32_t outRate = audioSampleRate();
+  uint32_t queued  = (uint32_t)(audioFill() * AUDIO_RING_SAMPLES);
+  int64_t  heardUs = (int64_t)(aFed * 1000000ULL / aRate) - (int64_t)queued * 1000000 / outRate;
+  int64_t  drift   = heardUs - nowUs();
+  uint32_t staged  = stageHead - stageTail;
+
+  if (drift < -(int64_t)VIDEO_AV_SLACK_MS * 1000) {
+    uint32_t n = (uint32_t)min<int64_t>(-drift * aRate / 1000000, staged);
+    stageTail += n;
+    aFed += n;
+    staged -= n;
+  } else if (drift > (int64_t)VIDEO_AV_SLACK_MS * 1000) {
+    return;
+  }
+
+  uint32_t target = (uint32_t)(SYNC_FILL_TARGET * AUDIO_RING_SAMPLES);
+  if (queued >= target) return;
+  uint32_t n = min<uint32_t>((uint32_t)((target - queued) / aRatio), staged);
+  while (n) {
+    uint32_t at    = stageTail & (VIDEO_AUDIO_STAGE - 1);
+    uint32_t piece = min<uint32_t>(n, VIDEO_AUDIO_STAGE - at);
+    audioWriteResampled(stage + at, piece, aRatio);
+    stageTail += piece;
+    aFed += piece;
+    n -= piece;
+  }
+}
+
+static void logStats() {
+  int64_t now = nowUs();
+  if (now - logAt < 5000000) return;
+  float secs = (now - logAt) / 1e6f;
+  const DecodeStats st = decodeStats.read();
+  uint32_t n = shown - logShown, d = st.decoded - logDecoded;
+
+  DBG_IF(VIDEO, "[Video] %.1f FPS at %dx%d (source %.2f), decode %.1f ms, push %.1f ms, read %.1f ms per frame, "
+                "dropped %lu read / %lu decode / %lu present, underruns %lu\n",
+         secs > 0 ? n / secs : 0.0f, fbW, fbH, 1e6f / usPerFrame,
+         d ? (st.decodeUs - logDecodeUs) / 1000.0f / d : 0.0f,
+         n ? (statPushUs - logPushUs) / 1000.0f / n : 0.0f,
+         n ? (statReadUs - logReadUs) / 1000.0f / n : 0.0f,
+         (unsigned long)dropRead, (unsigned long)st.dropped, (unsigned long)dropPresent,
+         (unsigned long)audioUnderruns());
+
+  logAt = now;
+  logShown = shown;
+  logDecoded = st.decoded;
+  logDecodeUs = st.decodeUs;
+  logPushUs = statPushUs;
+  logReadUs = statReadUs;
+}
+
+
+// =========================================================
+//  BUFFERS
+// =========================================================
+static void freePipeline() {
+  for (int i = 0; i < VIDEO_SLOTS; ++i) { free(slots[i]); slots[i] = nullptr; }
+  for (int i = 0; i < 2; ++i) {
+    free(frames[i]);
+    heap_caps_free(ring[i]);
+    frames[i] = ring[i] = nullptr;
+  }
+  free(stage);
+  free(chunkBuf);
+  free(strip);
+  ditherFsEnd(diffuse);
+  stage = nullptr;
+  chunkBuf = nullptr;
+  strip = nullptr;
+
+  QueueHandle_t* queues[] = { &freeSlots, &toDecode, &freeFrames, &decoded };
+  for (QueueHandle_t* q : queues) {
+    if (*q) vQueueDelete(*q);
+    *q = nullptr;
+  }
+}
+
+static bool allocPipeline() {
+  size_t frameBytes = (size_t)fbW * fbH * sizeof(uint16_t);
+  size_t blockBytes = (size_t)fbW * SCANOUT_BLOCK_LINES * sizeof(uint16_t);
+  for (int i = 0; i < VIDEO_SLOTS; ++i)
+    if (!(slots[i] = (uint8_t*)ps_malloc(VIDEO_SLOT_KB * 1024))) return false;
+  for (int i = 0; i < 2; ++i) {
+    if (!(frames[i] = (uint16_t*)ps_malloc(frameBytes))) return false;
+    ring[i] = (uint16_t*)heap_caps_malloc(blockBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!ring[i]) return false;
+  }
+
+  // MCU rows are at most 16 lines (1/1 scale, 4:2:0)
+  if (VIDEO_DITHER == (uint8_t)DitherMode::DIFFUSION) {
+    if (!(strip = (uint8_t*)ps_malloc((size_t)fbW * 16 * 3)) || !ditherFsBegin(diffuse, fbW)) return false;
+  }
+
+  freeSlots  = xQueueCreate(VIDEO_SLOTS, sizeof(int8_t));
+  toDecode   = xQueueCreate(VIDEO_SLOTS, sizeof(Job));
+  freeFrames = xQueueCreate(2, sizeof(int8_t));
+  decoded    = xQueueCreate(2, sizeof(Job));
+  if (!freeSlots || !toDecode || !freeFrames || !decoded) return false;
+  for (int8_t i = 0; i < VIDEO_SLOTS; ++i) xQueueSend(freeSlots, &i, 0);
+  for (int8_t i = 0; i < 2; ++i) xQueueSend(freeFrames, &i, 0);
+
+  // No audio beats no video
+  if (aStream != NO_STREAM && audioSampleRate()) {
+    stage    = (int16_t*)ps_malloc(VIDEO_AUDIO_STAGE * sizeof(int16_t));
+    chunkBuf = (uint8_t*)ps_malloc(VIDEO_AUDIO_CHUNK);
+    if (!stage || !chunkBuf) {
+      free(stage);
+      free(chunkBuf);
+      stage = nullptr;
+      chunkBuf = nullptr;
+    }
+  }
+  return true;
+}
+
+static bool inFlight() {
+  return uxQueueMessagesWaiting(freeSlots) < VIDEO_SLOTS || uxQueueMessagesWaiting(decoded) > 0;
+}
+
+
+// =========================================================
+//  SESSION LIFECYCLE
+// =========================================================
+bool videoIsFile(const String& name) {
+  String lower = name;
+  lower.toLowerCase();
+  return lower.endsWith(".avi");
+}
+
+bool videoPlay(const char* path) {
+  if (running) videoStop();
+
+  vStream = aStream = NO_STREAM;
+  usPerFrame = totalFrames = nextFrame = 0;
+  srcW = srcH = 0;
+  eof = false;
+  stageHead = stageTail = 0;
+  aFed = 0;
+  decodeStats.write(DecodeStats());   // decoder not running yet
+  statPushUs = statReadUs = shown = dropRead = dropPresent = 0;
+  logShown = logDecoded = logDecodeUs = logPushUs = logReadUs = 0;
+
+  bool ok;
+  {
+    SdBus bus;
+    ok = openAvi(path);
+    if (!ok && file) file.close();
+  }
+  if (!ok) {
+    DBG_IF(VIDEO, "[Video] %s: not an MJPEG AVI\n", path);
+    return false;
+  }
+  if (!usPerFrame) usPerFrame = 41667;
+
+  // Largest JPEG scale (1/1 … 1/8) that fits the panel
+  scale = 0;
+  while (scale < 3 && ((srcW >> scale) > tft.width() || (srcH >> scale) > tft.height())) scale++;
+  fbW  = min((int)((srcW + (1 << scale) - 1) >> scale), (int)tft.width());
+  fbH  = min((int)((srcH + (1 << scale) - 1) >> scale), (int)tft.height());
+  dstX = (tft.width()  - fbW) / 2;
+  dstY = (tft.height() - fbH) / 2;
+
+  if (!allocPipeline()) {
+    DBG_IF(VIDEO, "[Video] Out of memory for %dx%d\n", fbW, fbH);
+    freePipeline();
+    SdBus bus;
+    file.close();
+    return false;
+  }
+  if (stage) aRatio = (float)audioSampleRate() / aRate;
+
+  tft.fillScreen(0x0000);
+  tft.initDMA();
+  swapWas = tft.getSwapBytes();
+  tft.setSwapBytes(false);
+
+  // Decoder next to the audio feeder on core 0
+  quitting = false;
+  started = false;
+  running = true;
+  waiter = xTaskGetCurrentTaskHandle();
+  decoderUp = xTaskCreatePinnedToCore(decoderTask, "mjpeg", 4096, nullptr, 2, nullptr, 0) == pdPASS;
+  if (!decoderUp) {
+    DBG_IF(VIDEO, "[Video] %s: can't start the decoder task (internal RAM low)\n", path);
+    videoStop();
+    return false;
+  }
+
+  // Pre-roll: full read-ahead and the first picture decoded
+  readAhead(VIDEO_SLOTS);
+  uint32_t t0 = millis();
+  while (!uxQueueMessagesWaiting(decoded) && inFlight() && millis() - t0 < 2000) delay(1);
+  if (!uxQueueMessagesWaiting(decoded)) {
+    DBG_IF(VIDEO, "[Video] %s: no decodable frame\n", path);
+    videoStop();
+    return false;
+  }
+
+  if (stage) audioPrime(SYNC_FILL_TARGET);
+  startUs = esp_timer_get_time();
+  logAt = 0;
+  started = true;
+
+  DBG_IF(VIDEO, "[Video] %s: %ux%u MJPEG, %.2f fps, %lu frames, shown %dx%d (1/%d), audio %s\n",
+         path, srcW, srcH, 1e6f / usPerFrame, (unsigned long)totalFrames,
+         fbW, fbH, 1 << scale, stage ? "on" : "off");
+  if (stage)
+    DBG_IF(VIDEO, "[Video] Audio %lu Hz, %u-bit, %u ch\n", (unsigned long)aRate, aBits, aChannels);
+  return true;
+}
+
+bool videoRunning() { return running; }
+
+void videoUpdate() {
+  if (!running) return;
+
+  controls.update(controls.mode());
+  if (controls.b() || (controls.start() && controls.select())) { videoStop(); return; }
+
+  // Present the oldest decoded frame once it's due. A late one
+  // is still shown unless a newer frame is due as well.
+  Job f, g;
+  if (xQueuePeek(decoded, &f, 0) && nowUs() >= dueUs(f.frame)) {
+    xQueueReceive(decoded, &f, 0);
+    if (xQueuePeek(decoded, &g, 0) && nowUs() >= dueUs(g.frame)) {
+      dropPresent++;
+    } else {
+      present(f.idx);
+      shown++;
+    }
+    xQueueSend(freeFrames, &f.idx, 0);
+  }
+
+  readAhead(1);
+  feedAudio();
+  logStats();
+
+  if (eof && !inFlight()) videoStop();
+}
+
+void videoStop() {
+  if (!running) return;
+  running = false;
+
+  float secs = started ? nowUs() / 1e6f : 0;
+  quitting = true;
+  if (decoderUp) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  decoderUp = false;
+  started = false;
+  audioIdle();
+
+  tft.dmaWait();
+  tft.setSwapBytes(swapWas);
+  tft.deInitDMA();
+
+  {
+    SdBus bus;
+    file.close();
+  }
+
+  const DecodeStats st = decodeStats.read();
+  DBG_IF(VIDEO, "[Video] Stopped after %.1f s: %lu of %lu frames shown, sustained %.1f FPS at %dx%d "
+                "(decode %.1f ms avg), %lu bad frames\n",
+         secs, (unsigned long)shown, (unsigned long)nextFrame,
+         secs > 0 ? shown / secs : 0.0f, fbW, fbH,
+         st.decoded ? st.decodeUs / 1000.0f / st.decoded : 0.0f, (unsigned long)st.bad);
+  freePipeline();
+
+  // Hand the screen back to the menus
+  tft.fillScreen(COL_BG);
+  setMenuInputLockUntil(millis() + 300);
+  if (EditMenu* m = currentMenu()) m->forceRedraw();
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,36 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  video.h — MJPEG Video Player (Header)
+//
+//  Provides:
+//   • videoIsFile()  — *.avi filter for the Gallery
+//   • videoPlay()    — Open an AVI and start playback
+//   • videoUpdate()  — Present / read ahead / feed audio
+//                      (call from loop)
+//   • videoStop()    — End playback, log sustained FPS
+//
+//  Format:
+//   - AVI with an MJPEG video stream (baseline JPEG) and an
+//     optional PCM audio stream (8/16-bit, mono or stereo).
+//   - Frames larger than the panel are decoded at 1/2, 1/4 or
+//     1/8 scale; smaller ones are centered.
+//
+//  Notes:
+//   - B or START + SELECT stops playback.
+//   - While playing, loop() should skip the menus.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool videoIsFile(const String& name);
+bool videoPlay(const char* path);
+bool videoRunning();
+void videoUpdate();
+void videoStop();
+
+// ======================= End of File =======================
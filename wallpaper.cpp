@@ -0,0 +1,169 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  wallpaper.cpp — Menu Wallpaper
+//
+//  wallpaperSet() reads the JPEG into PSRAM once and checks
+//  it; wallpaperFor() decodes it the first time a size is
+//  asked for (and again only after a rotation). The menus
+//  then restore just the rectangles they drew over last
+//  frame, so the decoder never runs per frame.
+//
+//  Notes:
+//   - Uses the ROM TJpgDec like video.cpp: baseline only,
+//     scale 1/1 … 1/8. The largest scale that still covers
+//     the UI is picked, then the centre is cropped out; a
+//     smaller image is centred on black.
+// =========================================================
+
+#include "wallpaper.h"
+#include "config.h"
+#include "dither.h"
+#include "esp32s3/rom/tjpgd.h"
+#include "sdcard.h"
+#include <SD.h>
+
+// =========================================================
+//  MODULE STATE
+// =========================================================
+static uint8_t*  jpeg = nullptr;       // file bytes (PSRAM)
+static uint32_t  jpegLen = 0;
+static uint16_t* image = nullptr;      // decoded, imageW x imageH
+static int16_t   imageW = 0, imageH = 0;
+static bool      failed = false;       // this size didn't decode
+static uint32_t  generation = 0;
+
+bool     wallpaperActive()     { return jpeg != nullptr; }
+uint32_t wallpaperGeneration() { return generation; }
+
+
+// =========================================================
+//  DECODE
+// =========================================================
+struct WallSrc {
+  uint32_t pos;
+  int16_t  offX, offY;   // crop: scaled image x/y of UI (0, 0)
+};
+
+static UINT wallIn(JDEC* jd, BYTE* buf, UINT n) {
+  WallSrc& s = *(WallSrc*)jd->device;
+  if (n > jpegLen - s.pos) n = jpegLen - s.pos;
+  if (buf) memcpy(buf, jpeg + s.pos, n);
+  s.pos += n;
+  return n;
+}
+
+// One MCU block → the cropped window, ordered dither
+static UINT wallOut(JDEC* jd, void* bitmap, JRECT* r) {
+  const WallSrc& s = *(const WallSrc*)jd->device;
+  const uint8_t* px = (const uint8_t*)bitmap;
+  const int bw = r->right - r->left + 1;
+
+  int x0 = r->left - s.offX, x1 = r->right - s.offX + 1;
+  int skip = x0 < 0 ? -x0 : 0;
+  x0 += skip;
+  x1 = min(x1, (int)imageW);
+  if (x0 >= x1) return 1;
+
+  for (int sy = r->top; sy <= r->bottom; ++sy, px += bw * 3) {
+    int y = sy - s.offY;
+    if (y < 0 || y >= imageH) continue;
+    ditherOrderedRow(px + skip * 3, image + (size_t)y * imageW + x0, x1 - x0, x0, y, true);
+  }
+  return 1;
+}
+
+static bool decode(int16_t w, int16_t h) {
+  uint32_t t0 = millis();
+  free(image);
+  image = (uint16_t*)ps_malloc((size_t)w * h * sizeof(uint16_t));
+  uint8_t* pool = (uint8_t*)malloc(VIDEO_JPEG_POOL);
+  imageW = w;
+  imageH = h;
+  if (!image || !pool) {
+    free(pool);
+    DBG_IF(MENU, "[Wallpaper] Out of memory for %dx%d\n", w, h);
+    return false;
+  }
+  memset(image, 0, (size_t)w * h * sizeof(uint16_t));
+
+  WallSrc src = { 0, 0, 0 };
+  JDEC jd;
+  bool ok = jd_prepare(&jd, wallIn, pool, VIDEO_JPEG_POOL, &src) == JDR_OK;
+  if (ok) {
+    const int iw = jd.width, ih = jd.height;
+    uint8_t scale = 3;   // largest reduction that still covers
+    while (scale > 0 && ((iw >> scale) < w || (ih >> scale) < h)) scale--;
+    src.offX = (int16_t)(((iw >> scale) - w) / 2);
+    src.offY = (int16_t)(((ih >> scale) - h) / 2);
+    ok = jd_decomp(&jd, wallOut, scale) == JDR_OK;
+    DBG_IF(MENU, "[Wallpaper] %dx%d at 1/%d → %dx%d in %lu ms\n", iw, ih,
+           1 << scale, w, h, (unsigned long)(millis() - t0));
+  }
+  free(pool);
+  return ok;
+}
+
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool wallpaperSet(const char* path) {
+  free(jpeg);  jpeg = nullptr;  jpegLen = 0;
+  free(image); image = nullptr; imageW = imageH = 0;
+  failed = false;
+  generation++;
+  if (!path) return true;
+
+  bool ok = false;
+  {
+    SdBus bus;
+    File f = SD.open(path, FILE_READ);
+    if (f) {
+      jpegLen = f.size();
+      if (jpegLen >= 4 && jpegLen <= WALLPAPER_MAX_KB * 1024 && (jpeg = (uint8_t*)ps_malloc(jpegLen)))
+        ok = f.read(jpeg, jpegLen) == jpegLen && jpeg[0] == 0xFF && jpeg[1] == 0xD8;
+      f.close();
+    }
+  }
+
+  if (!ok) {
+    free(jpeg); jpeg = nullptr; jpegLen = 0;
+    DBG_IF(MENU, "[Wallpaper] %s: can't load (missing, not a JPEG, or over %lu KB)\n",
+           path, (unsigned long)WALLPAPER_MAX_KB);
+  }
+  return ok;
+}
+
+const uint16_t* wallpaperFor(int16_t w, int16_t h) {
+  if (!jpeg) return nullptr;
+  if (w != imageW || h != imageH) failed = !decode(w, h);
+  return failed ? nullptr : image;
+}
+
+void wallpaperRestoreRaw(uint16_t* fb, int16_t sw, int16_t sh, const uint16_t* src,
+                         int32_t x, int32_t y, int32_t w, int32_t h, uint16_t bg) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > sw) w = sw - x;
+  if (y + h > sh) h = sh - y;
+  if (w <= 0 || h <= 0) return;
+
+  if (src) {
+    for (int32_t r = y; r < y + h; ++r)
+      memcpy(fb + (size_t)r * sw + x, src + (size_t)r * sw + x, (size_t)w * sizeof(uint16_t));
+    return;
+  }
+  const uint16_t c = (uint16_t)((bg >> 8) | (bg << 8));
+  for (int32_t r = y; r < y + h; ++r) {
+    uint16_t* row = fb + (size_t)r * sw + x;
+    for (int32_t i = 0; i < w; ++i) row[i] = c;
+  }
+}
+
+void wallpaperRestore(TFT_eSprite& spr, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t bg) {
+  const int16_t sw = spr.width(), sh = spr.height();
+  wallpaperRestoreRaw((uint16_t*)spr.getPointer(), sw, sh, wallpaperFor(sw, sh), x, y, w, h, bg);
+}
+
+// ======================= End of File =======================
@@ -0,0 +1,49 @@
+// =========================================================
+//  RowBoy Firmware Prototype v1.0 (ESP32-S3)
+//  ---------------------------------------------------------
+//  wallpaper.h — Menu Wallpaper (Header)
+//
+//  Provides:
+//   • wallpaperSet()      — Use a JPEG from SD behind the menus
+//                           (nullptr = solid theme colour)
+//   • wallpaperFor()      — The decoded image at the UI size
+//   • wallpaperRestore()  — Put the background back under a
+//                           rectangle of a page sprite
+//   • wallpaperRestoreRaw() — The same on a raw page buffer,
+//                           safe from either core
+//
+//  Notes:
+//   - The JPEG is decoded once per UI size (rotation) into a
+//     PSRAM frame, scaled to cover and centre-cropped, with
+//     ordered dithering. Restoring a rectangle is a row copy
+//     out of it — as cheap as filling with a solid colour.
+//   - wallpaperGeneration() changes whenever the image does,
+//     so page sprites know to repaint in full.
+// =========================================================
+
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// =========================================================
+//  PUBLIC API
+// =========================================================
+bool wallpaperSet(const char* path);   // false: missing / not a baseline JPEG
+bool wallpaperActive();
+uint32_t wallpaperGeneration();
+
+// w x h pixels in sprite order (byte-swapped), or nullptr if
+// no wallpaper is set or it can't be decoded at that size.
+const uint16_t* wallpaperFor(int16_t w, int16_t h);
+
+// Clipped to the sprite; solid `bg` without a wallpaper
+void wallpaperRestore(TFT_eSprite& spr, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t bg);
+
+// The same on a raw sw x sh page (sprite order), `src` being
+// wallpaperFor(sw, sh) looked up beforehand: no sprite or
+// decoder calls, so disjoint rectangles of one page can be
+// restored from both cores at once (split.h)
+void wallpaperRestoreRaw(uint16_t* fb, int16_t sw, int16_t sh, const uint16_t* src,
+                         int32_t x, int32_t y, int32_t w, int32_t h, uint16_t bg);
+
+// ======================= End of File =======================